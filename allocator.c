@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <string.h>
+#include "allocator.h"
+#include "stats.h"
+
+/** An integer element, the value is first so that a pointer to the box is a pointer to the value */
+typedef struct {
+	int value;
+	const Allocator* allocator;
+} IntBox;
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+defaultAlloc: Allocates memory with malloc.
+
+@param context - Unused.
+@param size - The number of bytes to allocate.
+
+@return NULL if malloc failed.
+		Else, returns the allocated memory.
+*/
+static void* defaultAlloc(void* context, size_t size);
+
+/*
+defaultFree: Deallocates memory with free.
+
+@param context - Unused.
+@param ptr - The memory to deallocate.
+*/
+static void defaultFree(void* context, void* ptr);
+
+static const Allocator default_allocator = { defaultAlloc, defaultFree, NULL };
+
+/* =---------------------------------------------------------------------------=
+
+								Allocator Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+const Allocator* allocatorGetDefault(void)
+{
+	return &default_allocator;
+}
+
+void* allocatorAlloc(const Allocator* allocator, size_t size)
+{
+	if (allocator == NULL) {
+		allocator = &default_allocator;
+	}
+	void* ptr = allocator->alloc(allocator->context, size);
+	if (ptr != NULL) {
+		STATS_COUNT(allocations);
+	}
+	return ptr;
+}
+
+void allocatorFree(const Allocator* allocator, void* ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+	if (allocator == NULL) {
+		allocator = &default_allocator;
+	}
+	STATS_COUNT(deallocations);
+	allocator->free(allocator->context, ptr);
+}
+
+char* allocatorStringCopy(const Allocator* allocator, const char* str)
+{
+	if (str == NULL) {
+		return NULL;
+	}
+	size_t size = strlen(str) + 1;
+	char* copy = allocatorAlloc(allocator, size);
+	if (copy == NULL) {
+		return NULL;
+	}
+	memcpy(copy, str, size);
+	return copy;
+}
+
+int* allocatorIntCreate(const Allocator* allocator, int value)
+{
+	IntBox* box = allocatorAlloc(allocator, sizeof(*box));
+	if (box == NULL) {
+		return NULL;
+	}
+	box->value = value;
+	box->allocator = allocator;
+	return &box->value;
+}
+
+void* allocatorIntCopy(void* num)
+{
+	if (num == NULL) {
+		return NULL;
+	}
+	IntBox* box = num;
+	return allocatorIntCreate(box->allocator, box->value);
+}
+
+void allocatorIntFree(void* num)
+{
+	if (num == NULL) {
+		return;
+	}
+	IntBox* box = num;
+	allocatorFree(box->allocator, box);
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void* defaultAlloc(void* context, size_t size)
+{
+	return malloc(size);
+}
+
+static void defaultFree(void* context, void* ptr)
+{
+	free(ptr);
+}
@@ -0,0 +1,94 @@
+#ifndef _ALLOCATOR_H
+#define _ALLOCATOR_H
+
+#include <stddef.h>
+
+/*
+* A pluggable allocator, given to the *WithAllocator constructors.
+* Every object remembers the allocator it was created with, deallocates itself through it,
+* and its copies are created with the same allocator. Passing NULL selects the default
+* allocator, which uses malloc and free.
+* The allocator (and its context) must stay valid until every object created with it was deallocated.
+*/
+
+/** Type of the function that allocates memory, returns NULL if the allocation failed */
+typedef void*(*AllocatorAllocFunc)(void* context, size_t size);
+
+/** Type of the function that deallocates memory returned by the allocate function */
+typedef void(*AllocatorFreeFunc)(void* context, void* ptr);
+
+/** Type for defining an allocator */
+typedef struct {
+	AllocatorAllocFunc alloc;
+	AllocatorFreeFunc free;
+	void* context; //Passed to alloc and free.
+} Allocator;
+
+
+/*
+allocatorGetDefault: Returns the default allocator, which uses malloc and free.
+
+@return The default allocator.
+*/
+const Allocator* allocatorGetDefault(void);
+
+/*
+allocatorAlloc: Allocates memory from an allocator.
+
+@param allocator - The allocator, or NULL for the default allocator.
+@param size - The number of bytes to allocate.
+
+@return NULL if the allocation failed.
+		Else, returns the allocated memory.
+*/
+void* allocatorAlloc(const Allocator* allocator, size_t size);
+
+/*
+allocatorFree: Returns memory to the allocator it was allocated from.
+
+@param allocator - The allocator, or NULL for the default allocator.
+@param ptr - The memory to deallocate, nothing is done if it is NULL.
+*/
+void allocatorFree(const Allocator* allocator, void* ptr);
+
+/*
+allocatorStringCopy: Copies a string into memory of an allocator.
+
+@param allocator - The allocator, or NULL for the default allocator.
+@param str - The string to copy.
+
+@return NULL if the string is NULL or if the allocation failed.
+		Else, returns the copy, which is deallocated with allocatorFree.
+*/
+char* allocatorStringCopy(const Allocator* allocator, const char* str);
+
+/*
+allocatorIntCreate: Allocates an integer element that remembers its allocator, so that it can be
+					copied and deallocated by allocatorIntCopy and allocatorIntFree (ElemCopyFunc and ElemFreeFunc).
+
+@param allocator - The allocator, or NULL for the default allocator.
+@param value - The value of the integer.
+
+@return NULL if the allocation failed.
+		Else, returns the integer.
+*/
+int* allocatorIntCreate(const Allocator* allocator, int value);
+
+/*
+allocatorIntCopy: Copies an integer created by allocatorIntCreate, with the same allocator.
+
+@param num - The integer to copy.
+
+@return NULL if num is NULL or if the allocation failed.
+		Else, returns the copy.
+*/
+void* allocatorIntCopy(void* num);
+
+/*
+allocatorIntFree: Deallocates an integer created by allocatorIntCreate or allocatorIntCopy.
+
+@param num - The integer to deallocate.
+*/
+void allocatorIntFree(void* num);
+
+#endif /* _ALLOCATOR_H */
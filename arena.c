@@ -0,0 +1,282 @@
+#define _POSIX_C_SOURCE 200809L //For posix_memalign and pthread_mutex_t under -std=c99.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "arena.h"
+
+#define ALIGNMENT 16
+#define LARGE_CLASS -1
+#define CLASSES_COUNT ((int)(sizeof(class_sizes) / sizeof(class_sizes[0])))
+#define CHUNK_HEADER_SIZE ((sizeof(struct chunk_t) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+
+/** The object sizes of the size classes, a request is rounded up to the first class that fits */
+static const size_t class_sizes[] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+
+/*
+* The header at the start of every chunk. Chunks are aligned to the chunk size,
+* so the chunk of an object is found by rounding its address down.
+*/
+typedef struct chunk_t {
+	struct chunk_t* next;
+	struct chunk_t* prev;
+	int size_class; //LARGE_CLASS for a chunk of a single large allocation.
+}*Chunk;
+
+/** A deallocated object, linked into the free list of its size class */
+typedef struct free_object_t {
+	struct free_object_t* next;
+}*FreeObject;
+
+struct arena_t {
+	size_t chunk_size; //A power of 2.
+	Chunk chunks; //All of the chunks, for releasing them and for unlinking large chunks.
+	FreeObject free_lists[CLASSES_COUNT];
+	char* bump[CLASSES_COUNT]; //The next object of the class in its newest chunk.
+	char* bump_end[CLASSES_COUNT];
+	bool thread_safe;
+	pthread_mutex_t lock; //Initialized only when thread_safe is true.
+	Allocator allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+arenaAlloc: Allocates an object from an arena, the alloc function of the arena's allocator.
+
+@param context - The arena.
+@param size - The number of bytes to allocate.
+
+@return NULL if a memory allocation failed.
+		Else, returns the allocated memory.
+*/
+static void* arenaAlloc(void* context, size_t size);
+
+/*
+arenaFree: Returns an object to its arena, the free function of the arena's allocator.
+		   Objects of a size class are kept for reuse, a large allocation is released right away.
+
+@param context - The arena.
+@param ptr - The object to deallocate.
+*/
+static void arenaFree(void* context, void* ptr);
+
+/*
+findClass: Returns the size class of an allocation.
+
+@param size - The number of bytes to allocate.
+
+@return LARGE_CLASS if the size is bigger than every class.
+		Else, returns the index of the smallest class that fits.
+*/
+static int findClass(size_t size);
+
+/*
+addChunk: Allocates a chunk of memory and links it to the chunks of an arena.
+
+@param arena - The arena to add the chunk to.
+@param size - The size of the chunk, including its header.
+@param size_class - The size class of the chunk.
+
+@return NULL if the allocation failed.
+		Else, returns the chunk.
+*/
+static Chunk addChunk(Arena arena, size_t size, int size_class);
+
+/*
+allocateObject: Allocates an object from the free list or the newest chunk of its size class.
+
+@param arena - The arena to allocate from.
+@param size_class - The size class of the object.
+
+@return NULL if a memory allocation failed.
+		Else, returns the object.
+*/
+static void* allocateObject(Arena arena, int size_class);
+
+/* =---------------------------------------------------------------------------=
+
+								Arena Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+Arena arenaCreate(size_t chunk_size)
+{
+	if (chunk_size < ARENA_MIN_CHUNK_SIZE || (chunk_size & (chunk_size - 1)) != 0) {
+		return NULL;
+	}
+
+	Arena arena = malloc(sizeof(*arena));
+	if (arena == NULL) {
+		return NULL;
+	}
+	arena->chunk_size = chunk_size;
+	arena->chunks = NULL;
+	for (int i = 0; i < CLASSES_COUNT; i++) {
+		arena->free_lists[i] = NULL;
+		arena->bump[i] = NULL;
+		arena->bump_end[i] = NULL;
+	}
+	arena->thread_safe = false;
+	arena->allocator.alloc = arenaAlloc;
+	arena->allocator.free = arenaFree;
+	arena->allocator.context = arena;
+	return arena;
+}
+
+void arenaDestroy(Arena arena)
+{
+	if (arena == NULL) {
+		return;
+	}
+	while (arena->chunks != NULL) {
+		Chunk next = arena->chunks->next;
+		free(arena->chunks);
+		arena->chunks = next;
+	}
+	if (arena->thread_safe) {
+		pthread_mutex_destroy(&arena->lock);
+	}
+	free(arena);
+}
+
+const Allocator* arenaGetAllocator(Arena arena)
+{
+	if (arena == NULL) {
+		return NULL;
+	}
+	return &arena->allocator;
+}
+
+ArenaResult arenaEnableThreadSafety(Arena arena)
+{
+	if (arena == NULL) {
+		return ARENA_NULL_ARGUMENT;
+	}
+	if (arena->thread_safe) {
+		return ARENA_SUCCESS;
+	}
+	if (pthread_mutex_init(&arena->lock, NULL) != 0) {
+		return ARENA_OUT_OF_MEMORY;
+	}
+	arena->thread_safe = true;
+	return ARENA_SUCCESS;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void* arenaAlloc(void* context, size_t size)
+{
+	Arena arena = context;
+	int size_class = findClass(size);
+	if (size_class == LARGE_CLASS && size > SIZE_MAX - CHUNK_HEADER_SIZE) {
+		return NULL;
+	}
+
+	if (arena->thread_safe) {
+		pthread_mutex_lock(&arena->lock);
+	}
+	void* ptr = NULL;
+	if (size_class != LARGE_CLASS) {
+		ptr = allocateObject(arena, size_class);
+	}
+	else {
+		Chunk chunk = addChunk(arena, CHUNK_HEADER_SIZE + size, LARGE_CLASS);
+		ptr = chunk == NULL ? NULL : (char*)chunk + CHUNK_HEADER_SIZE;
+	}
+	if (arena->thread_safe) {
+		pthread_mutex_unlock(&arena->lock);
+	}
+	return ptr;
+}
+
+static void arenaFree(void* context, void* ptr)
+{
+	Arena arena = context;
+	Chunk chunk = (Chunk)((uintptr_t)ptr & ~(uintptr_t)(arena->chunk_size - 1));
+
+	if (arena->thread_safe) {
+		pthread_mutex_lock(&arena->lock);
+	}
+	if (chunk->size_class != LARGE_CLASS) {
+		FreeObject object = ptr;
+		object->next = arena->free_lists[chunk->size_class];
+		arena->free_lists[chunk->size_class] = object;
+	}
+	else {
+		if (chunk->prev == NULL) {
+			arena->chunks = chunk->next;
+		}
+		else {
+			chunk->prev->next = chunk->next;
+		}
+		if (chunk->next != NULL) {
+			chunk->next->prev = chunk->prev;
+		}
+		free(chunk);
+	}
+	if (arena->thread_safe) {
+		pthread_mutex_unlock(&arena->lock);
+	}
+}
+
+static int findClass(size_t size)
+{
+	for (int i = 0; i < CLASSES_COUNT; i++) {
+		if (size <= class_sizes[i]) {
+			return i;
+		}
+	}
+	return LARGE_CLASS;
+}
+
+static Chunk addChunk(Arena arena, size_t size, int size_class)
+{
+	void* memory = NULL;
+	if (posix_memalign(&memory, arena->chunk_size, size) != 0) {
+		return NULL;
+	}
+	Chunk chunk = memory;
+	chunk->size_class = size_class;
+	chunk->prev = NULL;
+	chunk->next = arena->chunks;
+	if (arena->chunks != NULL) {
+		arena->chunks->prev = chunk;
+	}
+	arena->chunks = chunk;
+	return chunk;
+}
+
+static void* allocateObject(Arena arena, int size_class)
+{
+	FreeObject object = arena->free_lists[size_class];
+	if (object != NULL) {
+		arena->free_lists[size_class] = object->next;
+		return object;
+	}
+
+	size_t object_size = class_sizes[size_class];
+	if (arena->bump[size_class] == NULL || (size_t)(arena->bump_end[size_class] - arena->bump[size_class]) < object_size) {
+		Chunk chunk = addChunk(arena, arena->chunk_size, size_class);
+		if (chunk == NULL) {
+			return NULL;
+		}
+		arena->bump[size_class] = (char*)chunk + CHUNK_HEADER_SIZE;
+		arena->bump_end[size_class] = (char*)chunk + arena->chunk_size;
+	}
+	void* ptr = arena->bump[size_class];
+	arena->bump[size_class] += object_size;
+	return ptr;
+}
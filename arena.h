@@ -0,0 +1,70 @@
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <stddef.h>
+#include "allocator.h"
+
+/*
+* A region allocator for objects that are all released together.
+* Memory is carved from large chunks by bumping a pointer, every chunk serving one size class,
+* and deallocated objects are kept in a free list of their size class for reuse.
+* Allocations larger than the biggest size class get a chunk of their own.
+* arenaDestroy releases the whole region with one free per chunk, no matter how many
+* objects were allocated, so the objects don't have to be deallocated one by one.
+*/
+
+/** Type for defining the arena */
+typedef struct arena_t* Arena;
+
+/** Type used for returning error codes from arena functions */
+typedef enum {
+	ARENA_SUCCESS,
+	ARENA_OUT_OF_MEMORY,
+	ARENA_NULL_ARGUMENT
+} ArenaResult;
+
+/** The smallest chunk size of an arena */
+#define ARENA_MIN_CHUNK_SIZE 4096
+
+
+/*
+arenaCreate: Creates a new empty arena.
+
+@param chunk_size - The size of the chunks in bytes, a power of 2 that is at least ARENA_MIN_CHUNK_SIZE.
+
+@return NULL if the chunk size is invalid or if a memory allocation failed.
+		Else, returns a new empty arena.
+*/
+Arena arenaCreate(size_t chunk_size);
+
+/*
+arenaDestroy: Releases all of the memory of the arena at once.
+			  Every object allocated from the arena becomes invalid.
+
+@param arena - The arena to destroy.
+*/
+void arenaDestroy(Arena arena);
+
+/*
+arenaGetAllocator: Returns an allocator that allocates from the arena,
+				   for the *WithAllocator constructors.
+
+@param arena - The arena to allocate from.
+
+@return NULL if the arena is NULL.
+		Else, returns the allocator of the arena, valid until the arena is destroyed.
+*/
+const Allocator* arenaGetAllocator(Arena arena);
+
+/*
+arenaEnableThreadSafety: Makes allocations and deallocations of the arena safe to call from several threads.
+
+@param arena - The arena to make thread safe.
+
+@return ARENA_NULL_ARGUMENT if the arena is NULL.
+		ARENA_OUT_OF_MEMORY if the lock couldn't be initialized.
+		ARENA_SUCCESS if the arena is thread safe (also when it already was).
+*/
+ArenaResult arenaEnableThreadSafety(Arena arena);
+
+#endif /* _ARENA_H */
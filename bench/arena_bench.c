@@ -0,0 +1,98 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "event_manager.h"
+#include "event_manager_ext.h"
+
+/*
+* Benchmark for arena-backed event managers.
+* Every cycle creates an event manager, populates it with members and events, links
+* every member to a few events, and destroys it. The same cycles are run with the
+* default allocator (every object is deallocated on its own) and with an arena
+* (destroyEventManager releases the arena chunks), on both backends.
+* The results are printed as CSV:
+* backend,allocator,members,events,cycles,populate_seconds,destroy_seconds,cycle_seconds
+*/
+
+#define CYCLES 5
+#define LINKS_PER_MEMBER 4
+#define DAYS_RANGE 365
+#define NAME_LENGTH 32
+
+typedef struct {
+	const char* name;
+	EventManagerBackend backend;
+} BenchBackend;
+
+static const BenchBackend backends[] = {
+	{ "priority_queue", EM_BACKEND_PRIORITY_QUEUE },
+	{ "timing_wheel", EM_BACKEND_TIMING_WHEEL }
+};
+
+static const int sizes[] = { 500, 2000 };
+
+static double secondsSince(const struct timespec* start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* Adds size members and size events, and links every member to LINKS_PER_MEMBER events. */
+static void populate(EventManager em, int size)
+{
+	char name[NAME_LENGTH];
+	for (int i = 0; i < size; i++) {
+		sprintf(name, "member %d", i);
+		emAddMember(em, name, i);
+		sprintf(name, "event %d", i);
+		emAddEventByDiff(em, name, i % DAYS_RANGE, i);
+	}
+	for (int i = 0; i < size; i++) {
+		for (int j = 0; j < LINKS_PER_MEMBER; j++) {
+			emAddMemberToEvent(em, i, (i * 7 + j * 13) % size);
+		}
+	}
+}
+
+int main(void)
+{
+	Date date = dateCreate(1, 1, 2020);
+	if (date == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	printf("backend,allocator,members,events,cycles,populate_seconds,destroy_seconds,cycle_seconds\n");
+	for (int b = 0; b < (int)(sizeof(backends) / sizeof(backends[0])); b++) {
+		for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+			for (int arena = 0; arena <= 1; arena++) {
+				double populate_seconds = 0, destroy_seconds = 0;
+				struct timespec cycle_start, start;
+				clock_gettime(CLOCK_MONOTONIC, &cycle_start);
+				for (int cycle = 0; cycle < CYCLES; cycle++) {
+					clock_gettime(CLOCK_MONOTONIC, &start);
+					EventManager em = arena ? createEventManagerWithArena(date, backends[b].backend) :
+						createEventManagerWithBackend(date, backends[b].backend);
+					if (em == NULL) {
+						fprintf(stderr, "Out of memory\n");
+						return 1;
+					}
+					populate(em, sizes[s]);
+					populate_seconds += secondsSince(&start);
+
+					clock_gettime(CLOCK_MONOTONIC, &start);
+					destroyEventManager(em);
+					destroy_seconds += secondsSince(&start);
+				}
+				printf("%s,%s,%d,%d,%d,%.4f,%.4f,%.4f\n", backends[b].name, arena ? "arena" : "malloc",
+					sizes[s], sizes[s], CYCLES, populate_seconds / CYCLES, destroy_seconds / CYCLES,
+					secondsSince(&cycle_start) / CYCLES);
+			}
+		}
+	}
+	dateDestroy(date);
+	return 0;
+}
@@ -0,0 +1,164 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "priority_queue.h"
+#include "concurrent_priority_queue.h"
+
+/*
+* Scaling benchmark for the concurrent priority queue.
+* Every thread inserts and removes elements in turns, on a queue that was
+* filled in advance, and the total throughput is printed as CSV:
+* queue,threads,ops,seconds,ops_per_sec
+* The run is split into rounds, and the nodes removed from the lock-free queue
+* are reclaimed after each round, once its threads were joined.
+* The same workload runs on a PriorityQueue guarded by a single mutex for comparison.
+*/
+
+#define PREFILL 1000
+#define OPS_PER_THREAD 200000
+#define PRIORITY_RANGE 100000
+#define MAX_THREADS 16
+#define ROUNDS 10
+
+static const int thread_counts[] = { 1, 2, 4, 8, MAX_THREADS };
+
+typedef struct {
+	void* queue;
+	unsigned int seed;
+	int ops;
+} WorkerArgs;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void* intCopy(void* element)
+{
+	int* copy = malloc(sizeof(int));
+	if (copy != NULL) {
+		*copy = *(int*)element;
+	}
+	return copy;
+}
+
+static void intFree(void* element)
+{
+	free(element);
+}
+
+static bool intEquals(void* element1, void* element2)
+{
+	return *(int*)element1 == *(int*)element2;
+}
+
+static int intCompareLowest(void* priority1, void* priority2)
+{
+	return *(int*)priority2 - *(int*)priority1;
+}
+
+static int nextRandom(unsigned int* seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) % PRIORITY_RANGE;
+}
+
+static void* concurrentWorker(void* arg)
+{
+	WorkerArgs* args = arg;
+	for (int i = 0; i < args->ops; i += 2) {
+		int priority = nextRandom(&args->seed);
+		cpqInsert(args->queue, &i, &priority);
+		cpqRemove(args->queue);
+	}
+	return NULL;
+}
+
+static void* lockedWorker(void* arg)
+{
+	WorkerArgs* args = arg;
+	for (int i = 0; i < args->ops; i += 2) {
+		int priority = nextRandom(&args->seed);
+		pthread_mutex_lock(&queue_lock);
+		pqInsert(args->queue, &i, &priority);
+		pthread_mutex_unlock(&queue_lock);
+		pthread_mutex_lock(&queue_lock);
+		pqRemove(args->queue);
+		pthread_mutex_unlock(&queue_lock);
+	}
+	return NULL;
+}
+
+static void reclaimConcurrent(void* queue)
+{
+	cpqReclaim(queue);
+}
+
+static double runThreads(void* queue, void* (*worker)(void*), void (*reclaim)(void*), int threads, int ops, int round)
+{
+	pthread_t ids[MAX_THREADS];
+	WorkerArgs args[MAX_THREADS];
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < threads; i++) {
+		args[i].queue = queue;
+		args[i].seed = round * threads + i + 1;
+		args[i].ops = ops;
+		pthread_create(&ids[i], NULL, worker, &args[i]);
+	}
+	for (int i = 0; i < threads; i++) {
+		pthread_join(ids[i], NULL);
+	}
+	if (reclaim != NULL) {
+		reclaim(queue); //No thread uses the queue anymore.
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+static double runRounds(void* queue, void* (*worker)(void*), void (*reclaim)(void*), int threads, int ops)
+{
+	double seconds = 0;
+	for (int round = 0; round < ROUNDS; round++) {
+		seconds += runThreads(queue, worker, reclaim, threads, ops / ROUNDS, round);
+	}
+	return seconds;
+}
+
+static void printResult(const char* name, int threads, int ops, double seconds)
+{
+	long total = (long)threads * ops;
+	printf("%s,%d,%ld,%.6f,%.0f\n", name, threads, total, seconds, total / seconds);
+}
+
+int main(int argc, char** argv)
+{
+	int ops = (argc > 1) ? atoi(argv[1]) : OPS_PER_THREAD;
+	ops -= ops % ROUNDS;
+	unsigned int seed = 0;
+	printf("queue,threads,ops,seconds,ops_per_sec\n");
+
+	for (int t = 0; t < (int)(sizeof(thread_counts) / sizeof(*thread_counts)); t++) {
+		ConcurrentPriorityQueue queue = cpqCreate(intCopy, intFree, intCopy, intFree, intCompareLowest);
+		for (int i = 0; i < PREFILL; i++) {
+			int priority = nextRandom(&seed);
+			cpqInsert(queue, &i, &priority);
+		}
+		printResult("lock_free_skiplist", thread_counts[t],
+			ops, runRounds(queue, concurrentWorker, reclaimConcurrent, thread_counts[t], ops));
+		cpqDestroy(queue);
+	}
+
+	for (int t = 0; t < (int)(sizeof(thread_counts) / sizeof(*thread_counts)); t++) {
+		PriorityQueue queue = pqCreate(intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest);
+		for (int i = 0; i < PREFILL; i++) {
+			int priority = nextRandom(&seed);
+			pqInsert(queue, &i, &priority);
+		}
+		printResult("mutex_priority_queue", thread_counts[t],
+			ops, runRounds(queue, lockedWorker, NULL, thread_counts[t], ops));
+		pqDestroy(queue);
+	}
+	return 0;
+}
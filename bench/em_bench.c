@@ -0,0 +1,631 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime, fork and getrusage under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "priority_queue.h"
+#include "priority_queue_ext.h"
+#include "event_manager.h"
+#include "event_manager_ext.h"
+#include "allocator.h"
+
+/*
+* Benchmark of the event manager and the priority queue under a synthetic workload.
+* The workload is generated from a seed, so the same parameters always produce the same calls:
+* - populate: members members and events events are added, and every member attends
+*   between 0 and 2 * attendance events. hot percent of the attendances go to the
+*   first tenth of the events, the rest are spread over all of them.
+* - steady: ops calls, churn percent of them change the event manager (events are replaced,
+*   moved and unlinked, members join events and new members are added) and the rest read it.
+*   The event manager ticks a day every tick_every calls.
+* - report: both print functions, written to /dev/null. emPrintAllEvents formats the events
+*   on report_threads threads.
+* - teardown: the event manager is destroyed.
+* The raw priority queue API runs the same phases on a queue of integer elements, with
+* insertions, priority changes, removals and iteration in place of the event manager calls.
+* The heap api runs them on an array binary heap that indexes the positions of its elements,
+* as the baseline of the queue engines. Like the engines, it orders equal priorities by an
+* insertion sequence, and its report phase sorts a copy of the heap.
+* The queue engines then run two more phases, with the events spread over sources queues:
+* - ingest: every event is inserted into one of the sources queues, in turns.
+* - merge: the sources queues are merged with pqMerge into the first of them.
+* Every configuration runs in a child process, so peak_rss_kb is the peak of that configuration
+* alone, and allocations counts the allocations made through a counting allocator.
+* Parameters are given as name=value arguments, for example:
+*   ./em_bench members=5000 events=20000 churn=50 engine=timing_wheel
+* engine selects the configurations whose api or engine has that name, or all of them.
+* The parameters are printed to stderr and the results are printed to stdout as CSV:
+* api,engine,phase,ops,seconds,ops_per_sec,allocations,peak_rss_kb
+*/
+
+#define DAYS_RANGE 365
+#define NAME_LENGTH 32
+#define HOT_EVENTS_DIVISOR 10 //The hot events are the first tenth of the events.
+
+typedef struct {
+	const char* name;
+	int value;
+} BenchParam;
+
+/** The workload parameters, in the order of the PARAM_* indexes */
+static BenchParam params[] = {
+	{ "members", 1000 },
+	{ "events", 2000 },
+	{ "attendance", 4 },
+	{ "hot", 50 },
+	{ "tick_every", 500 },
+	{ "churn", 20 },
+	{ "ops", 20000 },
+	{ "seed", 1 },
+	{ "report_threads", 1 },
+	{ "sources", 8 }
+};
+
+enum { PARAM_MEMBERS, PARAM_EVENTS, PARAM_ATTENDANCE, PARAM_HOT, PARAM_TICK_EVERY, PARAM_CHURN, PARAM_OPS, PARAM_SEED,
+	PARAM_REPORT_THREADS, PARAM_SOURCES };
+
+#define PARAM(index) (params[index].value)
+#define PARAMS_COUNT ((int)(sizeof(params) / sizeof(params[0])))
+
+typedef struct {
+	const char* api;
+	const char* engine;
+	EventManagerBackend backend; //Used by the event manager.
+	PQEngine queue_engine; //Used by the raw priority queue.
+} BenchEngine;
+
+static const BenchEngine engines[] = {
+	{ "em", "priority_queue", EM_BACKEND_PRIORITY_QUEUE, PQ_ENGINE_LIST },
+	{ "em", "timing_wheel", EM_BACKEND_TIMING_WHEEL, PQ_ENGINE_LIST },
+	{ "em", "btree", EM_BACKEND_BTREE, PQ_ENGINE_BTREE },
+	{ "pq", "priority_queue", EM_BACKEND_PRIORITY_QUEUE, PQ_ENGINE_LIST },
+	{ "pq", "btree", EM_BACKEND_BTREE, PQ_ENGINE_BTREE },
+	{ "pq", "pairing_heap", EM_BACKEND_PRIORITY_QUEUE, PQ_ENGINE_PAIRING_HEAP },
+	{ "heap", "binary_heap", EM_BACKEND_PRIORITY_QUEUE, PQ_ENGINE_LIST }
+};
+
+/** The queue of the raw workload: a priority queue, or the binary heap baseline when queue is NULL */
+typedef struct {
+	PriorityQueue queue;
+	int* heap; //heap[i] is the element at position i of the binary heap.
+	int* positions; //positions[element] is the position of the element in the heap, or NO_POSITION.
+	long long* sequences; //sequences[element] is the insertion sequence of the element, that orders equal priorities.
+	long long sequence; //The sequence of the next inserted element.
+	int size;
+	int* priorities; //priorities[element] is the priority of the element while it is in the queue.
+} BenchQueue;
+
+#define NO_POSITION -1
+
+/** The state of a measured phase */
+typedef struct {
+	const BenchEngine* engine;
+	const char* phase;
+	struct timespec start;
+	long allocations_start;
+	int ops;
+} BenchPhase;
+
+static long allocations = 0;
+
+static void* countingAlloc(void* context, size_t size)
+{
+	(void)context;
+	void* ptr = malloc(size);
+	if (ptr != NULL) {
+		allocations++;
+	}
+	return ptr;
+}
+
+static void countingFree(void* context, void* ptr)
+{
+	(void)context;
+	free(ptr);
+}
+
+static const Allocator counting_allocator = { countingAlloc, countingFree, NULL };
+
+static int nextRandom(unsigned int* seed, int range)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) % range;
+}
+
+/* Returns true with the given percent chance. */
+static bool chance(unsigned int* seed, int percent)
+{
+	return nextRandom(seed, 100) < percent;
+}
+
+/* Returns the event that an attendance goes to, following the hot parameter. */
+static int attendedEvent(unsigned int* seed, int events)
+{
+	int hot_events = events / HOT_EVENTS_DIVISOR > 0 ? events / HOT_EVENTS_DIVISOR : 1;
+	return chance(seed, PARAM(PARAM_HOT)) ? nextRandom(seed, hot_events) : nextRandom(seed, events);
+}
+
+static void phaseStart(BenchPhase* phase, const BenchEngine* engine, const char* name)
+{
+	phase->engine = engine;
+	phase->phase = name;
+	phase->allocations_start = allocations;
+	phase->ops = 0;
+	clock_gettime(CLOCK_MONOTONIC, &phase->start);
+}
+
+static void phaseEnd(const BenchPhase* phase)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	double seconds = (now.tv_sec - phase->start.tv_sec) + (now.tv_nsec - phase->start.tv_nsec) / 1e9;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	printf("%s,%s,%s,%d,%.4f,%.0f,%ld,%ld\n", phase->engine->api, phase->engine->engine, phase->phase,
+		phase->ops, seconds, seconds > 0 ? phase->ops / seconds : 0, allocations - phase->allocations_start,
+		usage.ru_maxrss);
+}
+
+/* Runs the workload on an event manager. Returns false if the event manager couldn't be created. */
+static bool runEventManager(const BenchEngine* engine)
+{
+	unsigned int seed = (unsigned int)PARAM(PARAM_SEED);
+	int members = PARAM(PARAM_MEMBERS), events = PARAM(PARAM_EVENTS);
+	char name[NAME_LENGTH];
+	BenchPhase phase;
+
+	Date date = dateCreate(1, 1, 2020);
+	if (date == NULL) {
+		return false;
+	}
+	phaseStart(&phase, engine, "populate");
+	EventManager em = createEventManagerWithAllocator(date, engine->backend, &counting_allocator);
+	dateDestroy(date);
+	if (em == NULL) {
+		return false;
+	}
+	for (int i = 0; i < members; i++, phase.ops++) {
+		sprintf(name, "member %d", i);
+		emAddMember(em, name, i);
+	}
+	for (int i = 0; i < events; i++, phase.ops++) {
+		sprintf(name, "event %d", i);
+		emAddEventByDiff(em, name, nextRandom(&seed, DAYS_RANGE), i);
+	}
+	for (int i = 0; i < members; i++) {
+		int attended = nextRandom(&seed, 2 * PARAM(PARAM_ATTENDANCE) + 1);
+		for (int j = 0; j < attended; j++, phase.ops++) {
+			emAddMemberToEvent(em, i, attendedEvent(&seed, events));
+		}
+	}
+	phaseEnd(&phase);
+
+	//New events and members continue the ids, and replaced events are chosen from the newest events ids.
+	int next_event = events, next_member = members;
+	phaseStart(&phase, engine, "steady");
+	for (int i = 1; i <= PARAM(PARAM_OPS); i++, phase.ops++) {
+		if (i % PARAM(PARAM_TICK_EVERY) == 0) {
+			emTick(em, 1);
+		}
+		else if (chance(&seed, PARAM(PARAM_CHURN))) {
+			int event = next_event - events + attendedEvent(&seed, events);
+			int kind = nextRandom(&seed, 5);
+			if (kind == 0) {
+				emRemoveEvent(em, event);
+				sprintf(name, "event %d", next_event);
+				emAddEventByDiff(em, name, nextRandom(&seed, DAYS_RANGE), next_event++);
+				phase.ops++;
+			}
+			else if (kind == 1) {
+				Date new_date = dateCreate(1 + nextRandom(&seed, 28), 1 + nextRandom(&seed, 12), 2020 + nextRandom(&seed, 2));
+				emChangeEventDate(em, event, new_date);
+				dateDestroy(new_date);
+			}
+			else if (kind == 2) {
+				emRemoveMemberFromEvent(em, nextRandom(&seed, next_member), event);
+			}
+			else if (kind == 3) {
+				emAddMemberToEvent(em, nextRandom(&seed, next_member), event);
+			}
+			else {
+				sprintf(name, "member %d", next_member);
+				emAddMember(em, name, next_member++);
+			}
+		}
+		else if (chance(&seed, 50)) {
+			emGetNextEvent(em);
+		}
+		else {
+			emGetEventsAmount(em);
+		}
+	}
+	phaseEnd(&phase);
+
+	phaseStart(&phase, engine, "report");
+	emSetReportThreads(em, PARAM(PARAM_REPORT_THREADS));
+	emPrintAllEvents(em, "/dev/null");
+	emPrintAllResponsibleMembers(em, "/dev/null");
+	phase.ops = 2;
+	phaseEnd(&phase);
+
+	phaseStart(&phase, engine, "teardown");
+	destroyEventManager(em);
+	phase.ops = 1;
+	phaseEnd(&phase);
+	return true;
+}
+
+static PQElement intCopy(PQElement element)
+{
+	int* copy = allocatorAlloc(&counting_allocator, sizeof(int));
+	if (copy != NULL) {
+		*copy = *(int*)element;
+	}
+	return copy;
+}
+
+static void intFree(PQElement element)
+{
+	allocatorFree(&counting_allocator, element);
+}
+
+static bool intEquals(PQElement element1, PQElement element2)
+{
+	return *(int*)element1 == *(int*)element2;
+}
+
+static int intCompareLowest(PQElementPriority priority1, PQElementPriority priority2)
+{
+	return *(int*)priority2 - *(int*)priority1;
+}
+
+/* Returns true if the element at position index1 of the heap comes before the one at position index2. */
+static bool heapBefore(const BenchQueue* queue, int index1, int index2)
+{
+	int element1 = queue->heap[index1], element2 = queue->heap[index2];
+	if (queue->priorities[element1] != queue->priorities[element2]) {
+		return queue->priorities[element1] < queue->priorities[element2];
+	}
+	return queue->sequences[element1] < queue->sequences[element2];
+}
+
+static void heapSwap(BenchQueue* queue, int index1, int index2)
+{
+	int element = queue->heap[index1];
+	queue->heap[index1] = queue->heap[index2];
+	queue->heap[index2] = element;
+	queue->positions[queue->heap[index1]] = index1;
+	queue->positions[queue->heap[index2]] = index2;
+}
+
+/* Moves the element at a position of the heap up or down to its place. */
+static void heapFix(BenchQueue* queue, int index)
+{
+	while (index > 0 && heapBefore(queue, index, (index - 1) / 2)) {
+		heapSwap(queue, index, (index - 1) / 2);
+		index = (index - 1) / 2;
+	}
+	while (2 * index + 1 < queue->size) {
+		int child = 2 * index + 1;
+		if (child + 1 < queue->size && heapBefore(queue, child + 1, child)) {
+			child++;
+		}
+		if (!heapBefore(queue, child, index)) {
+			return;
+		}
+		heapSwap(queue, index, child);
+		index = child;
+	}
+}
+
+static void queueInsert(BenchQueue* queue, int element)
+{
+	if (queue->queue != NULL) {
+		pqInsert(queue->queue, &element, &queue->priorities[element]);
+		return;
+	}
+	queue->heap[queue->size] = element;
+	queue->positions[element] = queue->size;
+	queue->sequences[element] = queue->sequence++;
+	queue->size++;
+	heapFix(queue, queue->size - 1);
+}
+
+static void queueRemoveElement(BenchQueue* queue, int element)
+{
+	if (queue->queue != NULL) {
+		pqRemoveElement(queue->queue, &element);
+		return;
+	}
+	int index = queue->positions[element];
+	queue->size--;
+	if (index != queue->size) {
+		heapSwap(queue, index, queue->size);
+		heapFix(queue, index);
+	}
+	queue->positions[element] = NO_POSITION;
+}
+
+/* Returns the first element, or NO_POSITION if the queue is empty. */
+static int queueGetFirst(BenchQueue* queue)
+{
+	if (queue->queue != NULL) {
+		int* first = pqGetFirst(queue->queue);
+		return first == NULL ? NO_POSITION : *first;
+	}
+	return queue->size == 0 ? NO_POSITION : queue->heap[0];
+}
+
+static void queueRemoveFirst(BenchQueue* queue)
+{
+	if (queue->queue != NULL) {
+		pqRemove(queue->queue);
+		return;
+	}
+	queueRemoveElement(queue, queue->heap[0]);
+}
+
+static void queueChangePriority(BenchQueue* queue, int element, int new_priority)
+{
+	if (queue->queue != NULL) {
+		pqChangePriority(queue->queue, &element, &queue->priorities[element], &new_priority);
+		queue->priorities[element] = new_priority;
+		return;
+	}
+	queue->priorities[element] = new_priority;
+	queue->sequences[element] = queue->sequence++; //Moves after the equal priorities, like a new insertion.
+	heapFix(queue, queue->positions[element]);
+}
+
+static bool queueContains(BenchQueue* queue, int element)
+{
+	if (queue->queue != NULL) {
+		return pqContains(queue->queue, &element);
+	}
+	return queue->positions[element] != NO_POSITION;
+}
+
+static const BenchQueue* sorted_queue = NULL; //The heap that qsort orders the elements of, it takes no context.
+
+static int compareElements(const void* element1, const void* element2)
+{
+	int priority1 = sorted_queue->priorities[*(const int*)element1];
+	int priority2 = sorted_queue->priorities[*(const int*)element2];
+	if (priority1 != priority2) {
+		return (priority1 > priority2) - (priority1 < priority2);
+	}
+	long long sequence1 = sorted_queue->sequences[*(const int*)element1];
+	long long sequence2 = sorted_queue->sequences[*(const int*)element2];
+	return (sequence1 > sequence2) - (sequence1 < sequence2);
+}
+
+/* Returns the number of elements visited in queue order, or NO_POSITION if a memory allocation failed. */
+static int queueVisitAll(BenchQueue* queue)
+{
+	int count = 0;
+	if (queue->queue != NULL) {
+		for (PQElement element = pqGetFirst(queue->queue); element != NULL; element = pqGetNext(queue->queue)) {
+			count++;
+		}
+		return count;
+	}
+	int* sorted = malloc(sizeof(int) * (queue->size > 0 ? queue->size : 1));
+	if (sorted == NULL) {
+		return NO_POSITION;
+	}
+	memcpy(sorted, queue->heap, sizeof(int) * queue->size);
+	sorted_queue = queue;
+	qsort(sorted, queue->size, sizeof(int), compareElements);
+	count = queue->size;
+	free(sorted);
+	return count;
+}
+
+static void queueDestroy(BenchQueue* queue)
+{
+	pqDestroy(queue->queue);
+	allocatorFree(&counting_allocator, queue->heap);
+	allocatorFree(&counting_allocator, queue->positions);
+	allocatorFree(&counting_allocator, queue->sequences);
+	free(queue->priorities);
+}
+
+/*
+* Runs the ingest and merge phases on sources queues of an engine, with new priorities for the events.
+* Returns false if a memory allocation failed.
+*/
+static bool runMerge(const BenchEngine* engine, unsigned int* seed)
+{
+	int events = PARAM(PARAM_EVENTS), sources = PARAM(PARAM_SOURCES);
+	BenchPhase phase;
+
+	PriorityQueue* queues = calloc(sources, sizeof(PriorityQueue));
+	if (queues == NULL) {
+		return false;
+	}
+	bool success = true;
+	phaseStart(&phase, engine, "ingest");
+	for (int i = 0; i < sources && success; i++) {
+		queues[i] = pqCreateWithEngine(intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest,
+			engine->queue_engine, &counting_allocator);
+		success = queues[i] != NULL;
+	}
+	for (int i = 0; i < events && success; i++, phase.ops++) {
+		int priority = nextRandom(seed, DAYS_RANGE);
+		success = pqInsert(queues[i % sources], &i, &priority) == PQ_SUCCESS;
+	}
+	phaseEnd(&phase);
+
+	phaseStart(&phase, engine, "merge");
+	for (int i = 1; i < sources && success; i++, phase.ops++) {
+		success = pqMerge(queues[0], queues[i]) == PQ_SUCCESS;
+	}
+	phaseEnd(&phase);
+
+	success = success && pqGetSize(queues[0]) == events;
+	for (int i = 0; i < sources; i++) {
+		pqDestroy(queues[i]);
+	}
+	free(queues);
+	return success;
+}
+
+/*
+* Runs the workload on a priority queue (or the binary heap) of integer elements, with priorities of days like the events.
+* The element of event i is i, and queue.priorities[i] is its priority while it is in the queue.
+* Returns false if a memory allocation failed.
+*/
+static bool runPriorityQueue(const BenchEngine* engine)
+{
+	unsigned int seed = (unsigned int)PARAM(PARAM_SEED);
+	int events = PARAM(PARAM_EVENTS);
+	BenchPhase phase;
+
+	BenchQueue queue = { NULL, NULL, NULL, NULL, 0, 0, malloc(sizeof(int) * events) };
+	if (queue.priorities == NULL) {
+		return false;
+	}
+	phaseStart(&phase, engine, "populate");
+	if (strcmp(engine->api, "heap") == 0) {
+		queue.heap = allocatorAlloc(&counting_allocator, sizeof(int) * events);
+		queue.positions = allocatorAlloc(&counting_allocator, sizeof(int) * events);
+		queue.sequences = allocatorAlloc(&counting_allocator, sizeof(long long) * events);
+	}
+	else {
+		queue.queue = pqCreateWithEngine(intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest,
+			engine->queue_engine, &counting_allocator);
+	}
+	if (queue.queue == NULL && (queue.heap == NULL || queue.positions == NULL || queue.sequences == NULL)) {
+		queueDestroy(&queue);
+		return false;
+	}
+	for (int i = 0; i < events; i++, phase.ops++) {
+		queue.priorities[i] = nextRandom(&seed, DAYS_RANGE);
+		queueInsert(&queue, i);
+	}
+	phaseEnd(&phase);
+
+	//Removed elements are inserted again at once, so every element stays in the queue.
+	int today = 0;
+	phaseStart(&phase, engine, "steady");
+	for (int i = 1; i <= PARAM(PARAM_OPS); i++, phase.ops++) {
+		int element = attendedEvent(&seed, events);
+		if (i % PARAM(PARAM_TICK_EVERY) == 0) {
+			today++;
+			int first = queueGetFirst(&queue);
+			while (first != NO_POSITION && queue.priorities[first] < today) {
+				queueRemoveFirst(&queue);
+				queue.priorities[first] = today + nextRandom(&seed, DAYS_RANGE);
+				queueInsert(&queue, first);
+				phase.ops += 2;
+				first = queueGetFirst(&queue);
+			}
+		}
+		else if (chance(&seed, PARAM(PARAM_CHURN))) {
+			int new_priority = today + nextRandom(&seed, DAYS_RANGE);
+			if (chance(&seed, 50)) {
+				queueChangePriority(&queue, element, new_priority);
+			}
+			else {
+				queueRemoveElement(&queue, element);
+				queue.priorities[element] = new_priority;
+				queueInsert(&queue, element);
+				phase.ops++;
+			}
+		}
+		else if (chance(&seed, 50)) {
+			queueGetFirst(&queue);
+		}
+		else {
+			queueContains(&queue, element);
+		}
+	}
+	phaseEnd(&phase);
+
+	phaseStart(&phase, engine, "report");
+	int visited = queueVisitAll(&queue);
+	phase.ops = visited;
+	phaseEnd(&phase);
+
+	phaseStart(&phase, engine, "teardown");
+	queueDestroy(&queue);
+	phase.ops = 1;
+	phaseEnd(&phase);
+	if (visited == NO_POSITION) {
+		return false;
+	}
+	return strcmp(engine->api, "heap") == 0 || runMerge(engine, &seed);
+}
+
+/* Sets the parameters from name=value arguments. Returns false if an argument is unknown or invalid. */
+static bool parseArguments(int argc, char** argv, const char** engine_filter)
+{
+	for (int i = 1; i < argc; i++) {
+		char* value = strchr(argv[i], '=');
+		if (value == NULL) {
+			return false;
+		}
+		*value++ = '\0';
+		if (strcmp(argv[i], "engine") == 0) {
+			*engine_filter = value;
+			continue;
+		}
+		int param = 0;
+		while (param < PARAMS_COUNT && strcmp(argv[i], params[param].name) != 0) {
+			param++;
+		}
+		char* end;
+		long number = strtol(value, &end, 10);
+		if (param == PARAMS_COUNT || *end != '\0' || number < 0 || number > 100000000) {
+			return false;
+		}
+		params[param].value = (int)number;
+	}
+	return PARAM(PARAM_MEMBERS) > 0 && PARAM(PARAM_EVENTS) > 0 && PARAM(PARAM_TICK_EVERY) > 0 && PARAM(PARAM_HOT) <= 100 &&
+		PARAM(PARAM_CHURN) <= 100 && PARAM(PARAM_REPORT_THREADS) > 0 && PARAM(PARAM_SOURCES) > 0;
+}
+
+int main(int argc, char** argv)
+{
+	const char* engine_filter = "all";
+	if (!parseArguments(argc, argv, &engine_filter)) {
+		fprintf(stderr, "Usage: %s [name=value]... with names:", argv[0]);
+		for (int i = 0; i < PARAMS_COUNT; i++) {
+			fprintf(stderr, " %s", params[i].name);
+		}
+		fprintf(stderr, " engine (all, em, pq, heap, priority_queue, timing_wheel, btree, pairing_heap or binary_heap)\n");
+		return 1;
+	}
+	for (int i = 0; i < PARAMS_COUNT; i++) {
+		fprintf(stderr, "%s=%d ", params[i].name, params[i].value);
+	}
+	fprintf(stderr, "engine=%s\n", engine_filter);
+
+	printf("api,engine,phase,ops,seconds,ops_per_sec,allocations,peak_rss_kb\n");
+	fflush(stdout);
+	int failures = 0;
+	for (int i = 0; i < (int)(sizeof(engines) / sizeof(engines[0])); i++) {
+		bool raw = strcmp(engines[i].api, "em") != 0;
+		if (strcmp(engine_filter, "all") != 0 && strcmp(engine_filter, engines[i].api) != 0 &&
+			strcmp(engine_filter, engines[i].engine) != 0) {
+			continue;
+		}
+		pid_t child = fork();
+		if (child == 0) {
+			bool success = raw ? runPriorityQueue(&engines[i]) : runEventManager(&engines[i]);
+			fflush(stdout);
+			_exit(success ? 0 : 1);
+		}
+		int status = 0;
+		if (child < 0 || waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			fprintf(stderr, "%s %s failed\n", engines[i].api, engines[i].engine);
+			failures++;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include "event.h"
+#include "node.h"
+#include "allocator.h"
+#include "sorted_ids.h"
+
+/*
+* Benchmark for the student ids of events.
+* Compares the sorted id arrays of events, with each kernel of sorted_ids, against the
+* sorted node lists that events used to keep (rebuilt here from node.h, walked the same way).
+* The operations are membership checks (half of the checked ids are linked), removing a linked
+* id and adding it back (churn), and intersecting the ids of two events with about half of their ids in common.
+* The results are printed as CSV:
+* operation,implementation,list_size,ops,seconds,ns_per_op
+*/
+
+#define OPS 2000000 //Divided by the list size for the operations that walk whole lists.
+#define SETS 16 //The operations cycle through this many events, so the branches don't repeat a single pattern.
+#define SEED 1
+
+static const int sizes[] = { 16, 256, 4096 };
+
+static const SortedIdsKernel kernels[] = { SORTED_IDS_SCALAR, SORTED_IDS_SSE2, SORTED_IDS_AVX2 };
+
+static unsigned int random_state = SEED;
+
+static int nextRandom(int range)
+{
+	random_state ^= random_state << 13; //xorshift32, whose low bits don't repeat in short periods.
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return (int)(random_state % (unsigned int)range);
+}
+
+static double secondsSince(const struct timespec* start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char* operation, const char* implementation, int size, int ops, double seconds)
+{
+	printf("%s,%s,%d,%d,%.4f,%.1f\n", operation, implementation, size, ops, seconds, seconds * 1e9 / ops);
+}
+
+/* Writes size sorted ids, each chosen with probability 1/2 out of [0, 2 * size). */
+static int fillIds(int* ids, int size)
+{
+	int count = 0;
+	for (int id = 0; count < size; id++) {
+		if (nextRandom(2) == 0 || 2 * size - id == size - count) {
+			ids[count++] = id;
+		}
+	}
+	return count;
+}
+
+/* ----- The node list baseline, walked like the event functions used to ----- */
+
+static Node listCreate(const int* ids, int count)
+{
+	Node first = NULL;
+	for (int i = count - 1; i >= 0; i--) {
+		Node node = nodeCreateOwning(allocatorIntCreate(NULL, ids[i]), allocatorIntCopy, allocatorIntFree, NULL);
+		if (node == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			exit(1);
+		}
+		nodeSetNext(node, first);
+		first = node;
+	}
+	return first;
+}
+
+static bool listContains(Node list, int id)
+{
+	for (Node ptr = list; ptr != NULL; ptr = nodeGetNext(ptr)) {
+		int data = *(int*)nodeGet(ptr);
+		if (data >= id) {
+			return data == id;
+		}
+	}
+	return false;
+}
+
+static Node listAdd(Node list, int id)
+{
+	Node node = nodeCreateOwning(allocatorIntCreate(NULL, id), allocatorIntCopy, allocatorIntFree, NULL);
+	if (list == NULL || *(int*)nodeGet(list) > id) {
+		nodeSetNext(node, list);
+		return node;
+	}
+	Node prev = list;
+	while (nodeGetNext(prev) != NULL && *(int*)nodeGet(nodeGetNext(prev)) < id) {
+		prev = nodeGetNext(prev);
+	}
+	nodeSetNext(node, nodeGetNext(prev));
+	nodeSetNext(prev, node);
+	return list;
+}
+
+static Node listRemove(Node list, int id)
+{
+	if (*(int*)nodeGet(list) == id) {
+		Node next = nodeGetNext(list);
+		nodeRemove(list);
+		return next;
+	}
+	Node prev = list;
+	while (*(int*)nodeGet(nodeGetNext(prev)) != id) {
+		prev = nodeGetNext(prev);
+	}
+	Node ptr = nodeGetNext(prev);
+	nodeSetNext(prev, nodeGetNext(ptr));
+	nodeRemove(ptr);
+	return list;
+}
+
+static int listIntersect(Node list1, Node list2, int* result)
+{
+	int found = 0;
+	while (list1 != NULL && list2 != NULL) {
+		int id1 = *(int*)nodeGet(list1), id2 = *(int*)nodeGet(list2);
+		if (id1 < id2) {
+			list1 = nodeGetNext(list1);
+		}
+		else if (id1 > id2) {
+			list2 = nodeGetNext(list2);
+		}
+		else {
+			result[found++] = id1;
+			list1 = nodeGetNext(list1);
+			list2 = nodeGetNext(list2);
+		}
+	}
+	return found;
+}
+
+/* ----- The benchmarks ----- */
+
+static long long benchList(int* const* ids, int size, int* result)
+{
+	long long checksum = 0;
+	Node lists[SETS];
+	for (int k = 0; k < SETS; k++) {
+		lists[k] = listCreate(ids[k], size);
+	}
+	struct timespec start;
+
+	int ops = OPS / size;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < ops; i++) {
+		checksum += listContains(lists[i % SETS], nextRandom(2 * size));
+	}
+	report("contains", "node_list", size, ops, secondsSince(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < ops; i++) {
+		int id = ids[i % SETS][nextRandom(size)];
+		lists[i % SETS] = listRemove(lists[i % SETS], id);
+		lists[i % SETS] = listAdd(lists[i % SETS], id);
+	}
+	report("churn", "node_list", size, ops, secondsSince(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < ops; i++) {
+		checksum += listIntersect(lists[i % SETS], lists[(i * 7 + 1) % SETS], result);
+	}
+	report("intersect", "node_list", size, ops, secondsSince(&start));
+
+	for (int k = 0; k < SETS; k++) {
+		nodeDestroy(lists[k]);
+	}
+	return checksum;
+}
+
+static long long benchEvents(int* const* ids, Event* events, int size, SortedIdsKernel kernel, int* result)
+{
+	long long checksum = 0;
+	const char* name = sortedIdsKernelName(kernel);
+	struct timespec start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < OPS; i++) {
+		checksum += eventHasStudentId(events[i % SETS], nextRandom(2 * size));
+	}
+	report("contains", name, size, OPS, secondsSince(&start));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < OPS; i++) {
+		int id = ids[i % SETS][nextRandom(size)];
+		eventRemoveStudentId(events[i % SETS], id);
+		eventAddStudentId(events[i % SETS], id);
+	}
+	report("churn", name, size, OPS, secondsSince(&start));
+
+	int ops = OPS / size * 4;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < ops; i++) {
+		int count = 0;
+		eventIntersectStudentIds(events[i % SETS], events[(i * 7 + 1) % SETS], result, &count);
+		checksum += count;
+	}
+	report("intersect", name, size, ops, secondsSince(&start));
+	return checksum;
+}
+
+int main(void)
+{
+	int max_size = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+	int* ids[SETS];
+	Event events[SETS];
+	int* result = malloc(sizeof(*result) * max_size);
+	Date date = dateCreate(1, 1, 2020);
+	if (result == NULL || date == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (int k = 0; k < SETS; k++) {
+		ids[k] = malloc(sizeof(*ids[k]) * max_size);
+		events[k] = eventCreate("event", k, date);
+		if (ids[k] == NULL || events[k] == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+	}
+
+	long long checksum = 0;
+	printf("operation,implementation,list_size,ops,seconds,ns_per_op\n");
+	for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+		int size = sizes[s];
+		for (int k = 0; k < SETS; k++) {
+			fillIds(ids[k], size);
+			if (eventSetStudentIds(events[k], ids[k], size) != EVENT_SUCCESS) {
+				fprintf(stderr, "Out of memory\n");
+				return 1;
+			}
+		}
+		checksum += benchList(ids, size, result);
+
+		SortedIdsKernel detected = sortedIdsGetKernel();
+		for (int k = 0; k < (int)(sizeof(kernels) / sizeof(kernels[0])); k++) {
+			if (sortedIdsSetKernel(kernels[k])) {
+				checksum += benchEvents(ids, events, size, kernels[k], result);
+			}
+		}
+		sortedIdsSetKernel(detected);
+	}
+	fprintf(stderr, "checksum %lld\n", checksum); //Keeps the results observable.
+
+	for (int k = 0; k < SETS; k++) {
+		eventDestroy(events[k]);
+		free(ids[k]);
+	}
+	dateDestroy(date);
+	free(result);
+	return 0;
+}
@@ -0,0 +1,125 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include "event_manager.h"
+#include "event_manager_ext.h"
+
+/*
+* Benchmark for the event manager journal.
+* The same mix of changes (adding members and events, linking and unlinking them,
+* moving and removing events and ticking) is run without a journal, and with a journal
+* that syncs every change, groups of changes, or the changes made in a time interval.
+* The journal is written to JOURNAL_PATH, so run the benchmark on the disk to measure.
+* The results are printed as CSV:
+* journal,group_size,group_interval_ms,ops,seconds,ops_per_sec,journal_bytes
+*/
+
+#define JOURNAL_PATH "journal_bench.log"
+#define OPS 20000
+#define OPS_PER_ROUND 8
+#define ROUNDS_PER_DAY 100
+#define DAYS_RANGE 365
+#define NAME_LENGTH 32
+
+typedef struct {
+	const char* journal;
+	int group_size;
+	int group_interval_ms;
+} BenchConfig;
+
+static const BenchConfig configs[] = {
+	{ "off", 0, 0 },
+	{ "group", 1, 0 },
+	{ "group", 8, 0 },
+	{ "group", 64, 0 },
+	{ "group", 512, 0 },
+	{ "interval", INT_MAX, 1 },
+	{ "interval", INT_MAX, 10 }
+};
+
+static int nextRandom(unsigned int* seed, int range)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) % range;
+}
+
+static double secondsSince(const struct timespec* start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/*
+* Runs OPS changes in rounds of OPS_PER_ROUND. Every round adds a member and an event,
+* so the ids of the round can be used by the other changes of the round.
+* Moved events are moved to later_date.
+*/
+static int runWorkload(EventManager em, Date later_date)
+{
+	unsigned int seed = 1;
+	char name[NAME_LENGTH];
+	int ops = 0;
+	for (int round = 0; ops < OPS; round++) {
+		sprintf(name, "member %d", round);
+		emAddMember(em, name, round);
+		sprintf(name, "event %d", round);
+		emAddEventByDiff(em, name, nextRandom(&seed, DAYS_RANGE), round);
+		emAddMemberToEvent(em, round, round);
+		emAddMemberToEvent(em, nextRandom(&seed, round + 1), nextRandom(&seed, round + 1));
+		emRemoveMemberFromEvent(em, round, round);
+		emChangeEventDate(em, nextRandom(&seed, round + 1), later_date);
+		emRemoveEvent(em, nextRandom(&seed, round + 1));
+		emTick(em, round % ROUNDS_PER_DAY == 0 ? 1 : 0);
+		ops += OPS_PER_ROUND;
+	}
+	return ops;
+}
+
+static long fileSize(const char* path)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return 0;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fclose(file);
+	return size;
+}
+
+int main(void)
+{
+	printf("journal,group_size,group_interval_ms,ops,seconds,ops_per_sec,journal_bytes\n");
+	for (int i = 0; i < (int)(sizeof(configs) / sizeof(configs[0])); i++) {
+		Date date = dateCreate(1, 1, 2020), later_date = dateCreate(1, 1, 2030);
+		EventManager em = createEventManager(date);
+		if (date == NULL || later_date == NULL || em == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+		remove(JOURNAL_PATH);
+		if (configs[i].group_size > 0 &&
+			emEnableJournal(em, JOURNAL_PATH, configs[i].group_size, configs[i].group_interval_ms) != EM_SUCCESS) {
+			fprintf(stderr, "Couldn't open %s\n", JOURNAL_PATH);
+			return 1;
+		}
+
+		struct timespec start;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		int ops = runWorkload(em, later_date);
+		emSyncJournal(em);
+		double seconds = secondsSince(&start);
+
+		destroyEventManager(em);
+		dateDestroy(date);
+		dateDestroy(later_date);
+		printf("%s,%d,%d,%d,%.3f,%.0f,%ld\n", configs[i].journal, configs[i].group_size,
+			configs[i].group_interval_ms, ops, seconds, ops / seconds, fileSize(JOURNAL_PATH));
+	}
+	remove(JOURNAL_PATH);
+	return 0;
+}
@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include "priority_queue.h"
+#include "multi_queue.h"
+
+/*
+* Benchmark for the relaxed multi queue.
+* Throughput: every thread inserts and removes elements in turns, on a queue that
+* was filled in advance, compared with a PriorityQueue guarded by a single mutex.
+* Quality: a filled queue is emptied by all of the threads, and the rank error of
+* every removal (how many remaining elements had a higher priority) is measured.
+* The results are printed as CSV:
+* test,queue,threads,shards,ops,seconds,ops_per_sec,mean_rank_error,max_rank_error
+*/
+
+#define PREFILL 1000
+#define OPS_PER_THREAD 200000
+#define QUALITY_ELEMENTS 10000
+#define PRIORITY_RANGE 100000
+#define SHARDS_PER_THREAD 2
+#define MAX_THREADS 16
+
+static const int thread_counts[] = { 1, 2, 4, 8, MAX_THREADS };
+
+typedef struct {
+	void* queue;
+	unsigned int seed;
+	int ops;
+} WorkerArgs;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static int removed_priorities[QUALITY_ELEMENTS];
+static int removed_count = 0;
+
+static void* intCopy(void* element)
+{
+	int* copy = malloc(sizeof(int));
+	if (copy != NULL) {
+		*copy = *(int*)element;
+	}
+	return copy;
+}
+
+static void intFree(void* element)
+{
+	free(element);
+}
+
+static bool intEquals(void* element1, void* element2)
+{
+	return *(int*)element1 == *(int*)element2;
+}
+
+static int intCompareLowest(void* priority1, void* priority2)
+{
+	return *(int*)priority2 - *(int*)priority1;
+}
+
+static int nextRandom(unsigned int* seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 8) % PRIORITY_RANGE;
+}
+
+static void* multiQueueWorker(void* arg)
+{
+	WorkerArgs* args = arg;
+	for (int i = 0; i < args->ops; i += 2) {
+		int priority = nextRandom(&args->seed);
+		mqInsert(args->queue, &i, &priority);
+		mqRemove(args->queue);
+	}
+	return NULL;
+}
+
+static void* lockedWorker(void* arg)
+{
+	WorkerArgs* args = arg;
+	for (int i = 0; i < args->ops; i += 2) {
+		int priority = nextRandom(&args->seed);
+		pthread_mutex_lock(&queue_lock);
+		pqInsert(args->queue, &i, &priority);
+		pthread_mutex_unlock(&queue_lock);
+		pthread_mutex_lock(&queue_lock);
+		pqRemove(args->queue);
+		pthread_mutex_unlock(&queue_lock);
+	}
+	return NULL;
+}
+
+static void* drainWorker(void* arg)
+{
+	WorkerArgs* args = arg;
+	int* priority = NULL;
+	while ((priority = mqPop(args->queue)) != NULL) { //The element stored is its own priority.
+		removed_priorities[__atomic_fetch_add(&removed_count, 1, __ATOMIC_RELAXED)] = *priority;
+		free(priority);
+	}
+	return NULL;
+}
+
+static double runThreads(void* queue, void* (*worker)(void*), int threads, int ops)
+{
+	pthread_t ids[MAX_THREADS];
+	WorkerArgs args[MAX_THREADS];
+	struct timespec start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (int i = 0; i < threads; i++) {
+		args[i].queue = queue;
+		args[i].seed = i + 1;
+		args[i].ops = ops;
+		pthread_create(&ids[i], NULL, worker, &args[i]);
+	}
+	for (int i = 0; i < threads; i++) {
+		pthread_join(ids[i], NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+/*
+* Replays the removals in the order they happened, and counts for each one the remaining
+* elements with a lower value (a higher priority) with a Fenwick tree over the values.
+*/
+static void measureRankError(double* mean, int* max)
+{
+	static int tree[PRIORITY_RANGE + 1];
+	memset(tree, 0, sizeof(tree));
+	for (int i = 0; i < removed_count; i++) {
+		for (int index = removed_priorities[i] + 1; index <= PRIORITY_RANGE; index += index & -index) {
+			tree[index]++;
+		}
+	}
+
+	long total = 0;
+	*max = 0;
+	for (int i = 0; i < removed_count; i++) {
+		int better = 0;
+		for (int index = removed_priorities[i]; index > 0; index -= index & -index) {
+			better += tree[index];
+		}
+		total += better;
+		*max = better > *max ? better : *max;
+		for (int index = removed_priorities[i] + 1; index <= PRIORITY_RANGE; index += index & -index) {
+			tree[index]--;
+		}
+	}
+	*mean = removed_count > 0 ? (double)total / removed_count : 0;
+}
+
+static void printResult(const char* test, const char* name, int threads, int shards, int ops,
+	double seconds, double mean_rank_error, int max_rank_error)
+{
+	printf("%s,%s,%d,%d,%d,%.6f,%.0f,%.2f,%d\n", test, name, threads, shards, ops,
+		seconds, ops / seconds, mean_rank_error, max_rank_error);
+}
+
+int main(int argc, char** argv)
+{
+	int ops = (argc > 1) ? atoi(argv[1]) : OPS_PER_THREAD;
+	printf("test,queue,threads,shards,ops,seconds,ops_per_sec,mean_rank_error,max_rank_error\n");
+
+	for (int t = 0; t < (int)(sizeof(thread_counts) / sizeof(*thread_counts)); t++) {
+		int threads = thread_counts[t], shards = threads * SHARDS_PER_THREAD;
+		unsigned int seed = 0;
+		MultiQueue queue = mqCreate(shards, intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest);
+		for (int i = 0; i < PREFILL; i++) {
+			int priority = nextRandom(&seed);
+			mqInsert(queue, &i, &priority);
+		}
+		double seconds = runThreads(queue, multiQueueWorker, threads, ops);
+		printResult("throughput", "multi_queue", threads, shards, threads * ops, seconds, 0, 0);
+		mqDestroy(queue);
+
+		PriorityQueue locked = pqCreate(intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest);
+		seed = 0;
+		for (int i = 0; i < PREFILL; i++) {
+			int priority = nextRandom(&seed);
+			pqInsert(locked, &i, &priority);
+		}
+		seconds = runThreads(locked, lockedWorker, threads, ops);
+		printResult("throughput", "mutex_priority_queue", threads, 1, threads * ops, seconds, 0, 0);
+		pqDestroy(locked);
+	}
+
+	for (int t = 0; t < (int)(sizeof(thread_counts) / sizeof(*thread_counts)); t++) {
+		int threads = thread_counts[t], shards = threads * SHARDS_PER_THREAD;
+		unsigned int seed = 0;
+		MultiQueue queue = mqCreate(shards, intCopy, intFree, intEquals, intCopy, intFree, intCompareLowest);
+		for (int i = 0; i < QUALITY_ELEMENTS; i++) {
+			int priority = nextRandom(&seed);
+			mqInsert(queue, &priority, &priority);
+		}
+		removed_count = 0;
+		double seconds = runThreads(queue, drainWorker, threads, 0);
+		double mean_rank_error = 0;
+		int max_rank_error = 0;
+		measureRankError(&mean_rank_error, &max_rank_error);
+		printResult("quality", "multi_queue", threads, shards, removed_count, seconds,
+			mean_rank_error, max_rank_error);
+		mqDestroy(queue);
+	}
+	return 0;
+}
@@ -0,0 +1,904 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "btree_queue.h"
+#include "stats.h"
+
+#define NODE_CAPACITY 32 //The entries of a leaf or the children of an inner node, a few cache lines of pointers each.
+#define SPLIT_INDEX (NODE_CAPACITY / 2)
+#define FIRST_SEQUENCE -1 //Comes before the sequence of every entry, so a search finds the first entry of a priority.
+
+typedef struct bq_node_t* BqNode;
+
+struct bq_node_t {
+	BqNode parent; //NULL for the root.
+	BqNode previous; //The leaf before a leaf, NULL for the first leaf and for inner nodes.
+	BqNode next; //The leaf after a leaf, NULL for the last leaf and for inner nodes.
+	bool leaf;
+	int count;
+	PQElementPriority priorities[NODE_CAPACITY]; //A leaf's priorities, or the first priority under every child (NOT COPIES).
+	long long sequences[NODE_CAPACITY]; //The insertion sequences that order equal priorities, like the priorities.
+	void* items[NODE_CAPACITY]; //A leaf's elements, or the children of an inner node.
+};
+
+struct btree_queue_t {
+	BqNode root; //A leaf while the tree fits in one, and an empty leaf when the tree is empty.
+	BqNode first; //The first leaf.
+	BqNode last; //The last leaf.
+	int size;
+	long long sequence; //The sequence of the next inserted entry.
+	CopyPQElement copyElement;
+	FreePQElement freeElement;
+	EqualPQElements equalElements;
+	CopyPQElementPriority copyPriority;
+	FreePQElementPriority freePriority;
+	ComparePQElementPriorities comparePriorities;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+
+/*
+createNode: Creates an empty leaf that isn't linked to the tree.
+
+@param tree - The tree that the node is created for.
+
+@return NULL if a memory allocation failed.
+		Else, returns the new node.
+*/
+static BqNode createNode(BTreeQueue tree);
+
+/*
+destroyNode: Deallocates a node, its subtree, and the elements and priorities of its leaves.
+
+@param tree - The tree of the node.
+@param node - The node to deallocate.
+*/
+static void destroyNode(BTreeQueue tree, BqNode node);
+
+/*
+compareEntry: Compares an entry of a node to a priority and a sequence, by the priority first and then by the sequence,
+			  so the compare function is called once for every compared entry.
+
+@param tree - The tree of the node.
+@param node - The node of the entry.
+@param index - The index of the entry in the node.
+@param priority - The priority to compare to.
+@param sequence - The sequence to compare to when the priorities are equal.
+
+@return A positive number if the entry comes before them, 0 if it has both of them, else a negative number.
+*/
+static int compareEntry(BTreeQueue tree, BqNode node, int index, PQElementPriority priority, long long sequence);
+
+/*
+countBefore: Counts the entries of a node, from a start index, that come before a priority and a sequence.
+			 The entries of a node are in queue order, so they are binary searched.
+
+@param tree - The tree of the node.
+@param node - The node to search.
+@param start - The index to start counting at.
+@param priority - The priority to compare to.
+@param sequence - The sequence to compare to, the next sequence of the tree to count the equal priorities too,
+				  or FIRST_SEQUENCE to count only the higher priorities.
+
+@return The index of the first entry from start that doesn't come before them.
+*/
+static int countBefore(BTreeQueue tree, BqNode node, int start, PQElementPriority priority, long long sequence);
+
+/*
+findLeaf: Returns the leaf that a priority and a sequence belong to.
+
+@param tree - The tree to search.
+@param priority - The priority to search for.
+@param sequence - The sequence to search for, like in countBefore.
+
+@return The leaf whose entries the position is among or right after.
+*/
+static BqNode findLeaf(BTreeQueue tree, PQElementPriority priority, long long sequence);
+
+/*
+findRangeStart: Finds the first entry whose priority doesn't come before the start of a range.
+
+@param tree - The tree to search.
+@param from - The highest priority of the range, or NULL for the first entry.
+@param leaf - Set to the leaf of the entry, or to NULL if every entry comes before from.
+@param position - Set to the index of the entry in the leaf.
+*/
+static void findRangeStart(BTreeQueue tree, PQElementPriority from, BqNode* leaf, int* position);
+
+/*
+isBeforeRangeEnd: Checks that a priority doesn't come after the end of a range.
+
+@param tree - The tree that compares the priorities.
+@param priority - The priority to check.
+@param to - The lowest priority of the range, or NULL for no end.
+
+@return True if the priority isn't lower than to.
+		Else, returns False.
+*/
+static bool isBeforeRangeEnd(BTreeQueue tree, PQElementPriority priority, PQElementPriority to);
+
+/*
+insertAt: Inserts an entry into a node that isn't full, setting the parent of an inserted child.
+
+@param node - The node to insert into.
+@param position - The index of the new entry.
+@param priority - The priority of the entry.
+@param sequence - The sequence of the entry.
+@param item - The element of a leaf, or the child of an inner node.
+*/
+static void insertAt(BqNode node, int position, PQElementPriority priority, long long sequence, void* item);
+
+/*
+removeAt: Removes entries from a node, without deallocating them.
+
+@param node - The node to remove from.
+@param position - The index of the first entry to remove.
+@param count - The number of entries to remove.
+*/
+static void removeAt(BqNode node, int position, int count);
+
+/*
+indexInParent: Returns the index of a node among the children of its parent.
+
+@param node - A node that isn't the root.
+
+@return The index of the node in its parent.
+*/
+static int indexInParent(BqNode node);
+
+/*
+updateFirstKey: Sets the first priority and sequence of a node's subtree in its ancestors, after its first entry changed.
+
+@param node - The node whose first entry changed.
+*/
+static void updateFirstKey(BqNode node);
+
+/*
+allocateSpareNodes: Allocates the nodes an insertion into a leaf needs: one for every full node
+					that it splits, and one for a new root if the root splits.
+					The insertion then can't fail after the tree was changed.
+
+@param tree - The tree to insert into.
+@param leaf - The leaf to insert into.
+@param spares - Set to the spare nodes, chained through their parent fields.
+
+@return False if a memory allocation failed (No nodes remain allocated).
+		Else, returns True.
+*/
+static bool allocateSpareNodes(BTreeQueue tree, BqNode leaf, BqNode* spares);
+
+/*
+allocateNodes: Allocates a number of spare nodes.
+
+@param tree - The tree that the nodes are created for.
+@param count - The number of nodes to allocate.
+@param spares - Set to the spare nodes, chained through their parent fields.
+
+@return False if a memory allocation failed (No nodes remain allocated).
+		Else, returns True.
+*/
+static bool allocateNodes(BTreeQueue tree, int count, BqNode* spares);
+
+/*
+countFullNodes: Returns the number of nodes of a tree that was built by adding its entries in order,
+				so all of its nodes are full except the last node of every level.
+
+@param size - The number of entries of the tree.
+
+@return The number of nodes, at least the root leaf.
+*/
+static int countFullNodes(int size);
+
+/*
+freeNodes: Deallocates a node and its subtree, without the elements and priorities of its leaves.
+
+@param tree - The tree of the node.
+@param node - The node to deallocate.
+*/
+static void freeNodes(BTreeQueue tree, BqNode node);
+
+/*
+takeSpareNode: Removes a node from the spare nodes and returns it.
+
+@param spares - The spare nodes.
+
+@return The first spare node.
+*/
+static BqNode takeSpareNode(BqNode* spares);
+
+/*
+splitNode: Moves the entries of a full node from an index on to a new node after it.
+
+@param tree - The tree of the node.
+@param node - The full node to split.
+@param right - The empty node that receives the entries.
+@param split_index - The index of the first entry to move.
+*/
+static void splitNode(BTreeQueue tree, BqNode node, BqNode right, int split_index);
+
+/*
+insertItem: Inserts an entry into a node, splitting it and its full ancestors as needed.
+
+@param tree - The tree of the node.
+@param node - The node to insert into.
+@param position - The index of the new entry.
+@param priority - The priority of the entry.
+@param sequence - The sequence of the entry.
+@param item - The element of a leaf, or the child of an inner node.
+@param spares - The spare nodes for the splits.
+@param sequential - True if the entry is added after the last entry of the tree, so full nodes are split
+					at their end and the nodes that are left behind stay full.
+*/
+static void insertItem(BTreeQueue tree, BqNode node, int position, PQElementPriority priority, long long sequence,
+	void* item, BqNode* spares, bool sequential);
+
+/*
+insertEntry: Inserts copies of an element and its priority into a leaf.
+
+@param tree - The tree of the leaf.
+@param leaf - The leaf to insert into.
+@param position - The index of the new entry in the leaf.
+@param element - The element to copy.
+@param priority - The priority to copy.
+@param sequence - The sequence of the entry, the next sequence of the tree for a new entry.
+@param sequential - True if the entry is added after the last entry of the tree.
+
+@return PQ_OUT_OF_MEMORY if a memory allocation failed (The tree isn't changed).
+		PQ_SUCCESS if the entry has been inserted.
+*/
+static PriorityQueueResult insertEntry(BTreeQueue tree, BqNode leaf, int position, PQElement element,
+	PQElementPriority priority, long long sequence, bool sequential);
+
+/*
+removeEntries: Deallocates entries of a leaf and removes them, removing the leaf if it became empty.
+
+@param tree - The tree of the leaf.
+@param leaf - The leaf to remove from.
+@param position - The index of the first entry to remove.
+@param count - The number of entries to remove.
+*/
+static void removeEntries(BTreeQueue tree, BqNode leaf, int position, int count);
+
+/*
+removeEmptyNodes: Removes an empty node and the ancestors that become empty, and shortens the tree
+				  while its root has a single child.
+
+@param tree - The tree of the node.
+@param node - The empty node, the root leaf stays in the tree.
+*/
+static void removeEmptyNodes(BTreeQueue tree, BqNode node);
+
+/*
+comparePriorities: Compares two priorities with the compare function of the tree, counting the call.
+
+@param tree - The tree that compares the priorities.
+@param priority1 - The first priority to compare.
+@param priority2 - The second priority to compare.
+
+@return The result of the compare function of the tree.
+*/
+static int comparePriorities(BTreeQueue tree, PQElementPriority priority1, PQElementPriority priority2);
+
+/*
+equalElements: Compares two elements with the equal function of the tree, counting the call.
+
+@param tree - The tree that compares the elements.
+@param element1 - The first element to compare.
+@param element2 - The second element to compare.
+
+@return The result of the equal function of the tree.
+*/
+static bool equalElements(BTreeQueue tree, PQElement element1, PQElement element2);
+
+/* =---------------------------------------------------------------------------=
+
+								B-Tree Queue Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+BTreeQueue bqCreate(CopyPQElement copy_element, FreePQElement free_element,
+					EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+					FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+					const Allocator* allocator)
+{
+	BTreeQueue tree = allocatorAlloc(allocator, sizeof(*tree));
+	if (tree == NULL) {
+		return NULL;
+	}
+	tree->allocator = allocator;
+	tree->root = createNode(tree);
+	if (tree->root == NULL) {
+		allocatorFree(allocator, tree);
+		return NULL;
+	}
+	tree->first = tree->root;
+	tree->last = tree->root;
+	tree->size = 0;
+	tree->sequence = 0;
+	tree->copyElement = copy_element;
+	tree->freeElement = free_element;
+	tree->equalElements = equal_elements;
+	tree->copyPriority = copy_priority;
+	tree->freePriority = free_priority;
+	tree->comparePriorities = compare_priorities;
+	return tree;
+}
+
+void bqDestroy(BTreeQueue tree)
+{
+	if (tree == NULL) {
+		return;
+	}
+	destroyNode(tree, tree->root);
+	allocatorFree(tree->allocator, tree);
+}
+
+BTreeQueue bqCopy(BTreeQueue tree)
+{
+	if (tree == NULL) {
+		return NULL;
+	}
+	BTreeQueue copy = bqCreate(tree->copyElement, tree->freeElement, tree->equalElements, tree->copyPriority,
+		tree->freePriority, tree->comparePriorities, tree->allocator);
+	for (BqNode leaf = tree->first; leaf != NULL && copy != NULL; leaf = leaf->next) {
+		for (int i = 0; i < leaf->count && copy != NULL; i++) {
+			if (insertEntry(copy, copy->last, copy->last->count, leaf->items[i], leaf->priorities[i],
+				leaf->sequences[i], true) != PQ_SUCCESS) {
+				bqDestroy(copy);
+				copy = NULL;
+			}
+		}
+	}
+	if (copy != NULL) { //The entries keep their sequences, so equal priorities keep their order in later inserts.
+		copy->sequence = tree->sequence;
+	}
+	return copy;
+}
+
+int bqGetSize(BTreeQueue tree)
+{
+	return tree->size;
+}
+
+bool bqContains(BTreeQueue tree, PQElement element)
+{
+	for (BqNode leaf = tree->first; leaf != NULL; leaf = leaf->next) {
+		STATS_COUNT(nodes_visited);
+		for (int i = 0; i < leaf->count; i++) {
+			if (equalElements(tree, leaf->items[i], element)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+PriorityQueueResult bqInsert(BTreeQueue tree, PQElement element, PQElementPriority priority)
+{
+	BqNode leaf = findLeaf(tree, priority, tree->sequence);
+	int position = countBefore(tree, leaf, 0, priority, tree->sequence);
+	return insertEntry(tree, leaf, position, element, priority, tree->sequence,
+		leaf == tree->last && position == leaf->count);
+}
+
+PriorityQueueResult bqAppend(BTreeQueue tree, PQElement element, PQElementPriority priority)
+{
+	BqNode last = tree->last;
+	if (last->count > 0 && comparePriorities(tree, last->priorities[last->count - 1], priority) < 0) {
+		return bqInsert(tree, element, priority); //Out of order, takes the regular path.
+	}
+	return insertEntry(tree, last, last->count, element, priority, tree->sequence, true);
+}
+
+void bqRemoveFirst(BTreeQueue tree)
+{
+	if (tree->size > 0) {
+		removeEntries(tree, tree->first, 0, 1);
+	}
+}
+
+PriorityQueueResult bqRemoveElement(BTreeQueue tree, PQElement element)
+{
+	for (BqNode leaf = tree->first; leaf != NULL; leaf = leaf->next) {
+		STATS_COUNT(nodes_visited);
+		for (int i = 0; i < leaf->count; i++) {
+			if (equalElements(tree, leaf->items[i], element)) {
+				removeEntries(tree, leaf, i, 1);
+				return PQ_SUCCESS;
+			}
+		}
+	}
+	return PQ_ELEMENT_DOES_NOT_EXISTS;
+}
+
+PriorityQueueResult bqRemoveElementWithPriority(BTreeQueue tree, PQElement element, PQElementPriority priority)
+{
+	BqNode leaf = NULL;
+	int position = 0;
+	//Starts at the first entry of the priority, and stops after the last one.
+	for (findRangeStart(tree, priority, &leaf, &position); leaf != NULL; leaf = leaf->next, position = 0) {
+		for (; position < leaf->count; position++) {
+			if (!isBeforeRangeEnd(tree, leaf->priorities[position], priority)) {
+				return PQ_ELEMENT_DOES_NOT_EXISTS;
+			}
+			if (equalElements(tree, leaf->items[position], element)) {
+				removeEntries(tree, leaf, position, 1);
+				return PQ_SUCCESS;
+			}
+		}
+		STATS_COUNT(nodes_visited);
+	}
+	return PQ_ELEMENT_DOES_NOT_EXISTS;
+}
+
+void bqClear(BTreeQueue tree)
+{
+	bqRemoveRange(tree, NULL, NULL);
+}
+
+PQElement bqCursorFirst(BTreeQueue tree, PQCursor* cursor)
+{
+	cursor->position = tree->size > 0 ? tree->first : NULL;
+	cursor->index = 0;
+	return tree->size > 0 ? tree->first->items[0] : NULL;
+}
+
+PQElement bqCursorNext(BTreeQueue tree, PQCursor* cursor)
+{
+	BqNode leaf = cursor->position;
+	if (leaf == NULL) {
+		return NULL;
+	}
+	cursor->index++;
+	if (cursor->index >= leaf->count) {
+		STATS_COUNT(nodes_visited);
+		leaf = leaf->next;
+		cursor->position = leaf;
+		cursor->index = 0;
+	}
+	return leaf == NULL ? NULL : leaf->items[cursor->index];
+}
+
+PQElementPriority bqGetFirstPriority(BTreeQueue tree)
+{
+	return tree->size > 0 ? tree->first->priorities[0] : NULL;
+}
+
+void bqForEachInPriorityRange(BTreeQueue tree, PQElementPriority from, PQElementPriority to,
+							  PQRangeFunc visit, void* context)
+{
+	BqNode leaf = NULL;
+	int position = 0;
+	bool visiting = true;
+	for (findRangeStart(tree, from, &leaf, &position); leaf != NULL && visiting; leaf = leaf->next, position = 0) {
+		for (; position < leaf->count && visiting; position++) {
+			visiting = isBeforeRangeEnd(tree, leaf->priorities[position], to) &&
+				visit(context, leaf->items[position], leaf->priorities[position]);
+		}
+		STATS_COUNT(nodes_visited);
+	}
+}
+
+void bqRemoveRange(BTreeQueue tree, PQElementPriority from, PQElementPriority to)
+{
+	BqNode leaf = NULL;
+	int position = 0;
+	findRangeStart(tree, from, &leaf, &position);
+	//Removes the range leaf by leaf, every leaf in one step.
+	while (leaf != NULL) {
+		int end = position;
+		while (end < leaf->count && isBeforeRangeEnd(tree, leaf->priorities[end], to)) {
+			end++;
+		}
+		BqNode next = end == leaf->count ? leaf->next : NULL;
+		if (end > position) {
+			removeEntries(tree, leaf, position, end - position);
+		}
+		leaf = next;
+		position = 0;
+	}
+}
+
+PriorityQueueResult bqMerge(BTreeQueue tree, BTreeQueue other)
+{
+	//Everything is allocated first: the nodes of the merged tree and the empty root that other is left with.
+	BTreeQueue merged = bqCreate(tree->copyElement, tree->freeElement, tree->equalElements, tree->copyPriority,
+		tree->freePriority, tree->comparePriorities, tree->allocator);
+	BqNode other_root = createNode(other);
+	BqNode spares = NULL;
+	if (merged == NULL || other_root == NULL ||
+		!allocateNodes(merged, countFullNodes(tree->size + other->size) - 1, &spares)) {
+		bqDestroy(merged);
+		if (other_root != NULL) {
+			allocatorFree(other->allocator, other_root);
+		}
+		return PQ_OUT_OF_MEMORY;
+	}
+
+	//The entries move in merged order to the end of the merged tree, and get new sequences in that order.
+	BqNode leaves[] = { tree->size > 0 ? tree->first : NULL, other->size > 0 ? other->first : NULL };
+	int positions[] = { 0, 0 };
+	for (int i = 0; i < tree->size + other->size; i++) {
+		int from = leaves[1] == NULL || (leaves[0] != NULL &&
+			comparePriorities(tree, leaves[0]->priorities[positions[0]], leaves[1]->priorities[positions[1]]) >= 0) ? 0 : 1;
+		BqNode leaf = leaves[from];
+		insertItem(merged, merged->last, merged->last->count, leaf->priorities[positions[from]], merged->sequence++,
+			leaf->items[positions[from]], &spares, true);
+		positions[from]++;
+		if (positions[from] == leaf->count) {
+			STATS_COUNT(nodes_visited);
+			leaves[from] = leaf->next;
+			positions[from] = 0;
+		}
+	}
+	assert(spares == NULL);
+
+	freeNodes(tree, tree->root);
+	freeNodes(other, other->root);
+	tree->root = merged->root;
+	tree->first = merged->first;
+	tree->last = merged->last;
+	tree->size += other->size;
+	tree->sequence = merged->sequence;
+	allocatorFree(merged->allocator, merged);
+	other->root = other_root;
+	other->first = other_root;
+	other->last = other_root;
+	other->size = 0;
+	return PQ_SUCCESS;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static BqNode createNode(BTreeQueue tree)
+{
+	BqNode node = allocatorAlloc(tree->allocator, sizeof(*node));
+	if (node == NULL) {
+		return NULL;
+	}
+	node->parent = NULL;
+	node->previous = NULL;
+	node->next = NULL;
+	node->leaf = true;
+	node->count = 0;
+	return node;
+}
+
+static void destroyNode(BTreeQueue tree, BqNode node)
+{
+	for (int i = 0; i < node->count; i++) {
+		if (node->leaf) {
+			tree->freeElement(node->items[i]);
+			tree->freePriority(node->priorities[i]);
+		}
+		else {
+			destroyNode(tree, node->items[i]);
+		}
+	}
+	allocatorFree(tree->allocator, node);
+}
+
+static int compareEntry(BTreeQueue tree, BqNode node, int index, PQElementPriority priority, long long sequence)
+{
+	int res = comparePriorities(tree, node->priorities[index], priority);
+	if (res != 0) {
+		return res;
+	}
+	return (node->sequences[index] < sequence) - (node->sequences[index] > sequence); //Earlier sequences come first.
+}
+
+static int countBefore(BTreeQueue tree, BqNode node, int start, PQElementPriority priority, long long sequence)
+{
+	int low = start, high = node->count;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (compareEntry(tree, node, middle, priority, sequence) > 0) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static BqNode findLeaf(BTreeQueue tree, PQElementPriority priority, long long sequence)
+{
+	BqNode node = tree->root;
+	while (!node->leaf) {
+		//The first child is entered without comparing, its first priority only marks the node's own.
+		node = node->items[countBefore(tree, node, 1, priority, sequence) - 1];
+		STATS_COUNT(nodes_visited);
+	}
+	return node;
+}
+
+static void findRangeStart(BTreeQueue tree, PQElementPriority from, BqNode* leaf, int* position)
+{
+	if (from == NULL) {
+		*leaf = tree->size > 0 ? tree->first : NULL;
+		*position = 0;
+		return;
+	}
+	*leaf = findLeaf(tree, from, FIRST_SEQUENCE);
+	*position = countBefore(tree, *leaf, 0, from, FIRST_SEQUENCE);
+	if (*position == (*leaf)->count) { //The range starts at the next leaf, if there is one.
+		*leaf = (*leaf)->next;
+		*position = 0;
+	}
+}
+
+static bool isBeforeRangeEnd(BTreeQueue tree, PQElementPriority priority, PQElementPriority to)
+{
+	return to == NULL || comparePriorities(tree, priority, to) >= 0;
+}
+
+static void insertAt(BqNode node, int position, PQElementPriority priority, long long sequence, void* item)
+{
+	assert(node->count < NODE_CAPACITY);
+	int moved = node->count - position;
+	memmove(node->priorities + position + 1, node->priorities + position, sizeof(*node->priorities) * moved);
+	memmove(node->sequences + position + 1, node->sequences + position, sizeof(*node->sequences) * moved);
+	memmove(node->items + position + 1, node->items + position, sizeof(*node->items) * moved);
+	node->priorities[position] = priority;
+	node->sequences[position] = sequence;
+	node->items[position] = item;
+	node->count++;
+	if (!node->leaf) {
+		((BqNode)item)->parent = node;
+	}
+}
+
+static void removeAt(BqNode node, int position, int count)
+{
+	int moved = node->count - position - count;
+	memmove(node->priorities + position, node->priorities + position + count, sizeof(*node->priorities) * moved);
+	memmove(node->sequences + position, node->sequences + position + count, sizeof(*node->sequences) * moved);
+	memmove(node->items + position, node->items + position + count, sizeof(*node->items) * moved);
+	node->count -= count;
+}
+
+static int indexInParent(BqNode node)
+{
+	BqNode parent = node->parent;
+	int index = 0;
+	while (parent->items[index] != node) {
+		index++;
+	}
+	return index;
+}
+
+static void updateFirstKey(BqNode node)
+{
+	//Only a first child passes its first key on to the next ancestor.
+	bool first_child = true;
+	while (node->parent != NULL && first_child) {
+		int index = indexInParent(node);
+		node->parent->priorities[index] = node->priorities[0];
+		node->parent->sequences[index] = node->sequences[0];
+		first_child = index == 0;
+		node = node->parent;
+	}
+}
+
+static bool allocateSpareNodes(BTreeQueue tree, BqNode leaf, BqNode* spares)
+{
+	int needed = 0;
+	BqNode node = leaf;
+	while (node != NULL && node->count == NODE_CAPACITY) {
+		needed++;
+		node = node->parent;
+	}
+	if (needed > 0 && node == NULL) { //The root splits too.
+		needed++;
+	}
+	return allocateNodes(tree, needed, spares);
+}
+
+static bool allocateNodes(BTreeQueue tree, int count, BqNode* spares)
+{
+	*spares = NULL;
+	for (int i = 0; i < count; i++) {
+		BqNode spare = createNode(tree);
+		if (spare == NULL) {
+			while (*spares != NULL) {
+				allocatorFree(tree->allocator, takeSpareNode(spares));
+			}
+			return false;
+		}
+		spare->parent = *spares;
+		*spares = spare;
+	}
+	return true;
+}
+
+static int countFullNodes(int size)
+{
+	int level = (size + NODE_CAPACITY - 1) / NODE_CAPACITY;
+	int count = level > 0 ? level : 1;
+	while (level > 1) {
+		level = (level + NODE_CAPACITY - 1) / NODE_CAPACITY;
+		count += level;
+	}
+	return count;
+}
+
+static void freeNodes(BTreeQueue tree, BqNode node)
+{
+	for (int i = 0; !node->leaf && i < node->count; i++) {
+		freeNodes(tree, node->items[i]);
+	}
+	allocatorFree(tree->allocator, node);
+}
+
+static BqNode takeSpareNode(BqNode* spares)
+{
+	BqNode spare = *spares;
+	assert(spare != NULL);
+	*spares = spare->parent;
+	spare->parent = NULL;
+	return spare;
+}
+
+static void splitNode(BTreeQueue tree, BqNode node, BqNode right, int split_index)
+{
+	right->leaf = node->leaf;
+	right->count = node->count - split_index;
+	memcpy(right->priorities, node->priorities + split_index, sizeof(*right->priorities) * right->count);
+	memcpy(right->sequences, node->sequences + split_index, sizeof(*right->sequences) * right->count);
+	memcpy(right->items, node->items + split_index, sizeof(*right->items) * right->count);
+	node->count = split_index;
+	if (!node->leaf) {
+		for (int i = 0; i < right->count; i++) {
+			((BqNode)right->items[i])->parent = right;
+		}
+		return;
+	}
+
+	right->previous = node;
+	right->next = node->next;
+	if (node->next != NULL) {
+		node->next->previous = right;
+	}
+	else {
+		tree->last = right;
+	}
+	node->next = right;
+}
+
+static void insertItem(BTreeQueue tree, BqNode node, int position, PQElementPriority priority, long long sequence,
+	void* item, BqNode* spares, bool sequential)
+{
+	if (node->count < NODE_CAPACITY) {
+		insertAt(node, position, priority, sequence, item);
+		if (position == 0) {
+			updateFirstKey(node);
+		}
+		return;
+	}
+
+	BqNode right = takeSpareNode(spares);
+	splitNode(tree, node, right, sequential && position == NODE_CAPACITY ? NODE_CAPACITY : SPLIT_INDEX);
+	if (position < node->count) {
+		insertAt(node, position, priority, sequence, item);
+		if (position == 0) {
+			updateFirstKey(node);
+		}
+	}
+	else {
+		insertAt(right, position - node->count, priority, sequence, item);
+	}
+
+	if (node->parent == NULL) { //The tree grows by a new root above the two halves.
+		BqNode root = takeSpareNode(spares);
+		root->leaf = false;
+		insertAt(root, 0, node->priorities[0], node->sequences[0], node);
+		insertAt(root, 1, right->priorities[0], right->sequences[0], right);
+		tree->root = root;
+		return;
+	}
+	insertItem(tree, node->parent, indexInParent(node) + 1, right->priorities[0], right->sequences[0], right, spares,
+		sequential);
+}
+
+static PriorityQueueResult insertEntry(BTreeQueue tree, BqNode leaf, int position, PQElement element,
+	PQElementPriority priority, long long sequence, bool sequential)
+{
+	PQElement element_copy = tree->copyElement(element);
+	PQElementPriority priority_copy = element_copy == NULL ? NULL : tree->copyPriority(priority);
+	BqNode spares = NULL;
+	if (priority_copy == NULL || !allocateSpareNodes(tree, leaf, &spares)) {
+		if (element_copy != NULL) {
+			tree->freeElement(element_copy);
+		}
+		if (priority_copy != NULL) {
+			tree->freePriority(priority_copy);
+		}
+		return PQ_OUT_OF_MEMORY;
+	}
+	insertItem(tree, leaf, position, priority_copy, sequence, element_copy, &spares, sequential);
+	assert(spares == NULL);
+	tree->size++;
+	if (sequence >= tree->sequence) {
+		tree->sequence = sequence + 1;
+	}
+	return PQ_SUCCESS;
+}
+
+static void removeEntries(BTreeQueue tree, BqNode leaf, int position, int count)
+{
+	for (int i = position; i < position + count; i++) {
+		tree->freeElement(leaf->items[i]);
+		tree->freePriority(leaf->priorities[i]);
+	}
+	removeAt(leaf, position, count);
+	tree->size -= count;
+	//The ancestors may still point to a deallocated first priority, which is replaced before any comparison.
+	if (leaf->count == 0) {
+		removeEmptyNodes(tree, leaf);
+	}
+	else if (position == 0) {
+		updateFirstKey(leaf);
+	}
+}
+
+static void removeEmptyNodes(BTreeQueue tree, BqNode node)
+{
+	while (node->count == 0 && node->parent != NULL) {
+		BqNode parent = node->parent;
+		int index = indexInParent(node);
+		if (node->leaf) {
+			if (node->previous != NULL) {
+				node->previous->next = node->next;
+			}
+			else {
+				tree->first = node->next;
+			}
+			if (node->next != NULL) {
+				node->next->previous = node->previous;
+			}
+			else {
+				tree->last = node->previous;
+			}
+		}
+		allocatorFree(tree->allocator, node);
+		removeAt(parent, index, 1);
+		if (index == 0 && parent->count > 0) {
+			updateFirstKey(parent);
+		}
+		node = parent;
+	}
+
+	//An inner root always keeps at least two children.
+	while (!tree->root->leaf && tree->root->count == 1) {
+		BqNode root = tree->root;
+		tree->root = root->items[0];
+		tree->root->parent = NULL;
+		allocatorFree(tree->allocator, root);
+	}
+}
+
+static int comparePriorities(BTreeQueue tree, PQElementPriority priority1, PQElementPriority priority2)
+{
+	STATS_COUNT(comparisons);
+	return tree->comparePriorities(priority1, priority2);
+}
+
+static bool equalElements(BTreeQueue tree, PQElement element1, PQElement element2)
+{
+	STATS_COUNT(equality_checks);
+	return tree->equalElements(element1, element2);
+}
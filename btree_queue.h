@@ -0,0 +1,206 @@
+#ifndef _BTREE_QUEUE_H
+#define _BTREE_QUEUE_H
+
+#include <stdbool.h>
+#include "priority_queue.h"
+#include "priority_queue_ext.h"
+#include "allocator.h"
+
+/*
+* The B+-tree engine of the priority queue (see pqCreateWithEngine).
+* Entries are kept in queue order in wide leaves that are linked to each other, so iterating
+* the queue steps through arrays, and the inner nodes keep the first key of every child,
+* so an entry is found with O(log n) comparisons. Every entry gets the next 64-bit sequence of
+* the tree when it is inserted, and entries are ordered by their priority and then by their
+* sequence, so equal priorities keep insertion order like in the linked list engine.
+* The sequence is compared only when the compare function returned 0, so it never adds calls.
+* Nodes are split when they fill up, and are removed only when they become empty, since a
+* queue is mostly emptied from its front. The functions behave like the pq functions of the
+* same names, whose arguments the priority queue already checked.
+*/
+
+/** Type for defining the B+-tree of a priority queue */
+typedef struct btree_queue_t* BTreeQueue;
+
+
+/*
+bqCreate: Creates a new empty tree, the functions are the ones of the queue.
+
+@param allocator - The allocator of the nodes, or NULL for the default allocator.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty tree.
+*/
+BTreeQueue bqCreate(CopyPQElement copy_element, FreePQElement free_element,
+					EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+					FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+					const Allocator* allocator);
+
+/*
+bqDestroy: Deallocates the tree and all of its elements and priorities.
+
+@param tree - The tree to deallocate.
+*/
+void bqDestroy(BTreeQueue tree);
+
+/*
+bqCopy: Returns a copy of the tree, built in order without comparing priorities.
+		The entries of the copy keep their sequences.
+
+@param tree - The tree to copy.
+
+@return NULL if the tree is NULL or if a memory allocation failed.
+		Else, returns a copy of the tree.
+*/
+BTreeQueue bqCopy(BTreeQueue tree);
+
+/*
+bqGetSize: Returns the number of elements in the tree.
+
+@param tree - The tree to count.
+
+@return The number of elements, kept by the tree.
+*/
+int bqGetSize(BTreeQueue tree);
+
+/*
+bqContains: Checks whether an element is in the tree.
+
+@param tree - The tree to search.
+@param element - The element to search for.
+
+@return True if an element of the tree is equal to it.
+		Else, returns False.
+*/
+bool bqContains(BTreeQueue tree, PQElement element);
+
+/*
+bqInsert: Adds copies of an element and its priority after the elements of equal or higher priority.
+
+@param tree - The tree to add to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_OUT_OF_MEMORY if a memory allocation failed (The tree isn't changed).
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult bqInsert(BTreeQueue tree, PQElement element, PQElementPriority priority);
+
+/*
+bqAppend: Adds copies of an element and its priority after the last element,
+		  or like bqInsert if its priority is higher than the last one.
+
+@param tree - The tree to add to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_OUT_OF_MEMORY if a memory allocation failed (The tree isn't changed).
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult bqAppend(BTreeQueue tree, PQElement element, PQElementPriority priority);
+
+/*
+bqRemoveFirst: Removes the element with the highest priority, if there is one.
+
+@param tree - The tree to remove from.
+*/
+void bqRemoveFirst(BTreeQueue tree);
+
+/*
+bqRemoveElement: Removes the first element that is equal to an element, searching all of the tree.
+
+@param tree - The tree to remove from.
+@param element - The element to remove.
+
+@return PQ_ELEMENT_DOES_NOT_EXISTS if no element is equal to it.
+		PQ_SUCCESS if the element has been removed.
+*/
+PriorityQueueResult bqRemoveElement(BTreeQueue tree, PQElement element);
+
+/*
+bqRemoveElementWithPriority: Removes the first element that is equal to an element and has an equal priority,
+							 searching only the elements of that priority.
+
+@param tree - The tree to remove from.
+@param element - The element to remove.
+@param priority - The priority of the element.
+
+@return PQ_ELEMENT_DOES_NOT_EXISTS if no element of that priority is equal to it.
+		PQ_SUCCESS if the element has been removed.
+*/
+PriorityQueueResult bqRemoveElementWithPriority(BTreeQueue tree, PQElement element, PQElementPriority priority);
+
+/*
+bqClear: Removes all of the elements of the tree.
+
+@param tree - The tree to empty.
+*/
+void bqClear(BTreeQueue tree);
+
+/*
+bqCursorFirst: Sets a cursor to the first element and returns it.
+
+@param tree - The tree to iterate over.
+@param cursor - The cursor to set.
+
+@return NULL if the tree is empty.
+		Else, returns the first element (Not a copy).
+*/
+PQElement bqCursorFirst(BTreeQueue tree, PQCursor* cursor);
+
+/*
+bqCursorNext: Advances a cursor and returns the element it points to.
+
+@param tree - The tree to iterate over.
+@param cursor - The cursor to advance.
+
+@return NULL if the end of the tree was reached, or the cursor was reset.
+		Else, returns the next element (Not a copy).
+*/
+PQElement bqCursorNext(BTreeQueue tree, PQCursor* cursor);
+
+/*
+bqGetFirstPriority: Returns the priority of the first element.
+
+@param tree - The tree to read.
+
+@return NULL if the tree is empty.
+		Else, returns the priority of the first element (Not a copy).
+*/
+PQElementPriority bqGetFirstPriority(BTreeQueue tree);
+
+/*
+bqForEachInPriorityRange: Passes the elements whose priorities are in a range to a function, in order.
+
+@param tree - The tree to visit.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+@param visit - The function that visits an element and its priority.
+@param context - Passed to every call of visit.
+*/
+void bqForEachInPriorityRange(BTreeQueue tree, PQElementPriority from, PQElementPriority to,
+							  PQRangeFunc visit, void* context);
+
+/*
+bqRemoveRange: Removes all of the elements whose priorities are in a range.
+
+@param tree - The tree to remove from.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+*/
+void bqRemoveRange(BTreeQueue tree, PQElementPriority from, PQElementPriority to);
+
+/*
+bqMerge: Moves all of the entries of another tree into the tree, without copying them, in O(n + m).
+		 The leaves of both trees are merged in order into a new tree that is built full,
+		 and the entries get new sequences in that order. Both trees must have the same functions.
+
+@param tree - The tree to merge into, its entries come first among equal priorities.
+@param other - The tree to empty.
+
+@return PQ_OUT_OF_MEMORY if a memory allocation failed (The trees aren't changed).
+		PQ_SUCCESS if the entries have been moved.
+*/
+PriorityQueueResult bqMerge(BTreeQueue tree, BTreeQueue other);
+
+#endif /* _BTREE_QUEUE_H */
@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include "change_feed.h"
+
+struct change_feed_t {
+	ChangeRecord* records; //The ring, the record of a sequence number is at sequence % capacity.
+	int capacity;
+	long long first; //The sequence number of the oldest record.
+	long long next; //The sequence number of the next change.
+	NamePool names;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+dropRecords: Drops the oldest records of the feed, releasing their names.
+
+@param feed - The feed to drop from.
+@param first - The sequence number of the oldest record to keep, at most the next sequence number.
+*/
+static void dropRecords(ChangeFeed feed, long long first);
+
+/* =---------------------------------------------------------------------------=
+
+								Change Feed Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+ChangeFeed changeFeedCreate(int capacity, NamePool names, const Allocator* allocator)
+{
+	if (capacity <= 0 || names == NULL) {
+		return NULL;
+	}
+	ChangeFeed feed = allocatorAlloc(allocator, sizeof(*feed));
+	if (feed == NULL) {
+		return NULL;
+	}
+	feed->records = allocatorAlloc(allocator, sizeof(*feed->records) * capacity);
+	if (feed->records == NULL) {
+		allocatorFree(allocator, feed);
+		return NULL;
+	}
+	feed->capacity = capacity;
+	feed->first = 1;
+	feed->next = 1;
+	feed->names = names;
+	feed->allocator = allocator;
+	return feed;
+}
+
+void changeFeedDestroy(ChangeFeed feed)
+{
+	if (feed == NULL) {
+		return;
+	}
+	dropRecords(feed, feed->next);
+	allocatorFree(feed->allocator, feed->records);
+	allocatorFree(feed->allocator, feed);
+}
+
+bool changeFeedAppend(ChangeFeed feed, int type, int id, int value, const char* name)
+{
+	if (feed == NULL) {
+		return false;
+	}
+	const char* acquired = name == NULL ? NULL : namePoolAcquire(feed->names, name);
+	if (name != NULL && acquired == NULL) {
+		dropRecords(feed, feed->next);
+		feed->first = ++feed->next;
+		return false;
+	}
+	if (feed->next - feed->first == feed->capacity) {
+		dropRecords(feed, feed->first + 1);
+	}
+
+	ChangeRecord* record = &feed->records[feed->next % feed->capacity];
+	record->sequence = feed->next++;
+	record->type = type;
+	record->id = id;
+	record->value = value;
+	record->name = acquired;
+	return true;
+}
+
+long long changeFeedGetFirst(ChangeFeed feed)
+{
+	return feed == NULL ? 0 : feed->first;
+}
+
+long long changeFeedGetLast(ChangeFeed feed)
+{
+	return feed == NULL ? 0 : feed->next - 1;
+}
+
+bool changeFeedGet(ChangeFeed feed, long long sequence, ChangeRecord* record)
+{
+	if (feed == NULL || record == NULL || sequence < feed->first || sequence >= feed->next) {
+		return false;
+	}
+	*record = feed->records[sequence % feed->capacity];
+	return true;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void dropRecords(ChangeFeed feed, long long first)
+{
+	for (; feed->first < first; feed->first++) {
+		const char* name = feed->records[feed->first % feed->capacity].name;
+		if (name != NULL) {
+			namePoolRelease(feed->names, name);
+		}
+	}
+	feed->first = first;
+}
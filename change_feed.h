@@ -0,0 +1,97 @@
+#ifndef _CHANGE_FEED_H
+#define _CHANGE_FEED_H
+
+#include <stdbool.h>
+#include "allocator.h"
+#include "name_pool.h"
+
+/*
+* A bounded feed of changes, numbered by increasing sequence numbers starting at 1.
+* The records are kept in a ring of a fixed capacity, so appending never allocates
+* records and the oldest record is dropped once the ring is full.
+* A record holds a type, two integers and an optional name, which is interned in a
+* name pool and referenced by the record until it is dropped.
+* If a name can't be acquired, all of the retained records are dropped along with
+* the change, so readers always see the feed as a gap and never as a missing record.
+*/
+
+/** Type for defining the change feed */
+typedef struct change_feed_t* ChangeFeed;
+
+/** A change of the feed */
+typedef struct {
+	long long sequence;
+	int type;
+	int id;
+	int value;
+	const char* name; //NOT A COPY, or NULL.
+} ChangeRecord;
+
+
+/*
+changeFeedCreate: Creates a new empty change feed.
+
+@param capacity - The number of records the feed keeps.
+@param names - The pool the names of the records are acquired from, which must outlive the feed.
+@param allocator - The allocator of the feed, or NULL for the default allocator.
+
+@return NULL if the capacity isn't positive, the pool is NULL or if a memory allocation failed.
+		Else, returns a new empty feed.
+*/
+ChangeFeed changeFeedCreate(int capacity, NamePool names, const Allocator* allocator);
+
+/*
+changeFeedDestroy: Deallocates the feed and releases the names of its records.
+
+@param feed - The feed to deallocate.
+*/
+void changeFeedDestroy(ChangeFeed feed);
+
+/*
+changeFeedAppend: Appends a change to the feed, dropping the oldest record if the feed is full.
+
+@param feed - The feed to append to.
+@param type - The type of the change.
+@param id - The first integer of the change.
+@param value - The second integer of the change.
+@param name - The name of the change, or NULL.
+
+@return False if the feed is NULL, or if the name couldn't be acquired (The change gets its sequence
+		number, but it and all of the records before it are dropped).
+		Else, returns True.
+*/
+bool changeFeedAppend(ChangeFeed feed, int type, int id, int value, const char* name);
+
+/*
+changeFeedGetFirst: Returns the sequence number of the oldest record that the feed keeps.
+
+@param feed - The feed to read.
+
+@return 0 if the feed is NULL.
+		Else, returns the sequence number of the oldest record, or the next sequence number if the feed is empty.
+*/
+long long changeFeedGetFirst(ChangeFeed feed);
+
+/*
+changeFeedGetLast: Returns the sequence number of the last change.
+
+@param feed - The feed to read.
+
+@return 0 if the feed is NULL or no change was appended.
+		Else, returns the sequence number of the last change (Also if it was dropped).
+*/
+long long changeFeedGetLast(ChangeFeed feed);
+
+/*
+changeFeedGet: Reads a record of the feed.
+
+@param feed - The feed to read.
+@param sequence - The sequence number of the record.
+@param record - Set to the record.
+
+@return False if the feed or record is NULL, or if the feed doesn't keep a record with the sequence number.
+		Else, returns True.
+*/
+bool changeFeedGet(ChangeFeed feed, long long sequence, ChangeRecord* record);
+
+#endif /* _CHANGE_FEED_H */
@@ -0,0 +1,443 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include "concurrent_priority_queue.h"
+
+#define MAX_LEVEL 24
+#define NO_SIZE -1
+#define DELETE_MARK ((uintptr_t)1)
+#define NOT_TAKEN 0
+#define TAKEN 1
+
+/*
+* The atomic operations use the GCC __atomic builtins, which are available
+* under -std=c99 and have the same semantics as the C11 <stdatomic.h> functions.
+*/
+#define ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define ATOMIC_CAS(ptr, expected, desired) \
+	__atomic_compare_exchange_n((ptr), (expected), (desired), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+typedef struct cpq_node_t* CpqNode;
+
+struct cpq_node_t {
+	PQElement element;
+	PQElementPriority priority;
+	unsigned long long sequence; //Breaks ties between equal priorities, so every node has a unique place.
+	int top_level;
+	int taken; //Set once by the thread that removes the node.
+	CpqNode retired_next;
+	uintptr_t next[]; //The low bit marks the node as logically deleted on that level.
+};
+
+struct ConcurrentPriorityQueue_t {
+	CpqNode head; //Sentinel node with MAX_LEVEL levels, its priority is never compared.
+	CpqNode retired; //Stack of removed nodes, deallocated by cpqReclaim.
+	unsigned long long sequence;
+	int size;
+	CopyPQElement copyElement;
+	FreePQElement freeElement;
+	CopyPQElementPriority copyPriority;
+	FreePQElementPriority freePriority;
+	ComparePQElementPriorities comparePriorities;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+nodeAllocate: Allocates a skiplist node with a given number of levels.
+
+@param top_level - The number of levels of the node.
+
+@return NULL if the memory allocation failed.
+		Else, returns a node with all of its levels pointing to NULL.
+*/
+static CpqNode nodeAllocate(int top_level);
+
+/*
+nodeLevel: Returns a random-looking level for a node, derived from its sequence number.
+		   Each level is used by half of the nodes of the level below it.
+
+@param sequence - The sequence number of the node.
+
+@return A level between 1 and MAX_LEVEL.
+*/
+static int nodeLevel(unsigned long long sequence);
+
+/*
+isBefore: Checks if a node should be placed before another node.
+
+@param queue - The queue that stores the priority compare function.
+@param node1 - The first node.
+@param node2 - The second node.
+
+@return True if node1 has a higher priority, or the same priority and was inserted earlier.
+		Else, returns False.
+*/
+static bool isBefore(ConcurrentPriorityQueue queue, CpqNode node1, CpqNode node2);
+
+/*
+tryFindSpot: Finds the predecessors and successors of a node on every level,
+			 while unlinking the logically deleted nodes on the way.
+
+@param queue - The queue to search in.
+@param node - The node to find its place.
+@param preds - Filled with the last node before the node on each level.
+@param succs - Filled with the first node that isn't before the node on each level.
+
+@return False if another thread changed the list during the search (it should be retried).
+		Else, returns True.
+*/
+static bool tryFindSpot(ConcurrentPriorityQueue queue, CpqNode node, CpqNode* preds, CpqNode* succs);
+
+/*
+findSpot: Calls tryFindSpot until the search succeeds.
+
+@param queue - The queue to search in.
+@param node - The node to find its place.
+@param preds - Filled with the last node before the node on each level.
+@param succs - Filled with the first node that isn't before the node on each level.
+*/
+static void findSpot(ConcurrentPriorityQueue queue, CpqNode node, CpqNode* preds, CpqNode* succs);
+
+/*
+markNode: Marks every level of a taken node as deleted, from the top level down.
+
+@param node - The node to mark.
+*/
+static void markNode(CpqNode node);
+
+/*
+retireNode: Pushes a removed node to the retired stack.
+
+@param queue - The queue that stores the retired stack.
+@param node - The removed node.
+*/
+static void retireNode(ConcurrentPriorityQueue queue, CpqNode node);
+
+/*
+takeFirst: Logically removes the first node that wasn't taken by another thread.
+
+@param queue - The queue to remove the node from.
+
+@return NULL if there are no nodes left.
+		Else, returns the removed node, which is already unlinked and retired.
+*/
+static CpqNode takeFirst(ConcurrentPriorityQueue queue);
+
+/*
+cpqNodeDestroy: Deallocates a node with its element and priority.
+
+@param queue - The queue that stores the free functions.
+@param node - The node to deallocate.
+*/
+static void cpqNodeDestroy(ConcurrentPriorityQueue queue, CpqNode node);
+
+/* =---------------------------------------------------------------------------=
+
+						Concurrent Priority Queue Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element, FreePQElement free_element,
+	CopyPQElementPriority copy_priority, FreePQElementPriority free_priority,
+	ComparePQElementPriorities compare_priorities)
+{
+	if (copy_element == NULL || free_element == NULL || copy_priority == NULL ||
+		free_priority == NULL || compare_priorities == NULL) {
+		return NULL;
+	}
+
+	ConcurrentPriorityQueue queue = malloc(sizeof(*queue));
+	if (queue == NULL) {
+		return NULL;
+	}
+	queue->head = nodeAllocate(MAX_LEVEL);
+	if (queue->head == NULL) {
+		free(queue);
+		return NULL;
+	}
+	queue->retired = NULL;
+	queue->sequence = 0;
+	queue->size = 0;
+	queue->copyElement = copy_element;
+	queue->freeElement = free_element;
+	queue->copyPriority = copy_priority;
+	queue->freePriority = free_priority;
+	queue->comparePriorities = compare_priorities;
+	return queue;
+}
+
+void cpqDestroy(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return;
+	}
+
+	cpqReclaim(queue);
+	CpqNode node = (CpqNode)queue->head->next[0];
+	while (node != NULL) {
+		CpqNode next = (CpqNode)(node->next[0] & ~DELETE_MARK);
+		cpqNodeDestroy(queue, node);
+		node = next;
+	}
+	free(queue->head);
+	free(queue);
+}
+
+int cpqGetSize(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return NO_SIZE;
+	}
+	return ATOMIC_LOAD(&queue->size);
+}
+
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+	if (queue == NULL || element == NULL || priority == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+
+	unsigned long long sequence = __atomic_fetch_add(&queue->sequence, 1, __ATOMIC_RELAXED);
+	CpqNode node = nodeAllocate(nodeLevel(sequence));
+	if (node == NULL) {
+		return PQ_OUT_OF_MEMORY;
+	}
+	node->sequence = sequence;
+	node->element = queue->copyElement(element);
+	if (node->element == NULL) {
+		free(node);
+		return PQ_OUT_OF_MEMORY;
+	}
+	node->priority = queue->copyPriority(priority);
+	if (node->priority == NULL) {
+		queue->freeElement(node->element);
+		free(node);
+		return PQ_OUT_OF_MEMORY;
+	}
+
+	CpqNode preds[MAX_LEVEL], succs[MAX_LEVEL];
+	while (true) { //The node is visible to other threads once it's linked on the bottom level.
+		findSpot(queue, node, preds, succs);
+		for (int level = 0; level < node->top_level; level++) {
+			node->next[level] = (uintptr_t)succs[level];
+		}
+		uintptr_t expected = (uintptr_t)succs[0];
+		if (ATOMIC_CAS(&preds[0]->next[0], &expected, (uintptr_t)node)) {
+			break;
+		}
+	}
+	__atomic_fetch_add(&queue->size, 1, __ATOMIC_RELAXED);
+
+	for (int level = 1; level < node->top_level; level++) {
+		while (true) {
+			uintptr_t next = ATOMIC_LOAD(&node->next[level]);
+			if (next & DELETE_MARK) {
+				return PQ_SUCCESS; //Already removed by another thread, no need to link it higher.
+			}
+			if (next != (uintptr_t)succs[level] &&
+				!ATOMIC_CAS(&node->next[level], &next, (uintptr_t)succs[level])) {
+				return PQ_SUCCESS; //Marked while being updated.
+			}
+			uintptr_t expected = (uintptr_t)succs[level];
+			if (ATOMIC_CAS(&preds[level]->next[level], &expected, (uintptr_t)node)) {
+				break;
+			}
+			findSpot(queue, node, preds, succs);
+		}
+	}
+	return PQ_SUCCESS;
+}
+
+PQElement cpqPop(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return NULL;
+	}
+
+	CpqNode node = takeFirst(queue);
+	if (node == NULL) {
+		return NULL;
+	}
+	return queue->copyElement(node->element); //The node itself stays readable until cpqReclaim.
+}
+
+PriorityQueueResult cpqRemove(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+	takeFirst(queue);
+	return PQ_SUCCESS;
+}
+
+PQElement cpqGetFirst(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return NULL;
+	}
+
+	CpqNode node = (CpqNode)(ATOMIC_LOAD(&queue->head->next[0]) & ~DELETE_MARK);
+	while (node != NULL) {
+		if (ATOMIC_LOAD(&node->taken) == NOT_TAKEN) {
+			return queue->copyElement(node->element);
+		}
+		node = (CpqNode)(ATOMIC_LOAD(&node->next[0]) & ~DELETE_MARK);
+	}
+	return NULL;
+}
+
+void cpqReclaim(ConcurrentPriorityQueue queue)
+{
+	if (queue == NULL) {
+		return;
+	}
+
+	//A removed node can still be linked on a level that an inserter linked it to late.
+	for (int level = 0; level < MAX_LEVEL; level++) {
+		CpqNode pred = queue->head;
+		CpqNode curr = (CpqNode)(pred->next[level] & ~DELETE_MARK);
+		while (curr != NULL) {
+			CpqNode succ = (CpqNode)(curr->next[level] & ~DELETE_MARK);
+			if (curr->next[level] & DELETE_MARK) {
+				pred->next[level] = (uintptr_t)succ;
+			}
+			else {
+				pred = curr;
+			}
+			curr = succ;
+		}
+	}
+
+	CpqNode node = queue->retired;
+	while (node != NULL) {
+		CpqNode next = node->retired_next;
+		cpqNodeDestroy(queue, node);
+		node = next;
+	}
+	queue->retired = NULL;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static CpqNode nodeAllocate(int top_level)
+{
+	CpqNode node = malloc(sizeof(*node) + sizeof(node->next[0]) * top_level);
+	if (node == NULL) {
+		return NULL;
+	}
+	node->element = NULL;
+	node->priority = NULL;
+	node->sequence = 0;
+	node->top_level = top_level;
+	node->taken = NOT_TAKEN;
+	node->retired_next = NULL;
+	for (int level = 0; level < top_level; level++) {
+		node->next[level] = (uintptr_t)NULL;
+	}
+	return node;
+}
+
+static int nodeLevel(unsigned long long sequence)
+{
+	unsigned long long hash = (sequence + 1) * 0x9E3779B97F4A7C15ULL; //Fibonacci hashing.
+	hash ^= hash >> 31;
+	int level = 1;
+	while (level < MAX_LEVEL && (hash & 1)) {
+		level++;
+		hash >>= 1;
+	}
+	return level;
+}
+
+static bool isBefore(ConcurrentPriorityQueue queue, CpqNode node1, CpqNode node2)
+{
+	int res = queue->comparePriorities(node1->priority, node2->priority);
+	if (res != 0) {
+		return res > 0;
+	}
+	return node1->sequence < node2->sequence;
+}
+
+static bool tryFindSpot(ConcurrentPriorityQueue queue, CpqNode node, CpqNode* preds, CpqNode* succs)
+{
+	CpqNode pred = queue->head;
+	for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+		CpqNode curr = (CpqNode)(ATOMIC_LOAD(&pred->next[level]) & ~DELETE_MARK);
+		while (curr != NULL) {
+			uintptr_t succ = ATOMIC_LOAD(&curr->next[level]);
+			if (succ & DELETE_MARK) { //Unlink the deleted node from this level.
+				uintptr_t expected = (uintptr_t)curr;
+				if (!ATOMIC_CAS(&pred->next[level], &expected, succ & ~DELETE_MARK)) {
+					return false;
+				}
+				curr = (CpqNode)(succ & ~DELETE_MARK);
+				continue;
+			}
+			if (!isBefore(queue, curr, node)) {
+				break;
+			}
+			pred = curr;
+			curr = (CpqNode)succ;
+		}
+		preds[level] = pred;
+		succs[level] = curr;
+	}
+	return true;
+}
+
+static void findSpot(ConcurrentPriorityQueue queue, CpqNode node, CpqNode* preds, CpqNode* succs)
+{
+	while (!tryFindSpot(queue, node, preds, succs));
+}
+
+static void markNode(CpqNode node)
+{
+	for (int level = node->top_level - 1; level >= 0; level--) {
+		uintptr_t next = ATOMIC_LOAD(&node->next[level]);
+		while (!(next & DELETE_MARK) && !ATOMIC_CAS(&node->next[level], &next, next | DELETE_MARK));
+	}
+}
+
+static void retireNode(ConcurrentPriorityQueue queue, CpqNode node)
+{
+	CpqNode top = ATOMIC_LOAD(&queue->retired);
+	do {
+		node->retired_next = top;
+	} while (!ATOMIC_CAS(&queue->retired, &top, node));
+}
+
+static CpqNode takeFirst(ConcurrentPriorityQueue queue)
+{
+	CpqNode node = (CpqNode)(ATOMIC_LOAD(&queue->head->next[0]) & ~DELETE_MARK);
+	while (node != NULL) {
+		int expected = NOT_TAKEN;
+		if (ATOMIC_LOAD(&node->taken) == NOT_TAKEN && ATOMIC_CAS(&node->taken, &expected, TAKEN)) {
+			markNode(node);
+			CpqNode preds[MAX_LEVEL], succs[MAX_LEVEL];
+			findSpot(queue, node, preds, succs); //Unlinks the marked node from every level.
+			retireNode(queue, node);
+			__atomic_fetch_sub(&queue->size, 1, __ATOMIC_RELAXED);
+			return node;
+		}
+		node = (CpqNode)(ATOMIC_LOAD(&node->next[0]) & ~DELETE_MARK);
+	}
+	return NULL;
+}
+
+static void cpqNodeDestroy(ConcurrentPriorityQueue queue, CpqNode node)
+{
+	queue->freeElement(node->element);
+	queue->freePriority(node->priority);
+	free(node);
+}
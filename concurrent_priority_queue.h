@@ -0,0 +1,107 @@
+#ifndef _CONCURRENT_PRIORITY_QUEUE_H
+#define _CONCURRENT_PRIORITY_QUEUE_H
+
+#include <stdbool.h>
+#include "priority_queue.h"
+
+/*
+* A lock-free priority queue, based on a skiplist with logical deletion.
+* Insertions, removals and reads may be called from any number of threads
+* at the same time, without any lock.
+*
+* Elements with equal priorities are removed in insertion order.
+* Removed nodes aren't deallocated while other threads may still read them:
+* they are kept until cpqReclaim or cpqDestroy, which must be called
+* when no other thread uses the queue.
+*/
+
+/** Type for defining the concurrent priority queue */
+typedef struct ConcurrentPriorityQueue_t* ConcurrentPriorityQueue;
+
+
+/*
+cpqCreate: Creates a new empty concurrent priority queue.
+		   The functions have the same meaning as in pqCreate.
+
+@return NULL if one of the arguments is NULL or if a memory allocation failed.
+		Else, returns a new empty queue.
+*/
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element, FreePQElement free_element,
+	CopyPQElementPriority copy_priority, FreePQElementPriority free_priority,
+	ComparePQElementPriorities compare_priorities);
+
+/*
+cpqDestroy: Deallocates the queue, its elements and all of the removed nodes.
+			Must not be called while other threads use the queue.
+
+@param queue - The queue to deallocate.
+*/
+void cpqDestroy(ConcurrentPriorityQueue queue);
+
+/*
+cpqGetSize: Returns the number of elements in the queue.
+			While other threads change the queue the result is a snapshot.
+
+@param queue - The queue to count.
+
+@return -1 if the queue is NULL.
+		Else, returns the number of elements in the queue.
+*/
+int cpqGetSize(ConcurrentPriorityQueue queue);
+
+/*
+cpqInsert: Adds a copy of an element with a copy of its priority to the queue.
+		   Safe to call from several threads at the same time.
+
+@param queue - The queue to add the element to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_NULL_ARGUMENT if one of the arguments is NULL.
+		PQ_OUT_OF_MEMORY if a memory allocation failed.
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/*
+cpqPop: Removes the highest priority element from the queue and returns a copy of it.
+		Safe to call from several threads at the same time, each element is returned once.
+
+@param queue - The queue to remove the element from.
+
+@return NULL if the queue is NULL or empty, or if copying the element failed.
+		Else, returns a copy of the removed element, which the caller must deallocate.
+*/
+PQElement cpqPop(ConcurrentPriorityQueue queue);
+
+/*
+cpqRemove: Removes the highest priority element from the queue.
+		   Safe to call from several threads at the same time.
+
+@param queue - The queue to remove the element from.
+
+@return PQ_NULL_ARGUMENT if the queue is NULL.
+		PQ_SUCCESS otherwise (also when the queue is empty).
+*/
+PriorityQueueResult cpqRemove(ConcurrentPriorityQueue queue);
+
+/*
+cpqGetFirst: Returns a copy of the highest priority element.
+			 Another thread may remove the element right after it was read.
+
+@param queue - The queue to read from.
+
+@return NULL if the queue is NULL or empty, or if copying the element failed.
+		Else, returns a copy of the highest priority element, which the caller must deallocate.
+*/
+PQElement cpqGetFirst(ConcurrentPriorityQueue queue);
+
+/*
+cpqReclaim: Deallocates the nodes that were removed from the queue.
+			Must not be called while other threads use the queue.
+
+@param queue - The queue to clean.
+*/
+void cpqReclaim(ConcurrentPriorityQueue queue);
+
+#endif /* _CONCURRENT_PRIORITY_QUEUE_H */
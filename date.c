@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include "date.h"
+#include "date_ext.h"
 
 #define MAX_DAYS 30
 #define MAX_MONTHS 12
@@ -13,6 +14,7 @@ struct Date_t {
 	int day;
 	int month;
 	int year;
+	const Allocator* allocator;
 };
 
 /* =---------------------------------------------------------------------------=
@@ -42,12 +44,17 @@ static int compareInt(int num1, int num2);
 */
 
 Date dateCreate(int day, int month, int year)
+{
+	return dateCreateWithAllocator(day, month, year, NULL);
+}
+
+Date dateCreateWithAllocator(int day, int month, int year, const Allocator* allocator)
 {
 	if (day < MIN_DAYS || day > MAX_DAYS || month < MIN_MONTH || month > MAX_MONTHS) { //Years can be negative
 		return NULL;
 	}
 
-	Date date = malloc(sizeof(*date));
+	Date date = allocatorAlloc(allocator, sizeof(*date));
 	if (date == NULL) {
 		return NULL;
 	}
@@ -55,13 +62,17 @@ Date dateCreate(int day, int month, int year)
 	date->day = day;
 	date->month = month;
 	date->year = year;
+	date->allocator = allocator;
 	return date;
 }
 
 
 void dateDestroy(Date date)
 {
-	free(date);
+	if (date == NULL) {
+		return;
+	}
+	allocatorFree(date->allocator, date);
 }
 
 
@@ -70,7 +81,15 @@ Date dateCopy(Date date)
 	if (date == NULL) {
 		return NULL;
 	}
-	Date date_copy = dateCreate(date->day, date->month, date->year);
+	return dateCopyWithAllocator(date, date->allocator);
+}
+
+Date dateCopyWithAllocator(Date date, const Allocator* allocator)
+{
+	if (date == NULL) {
+		return NULL;
+	}
+	Date date_copy = dateCreateWithAllocator(date->day, date->month, date->year, allocator);
 	if (date_copy == NULL) {
 		return NULL;
 	}
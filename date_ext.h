@@ -0,0 +1,38 @@
+#ifndef _DATE_EXT_H
+#define _DATE_EXT_H
+
+#include "date.h"
+#include "allocator.h"
+
+/*
+* Extensions to the date interface.
+* The functions declared in date.h behave the same for every date.
+*/
+
+
+/*
+dateCreateWithAllocator: Creates a new date, allocated from the given allocator.
+						 dateCopy copies the date with the same allocator, and dateDestroy returns it to the allocator.
+
+@param day - The day of the date, between 1 and 30.
+@param month - The month of the date, between 1 and 12.
+@param year - The year of the date.
+@param allocator - The allocator of the date, or NULL for the default allocator.
+
+@return NULL if the date is invalid or if a memory allocation failed.
+		Else, returns the new date.
+*/
+Date dateCreateWithAllocator(int day, int month, int year, const Allocator* allocator);
+
+/*
+dateCopyWithAllocator: Copies a date into memory of another allocator.
+
+@param date - The date to copy.
+@param allocator - The allocator of the copy, or NULL for the default allocator.
+
+@return NULL if the date is NULL or if a memory allocation failed.
+		Else, returns the copy.
+*/
+Date dateCopyWithAllocator(Date date, const Allocator* allocator);
+
+#endif /* _DATE_EXT_H */
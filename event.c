@@ -1,15 +1,22 @@
 #include <stdlib.h>
 #include "event.h"
+#include "date_ext.h"
+#include "sorted_ids.h"
 #include <string.h>
 #include <assert.h>
 
 #define NO_ID -1;
+#define INITIAL_IDS_CAPACITY 4
 
 struct event_t {
 	char* name;
 	int id;
 	Date date;
-	Node id_list;
+	int* student_ids; //Sorted in increasing order and without duplicates.
+	int students_count;
+	int students_capacity; //The length of student_ids.
+	const Allocator* allocator;
+	NamePool names; //The pool the name is interned in, else NULL and the name is owned by the event.
 };
 
 
@@ -32,34 +39,48 @@ stringCopy: Copies a string and returns the copy.
 static char* stringCopy(char* str);
 
 /*
-intCopy: Copies an integer and returns the copy.
+releaseName: Deallocates the name of an event, or releases it from the event's name pool.
 
-@param str - The integer to copy.
+@param event - The event to release its name.
+*/
+static void releaseName(Event event);
+
+/*
+resizeIds: Moves an event's student ids into a new array of a different length.
 
-@return NULL if the given element is NULL.
-		Else, returns a copy of the int.
+@param event - The event to resize the ids of.
+@param capacity - The length of the new array, at least the number of ids.
+
+@return EVENT_MEMORY_FAIL if a memory allocation fails (The ids are left unchanged).
+		EVENT_SUCCESS if the ids have been moved.
 */
-static void* intCopy(void* element);
+static EventResult resizeIds(Event event, int capacity);
 
 /*
-intFree: Deallocates an integer.
+checkSortedIds: Checks that student ids are non-negative, sorted in increasing order and without duplicates.
+
+@param student_ids - The student ids to check.
+@param count - The number of student ids.
 
-@param str - The int* to copy.
+@return True if the ids are valid.
+		Else, returns False.
 */
-static void intFree(void* element);
+static bool checkSortedIds(int* student_ids, int count);
 
 /*
-sortId: Adds a new student id into an event's id list,
-		while keeping the list sorted.
+checkIdUpdate: Checks that none of the added ids and all of the removed ids exist in an event's id list.
 
-@param event - The event to add the id to.
-@param new_id - The student id to add to the id list.
+@param event - The event to check.
+@param added_ids - The sorted student ids to add.
+@param added_count - The number of student ids to add.
+@param removed_ids - The sorted student ids to remove.
+@param removed_count - The number of student ids to remove.
 
-@return EVENT_SUCCESS if the student id hass been successfully added.
-		EVENT_STUDENT_ALREDY_LINKED if the student id already exists in the list.
-		EVENT_MEMORY_FAIL if a memory error occurs.
+@return EVENT_STUDENT_ALREDY_LINKED if one of the added ids exists in the list.
+		EVENT_STUDENT_NOT_LINKED if one of the removed ids doesn't exist in the list.
+		EVENT_SUCCESS otherwise.
 */
-static EventResult sortId(Event event, Node new_id);
+static EventResult checkIdUpdate(Event event, int* added_ids, int added_count, int* removed_ids, int removed_count);
 
 
 /* =---------------------------------------------------------------------------=
@@ -71,29 +92,43 @@ static EventResult sortId(Event event, Node new_id);
 
 
 Event eventCreate(char* event_name, int event_id, Date event_date)
+{
+	return eventCreateWithAllocator(event_name, event_id, event_date, NULL);
+}
+
+Event eventCreateWithAllocator(char* event_name, int event_id, Date event_date, const Allocator* allocator)
+{
+	return eventCreateInterned(event_name, event_id, event_date, allocator, NULL);
+}
+
+Event eventCreateInterned(char* event_name, int event_id, Date event_date, const Allocator* allocator, NamePool names)
 {
 	if (event_name == NULL || event_id < 0 || event_date == NULL) {
 		return NULL;
 	}
 
-	Event event = malloc(sizeof(*event));
+	Event event = allocatorAlloc(allocator, sizeof(*event));
 	if (event == NULL) {
 		return NULL;
 	}
-	event->name = stringCopy(event_name);
+	event->name = names != NULL ? (char*)namePoolAcquire(names, event_name) : allocatorStringCopy(allocator, event_name);
 	assert(event->name != NULL);
 	if (event->name == NULL) {
-		free(event);
+		allocatorFree(allocator, event);
 		return NULL;
 	}
-	event->date = dateCopy(event_date);
+	event->names = names;
+	event->allocator = allocator;
+	event->date = dateCopyWithAllocator(event_date, allocator);
 	assert(event->date != NULL);
 	if (event->date == NULL) {
-		free(event->name);
-		free(event);
+		releaseName(event);
+		allocatorFree(allocator, event);
 		return NULL;
 	}
-	event->id_list = NULL;
+	event->student_ids = NULL;
+	event->students_count = 0;
+	event->students_capacity = 0;
 	event->id = event_id;
 	return event;
 }
@@ -103,10 +138,10 @@ void eventDestroy(Event event)
 	if (event == NULL) {
 		return;
 	}
-	free(event->name);
+	releaseName(event);
 	dateDestroy(event->date);
-	nodeDestroy(event->id_list);
-	free(event);
+	allocatorFree(event->allocator, event->student_ids);
+	allocatorFree(event->allocator, event);
 }
 
 Event eventCopy(Event event)
@@ -115,18 +150,14 @@ Event eventCopy(Event event)
 		return NULL;
 	}
 
-	Event copy_event = eventCreate(event->name, event->id, event->date);
+	Event copy_event = eventCreateInterned(event->name, event->id, event->date, event->allocator, event->names);
 	assert(copy_event != NULL);
 	if (copy_event == NULL) {
 		return NULL;
 	}
-	if (event->id_list != NULL){
-		copy_event->id_list = nodeListCopy(event->id_list);
-		assert(copy_event->id_list != NULL);
-		if (copy_event->id_list == NULL) {
-			free(copy_event);
-			return NULL;
-		}
+	if (event->students_count > 0 && eventSetStudentIds(copy_event, event->student_ids, event->students_count) != EVENT_SUCCESS) {
+		eventDestroy(copy_event);
+		return NULL;
 	}
 	return copy_event;
 }
@@ -139,17 +170,33 @@ Date eventGetDate(Event event)
 	return dateCopy(event->date);
 }
 
-Node eventGetIdList(Event event)
+const int* eventGetStudentIds(Event event, int* count)
 {
-	if (event == NULL) {
+	if (event == NULL || event->students_count == 0) {
+		*count = 0;
 		return NULL;
 	}
-	return event->id_list;
+	*count = event->students_count;
+	return event->student_ids;
 }
 
+bool eventHasStudentId(Event event, int student_id)
+{
+	if (event == NULL) {
+		return false;
+	}
+	return sortedIdsContains(event->student_ids, event->students_count, student_id);
+}
 
-
-
+EventResult eventIntersectStudentIds(Event event1, Event event2, int* student_ids, int* count)
+{
+	if (event1 == NULL || event2 == NULL || student_ids == NULL || count == NULL) {
+		return EVENT_NULL_ARG;
+	}
+	*count = sortedIdsIntersect(event1->student_ids, event1->students_count,
+		event2->student_ids, event2->students_count, student_ids);
+	return EVENT_SUCCESS;
+}
 
 char* eventGetNamePtr(Event event)
 {
@@ -159,6 +206,22 @@ char* eventGetNamePtr(Event event)
 	return event->name;
 }
 
+const char* eventGetNameView(Event event)
+{
+	if (event == NULL) {
+		return NULL;
+	}
+	return event->name;
+}
+
+Date eventGetDateView(Event event)
+{
+	if (event == NULL) {
+		return NULL;
+	}
+	return event->date;
+}
+
 EventResult eventSetDate(Event event, Date new_event_date)
 {
 	if (event == NULL || new_event_date == NULL) {
@@ -166,7 +229,7 @@ EventResult eventSetDate(Event event, Date new_event_date)
 	}
 
 	dateDestroy(event->date);
-	event->date = dateCopy(new_event_date);
+	event->date = dateCopyWithAllocator(new_event_date, event->allocator);
 	if (event->date == NULL) {
 		return EVENT_MEMORY_FAIL;
 	}
@@ -179,19 +242,20 @@ EventResult eventAddStudentId(Event event, int student_id)
 		return EVENT_NULL_ARG;
 	}
 
-	Node new_id = nodeCreate(&student_id,intCopy, intFree);
-	if (new_id == NULL) {
-		return EVENT_MEMORY_FAIL;
-	}
-	int res = sortId(event, new_id);
-	if (res == EVENT_MEMORY_FAIL) {
-		nodeDestroy(new_id);
-		return EVENT_MEMORY_FAIL;
-	}
-	else if (res == EVENT_STUDENT_ALREDY_LINKED) {
-		nodeDestroy(new_id);
+	int index = sortedIdsLowerBound(event->student_ids, event->students_count, student_id);
+	if (index < event->students_count && event->student_ids[index] == student_id) {
 		return EVENT_STUDENT_ALREDY_LINKED;
 	}
+	if (event->students_count == event->students_capacity) {
+		int capacity = event->students_capacity == 0 ? INITIAL_IDS_CAPACITY : event->students_capacity * 2;
+		if (resizeIds(event, capacity) != EVENT_SUCCESS) {
+			return EVENT_MEMORY_FAIL;
+		}
+	}
+	memmove(&event->student_ids[index + 1], &event->student_ids[index],
+		sizeof(*event->student_ids) * (event->students_count - index));
+	event->student_ids[index] = student_id;
+	event->students_count++;
 	return EVENT_SUCCESS;
 }
 
@@ -201,33 +265,91 @@ EventResult eventRemoveStudentId(Event event, int student_id)
 		return EVENT_NULL_ARG;
 	}
 
-	Node prev = event->id_list;
-	int* data = nodeGet(event->id_list);
-	if (data == NULL){
+	int index = sortedIdsLowerBound(event->student_ids, event->students_count, student_id);
+	if (index == event->students_count || event->student_ids[index] != student_id) {
 		return EVENT_STUDENT_NOT_LINKED;
 	}
-	if (*data == student_id) {
-		event->id_list = nodeGetNext(event->id_list);
-		nodeRemove(prev);
-		return EVENT_SUCCESS;
+	event->students_count--;
+	memmove(&event->student_ids[index], &event->student_ids[index + 1],
+		sizeof(*event->student_ids) * (event->students_count - index));
+	return EVENT_SUCCESS;
+}
+
+EventResult eventSetStudentIds(Event event, int* student_ids, int count)
+{
+	if (event == NULL || (student_ids == NULL && count > 0) || count < 0 || !checkSortedIds(student_ids, count)) {
+		return EVENT_NULL_ARG;
 	}
 
-	Node ptr = nodeGetNext(prev);
-	while (ptr != NULL) {
-		int* data = nodeGet(ptr);
-		if (data == NULL) {
+	if (count > event->students_capacity) {
+		int old_count = event->students_count;
+		event->students_count = 0; //The old ids are replaced, so they aren't copied.
+		if (resizeIds(event, count) != EVENT_SUCCESS) {
+			event->students_count = old_count;
 			return EVENT_MEMORY_FAIL;
 		}
+	}
+	if (count > 0) {
+		memcpy(event->student_ids, student_ids, sizeof(*student_ids) * count);
+	}
+	event->students_count = count;
+	return EVENT_SUCCESS;
+}
 
-		if (*data == student_id) {
-			nodeSetNext(prev, nodeGetNext(ptr));
-			nodeRemove(ptr);
-			return EVENT_SUCCESS;
+EventResult eventFindStudentIds(Event event, int* student_ids, int count, bool* linked)
+{
+	if (event == NULL || (count > 0 && (student_ids == NULL || linked == NULL)) || count < 0 ||
+		!checkSortedIds(student_ids, count)) {
+		return EVENT_NULL_ARG;
+	}
+
+	int index = 0; //The ids before index are smaller than the remaining student_ids.
+	for (int i = 0; i < count; i++) {
+		index += sortedIdsLowerBound(event->student_ids + index, event->students_count - index, student_ids[i]);
+		linked[i] = index < event->students_count && event->student_ids[index] == student_ids[i];
+	}
+	return EVENT_SUCCESS;
+}
+
+EventResult eventUpdateStudentIds(Event event, int* added_ids, int added_count, int* removed_ids, int removed_count)
+{
+	if (event == NULL || (added_ids == NULL && added_count > 0) || (removed_ids == NULL && removed_count > 0) ||
+		added_count < 0 || removed_count < 0 ||
+		!checkSortedIds(added_ids, added_count) || !checkSortedIds(removed_ids, removed_count)) {
+		return EVENT_NULL_ARG;
+	}
+	EventResult res = checkIdUpdate(event, added_ids, added_count, removed_ids, removed_count);
+	if (res != EVENT_SUCCESS) {
+		return res;
+	}
+	int count = event->students_count + added_count - removed_count;
+	int* merged = count > 0 ? allocatorAlloc(event->allocator, sizeof(*merged) * count) : NULL;
+	if (count > 0 && merged == NULL) {
+		return EVENT_MEMORY_FAIL;
+	}
+
+	//Merges the added ids into the ids, and drops the removed ids on the way.
+	int* old = event->student_ids;
+	int old_index = 0, added_index = 0, removed_index = 0, merged_index = 0;
+	while (old_index < event->students_count || added_index < added_count) {
+		if (added_index == added_count || (old_index < event->students_count && old[old_index] < added_ids[added_index])) {
+			if (removed_index < removed_count && old[old_index] == removed_ids[removed_index]) {
+				removed_index++;
+			}
+			else {
+				merged[merged_index++] = old[old_index];
+			}
+			old_index++;
+		}
+		else {
+			merged[merged_index++] = added_ids[added_index++];
 		}
-		prev = ptr;
-		ptr = nodeGetNext(ptr);
 	}
-	return EVENT_STUDENT_NOT_LINKED;
+	allocatorFree(event->allocator, event->student_ids);
+	event->student_ids = merged;
+	event->students_count = count;
+	event->students_capacity = count;
+	return EVENT_SUCCESS;
 }
 
 
@@ -252,8 +374,9 @@ bool eventEquals(Event event1, Event event2)
 	if (event1 == NULL || event2 == NULL){
 		return false;
 	}
+	bool interned = event1->names != NULL && event1->names == event2->names;
 	if (!dateCompare(event1->date, event2->date) &&
-		!strcmp(event1->name, event2->name) &&
+		(interned ? event1->name == event2->name : !strcmp(event1->name, event2->name)) &&
 		(event1->id == event2->id)){
 		return true;
 	}
@@ -288,65 +411,59 @@ static char* stringCopy(char* str) {
 	return out;
 }
 
-static void* intCopy(void* element)
+static void releaseName(Event event)
 {
-	if (element == NULL) {
-		return NULL;
+	if (event->names != NULL) {
+		namePoolRelease(event->names, event->name);
 	}
-
-	int* new_int = malloc(sizeof(int));
-	if (new_int == NULL) {
-		return NULL;
+	else {
+		allocatorFree(event->allocator, event->name);
 	}
-	*new_int = *(int*)element;
-	return new_int;
 }
 
-static void intFree(void* element)
+static EventResult resizeIds(Event event, int capacity)
 {
-	free(element);
+	int* student_ids = allocatorAlloc(event->allocator, sizeof(*student_ids) * capacity);
+	if (student_ids == NULL) {
+		return EVENT_MEMORY_FAIL;
+	}
+	if (event->students_count > 0) {
+		memcpy(student_ids, event->student_ids, sizeof(*student_ids) * event->students_count);
+	}
+	allocatorFree(event->allocator, event->student_ids);
+	event->student_ids = student_ids;
+	event->students_capacity = capacity;
+	return EVENT_SUCCESS;
 }
 
-static EventResult sortId(Event event, Node new_id)
+static bool checkSortedIds(int* student_ids, int count)
 {
-	assert(event != NULL && new_id != NULL);
-	int* data = nodeGet(event->id_list), *student_id = nodeGet(new_id);
-	if (data == NULL) {
-		event->id_list = new_id;
-		return EVENT_SUCCESS;
-	}
-	else if (*data > *student_id){
-		Node next = event->id_list;
-		event->id_list = new_id;
-		nodeSetNext(new_id, next);
-		return EVENT_SUCCESS;
-	}
-	else if (*data == *student_id){
-		return EVENT_STUDENT_ALREDY_LINKED;
-	}
-
-	Node prev = event->id_list;
-	Node ptr = nodeGetNext(event->id_list);
-	while (ptr != NULL) {
-		data = nodeGet(ptr);
-		if (data == NULL) {
-			return EVENT_MEMORY_FAIL;
+	for (int i = 0; i < count; i++) {
+		if (student_ids[i] < 0 || (i > 0 && student_ids[i - 1] >= student_ids[i])) {
+			return false;
 		}
+	}
+	return true;
+}
 
-		if (*data < *student_id) {
-			prev = ptr;
-			ptr = nodeGetNext(ptr);
-			continue;
+static EventResult checkIdUpdate(Event event, int* added_ids, int added_count, int* removed_ids, int removed_count)
+{
+	int added_index = 0, removed_index = 0;
+	for (int i = 0; i < event->students_count; i++) {
+		int student_id = event->student_ids[i];
+		while (added_index < added_count && added_ids[added_index] < student_id) {
+			added_index++;
 		}
-		else if (*data == *student_id) {
+		if (added_index < added_count && added_ids[added_index] == student_id) {
 			return EVENT_STUDENT_ALREDY_LINKED;
 		}
-		else {
-			break; //Ptr now points to the first id bigger than student_id.
+		if (removed_index < removed_count && removed_ids[removed_index] < student_id) {
+			return EVENT_STUDENT_NOT_LINKED; //The ids skipped over a removed id.
+		}
+		if (removed_index < removed_count && removed_ids[removed_index] == student_id) {
+			removed_index++;
 		}
 	}
-	nodeSetNext(prev, new_id);
-	nodeSetNext(new_id, ptr);
-	return EVENT_SUCCESS;
+	return removed_index == removed_count ? EVENT_SUCCESS : EVENT_STUDENT_NOT_LINKED;
 }
 
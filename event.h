@@ -1,8 +1,9 @@
 #ifndef _EVENT_H
 #define _EVENT_H
 
+#include <stdbool.h>
 #include "date.h"
-#include "node.h"
+#include "name_pool.h"
 
 /** Type for defining the event */
 typedef struct event_t* Event;
@@ -29,6 +30,37 @@ eventCreate: Creates a new event with a name, a unique id and a date.
 */
 Event eventCreate(char* event_name, int event_id, Date event_date);
 
+/*
+eventCreateWithAllocator: Creates a new event like eventCreate, allocated from the given allocator.
+						  The event's name, date, student id list and copies use the same allocator.
+
+@param event_name - The event's name
+@param event_id - The event's Id.
+@param event_date - The event's date.
+@param allocator - The allocator of the event, or NULL for the default allocator.
+
+@return NULL if a memory allocation fails or if the paramaters are NULL.
+		Else, returns a new event.
+*/
+Event eventCreateWithAllocator(char* event_name, int event_id, Date event_date, const Allocator* allocator);
+
+/*
+eventCreateInterned: Creates a new event like eventCreateWithAllocator, whose name is interned in a name pool.
+					 Copies of the event share the interned name instead of copying it, and events
+					 of the same pool are compared by their name pointers.
+
+@param event_name - The event's name
+@param event_id - The event's Id.
+@param event_date - The event's date.
+@param allocator - The allocator of the event, or NULL for the default allocator.
+@param names - The pool to intern the name in, or NULL to copy the name like eventCreateWithAllocator.
+			   It must stay valid until the event and its copies are deallocated.
+
+@return NULL if a memory allocation fails or if the paramaters are NULL.
+		Else, returns a new event.
+*/
+Event eventCreateInterned(char* event_name, int event_id, Date event_date, const Allocator* allocator, NamePool names);
+
 /*
 eventDestroy: Deallocates a given event.
 
@@ -57,14 +89,40 @@ eventGetDate: Returns a copy of the date of a given event.
 Date eventGetDate(Event event);
 
 /*
-eventGetIdList: Returns a copy of the student id list of the event.
+eventGetStudentIds: Returns the student ids of the event, sorted in increasing order (NOT A COPY).
+					The ids must not be changed, and are valid until the event's ids change.
 
-@param event - The event to extract the id list from.
+@param event - The event to extract the ids from.
+@param count - Set to the number of ids.
 
-@return NULL if a memory allocation fails or if the event is NULL.
-		Else, returns a copy of the id list from the event.
+@return NULL if the event is NULL or has no students.
+		Else, returns the ids of the event.
 */
-Node eventGetIdList(Event event);
+const int* eventGetStudentIds(Event event, int* count);
+
+/*
+eventHasStudentId: Checks whether a student id is linked to the event, by a binary search of its ids.
+
+@param event - The event to search in.
+@param student_id - The student id to search for.
+
+@return True if the student id is linked to the event.
+		Else, returns False.
+*/
+bool eventHasStudentId(Event event, int student_id);
+
+/*
+eventIntersectStudentIds: Finds the student ids that are linked to both of two events.
+
+@param event1 - The first event.
+@param event2 - The second event.
+@param student_ids - Set to the common ids in increasing order, must have room for the ids of the event with fewer students.
+@param count - Set to the number of common ids.
+
+@return EVENT_NULL_ARG if the function arguments are NULL.
+		EVENT_SUCCESS if the common ids have been set.
+*/
+EventResult eventIntersectStudentIds(Event event1, Event event2, int* student_ids, int* count);
 
 /*
 eventGetId: Returns the id number of the event.
@@ -97,6 +155,28 @@ eventGetNamePtr: Returns a pointer to the name of a given event.
 */
 char* eventGetNamePtr(Event event);
 
+/*
+eventGetNameView: Returns the name of a given event without copying it.
+				  The name is valid until the event is deallocated.
+
+@param event - The event to extract the name from.
+
+@return NULL if the event is NULL.
+		Else, returns the name of the event.
+*/
+const char* eventGetNameView(Event event);
+
+/*
+eventGetDateView: Returns the date of a given event without copying it.
+				  The date must not be changed or deallocated, and is valid until the event's date changes.
+
+@param event - The event to extract the date from.
+
+@return NULL if the event is NULL.
+		Else, returns the date of the event.
+*/
+Date eventGetDateView(Event event);
+
 /*
 eventSetDate: Changes the date of a given event.
 
@@ -130,12 +210,56 @@ eventRemoveStudentId: Removes a given student id from the event's student id lis
 @param student_id - The student id to remove from the list.
 
 @return EVENT_NULL_ARG if the function arguments are NULL.
-		EVENT_MEMORY_FAIL if a memory allocation fails.
 		EVENT_STUDENT_NOT_LINKED if the student id doesn't exist in the list.
 		EVENT_SUCCESS if the student id has been added successfully.
 */
 EventResult eventRemoveStudentId(Event event, int student_id);
 
+/*
+eventSetStudentIds: Replaces the event's student id list with the given ids, in a single pass.
+					Used for bulk loading, when the ids are already sorted.
+
+@param event - The event to set the student ids of.
+@param student_ids - The student ids, sorted in increasing order and without duplicates.
+@param count - The number of student ids.
+
+@return EVENT_NULL_ARG if the function arguments are NULL or if the ids aren't sorted.
+		EVENT_MEMORY_FAIL if a memory allocation fails (The event's list is left unchanged).
+		EVENT_SUCCESS if the student ids have been set successfully.
+*/
+EventResult eventSetStudentIds(Event event, int* student_ids, int count);
+
+/*
+eventFindStudentIds: Checks which of the given student ids are linked to the event, in a single pass.
+
+@param event - The event to search in.
+@param student_ids - The student ids to search for, sorted in increasing order and without duplicates.
+@param count - The number of student ids.
+@param linked - Set to whether each of the student ids is in the event's list.
+
+@return EVENT_NULL_ARG if the function arguments are NULL or if the ids aren't sorted.
+		EVENT_SUCCESS if linked has been set.
+*/
+EventResult eventFindStudentIds(Event event, int* student_ids, int count, bool* linked);
+
+/*
+eventUpdateStudentIds: Adds and removes student ids from the event's student id list, in a single pass.
+					   Nothing is changed unless all of the ids can be added and removed.
+
+@param event - The event to update.
+@param added_ids - The student ids to add, sorted in increasing order and without duplicates.
+@param added_count - The number of student ids to add.
+@param removed_ids - The student ids to remove, sorted in increasing order and without duplicates.
+@param removed_count - The number of student ids to remove.
+
+@return EVENT_NULL_ARG if the function arguments are NULL or if the ids aren't sorted.
+		EVENT_STUDENT_ALREDY_LINKED if one of the added ids already exists in the list.
+		EVENT_STUDENT_NOT_LINKED if one of the removed ids doesn't exist in the list.
+		EVENT_MEMORY_FAIL if a memory allocation fails (The event's list is left unchanged).
+		EVENT_SUCCESS if the list has been updated.
+*/
+EventResult eventUpdateStudentIds(Event event, int* added_ids, int added_count, int* removed_ids, int removed_count);
+
 /*
 eventEquals: Compares between two events.
 
@@ -1,12 +1,27 @@
+#define _GNU_SOURCE //For pthread_rwlock_t and the writer preferring lock kind under -std=c99.
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
 #include <string.h>
+#include <limits.h>
 #include <assert.h>
 #include "priority_queue.h"
+#include "priority_queue_ext.h"
 #include "event_manager.h"
+#include "event_manager_ext.h"
 #include "event.h"
-#include "student.h"
-#include "pair.h"
+#include "member_table.h"
+#include "timing_wheel.h"
+#include "snapshot.h"
+#include "string_table.h"
+#include "journal.h"
+#include "change_feed.h"
+#include "date_ext.h"
+#include "arena.h"
+#include "name_pool.h"
+#include "latency.h"
 
 #define EQUAL_ELEMENTS 0
 #define FIRST_ELEMENT_BIGGER 1
@@ -16,13 +31,216 @@
 #define EVENT_REMOVED 0
 #define EVENT_QUEUE_UPDATED 1
 #define EVENT_QUEUE_OUT_OF_MEMORY 2
+#define DAYS_IN_MONTH 30
+#define MONTHS_IN_YEAR 12
+#define NO_INDEX -1
+#define ARENA_CHUNK_SIZE (256 * 1024)
+#define MAX_REPORT_THREADS 64
+#define INITIAL_REPORT_BUFFER_SIZE 4096
+#define DATE_TEXT_SIZE 40 //Fits ",day.month.year" for any int values.
+#define COUNT_TEXT_SIZE 16 //Fits ",count\n" for any int count.
 
 struct EventManager_t {
 	Date current_date;
-	PriorityQueue events;
-	PriorityQueue students;
+	EventManagerBackend backend;
+	PriorityQueue events; //Used by EM_BACKEND_PRIORITY_QUEUE and EM_BACKEND_BTREE, else NULL.
+	TimingWheel events_wheel; //Used by EM_BACKEND_TIMING_WHEEL, else NULL.
+	MemberTable members; //The members by index, with their ranking by priority.
+	bool thread_safe;
+	pthread_rwlock_t lock; //Initialized only when thread_safe is true.
+	Snapshot base; //A mapped snapshot that the events and members are layered over, else NULL.
+	Event* base_overrides; //Base events that were copied to change their members, by base index.
+	bool* base_events_removed; //Base events that were removed, expired or moved to the events backend.
+	bool* base_members_copied; //Base members that were copied into the members table.
+	int base_first_event; //All of the base events before it were removed.
+	int base_events_count; //The number of base events that weren't removed.
+	int base_members_count; //The number of base members that weren't copied.
+	Journal journal; //Successful changes are logged to it, else NULL.
+	const Allocator* allocator; //The allocator of the date, the backends and their elements.
+	Arena arena; //The arena that allocator comes from when the event manager owns it, else NULL.
+	NamePool names; //The names of the events and the members, each distinct name is stored once.
+	OperationStats stats; //The work done by the public functions, only counted when COLLECT_STATS is defined.
+	LatencyRecorder latency; //Records the latency of every public function call when enabled, else NULL.
+	int report_threads; //The number of threads emPrintAllEvents formats the events on.
+	ChangeFeed changes; //The recent changes, for emExportChanges, else NULL.
+};
+
+/** The types of the journal records, one for every function that changes the event manager */
+typedef enum {
+	JOURNAL_ADD_EVENT_BY_DATE, //{event id, date ordinal}, event name
+	JOURNAL_ADD_EVENT_BY_DIFF, //{event id, days}, event name
+	JOURNAL_REMOVE_EVENT, //{event id}
+	JOURNAL_CHANGE_EVENT_DATE, //{event id, date ordinal}
+	JOURNAL_ADD_MEMBER, //{member id}, member name
+	JOURNAL_ADD_MEMBER_TO_EVENT, //{member id, event id}
+	JOURNAL_REMOVE_MEMBER_FROM_EVENT, //{member id, event id}
+	JOURNAL_TICK //{days}
+} JournalRecordType;
+
+/** The types of the change feed records, as exported by emExportChanges */
+typedef enum {
+	CHANGE_EVENT_ADDED, //{event id, date ordinal}, event name
+	CHANGE_EVENT_REMOVED, //{event id, 0}
+	CHANGE_EVENT_DATE_CHANGED, //{event id, date ordinal}
+	CHANGE_MEMBER_ADDED, //{member id, 0}, member name
+	CHANGE_MEMBER_LINKED, //{member id, event id}
+	CHANGE_MEMBER_UNLINKED, //{member id, event id}
+	CHANGE_MEMBER_EVENT_COUNT, //{member id, event count}
+	CHANGE_TYPES_COUNT
+} ChangeType;
+
+/** The names of the change types, as exported by emExportChanges */
+static const char* change_type_names[CHANGE_TYPES_COUNT] = {
+	"event_added", "event_removed", "event_date_changed", "member_added", "member_linked", "member_unlinked",
+	"member_event_count"
+};
+
+/** The public functions whose latency is recorded, one histogram of the latency recorder each */
+typedef enum {
+	LATENCY_ADD_EVENT_BY_DATE,
+	LATENCY_ADD_EVENT_BY_DIFF,
+	LATENCY_REMOVE_EVENT,
+	LATENCY_CHANGE_EVENT_DATE,
+	LATENCY_ADD_MEMBER,
+	LATENCY_ADD_MEMBER_TO_EVENT,
+	LATENCY_REMOVE_MEMBER_FROM_EVENT,
+	LATENCY_TICK,
+	LATENCY_GET_EVENTS_AMOUNT,
+	LATENCY_GET_NEXT_EVENT,
+	LATENCY_PRINT_ALL_EVENTS,
+	LATENCY_PRINT_ALL_RESPONSIBLE_MEMBERS,
+	LATENCY_PRINT_ALL_EVENTS_ASYNC,
+	LATENCY_PRINT_ALL_RESPONSIBLE_MEMBERS_ASYNC,
+	LATENCY_SAVE_SNAPSHOT,
+	LATENCY_APPLY_BATCH,
+	LATENCY_GET_MEMBER_EVENTS,
+	LATENCY_ENABLE_JOURNAL,
+	LATENCY_SYNC_JOURNAL,
+	LATENCY_DISABLE_JOURNAL,
+	LATENCY_REPLAY_JOURNAL,
+	LATENCY_ENABLE_CHANGE_FEED,
+	LATENCY_GET_CHANGE_SEQUENCE,
+	LATENCY_EXPORT_CHANGES,
+	LATENCY_OPERATIONS_COUNT
+} LatencyOperation;
+
+/** The names of the latency operations, as printed in the latency report */
+static const char* latency_operation_names[LATENCY_OPERATIONS_COUNT] = {
+	"emAddEventByDate", "emAddEventByDiff", "emRemoveEvent", "emChangeEventDate", "emAddMember",
+	"emAddMemberToEvent", "emRemoveMemberFromEvent", "emTick", "emGetEventsAmount", "emGetNextEvent",
+	"emPrintAllEvents", "emPrintAllResponsibleMembers", "emPrintAllEventsAsync",
+	"emPrintAllResponsibleMembersAsync", "emSaveSnapshot", "emApplyBatch",
+	"emGetMemberEvents", "emEnableJournal", "emSyncJournal", "emDisableJournal", "emReplayJournal",
+	"emEnableChangeFeed", "emGetChangeSequence", "emExportChanges"
 };
 
+/** Type for iterating over the events without changing the events backend */
+typedef struct {
+	PQCursor queue_cursor;
+	TwCursor wheel_cursor;
+} EventsCursor;
+
+/*
+* Macro for iterating over the events of an event manager in date order,
+* regardless of the backend that stores them.
+* The iteration only reads the backend, the cursor must be declared by the caller.
+*/
+#define EVENTS_FOREACH(iterator, cursor, em) \
+	for(Event iterator = eventsGetFirst(em, &(cursor)) ; \
+		iterator != NULL ;\
+		iterator = eventsGetNext(em, &(cursor)))
+
+/*
+* An event as seen by the read functions: an event object of the events backend,
+* or a base event of a mapped snapshot, which is read from the mapping as long as it wasn't changed.
+*/
+typedef struct {
+	Event event; //NULL for a base event that is read from the mapping.
+	int base_index; //The index of the base event, or NO_INDEX.
+	int date; //The date ordinal of the event.
+	const char* name; //The name of the event (NOT A COPY).
+} EventView;
+
+/** Type for iterating over the events backend and the base events together, in date order */
+typedef struct {
+	EventsCursor events_cursor;
+	Event next_event; //The next event of the events backend, NULL when they ended.
+	int next_base; //The next base index that wasn't removed, or the number of base events.
+} ViewCursor;
+
+/** A member as seen by the read functions, like EventView */
+typedef struct {
+	int index; //The index in the members table, or NO_INDEX for a base member that is read from the mapping.
+	int id;
+	int event_count;
+	const char* name; //The name of the member (NOT A COPY).
+} MemberView;
+
+/** Type for iterating over the members table and the base members together, in priority order */
+typedef struct {
+	int next_rank; //The rank of the next member of the members table.
+	int next_base; //The next base member that wasn't copied, or the number of base members.
+} MemberViewCursor;
+
+/** A member of a snapshot that is being loaded, with the events it was linked to so far */
+typedef struct {
+	int id;
+	int event_count;
+	int linked;
+	int* event_ids; //Room for event_count event ids, or NULL when only the counts are checked.
+} LoadedMember;
+
+/** An operation of a batch, with its index in the batch */
+typedef struct {
+	int event_id;
+	int member_id;
+	int index;
+} BatchEntry;
+
+/** A member that is changed by a batch */
+typedef struct {
+	int id;
+	int index; //The index in the members table, or NO_INDEX if the member doesn't exist.
+} BatchMember;
+
+/** The buffers used while applying a batch, each one can hold all of the batch's operations */
+typedef struct {
+	BatchEntry* entries; //The valid operations, sorted by event id, member id and index.
+	BatchMember* members; //The members of the valid operations, sorted by id.
+	int members_count;
+	int* ids;
+	bool* linked;
+	int* added_ids;
+	int* removed_ids;
+} Batch;
+
+/** The name of a member by its id, for finding the names of the members without searching the members table */
+typedef struct {
+	int id;
+	const char* name; //NOT A COPY.
+} MemberName;
+
+/** A range of the events of a parallel report, and the buffer a worker thread formats them into */
+typedef struct {
+	EventManager em;
+	const EventView* views; //All of the events, in date order.
+	int first;
+	int last; //The index after the last event of the range.
+	const MemberName* names; //The names of all of the members, sorted by id.
+	int names_count;
+	char* buffer;
+	size_t size;
+	size_t capacity;
+	bool failed; //True if a memory allocation failed, the buffer is then incomplete.
+} ReportChunk;
+
+/** The progress of expiring the outdated events of the events queue, see expireQueueEvents */
+typedef struct {
+	EventManager em;
+	int count; //The number of outdated events whose members were unlinked, all at the start of the queue.
+	EventManagerResult result;
+} ExpiredEvents;
+
 /* =---------------------------------------------------------------------------=
 
 							Static Functions Declarations
@@ -31,16 +249,96 @@ struct EventManager_t {
 */
 
 /*
-studentPriorityCompare: Compares between 2 student priorities.
+* Unlocked implementations of the public event manager functions.
+* Each one takes the same arguments and returns the same values as its em* counterpart,
+* and expects the caller to hold the event manager lock when thread safety is enabled.
+*/
+static EventManagerResult addEventByDate(EventManager em, char* event_name, Date date, int event_id);
+static EventManagerResult addEventByDiff(EventManager em, char* event_name, int days, int event_id);
+static EventManagerResult removeEvent(EventManager em, int event_id);
+static EventManagerResult changeEventDate(EventManager em, int event_id, Date new_date);
+static EventManagerResult addMember(EventManager em, char* member_name, int member_id);
+static EventManagerResult addMemberToEvent(EventManager em, int member_id, int event_id);
+static EventManagerResult removeMemberFromEvent(EventManager em, int member_id, int event_id);
+static EventManagerResult tick(EventManager em, int days);
+static int getEventsAmount(EventManager em);
+static char* getNextEvent(EventManager em);
+static void printAllEvents(EventManager em, const char* file_name);
+static void printAllResponsibleMembers(EventManager em, const char* file_name);
+static EventManagerResult printAllEventsAsync(EventManager em, const char* file_name, EventManagerExport* report);
+static EventManagerResult printAllResponsibleMembersAsync(EventManager em, const char* file_name,
+	EventManagerExport* report);
+static EventManagerResult saveSnapshot(EventManager em, const char* path);
+static EventManagerResult applyBatch(EventManager em, const EventManagerBatchOp* ops, int ops_count,
+	EventManagerResult* results);
+static EventManagerResult getMemberEvents(EventManager em, int member_id, int** event_ids, int* count);
+static EventManagerResult exportChanges(EventManager em, long long since, const char* file_name, long long* last);
+
+/*
+writeChange: Prints a change of the change feed as a line of emExportChanges.
+
+@param file - The file to print to.
+@param record - The change to print.
+
+@return False if the line couldn't be written.
+		Else, returns True.
+*/
+static bool writeChange(FILE* file, const ChangeRecord* record);
+
+/*
+lockRead: Acquires the event manager lock for reading, if thread safety is enabled.
+
+@param em - The event manager to lock.
+*/
+static void lockRead(EventManager em);
+
+/*
+lockWrite: Acquires the event manager lock for writing, if thread safety is enabled.
+
+@param em - The event manager to lock.
+*/
+static void lockWrite(EventManager em);
+
+/*
+unlock: Releases the event manager lock, if thread safety is enabled.
+
+@param em - The event manager to unlock.
+*/
+static void unlock(EventManager em);
+
+/*
+latencyStart: Returns the start time of a public function call, if latency tracking is enabled.
+			  Called before the lock is taken, so the recorded latency includes waiting for it.
 
-@param pair1 - A pair of the first student's event count and his id.
-@param pair2 - A pair of the second student's event count and his id.
+@param em - The event manager that is called.
 
-@return EQUAL_ELEMENTS if the event counts and id's are equal.
-		FIRST_ELEMENT_BIGGER if the first pair is of higher priority.
-		SECOND_ELEMENT_BIGGER if the second pair is of higher priority.
+@return 0 if latency tracking is disabled.
+		Else, returns the current timestamp of latencyNow.
 */
-static int studentPriorityCompare(Pair pair1, Pair pair2);
+static long long latencyStart(EventManager em);
+
+/*
+latencyEnd: Records the latency of a public function call in the calling thread's histogram,
+			if latency tracking is enabled. Called before the lock is released.
+
+@param em - The event manager that was called.
+@param operation - The public function that was called.
+@param start_time - The start time returned by latencyStart.
+*/
+static void latencyEnd(EventManager em, LatencyOperation operation, long long start_time);
+
+/*
+dumpLatency: Prints the latency of every public function, merged from the histograms of all of the threads.
+
+@param em - The event manager to print the latency of.
+@param stream - The stream to print to.
+@param csv - True to print a CSV row for every function, False to print a table of the functions that were called.
+
+@return EM_ERROR if latency tracking isn't enabled.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_SUCCESS if the report has been printed.
+*/
+static EventManagerResult dumpLatency(EventManager em, FILE* stream, bool csv);
 
 /*
 dateCompareEarliest: Compares between 2 dates and returns the earliest.
@@ -67,92 +365,178 @@ intCompare: Compares between 2 integers and returns the biggest.
 static int intCompare(int num1, int num2);
 
 /*
-intCopy: Copies an integer and returns it.
-
-@param element - The integer to copy.
+queueDateCreate: Returns a date of the allocator of the event manager, for the events queue to copy as a priority.
 
+@param em - The event manager of the queue.
+@param date - The date to copy.
 
-@return NULL if the element is NULL or a memory allocation fails.
-		Else returns a copy of the integer.
+@return NULL if a memory allocation failed.
+		Else, returns the date itself when the event manager uses the default allocator, or a copy.
 */
-static void* intCopy(void* num);
+static Date queueDateCreate(EventManager em, Date date);
 
 /*
-intFree: Deallocates an integer.
+queueDateDestroy: Deallocates a date that was returned by queueDateCreate.
 
-@param num - The integer to deallocate.
+@param em - The event manager of the queue.
+@param date - The date to deallocate.
 */
-static void intFree(void* num);
+static void queueDateDestroy(EventManager em, Date date);
 
 /*
 checkEventQueue: Checks if there is already an event with the given name and date in the queue.
 
-@param events - The priority queue to iterate over.
+@param em - The event manager that stores the events.
 @param event_name - The event name to search for.
 @param event_date - The event date to search for.
 
-@return EM_OUT_OF_MEMORY if a memory error occurs,
-		EM_EVENT_ALREADY_EXISTS if there is an event with the given name and date,
+@return EM_EVENT_ALREADY_EXISTS if there is an event with the given name and date,
 		EM_SUCCESS if there isn't an event with the given paramaters.
 */
-static EventManagerResult checkEventQueue(PriorityQueue events, char* event_name, Date event_date);
+static EventManagerResult checkEventQueue(EventManager em, const char* event_name, Date event_date);
 
 /*
 findEvent: Searches for an event by its id.
 
-@param events - The priority queue to iterate over.
+@param em - The event manager that stores the events.
 @param event_id - The event id to search for.
 
 @return NULL if the event doesn't exist in the queue.
 		Else, returns the event. (NOT A COPY)
 */
-static Event findEvent(PriorityQueue events, int event_id);
+static Event findEvent(EventManager em, int event_id);
 
 /*
-findStudent: Searches for a student by its id.
+findMember: Searches for a member of the members table by its id.
+
+@param em - The event manager that stores the members.
+@param member_id - The member id to search for.
+
+@return NO_INDEX if the member isn't in the members table.
+		Else, returns the index of the member.
+*/
+static int findMember(EventManager em, int member_id);
 
-@param students - The priority queue to iterate over.
-@param student_id - The student id to search for.
+/*
+eventPrintStudentList: Prints the names of the students linked to an event.
 
-@return NULL if the student doesn't exist in the queue.
-		Else, returns the student. (NOT A COPY)
+@param em - The event manager that stores the students.
+@param view - The event to print its students.
+@param stream - The file to print into.
 */
-static Student findStudent(PriorityQueue students, int student_id);
+static void eventPrintStudentList(EventManager em, EventView* view, FILE* stream);
 
 /*
-changeStudentEventCount: Changes a student's event count and updates the priority queue.
+printAllEventsParallel: Prints the events like printAllEvents, after formatting them on several threads.
+						The events are split into ranges of about the same number of events and members,
+						each range is formatted by a thread into a buffer of its own, and the buffers
+						are written to the file in order.
 
-@param students - The priority queue to iterate over.
-@param student - The student to update its event count and queue priority.
-@param increment - The amount to add/subtract from the student's event count.
+@param em - The event manager to print, whose report_threads is bigger than 1.
+@param file_name - The file to print into.
 
-@return EM_OUT_OF_MEMORY if the change priority function fails.
-		EM_SUCCESS if the student's priority was changed successfully.
+@return EM_OUT_OF_MEMORY if a memory allocation has failed (The file isn't opened).
+		EM_ERROR if the file couldn't be opened.
+		EM_SUCCESS if the events have been printed.
 */
-static EventManagerResult changeStudentEventCount(PriorityQueue students, Student student, int increment);
+static EventManagerResult printAllEventsParallel(EventManager em, const char* file_name);
 
 /*
-changeStudentPriority: Updates a student's priority.
+formatAllEvents: Formats the lines of emPrintAllEvents into the buffers of report ranges,
+				 on the number of threads set by emSetReportThreads.
 
-@param students - The priority queue to iterate over.
-@param student - The student to update its queue priority.
+@param em - The event manager to format.
+@param chunks - Set to the ranges, whose buffers hold the lines in order and must be freed by the caller.
+				Must have room for MAX_REPORT_THREADS ranges.
+@param chunks_count - Set to the number of ranges.
 
-@return EM_OUT_OF_MEMORY if a memory allocation fails.
-		Else, returns the student. (NOT A COPY)
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if all of the events have been formatted.
 */
-static EventManagerResult changeStudentPriority(PriorityQueue students, Student student);
+static EventManagerResult formatAllEvents(EventManager em, ReportChunk* chunks, int* chunks_count);
 
 /*
-eventPrintStudentList: Prints the names of the students in the id list.
+formatAllResponsibleMembers: Formats the lines of emPrintAllResponsibleMembers into the buffer of a report range.
 
-@param students - The priority queue to iterate over.
-@param id_list - The id list that stores the students id's
-@param stream - The file to print into.
+@param em - The event manager to format.
+@param chunk - Set to the range, whose buffer must be freed by the caller.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if all of the members have been formatted.
+*/
+static EventManagerResult formatAllResponsibleMembers(EventManager em, ReportChunk* chunk);
+
+/*
+startReportWriter: Joins the buffers of report ranges and hands them to a background writer.
+
+@param file_name - The file to write into.
+@param chunks - The formatted ranges, whose buffers are freed or taken by the writer.
+@param chunks_count - The number of ranges.
+@param report - Set to the writer.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed (The file isn't changed).
+		EM_SUCCESS if the writer has started.
+*/
+static EventManagerResult startReportWriter(const char* file_name, ReportChunk* chunks, int chunks_count,
+	EventManagerExport* report);
+
+/*
+createMemberNames: Creates an array of the names of all of the members, including the base members, sorted by id.
+
+@param em - The event manager that stores the members.
+@param count - Set to the number of members.
+
+@return NULL if a memory allocation has failed.
+		Else, returns the array, which the caller must free.
+*/
+static MemberName* createMemberNames(EventManager em, int* count);
+
+/*
+memberNameCompare: Compares between 2 member names by their ids, for qsort and bsearch.
+
+@param name1 - The first MemberName.
+@param name2 - The second MemberName.
+
+@return A negative number, zero or a positive number if the first id is smaller, equal or bigger.
 */
-static void eventPrintStudentList(PriorityQueue students, Node id_list, FILE* stream);
+static int memberNameCompare(const void* name1, const void* name2);
 
 /*
-updateEventQueue: Removes one of the outdated events while using emTick.
+formatReportChunk: Formats the events of a report range into its buffer, the entry function of the report threads.
+				   Only reads the event manager, whose lock is held by the thread that started the report.
+
+@param chunk - The ReportChunk to format.
+
+@return NULL.
+*/
+static void* formatReportChunk(void* chunk);
+
+/*
+reportAppend: Appends text to the buffer of a report range, growing the buffer if needed.
+
+@param chunk - The range to append to.
+@param text - The text to append.
+@param length - The number of characters to append.
+
+@return False if a memory allocation has failed (failed is then set).
+		Else, returns True.
+*/
+static bool reportAppend(ReportChunk* chunk, const char* text, size_t length);
+
+/*
+reportAppendMember: Appends a comma and the name of a member to the buffer of a report range,
+					like printMemberName.
+
+@param chunk - The range to append to.
+@param member_id - The id of the member.
+
+@return False if a memory allocation has failed.
+		Else, returns True.
+*/
+static bool reportAppendMember(ReportChunk* chunk, int member_id);
+
+/*
+updateEventQueue: Removes the earliest event of the timing wheel if it is outdated while using emTick.
 
 @param em - The event manager the stores the events queue.
 
@@ -162,609 +546,3154 @@ updateEventQueue: Removes one of the outdated events while using emTick.
 */
 static int updateEventQueue(EventManager em);
 
+/*
+expireQueueEvents: Removes all of the outdated events of the events queue while using emTick,
+				   by visiting the range of dates before the current date and then removing the visited events.
+
+@param em - The event manager that stores the events queue.
 
-/* =---------------------------------------------------------------------------=
+@return EM_OUT_OF_MEMORY if a memory allocation has failed (The events that were unlinked are still removed).
+		EM_SUCCESS if all of the outdated events have been removed.
+*/
+static EventManagerResult expireQueueEvents(EventManager em);
 
-								Event Manager Functions
+/*
+expireEvent: Unlinks the members of an outdated event of the events queue, before the event is removed.
 
-   =---------------------------------------------------------------------------=
+@param context - The ExpiredEvents of the expiry.
+@param element - The outdated event.
+@param priority - The date of the event.
+
+@return False if a memory allocation has failed, which stops the expiry.
+		Else, returns True.
 */
+static bool expireEvent(void* context, PQElement element, PQElementPriority priority);
 
+/*
+unlinkEventMembers: Unlinks an event from the events of every member linked to it.
 
-EventManager createEventManager(Date date)
-{
-	if (date == NULL) {
-		return NULL;
-	}
+@param em - The event manager that stores the members.
+@param event - The event to unlink its members.
 
-	EventManager manager = malloc(sizeof(*manager));
-	if (manager == NULL) {
-		return NULL;
-	}
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if all of the members have been updated.
+*/
+static EventManagerResult unlinkEventMembers(EventManager em, Event event);
 
-	manager->current_date = dateCopy(date);
-	if (manager->current_date == NULL) {
-		free(manager);
-		return NULL;
-	}
-	manager->events = pqCreate((ElemCopyFunc)eventCopy, (ElemFreeFunc)eventDestroy,
-		(EqualPQElements)eventEquals, (CopyPQElementPriority)dateCopy,
-		(FreePQElementPriority)dateDestroy,
-		(ComparePQElementPriorities)dateCompareEarliest);
-	if (manager->events == NULL) {
-		dateDestroy(manager->current_date);
-		free(manager);
-		return NULL;
-	}
-	manager->students = pqCreate((ElemCopyFunc)stCopy, (ElemFreeFunc)stDestroy,
-		(EqualPQElements)stEquals, (CopyPQElementPriority)pairCopy,
-		(FreePQElementPriority)pairDestroy,
-		(ComparePQElementPriorities)studentPriorityCompare);
-	if (manager->students == NULL) {
-		pqDestroy(manager->events);
-		dateDestroy(manager->current_date);
-		free(manager);
-		return NULL;
-	}
+/*
+eventsInsert: Adds a copy of an event to the events backend.
 
-	return manager;
-}
+@param em - The event manager that stores the events.
+@param event - The event to add.
+@param date - The date of the event.
 
-void destroyEventManager(EventManager em)
-{
-	if (em == NULL) {
-		return;
-	}
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if the event has been added.
+*/
+static EventManagerResult eventsInsert(EventManager em, Event event, Date date);
 
-	pqDestroy(em->events);
-	pqDestroy(em->students);
-	dateDestroy(em->current_date);
-	free(em);
-}
+/*
+eventsRemove: Removes an event from the events backend.
 
-EventManagerResult emAddEventByDate(EventManager em, char* event_name, Date date, int event_id)
-{
-	if (em == NULL || event_name == NULL || date == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (dateCompareEarliest(em->current_date, date) == SECOND_ELEMENT_BIGGER) {
-		return EM_INVALID_DATE;
-	}
-	else if (event_id < 0) {
-		return EM_INVALID_EVENT_ID;
-	}
+@param em - The event manager that stores the events.
+@param event - The event to remove.
 
-	int res = checkEventQueue(em->events, event_name, date);
-	if (res != EM_SUCCESS) {
-		return res;
-	}
-	Event ptr = findEvent(em->events, event_id);
-	if (ptr != NULL) {
-		return EM_EVENT_ID_ALREADY_EXISTS;
-	}
-	Event event = eventCreate(event_name, event_id, date);
-	assert(event != NULL);
-	if (event == NULL) {
-		return EM_OUT_OF_MEMORY;
-	}
+@return EM_OUT_OF_MEMORY if the event couldn't be removed.
+		EM_SUCCESS if the event has been removed.
+*/
+static EventManagerResult eventsRemove(EventManager em, Event event);
 
-	res = pqInsert(em->events, event, date);
-	assert(res != PQ_OUT_OF_MEMORY);
-	if (res == PQ_OUT_OF_MEMORY) {
-		eventDestroy(event);
-		return EM_OUT_OF_MEMORY;
-	}
+/*
+eventsRemoveFirst: Removes the earliest event from the events backend.
 
-	eventDestroy(event);
-	return EM_SUCCESS;
-}
+@param em - The event manager that stores the events.
 
-EventManagerResult emAddEventByDiff(EventManager em, char* event_name, int days, int event_id)
-{
-	if (em == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	if (days < 0) {
-		return EM_INVALID_DATE;
-	}
+@return EM_OUT_OF_MEMORY if the event couldn't be removed.
+		EM_SUCCESS if the event has been removed.
+*/
+static EventManagerResult eventsRemoveFirst(EventManager em);
 
-	Date date = dateCopy(em->current_date);
-	assert(date != NULL);
-	if (date == NULL) {
-		return EM_OUT_OF_MEMORY;
-	}
-	for (int i = 0; i < days; i++)
-	{
-		dateTick(date);
-	}
+/*
+eventsChangeDate: Moves an event that its date was already changed to its new place in the events backend.
 
-	int res = emAddEventByDate(em, event_name, date, event_id);
-	dateDestroy(date);
-	return res;
-}
+@param em - The event manager that stores the events.
+@param event - The event to move (NOT A COPY).
+@param old_date - The date the event was stored by.
+@param new_date - The new date of the event.
 
-EventManagerResult emRemoveEvent(EventManager em, int event_id)
-{
-	if (em == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (event_id < 0) {
-		return EM_INVALID_EVENT_ID;
-	}
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if the event has been moved.
+*/
+static EventManagerResult eventsChangeDate(EventManager em, Event event, Date old_date, Date new_date);
 
-	Event ptr = findEvent(em->events, event_id);
-	if (ptr == NULL) {
-		return EM_EVENT_NOT_EXISTS;
-	}
-	NODE_FOREACH(Node, node, eventGetIdList(ptr)) {
-		int* id = nodeGet(node);
-		assert(id != NULL);
-		Student student = findStudent(em->students, *id);
-		assert(student != NULL);
-		if (changeStudentEventCount(em->students, student, -1) != EM_SUCCESS) {
-			return EM_OUT_OF_MEMORY;
-		}
-	}
-	int res = pqRemoveElement(em->events, ptr);
-	if (res != PQ_SUCCESS) {
-		return EM_OUT_OF_MEMORY;
-	}
-	return EM_SUCCESS;
-}
+/*
+eventsGetFirst: Sets a cursor to the earliest event and returns it.
 
-EventManagerResult emChangeEventDate(EventManager em, int event_id, Date new_date)
-{
-	if (em == NULL || new_date == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (dateCompare(em->current_date, new_date) > 0) {
-		return EM_INVALID_DATE;
-	}
-	else if (event_id < 0) {
-		return EM_INVALID_EVENT_ID;
-	}
+@param em - The event manager that stores the events.
+@param cursor - The cursor to set.
 
-	Event event = findEvent(em->events, event_id);
-	if (event == NULL) {
-		return EM_EVENT_ID_NOT_EXISTS;
-	}
-	int res = checkEventQueue(em->events, eventGetNamePtr(event), new_date);
-	if (res != EM_SUCCESS) {
-		return res;
-	}
+@return NULL if there are no events.
+		Else, returns the earliest event. (NOT A COPY)
+*/
+static Event eventsGetFirst(EventManager em, EventsCursor* cursor);
 
-	Date event_date = eventGetDate(event);
-	if (event_date == NULL) {
-		return EM_OUT_OF_MEMORY;
-	}
-	res = eventSetDate(event, new_date);
-	if (res != EVENT_SUCCESS) {
-		dateDestroy(event_date);
-		return EM_OUT_OF_MEMORY;
-	}
-	Event event_copy = eventCopy(event); //The queue iterator doesn't return a copy.
-	if (event_copy == NULL) {
-		dateDestroy(event_date);
-		return EM_OUT_OF_MEMORY;
-	}
+/*
+eventsGetNext: Advances a cursor over the events.
 
-	res = pqChangePriority(em->events, event_copy, event_date, new_date);
-	if (res != PQ_SUCCESS) {
-		eventDestroy(event_copy);
-		dateDestroy(event_date);
-		return EM_OUT_OF_MEMORY;
-	}
+@param em - The event manager that stores the events.
+@param cursor - The cursor to advance.
 
-	eventDestroy(event_copy);
-	dateDestroy(event_date);
-	return EM_SUCCESS;
-}
+@return NULL if the cursor reached the end.
+		Else, returns the next event in date order. (NOT A COPY)
+*/
+static Event eventsGetNext(EventManager em, EventsCursor* cursor);
 
-EventManagerResult emAddMember(EventManager em, char* member_name, int member_id)
-{
-	if (em == NULL || member_name == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (member_id < 0) {
-		return EM_INVALID_MEMBER_ID;
-	}
+/*
+eventsFirstView: Sets a cursor to the earliest event, including the base events.
+				 Base events come before backend events with the same date, since they were added first.
 
-	Student student = findStudent(em->students, member_id);
-	if (student != NULL) {
-		return EM_MEMBER_ID_ALREADY_EXISTS;
-	}
-	student = stCreate(member_name, member_id);
-	assert(student != NULL);
-	if (student == NULL) {
-		return EM_OUT_OF_MEMORY;
-	}
+@param em - The event manager that stores the events.
+@param cursor - The cursor to set.
+@param view - Set to the earliest event.
 
-	int event_count = 0;
-	Pair priority = pairCreate(&event_count, &member_id, intCopy, intCopy, intFree, intFree);
-	assert(priority != NULL);
-	if (priority == NULL) {
-		stDestroy(student);
-		return EM_OUT_OF_MEMORY;
-	}
-	else if (pqInsert(em->students, student, priority) != PQ_SUCCESS) {
-		stDestroy(student);
-		pairDestroy(priority);
-		return EM_OUT_OF_MEMORY;
-	}
+@return False if there are no events.
+		Else, returns True.
+*/
+static bool eventsFirstView(EventManager em, ViewCursor* cursor, EventView* view);
 
-	stDestroy(student);
-	pairDestroy(priority);
-	return EM_SUCCESS;
-}
+/*
+eventsNextView: Advances a cursor over the events, including the base events.
 
-EventManagerResult emAddMemberToEvent(EventManager em, int member_id, int event_id)
-{
-	if (em == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (member_id < 0) {
+@param em - The event manager that stores the events.
+@param cursor - The cursor to advance.
+@param view - Set to the next event.
+
+@return False if the cursor reached the end.
+		Else, returns True.
+*/
+static bool eventsNextView(EventManager em, ViewCursor* cursor, EventView* view);
+
+/*
+membersFirstView: Sets a cursor to the member with the highest priority, including the base members.
+
+@param em - The event manager that stores the members.
+@param cursor - The cursor to set.
+@param view - Set to the first member.
+
+@return False if there are no members.
+		Else, returns True.
+*/
+static bool membersFirstView(EventManager em, MemberViewCursor* cursor, MemberView* view);
+
+/*
+membersNextView: Advances a cursor over the members, including the base members.
+
+@param em - The event manager that stores the members.
+@param cursor - The cursor to advance.
+@param view - Set to the next member.
+
+@return False if the cursor reached the end.
+		Else, returns True.
+*/
+static bool membersNextView(EventManager em, MemberViewCursor* cursor, MemberView* view);
+
+/*
+printMemberName: Prints the name of a member, found by its id in the members table or in the base members.
+
+@param em - The event manager that stores the members.
+@param member_id - The id of the member.
+@param stream - The file to print into.
+*/
+static void printMemberName(EventManager em, int member_id, FILE* stream);
+
+/*
+findBaseEvent: Searches for a base event that wasn't removed by its id.
+
+@param em - The event manager that stores the base events.
+@param event_id - The event id to search for.
+
+@return NO_INDEX if there is no such base event (or no base).
+		Else, returns the index of the base event.
+*/
+static int findBaseEvent(EventManager em, int event_id);
+
+/*
+findBaseMember: Searches for a base member that wasn't copied into the members table by its id.
+
+@param em - The event manager that stores the base members.
+@param member_id - The member id to search for.
+
+@return NO_INDEX if there is no such base member (or no base).
+		Else, returns the index of the base member.
+*/
+static int findBaseMember(EventManager em, int member_id);
+
+/*
+eventHasMember: Checks if a member is linked to an event, which may be a base event that wasn't copied.
+
+@param em - The event manager that stores the event.
+@param event - The event, or NULL for a base event that wasn't copied.
+@param base_index - The index of the base event, used only if event is NULL.
+@param member_id - The id of the member.
+
+@return true if the member is linked to the event, false otherwise.
+*/
+static bool eventHasMember(EventManager em, Event event, int base_index, int member_id);
+
+/*
+copyBaseEvent: Copies a base event into an event object, so that its members can be changed.
+			   The copy keeps the place of the base event, and findEvent returns it from now on.
+
+@param em - The event manager that stores the base events.
+@param event_id - The id of the event to copy, nothing is done if it isn't a base event.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS otherwise.
+*/
+static EventManagerResult copyBaseEvent(EventManager em, int event_id);
+
+/*
+copyBaseMember: Copies a base member and its events into the members table, so that its events can be changed.
+
+@param em - The event manager that stores the base members.
+@param member_id - The id of the member to copy, nothing is done if it isn't a base member.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS otherwise.
+*/
+static EventManagerResult copyBaseMember(EventManager em, int member_id);
+
+/*
+removeBaseEvent: Marks a base event as removed.
+
+@param em - The event manager that stores the base events.
+@param index - The index of the base event.
+*/
+static void removeBaseEvent(EventManager em, int index);
+
+/*
+expireBaseEvents: Removes the base events that are earlier than the current date, and unlinks their members.
+
+@param em - The event manager that stores the base events.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS otherwise.
+*/
+static EventManagerResult expireBaseEvents(EventManager em);
+
+/*
+unlinkMember: Unlinks an event from the events of a member, copying the member from the base members if needed,
+			  and records the unlink in the change feed.
+
+@param em - The event manager that stores the members.
+@param member_id - The id of the member.
+@param event_id - The id of the event.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS otherwise.
+*/
+static EventManagerResult unlinkMember(EventManager em, int member_id, int event_id);
+
+/*
+updateMemberRank: Moves a member of the members table to the rank of its number of events,
+				  and records the change of its event count in the change feed.
+
+@param em - The event manager that stores the member.
+@param member - The index of the member in the members table.
+*/
+static void updateMemberRank(EventManager em, int member);
+
+/*
+collectMemberEvents: Finds the events a member is linked to by scanning the member lists of the events,
+					 for a base member whose events aren't in the members table.
+
+@param em - The event manager that stores the events.
+@param member_id - The id of the member.
+@param event_ids - Set to the ids of the member's events sorted in ascending order,
+				   must have room for all of the events.
+
+@return The number of events.
+*/
+static int collectMemberEvents(EventManager em, int member_id, int* event_ids);
+
+/*
+checkBase: Checks that the base events are sorted by date and the base members by priority,
+		   which the merged iteration over the base and the delta relies on, and that the
+		   events are linked only to base members with matching event counts.
+
+@param snapshot - The mapped snapshot.
+
+@return False if the snapshot's records are invalid, or if a memory allocation has failed.
+		Else, returns True.
+*/
+static bool checkBase(Snapshot snapshot);
+
+/*
+eventsAppend: Adds a copy of an event after the events that are stored by the same or an earlier date.
+			  Appending events in date order takes O(1) for each event in both backends.
+
+@param em - The event manager that stores the events.
+@param event - The event to add.
+@param date - The date of the event.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if the event has been added.
+*/
+static EventManagerResult eventsAppend(EventManager em, Event event, Date date);
+
+/*
+fillSnapshotContent: Copies the members and the events of the event manager into the records of a snapshot.
+
+@param em - The event manager to copy.
+@param content - The snapshot content, with its arrays allocated by the sizes of the queues.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if the records have been filled.
+*/
+static EventManagerResult fillSnapshotContent(EventManager em, SnapshotContent* content);
+
+/*
+dateToOrdinal: Converts a date to the number of days since 1.1.0 (Months are 30 days long).
+
+@param date - The date to convert.
+
+@return The day ordinal of the date.
+*/
+static int dateToOrdinal(Date date);
+
+/*
+dateFromOrdinal: Creates the date of a day ordinal, the inverse of dateToOrdinal.
+
+@param ordinal - The day ordinal.
+
+@return NULL if a memory allocation has failed.
+		Else, returns a new date.
+*/
+static Date dateFromOrdinal(int ordinal);
+
+/*
+ordinalGet: Returns the day, month and year of a day ordinal without creating a date.
+
+@param ordinal - The day ordinal.
+@param day - Set to the day of the ordinal.
+@param month - Set to the month of the ordinal.
+@param year - Set to the year of the ordinal.
+*/
+static void ordinalGet(int ordinal, int* day, int* month, int* year);
+
+/*
+loadSnapshot: Fills an empty event manager with the members and the events of a snapshot.
+
+@param em - The empty event manager to fill.
+@param snapshot - The snapshot to load.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_ERROR if the snapshot's ids don't match (duplicated ids, unknown members or wrong event counts).
+		EM_SUCCESS if the snapshot has been loaded.
+*/
+static EventManagerResult loadSnapshot(EventManager em, Snapshot snapshot);
+
+/*
+loadSnapshotMember: Adds a member with the events it was linked to by the loaded events to the members table.
+
+@param em - The event manager to add the member to.
+@param name - The member's name.
+@param member - The loaded member, with its events.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_SUCCESS if the member has been added.
+*/
+static EventManagerResult loadSnapshotMember(EventManager em, const char* name, LoadedMember* member);
+
+/*
+loadSnapshotEvents: Appends the events of a snapshot to the events backend.
+
+@param em - The event manager to add the events to.
+@param snapshot - The snapshot to load.
+@param members - The snapshot's members sorted by id, their linked counts are updated.
+@param members_count - The number of members.
+
+@return EM_OUT_OF_MEMORY if a memory allocation has failed.
+		EM_ERROR if an event id is duplicated or an event is linked to an unknown member.
+		EM_SUCCESS if the events have been added.
+*/
+static EventManagerResult loadSnapshotEvents(EventManager em, Snapshot snapshot,
+	LoadedMember* members, int members_count);
+
+/*
+loadedMemberCompare: Compares between 2 loaded members by their ids, for qsort and bsearch.
+
+@param member1 - The first LoadedMember.
+@param member2 - The second LoadedMember.
+
+@return A negative number, zero or a positive number if the first id is smaller, equal or bigger.
+*/
+static int loadedMemberCompare(const void* member1, const void* member2);
+
+/*
+idCompare: Compares between 2 integers, for qsort.
+
+@param id1 - The first int.
+@param id2 - The second int.
+
+@return A negative number, zero or a positive number if the first id is smaller, equal or bigger.
+*/
+static int idCompare(const void* id1, const void* id2);
+
+/*
+journalOperation: Appends the record of a change to the journal of the event manager, if it has one.
+				  Called before the change is made, which must be skipped if the record can't be appended.
+				  The records of the change are then committed or rolled back by journalOperationEnd.
+
+@param em - The event manager that is changed.
+@param type - The JournalRecordType of the change.
+@param values - The integer arguments of the change.
+@param values_count - The number of integer arguments.
+@param name - The name argument of the change, or NULL.
+
+@return EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_ERROR if the record couldn't be appended.
+		In both cases, the records of the change are rolled back.
+		EM_SUCCESS if the record has been appended, or the event manager has no journal.
+*/
+static EventManagerResult journalOperation(EventManager em, JournalRecordType type,
+	const int* values, int values_count, const char* name);
+
+/*
+journalOperationEnd: Commits the records of a change to the journal of the event manager if the change
+					 succeeded, or rolls them back if it failed.
+
+@param em - The event manager that is changed.
+@param res - The result of the change.
+
+@return EM_ERROR if the change succeeded, but the journal couldn't be written or synced.
+		Else, returns res.
+*/
+static EventManagerResult journalOperationEnd(EventManager em, EventManagerResult res);
+
+/*
+replayRecord: Applies a journal record to an event manager, without logging it again.
+
+@param context - The event manager.
+@param type - The JournalRecordType of the record.
+@param values - The integer arguments of the record.
+@param values_count - The number of integer arguments.
+@param text - The name argument of the record, or NULL.
+
+@return False if the record is malformed or the change failed.
+		Else, returns True.
+*/
+static bool replayRecord(void* context, int type, const int* values, int values_count, const char* text);
+
+/*
+checkBatchOp: Checks the arguments of a batch operation, in the order the single call checks them.
+
+@param op - The operation to check.
+
+@return EM_INVALID_MEMBER_ID or EM_INVALID_EVENT_ID if an id is negative.
+		EM_ERROR if the type of the operation is unknown.
+		EM_SUCCESS if the operation is valid.
+*/
+static EventManagerResult checkBatchOp(const EventManagerBatchOp* op);
+
+/*
+findBatchMembers: Collects the distinct members of a batch's entries, and finds their indexes
+				  in a single pass over the ids of the members table.
+
+@param em - The event manager that stores the members.
+@param batch - The batch, with its entries set.
+@param entries_count - The number of entries.
+
+@return EM_OUT_OF_MEMORY if a base member couldn't be copied.
+		EM_SUCCESS otherwise.
+*/
+static EventManagerResult findBatchMembers(EventManager em, Batch* batch, int entries_count);
+
+/*
+findBatchMember: Searches for a member of a batch by its id.
+
+@param batch - The batch, with its members set.
+@param member_id - The member id to search for.
+
+@return NULL if the id isn't one of the batch's members.
+		Else, returns the member.
+*/
+static BatchMember* findBatchMember(Batch* batch, int member_id);
+
+/*
+applyBatchEvent: Applies the entries of a batch that change one event, and updates its member list in a single pass.
+				 The event is linked to and unlinked from the events of its changed members,
+				 which keep their ranks until the whole batch is applied.
+
+@param em - The event manager that stores the members.
+@param event - The event to change.
+@param batch - The batch.
+@param first - The index of the event's first entry.
+@param last - The index after the event's last entry.
+@param ops - The operations of the batch.
+@param results - Set to the results of the event's operations.
+
+@return EM_OUT_OF_MEMORY if the member list couldn't be updated.
+		EM_OUT_OF_MEMORY or EM_ERROR if the successful operations couldn't be logged to the journal.
+		In both cases the event isn't changed, and the successful results are set to the returned value.
+		EM_SUCCESS otherwise (The caller commits the logged operations with journalOperationEnd).
+*/
+static EventManagerResult applyBatchEvent(EventManager em, Event event, Batch* batch, int first, int last,
+	const EventManagerBatchOp* ops, EventManagerResult* results);
+
+/*
+batchEntryCompare: Compares between 2 batch entries by their event id, member id and index, for qsort.
+
+@param entry1 - The first BatchEntry.
+@param entry2 - The second BatchEntry.
+
+@return A negative number, zero or a positive number if the first entry is smaller, equal or bigger.
+*/
+static int batchEntryCompare(const void* entry1, const void* entry2);
+
+/*
+batchMemberCompare: Compares between 2 batch members by their ids, for bsearch.
+
+@param member1 - The first BatchMember.
+@param member2 - The second BatchMember.
+
+@return A negative number, zero or a positive number if the first id is smaller, equal or bigger.
+*/
+static int batchMemberCompare(const void* member1, const void* member2);
+
+
+/* =---------------------------------------------------------------------------=
+
+								Event Manager Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+
+EventManager createEventManager(Date date)
+{
+	return createEventManagerWithBackend(date, EM_BACKEND_PRIORITY_QUEUE);
+}
+
+EventManager createEventManagerWithBackend(Date date, EventManagerBackend backend)
+{
+	return createEventManagerWithAllocator(date, backend, NULL);
+}
+
+EventManager createEventManagerWithAllocator(Date date, EventManagerBackend backend, const Allocator* allocator)
+{
+	if (date == NULL || (backend != EM_BACKEND_PRIORITY_QUEUE && backend != EM_BACKEND_TIMING_WHEEL &&
+						 backend != EM_BACKEND_BTREE)) {
+		return NULL;
+	}
+
+	EventManager manager = allocatorAlloc(allocator, sizeof(*manager));
+	if (manager == NULL) {
+		return NULL;
+	}
+
+	manager->allocator = allocator;
+	manager->arena = NULL;
+	manager->current_date = dateCopyWithAllocator(date, allocator);
+	if (manager->current_date == NULL) {
+		allocatorFree(allocator, manager);
+		return NULL;
+	}
+	manager->names = namePoolCreate(allocator);
+	if (manager->names == NULL) {
+		dateDestroy(manager->current_date);
+		allocatorFree(allocator, manager);
+		return NULL;
+	}
+	manager->backend = backend;
+	manager->thread_safe = false;
+	statsReset(&manager->stats);
+	manager->latency = NULL;
+	manager->report_threads = 1;
+	manager->changes = NULL;
+	manager->base = NULL;
+	manager->base_overrides = NULL;
+	manager->base_events_removed = NULL;
+	manager->base_members_copied = NULL;
+	manager->base_first_event = 0;
+	manager->base_events_count = 0;
+	manager->base_members_count = 0;
+	manager->journal = NULL;
+	manager->events = NULL;
+	manager->events_wheel = NULL;
+	if (backend == EM_BACKEND_TIMING_WHEEL) {
+		manager->events_wheel = twCreateWithAllocator((ElemCopyFunc)eventCopy, (ElemFreeFunc)eventDestroy,
+			(ElemEqualFunc)eventEquals, allocator);
+	}
+	else {
+		manager->events = pqCreateWithEngine((ElemCopyFunc)eventCopy, (ElemFreeFunc)eventDestroy,
+			(EqualPQElements)eventEquals, (CopyPQElementPriority)dateCopy,
+			(FreePQElementPriority)dateDestroy, (ComparePQElementPriorities)dateCompareEarliest,
+			backend == EM_BACKEND_BTREE ? PQ_ENGINE_BTREE : PQ_ENGINE_LIST, allocator);
+	}
+	if (manager->events == NULL && manager->events_wheel == NULL) {
+		namePoolDestroy(manager->names);
+		dateDestroy(manager->current_date);
+		allocatorFree(allocator, manager);
+		return NULL;
+	}
+	manager->members = memberTableCreate(allocator);
+	if (manager->members == NULL) {
+		pqDestroy(manager->events);
+		twDestroy(manager->events_wheel);
+		namePoolDestroy(manager->names);
+		dateDestroy(manager->current_date);
+		allocatorFree(allocator, manager);
+		return NULL;
+	}
+
+	return manager;
+}
+
+EventManager createEventManagerWithArena(Date date, EventManagerBackend backend)
+{
+	Arena arena = arenaCreate(ARENA_CHUNK_SIZE);
+	if (arena == NULL) {
+		return NULL;
+	}
+	EventManager manager = createEventManagerWithAllocator(date, backend, arenaGetAllocator(arena));
+	if (manager == NULL) {
+		arenaDestroy(arena);
+		return NULL;
+	}
+	manager->arena = arena;
+	return manager;
+}
+
+void destroyEventManager(EventManager em)
+{
+	if (em == NULL) {
+		return;
+	}
+
+	journalClose(em->journal);
+	if (em->thread_safe) {
+		pthread_rwlock_destroy(&em->lock);
+	}
+	if (em->base != NULL) {
+		for (int i = 0; i < snapshotGetEventsCount(em->base); i++) {
+			eventDestroy(em->base_overrides[i]);
+		}
+		snapshotClose(em->base);
+	}
+	free(em->base_overrides);
+	free(em->base_events_removed);
+	free(em->base_members_copied);
+	latencyRecorderDestroy(em->latency);
+	if (em->arena != NULL) { //Everything else, including em itself, is released with the arena.
+		arenaDestroy(em->arena);
+		return;
+	}
+	pqDestroy(em->events);
+	twDestroy(em->events_wheel);
+	memberTableDestroy(em->members);
+	changeFeedDestroy(em->changes);
+	namePoolDestroy(em->names);
+	dateDestroy(em->current_date);
+	allocatorFree(em->allocator, em);
+}
+
+EventManagerResult emAddEventByDate(EventManager em, char* event_name, Date date, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	int values[] = { event_id, dateToOrdinal(date) };
+	EventManagerResult res = journalOperation(em, JOURNAL_ADD_EVENT_BY_DATE, values, 2, event_name);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, addEventByDate(em, event_name, date, event_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ADD_EVENT_BY_DATE, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emAddEventByDiff(EventManager em, char* event_name, int days, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	int values[] = { event_id, days };
+	EventManagerResult res = journalOperation(em, JOURNAL_ADD_EVENT_BY_DIFF, values, 2, event_name);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, addEventByDiff(em, event_name, days, event_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ADD_EVENT_BY_DIFF, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emRemoveEvent(EventManager em, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = journalOperation(em, JOURNAL_REMOVE_EVENT, &event_id, 1, NULL);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, removeEvent(em, event_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_REMOVE_EVENT, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emChangeEventDate(EventManager em, int event_id, Date new_date)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	int values[] = { event_id, dateToOrdinal(new_date) };
+	EventManagerResult res = journalOperation(em, JOURNAL_CHANGE_EVENT_DATE, values, 2, NULL);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, changeEventDate(em, event_id, new_date));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_CHANGE_EVENT_DATE, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emAddMember(EventManager em, char* member_name, int member_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = journalOperation(em, JOURNAL_ADD_MEMBER, &member_id, 1, member_name);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, addMember(em, member_name, member_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ADD_MEMBER, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emAddMemberToEvent(EventManager em, int member_id, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	int values[] = { member_id, event_id };
+	EventManagerResult res = journalOperation(em, JOURNAL_ADD_MEMBER_TO_EVENT, values, 2, NULL);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, addMemberToEvent(em, member_id, event_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ADD_MEMBER_TO_EVENT, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emRemoveMemberFromEvent(EventManager em, int member_id, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	int values[] = { member_id, event_id };
+	EventManagerResult res = journalOperation(em, JOURNAL_REMOVE_MEMBER_FROM_EVENT, values, 2, NULL);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, removeMemberFromEvent(em, member_id, event_id));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_REMOVE_MEMBER_FROM_EVENT, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emTick(EventManager em, int days)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = journalOperation(em, JOURNAL_TICK, &days, 1, NULL);
+	if (res == EM_SUCCESS) {
+		res = journalOperationEnd(em, tick(em, days));
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_TICK, start_time);
+	unlock(em);
+	return res;
+}
+
+int emGetEventsAmount(EventManager em)
+{
+	if (em == NULL) {
+		return NO_SIZE;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	int res = getEventsAmount(em);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_GET_EVENTS_AMOUNT, start_time);
+	unlock(em);
+	return res;
+}
+
+char* emGetNextEvent(EventManager em)
+{
+	if (em == NULL) {
+		return NULL;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	char* res = getNextEvent(em);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_GET_NEXT_EVENT, start_time);
+	unlock(em);
+	return res;
+}
+
+void emPrintAllEvents(EventManager em, const char* file_name)
+{
+	if (em == NULL) {
+		return;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	printAllEvents(em, file_name);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_PRINT_ALL_EVENTS, start_time);
+	unlock(em);
+}
+
+void emPrintAllResponsibleMembers(EventManager em, const char* file_name)
+{
+	if (em == NULL) {
+		return;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	printAllResponsibleMembers(em, file_name);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_PRINT_ALL_RESPONSIBLE_MEMBERS, start_time);
+	unlock(em);
+}
+
+EventManagerResult emPrintAllEventsAsync(EventManager em, const char* file_name, EventManagerExport* report)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = printAllEventsAsync(em, file_name, report);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_PRINT_ALL_EVENTS_ASYNC, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emPrintAllResponsibleMembersAsync(EventManager em, const char* file_name,
+	EventManagerExport* report)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = printAllResponsibleMembersAsync(em, file_name, report);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_PRINT_ALL_RESPONSIBLE_MEMBERS_ASYNC, start_time);
+	unlock(em);
+	return res;
+}
+
+bool emExportIsDone(EventManagerExport report)
+{
+	return reportWriterIsDone(report);
+}
+
+EventManagerResult emExportWait(EventManagerExport report)
+{
+	ReportWriterResult res = reportWriterWait(report);
+	if (res == REPORT_WRITER_NULL_ARGUMENT) {
+		return EM_NULL_ARGUMENT;
+	}
+	return res == REPORT_WRITER_SUCCESS ? EM_SUCCESS : EM_ERROR;
+}
+
+EventManagerResult emEnableThreadSafety(EventManager em)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	if (em->thread_safe) {
+		return EM_SUCCESS;
+	}
+	if (em->arena != NULL && arenaEnableThreadSafety(em->arena) != ARENA_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	pthread_rwlockattr_t attributes;
+	if (pthread_rwlockattr_init(&attributes) != 0) {
+		return EM_OUT_OF_MEMORY;
+	}
+	//Waiting writers block new readers, so a steady stream of reports can't starve changes.
+	//A thread that took the read lock must not take it again, which no function does.
+	pthread_rwlockattr_setkind_np(&attributes, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+	int res = pthread_rwlock_init(&em->lock, &attributes);
+	pthread_rwlockattr_destroy(&attributes);
+	if (res != 0) {
+		return EM_OUT_OF_MEMORY;
+	}
+	em->thread_safe = true;
+	return EM_SUCCESS;
+}
+
+EventManagerResult emSetReportThreads(EventManager em, int threads)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (threads < 1) {
+		return EM_ERROR;
+	}
+	em->report_threads = threads < MAX_REPORT_THREADS ? threads : MAX_REPORT_THREADS;
+	return EM_SUCCESS;
+}
+
+EventManagerResult emSaveSnapshot(EventManager em, const char* path)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = saveSnapshot(em, path);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_SAVE_SNAPSHOT, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManager emLoadSnapshot(const char* path)
+{
+	if (path == NULL) {
+		return NULL;
+	}
+	Snapshot snapshot = snapshotOpen(path, NULL);
+	if (snapshot == NULL) {
+		return NULL;
+	}
+
+	EventManager em = NULL;
+	Date date = dateFromOrdinal(snapshotGetCurrentDate(snapshot));
+	if (date != NULL) {
+		em = createEventManagerWithBackend(date, snapshotGetBackend(snapshot));
+		dateDestroy(date);
+	}
+	if (em != NULL && loadSnapshot(em, snapshot) != EM_SUCCESS) {
+		destroyEventManager(em);
+		em = NULL;
+	}
+	snapshotClose(snapshot);
+	return em;
+}
+
+EventManager emOpenSnapshot(const char* path)
+{
+	if (path == NULL) {
+		return NULL;
+	}
+	Snapshot snapshot = snapshotMap(path, NULL);
+	if (snapshot == NULL || !checkBase(snapshot)) {
+		snapshotClose(snapshot);
+		return NULL;
+	}
+
+	EventManager em = NULL;
+	Date date = dateFromOrdinal(snapshotGetCurrentDate(snapshot));
+	if (date != NULL) {
+		em = createEventManagerWithBackend(date, snapshotGetBackend(snapshot));
+		dateDestroy(date);
+	}
+	if (em == NULL) {
+		snapshotClose(snapshot);
+		return NULL;
+	}
+	em->base = snapshot;
+	em->base_events_count = snapshotGetEventsCount(snapshot);
+	em->base_members_count = snapshotGetMembersCount(snapshot);
+	//calloc only reserves zeroed pages, so startup doesn't depend on the size of the snapshot.
+	em->base_overrides = calloc(em->base_events_count + 1, sizeof(*em->base_overrides));
+	em->base_events_removed = calloc(em->base_events_count + 1, sizeof(*em->base_events_removed));
+	em->base_members_copied = calloc(em->base_members_count + 1, sizeof(*em->base_members_copied));
+	if (em->base_overrides == NULL || em->base_events_removed == NULL || em->base_members_copied == NULL) {
+		destroyEventManager(em);
+		return NULL;
+	}
+	return em;
+}
+
+EventManagerResult emApplyBatch(EventManager em, const EventManagerBatchOp* ops, int ops_count,
+	EventManagerResult* results)
+{
+	if (em == NULL || ops_count < 0 || (ops == NULL && ops_count > 0)) {
+		return EM_NULL_ARGUMENT;
+	}
+	EventManagerResult* op_results = results != NULL ? results : malloc(sizeof(*op_results) * (ops_count + 1));
+	if (op_results == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = applyBatch(em, ops, ops_count, op_results);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_APPLY_BATCH, start_time);
+	unlock(em);
+	if (op_results != results) {
+		free(op_results);
+	}
+	return res;
+}
+
+EventManagerResult emGetMemberEvents(EventManager em, int member_id, int** event_ids, int* count)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = getMemberEvents(em, member_id, event_ids, count);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_GET_MEMBER_EVENTS, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emEnableJournal(EventManager em, const char* path, int group_size, int group_interval_ms)
+{
+	if (em == NULL || path == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = EM_SUCCESS;
+	if (em->journal != NULL) {
+		res = EM_ERROR;
+	}
+	else {
+		em->journal = journalOpen(path, group_size, group_interval_ms);
+		if (em->journal == NULL) {
+			res = EM_ERROR;
+		}
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ENABLE_JOURNAL, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emSyncJournal(EventManager em)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = EM_SUCCESS;
+	if (em->journal != NULL && journalSync(em->journal) != JOURNAL_SUCCESS) {
+		res = EM_ERROR;
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_SYNC_JOURNAL, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emDisableJournal(EventManager em)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = EM_SUCCESS;
+	if (em->journal != NULL && journalSync(em->journal) != JOURNAL_SUCCESS) {
+		res = EM_ERROR;
+	}
+	journalClose(em->journal);
+	em->journal = NULL;
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_DISABLE_JOURNAL, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emReplayJournal(EventManager em, const char* path)
+{
+	if (em == NULL || path == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	JournalResult replay_res = journalReplay(path, replayRecord, em, NULL);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_REPLAY_JOURNAL, start_time);
+	unlock(em);
+	if (replay_res == JOURNAL_SUCCESS) {
+		return EM_SUCCESS;
+	}
+	return replay_res == JOURNAL_OUT_OF_MEMORY ? EM_OUT_OF_MEMORY : EM_ERROR;
+}
+
+EventManagerResult emEnableChangeFeed(EventManager em, int capacity)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockWrite(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = EM_SUCCESS;
+	if (em->changes != NULL || capacity < 1) {
+		res = EM_ERROR;
+	}
+	else {
+		em->changes = changeFeedCreate(capacity, em->names, em->allocator);
+		if (em->changes == NULL) {
+			res = EM_OUT_OF_MEMORY;
+		}
+	}
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_ENABLE_CHANGE_FEED, start_time);
+	unlock(em);
+	return res;
+}
+
+long long emGetChangeSequence(EventManager em)
+{
+	if (em == NULL) {
+		return 0;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	long long sequence = changeFeedGetLast(em->changes);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_GET_CHANGE_SEQUENCE, start_time);
+	unlock(em);
+	return sequence;
+}
+
+EventManagerResult emExportChanges(EventManager em, long long since, const char* file_name, long long* last)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	long long start_time = latencyStart(em);
+	lockRead(em);
+	STATS_BEGIN(start);
+	EventManagerResult res = exportChanges(em, since, file_name, last);
+	STATS_END(&em->stats, start);
+	latencyEnd(em, LATENCY_EXPORT_CHANGES, start_time);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emEnableLatencyTracking(EventManager em)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	if (em->latency != NULL) {
+		return EM_SUCCESS;
+	}
+	em->latency = latencyRecorderCreate(LATENCY_OPERATIONS_COUNT);
+	return em->latency == NULL ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+}
+
+EventManagerResult emDumpLatencyReport(EventManager em, FILE* stream)
+{
+	if (em == NULL || stream == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	lockWrite(em); //Keeps the other threads from recording while their histograms are merged.
+	EventManagerResult res = dumpLatency(em, stream, false);
+	unlock(em);
+	return res;
+}
+
+EventManagerResult emDumpLatencyCsv(EventManager em, FILE* stream)
+{
+	if (em == NULL || stream == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	lockWrite(em);
+	EventManagerResult res = dumpLatency(em, stream, true);
+	unlock(em);
+	return res;
+}
+
+void emResetLatency(EventManager em)
+{
+	if (em == NULL) {
+		return;
+	}
+	lockWrite(em);
+	latencyRecorderReset(em->latency);
+	unlock(em);
+}
+
+bool emGetStats(EventManager em, OperationStats* stats)
+{
+	if (em == NULL || stats == NULL) {
+		return false;
+	}
+	lockRead(em);
+	*stats = em->stats;
+	unlock(em);
+	return statsEnabled();
+}
+
+void emResetStats(EventManager em)
+{
+	if (em == NULL) {
+		return;
+	}
+	lockWrite(em);
+	statsReset(&em->stats);
+	unlock(em);
+}
+
+/* =---------------------------------------------------------------------------=
+
+						Unlocked Event Manager Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static EventManagerResult addEventByDate(EventManager em, char* event_name, Date date, int event_id)
+{
+	if (em == NULL || event_name == NULL || date == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (dateCompareEarliest(em->current_date, date) == SECOND_ELEMENT_BIGGER) {
+		return EM_INVALID_DATE;
+	}
+	else if (event_id < 0) {
+		return EM_INVALID_EVENT_ID;
+	}
+
+	int res = checkEventQueue(em, event_name, date);
+	if (res != EM_SUCCESS) {
+		return res;
+	}
+	Event ptr = findEvent(em, event_id);
+	if (ptr != NULL || findBaseEvent(em, event_id) != NO_INDEX) {
+		return EM_EVENT_ID_ALREADY_EXISTS;
+	}
+	Event event = eventCreateInterned(event_name, event_id, date, em->allocator, em->names);
+	assert(event != NULL);
+	if (event == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+
+	res = eventsInsert(em, event, date);
+	eventDestroy(event);
+	if (res == EM_SUCCESS) {
+		changeFeedAppend(em->changes, CHANGE_EVENT_ADDED, event_id, dateToOrdinal(date), event_name);
+	}
+	return res;
+}
+
+static EventManagerResult addEventByDiff(EventManager em, char* event_name, int days, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	if (days < 0) {
+		return EM_INVALID_DATE;
+	}
+
+	Date date = dateCopy(em->current_date);
+	assert(date != NULL);
+	if (date == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	for (int i = 0; i < days; i++)
+	{
+		dateTick(date);
+	}
+
+	int res = addEventByDate(em, event_name, date, event_id);
+	dateDestroy(date);
+	return res;
+}
+
+static EventManagerResult removeEvent(EventManager em, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (event_id < 0) {
+		return EM_INVALID_EVENT_ID;
+	}
+
+	if (findEvent(em, event_id) == NULL && findBaseEvent(em, event_id) == NO_INDEX) {
+		return EM_EVENT_NOT_EXISTS;
+	}
+	if (copyBaseEvent(em, event_id) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	Event ptr = findEvent(em, event_id);
+	if (unlinkEventMembers(em, ptr) != EM_SUCCESS || eventsRemove(em, ptr) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	changeFeedAppend(em->changes, CHANGE_EVENT_REMOVED, event_id, 0, NULL);
+	return EM_SUCCESS;
+}
+
+static EventManagerResult changeEventDate(EventManager em, int event_id, Date new_date)
+{
+	if (em == NULL || new_date == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (dateCompare(em->current_date, new_date) > 0) {
+		return EM_INVALID_DATE;
+	}
+	else if (event_id < 0) {
+		return EM_INVALID_EVENT_ID;
+	}
+
+	Event event = findEvent(em, event_id);
+	int base_index = event == NULL ? findBaseEvent(em, event_id) : NO_INDEX;
+	if (event == NULL && base_index == NO_INDEX) {
+		return EM_EVENT_ID_NOT_EXISTS;
+	}
+	const char* event_name = event != NULL ? eventGetNameView(event) :
+		snapshotGetString(em->base, snapshotGetEvent(em->base, base_index).name);
+	int res = checkEventQueue(em, event_name, new_date);
+	if (res != EM_SUCCESS) {
+		return res;
+	}
+	if (copyBaseEvent(em, event_id) != EM_SUCCESS) { //Only copied once the date can change.
+		return EM_OUT_OF_MEMORY;
+	}
+	event = findEvent(em, event_id);
+
+	Date event_date = eventGetDate(event);
+	if (event_date == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	res = eventSetDate(event, new_date);
+	if (res != EVENT_SUCCESS) {
+		dateDestroy(event_date);
+		return EM_OUT_OF_MEMORY;
+	}
+
+	res = eventsChangeDate(em, event, event_date, new_date);
+	dateDestroy(event_date);
+	if (res == EM_SUCCESS) {
+		changeFeedAppend(em->changes, CHANGE_EVENT_DATE_CHANGED, event_id, dateToOrdinal(new_date), NULL);
+	}
+	return res;
+}
+
+static EventManagerResult addMember(EventManager em, char* member_name, int member_id)
+{
+	if (em == NULL || member_name == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (member_id < 0) {
+		return EM_INVALID_MEMBER_ID;
+	}
+
+	if (findMember(em, member_id) != NO_INDEX || findBaseMember(em, member_id) != NO_INDEX) {
+		return EM_MEMBER_ID_ALREADY_EXISTS;
+	}
+	if (memberTableAdd(em->members, member_id, member_name, NULL, 0) == MEMBER_TABLE_NO_INDEX) {
+		return EM_OUT_OF_MEMORY;
+	}
+	changeFeedAppend(em->changes, CHANGE_MEMBER_ADDED, member_id, 0, member_name);
+	return EM_SUCCESS;
+}
+
+static EventManagerResult addMemberToEvent(EventManager em, int member_id, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (member_id < 0) {
+		return EM_INVALID_MEMBER_ID;
+	}
+	else if (event_id < 0) {
+		return EM_INVALID_EVENT_ID;
+	}
+
+	Event event = findEvent(em, event_id);
+	int base_index = event == NULL ? findBaseEvent(em, event_id) : NO_INDEX;
+	if (event == NULL && base_index == NO_INDEX) {
+		return EM_EVENT_ID_NOT_EXISTS;
+	}
+	if (findMember(em, member_id) == NO_INDEX && findBaseMember(em, member_id) == NO_INDEX) {
+		return EM_MEMBER_ID_NOT_EXISTS;
+	}
+	if (eventHasMember(em, event, base_index, member_id)) {
+		return EM_EVENT_AND_MEMBER_ALREADY_LINKED;
+	}
+	if (copyBaseEvent(em, event_id) != EM_SUCCESS || copyBaseMember(em, member_id) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	event = findEvent(em, event_id);
+	int member = findMember(em, member_id);
+
+	if (eventAddStudentId(event, member_id) != EVENT_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	if (!memberTableLinkEvent(em->members, member, event_id)) {
+		eventRemoveStudentId(event, member_id);
+		return EM_OUT_OF_MEMORY;
+	}
+	changeFeedAppend(em->changes, CHANGE_MEMBER_LINKED, member_id, event_id, NULL);
+	updateMemberRank(em, member);
+	return EM_SUCCESS;
+}
+
+static EventManagerResult removeMemberFromEvent(EventManager em, int member_id, int event_id)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (event_id < 0) {
+		return EM_INVALID_EVENT_ID;
+	}
+	else if (member_id < 0) {
+		return EM_INVALID_MEMBER_ID;
+	}
+
+	Event event = findEvent(em, event_id);
+	int base_index = event == NULL ? findBaseEvent(em, event_id) : NO_INDEX;
+	if (event == NULL && base_index == NO_INDEX) {
+		return EM_EVENT_ID_NOT_EXISTS;
+	}
+	if (findMember(em, member_id) == NO_INDEX && findBaseMember(em, member_id) == NO_INDEX) {
+		return EM_MEMBER_ID_NOT_EXISTS;
+	}
+	if (!eventHasMember(em, event, base_index, member_id)) {
+		return EM_EVENT_AND_MEMBER_NOT_LINKED;
+	}
+	if (copyBaseEvent(em, event_id) != EM_SUCCESS || copyBaseMember(em, member_id) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	event = findEvent(em, event_id);
+	int member = findMember(em, member_id);
+
+	if (eventRemoveStudentId(event, member_id) != EVENT_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+	memberTableUnlinkEvent(em->members, member, event_id);
+	changeFeedAppend(em->changes, CHANGE_MEMBER_UNLINKED, member_id, event_id, NULL);
+	updateMemberRank(em, member);
+	return EM_SUCCESS;
+}
+
+static EventManagerResult tick(EventManager em, int days)
+{
+	if (em == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	if (days <= 0) {
+		return EM_INVALID_DATE;
+	}
+
+	for (int i = 0; i < days; i++)
+	{
+		dateTick(em->current_date);
+	}
+	if (expireBaseEvents(em) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
+	}
+
+	if (em->backend != EM_BACKEND_TIMING_WHEEL) {
+		return expireQueueEvents(em);
+	}
+	int res = updateEventQueue(em);
+	while (res == EVENT_REMOVED) {  //Only the earliest event is checked, so each removal is O(1) for the wheel.
+		res = updateEventQueue(em);
+	}
+
+	if (res == EVENT_QUEUE_UPDATED) {
+		return EM_SUCCESS;
+	}
+	else {
+		return EM_OUT_OF_MEMORY;
+	}
+}
+
+static int getEventsAmount(EventManager em)
+{
+	if (em == NULL) {
+		return NO_SIZE;
+	}
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) {
+		return twGetSize(em->events_wheel) + em->base_events_count;
+	}
+	return pqGetSize(em->events) + em->base_events_count;
+}
+
+static char* getNextEvent(EventManager em)
+{
+	if (em == NULL) {
+		return NULL;
+	}
+	ViewCursor cursor;
+	EventView view;
+	if (!eventsFirstView(em, &cursor, &view)) {
+		return NULL;
+	}
+	return (char*)view.name; //Base names are read only, like the names of the events backend.
+}
+
+static void printAllEvents(EventManager em, const char* file_name)
+{
+	if (em == NULL || file_name == NULL) {
+		return;
+	}
+	//Without the memory for the buffers the events are printed by this thread alone, the output is the same.
+	if (em->report_threads > 1 && printAllEventsParallel(em, file_name) != EM_OUT_OF_MEMORY) {
+		return;
+	}
+
+	FILE* fd = fopen(file_name, "w");
+	if (fd == NULL) {
+		return;
+	}
+	ViewCursor cursor;
+	EventView view;
+	for (bool found = eventsFirstView(em, &cursor, &view); found; found = eventsNextView(em, &cursor, &view)) {
+		int day = 0, month = 0, year = 0;
+		ordinalGet(view.date, &day, &month, &year);
+
+		fprintf(fd, "%s,%d.%d.%d", view.name, day, month, year);
+		eventPrintStudentList(em, &view, fd);
+		fprintf(fd, "\n");
+	}
+	fclose(fd);
+}
+
+static void printAllResponsibleMembers(EventManager em, const char* file_name)
+{
+	if (em == NULL || file_name == NULL) {
+		return;
+	}
+
+	FILE* fd = fopen(file_name, "w");
+	if (fd == NULL) {
+		return;
+	}
+	MemberViewCursor cursor;
+	MemberView view;
+	for (bool found = membersFirstView(em, &cursor, &view); found; found = membersNextView(em, &cursor, &view)) {
+		if (view.event_count == 0) {
+			break;
+		}
+		fprintf(fd, "%s,%d\n", view.name, view.event_count);
+	}
+	fclose(fd);
+}
+
+static EventManagerResult printAllEventsAsync(EventManager em, const char* file_name, EventManagerExport* report)
+{
+	if (file_name == NULL || report == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	ReportChunk chunks[MAX_REPORT_THREADS];
+	int chunks_count = 0;
+	if (formatAllEvents(em, chunks, &chunks_count) != EM_SUCCESS) {
+		for (int i = 0; i < chunks_count; i++) {
+			free(chunks[i].buffer);
+		}
+		return EM_OUT_OF_MEMORY;
+	}
+	return startReportWriter(file_name, chunks, chunks_count, report);
+}
+
+static EventManagerResult printAllResponsibleMembersAsync(EventManager em, const char* file_name,
+	EventManagerExport* report)
+{
+	if (file_name == NULL || report == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	ReportChunk chunk;
+	if (formatAllResponsibleMembers(em, &chunk) != EM_SUCCESS) {
+		free(chunk.buffer);
+		return EM_OUT_OF_MEMORY;
+	}
+	return startReportWriter(file_name, &chunk, 1, report);
+}
+
+static EventManagerResult exportChanges(EventManager em, long long since, const char* file_name, long long* last)
+{
+	if (file_name == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (em->changes == NULL || since < 0 || since + 1 < changeFeedGetFirst(em->changes)) {
+		return EM_ERROR;
+	}
+
+	FILE* fd = fopen(file_name, "w");
+	if (fd == NULL) {
+		return EM_ERROR;
+	}
+	long long end = changeFeedGetLast(em->changes);
+	bool written = true;
+	ChangeRecord record;
+	for (long long sequence = since + 1; sequence <= end && written; sequence++) {
+		written = changeFeedGet(em->changes, sequence, &record) && writeChange(fd, &record);
+	}
+	written = fclose(fd) == 0 && written;
+	if (last != NULL) {
+		*last = end;
+	}
+	return written ? EM_SUCCESS : EM_ERROR;
+}
+
+static bool writeChange(FILE* file, const ChangeRecord* record)
+{
+	int written = fprintf(file, "%lld,%s,%d", record->sequence, change_type_names[record->type], record->id);
+	if (record->type == CHANGE_EVENT_ADDED || record->type == CHANGE_EVENT_DATE_CHANGED) {
+		int day = 0, month = 0, year = 0;
+		ordinalGet(record->value, &day, &month, &year);
+		written = written < 0 ? written : fprintf(file, ",%d.%d.%d", day, month, year);
+	}
+	else if (record->type != CHANGE_EVENT_REMOVED && record->type != CHANGE_MEMBER_ADDED) {
+		written = written < 0 ? written : fprintf(file, ",%d", record->value);
+	}
+	if (record->name != NULL) {
+		written = written < 0 ? written : fprintf(file, ",%s", record->name);
+	}
+	return written >= 0 && fprintf(file, "\n") >= 0;
+}
+
+static EventManagerResult saveSnapshot(EventManager em, const char* path)
+{
+	if (em == NULL || path == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+
+	SnapshotContent content = { em->backend, dateToOrdinal(em->current_date), strTableCreate(),
+		NULL, memberTableGetSize(em->members) + em->base_members_count, NULL, getEventsAmount(em), NULL, 0 };
+	ViewCursor cursor;
+	EventView view;
+	for (bool found = eventsFirstView(em, &cursor, &view); found; found = eventsNextView(em, &cursor, &view)) {
+		if (view.event == NULL) {
+			content.member_ids_count += snapshotGetEvent(em->base, view.base_index).members_count;
+		}
+		int ids_count = 0;
+		eventGetStudentIds(view.event, &ids_count);
+		content.member_ids_count += ids_count;
+	}
+	content.members = malloc(sizeof(*content.members) * content.members_count);
+	content.events = malloc(sizeof(*content.events) * content.events_count);
+	content.member_ids = malloc(sizeof(*content.member_ids) * content.member_ids_count);
+
+	EventManagerResult res = EM_OUT_OF_MEMORY;
+	if (content.names != NULL && (content.members != NULL || content.members_count == 0) &&
+		(content.events != NULL || content.events_count == 0) &&
+		(content.member_ids != NULL || content.member_ids_count == 0)) {
+		res = fillSnapshotContent(em, &content);
+	}
+	if (res == EM_SUCCESS) {
+		SnapshotResult save_res = snapshotSave(path, &content);
+		if (save_res == SNAPSHOT_OUT_OF_MEMORY) {
+			res = EM_OUT_OF_MEMORY;
+		}
+		else if (save_res != SNAPSHOT_SUCCESS) {
+			res = EM_ERROR;
+		}
+	}
+
+	strTableDestroy(content.names);
+	free(content.members);
+	free(content.events);
+	free(content.member_ids);
+	return res;
+}
+
+static EventManagerResult applyBatch(EventManager em, const EventManagerBatchOp* ops, int ops_count,
+	EventManagerResult* results)
+{
+	Batch batch;
+	batch.entries = malloc(sizeof(*batch.entries) * (ops_count + 1));
+	batch.members = malloc(sizeof(*batch.members) * (ops_count + 1));
+	batch.ids = malloc(sizeof(*batch.ids) * (ops_count + 1));
+	batch.linked = malloc(sizeof(*batch.linked) * (ops_count + 1));
+	batch.added_ids = malloc(sizeof(*batch.added_ids) * (ops_count + 1));
+	batch.removed_ids = malloc(sizeof(*batch.removed_ids) * (ops_count + 1));
+	batch.members_count = 0;
+	bool allocated = batch.entries != NULL && batch.members != NULL && batch.ids != NULL &&
+		batch.linked != NULL && batch.added_ids != NULL && batch.removed_ids != NULL;
+
+	int count = 0;
+	for (int i = 0; i < ops_count; i++) {
+		results[i] = checkBatchOp(&ops[i]);
+		if (results[i] == EM_SUCCESS && !allocated) {
+			results[i] = EM_OUT_OF_MEMORY;
+		}
+		else if (results[i] == EM_SUCCESS) {
+			batch.entries[count].event_id = ops[i].event_id;
+			batch.entries[count].member_id = ops[i].member_id;
+			batch.entries[count].index = i;
+			count++;
+		}
+	}
+
+	EventManagerResult res = allocated ? EM_SUCCESS : EM_OUT_OF_MEMORY, journal_res = EM_SUCCESS;
+	int applied = 0;
+	if (allocated) {
+		qsort(batch.entries, count, sizeof(*batch.entries), batchEntryCompare);
+		res = findBatchMembers(em, &batch, count);
+	}
+	while (applied < count && res == EM_SUCCESS) {
+		int event_id = batch.entries[applied].event_id, last = applied;
+		while (last < count && batch.entries[last].event_id == event_id) {
+			last++;
+		}
+		res = copyBaseEvent(em, event_id);
+		Event event = res == EM_SUCCESS ? findEvent(em, event_id) : NULL;
+		if (res == EM_SUCCESS && event == NULL) {
+			for (int i = applied; i < last; i++) {
+				results[batch.entries[i].index] = EM_EVENT_ID_NOT_EXISTS;
+			}
+		}
+		else if (res == EM_SUCCESS) {
+			res = applyBatchEvent(em, event, &batch, applied, last, ops, results);
+			if (journalOperationEnd(em, res) != res) { //The event was changed, but the journal couldn't be written.
+				journal_res = EM_ERROR;
+			}
+		}
+		applied = res == EM_SUCCESS ? last : applied;
+	}
+	for (int i = applied; i < count; i++) {
+		results[batch.entries[i].index] = res;
+	}
+
+	//Every member is moved in the ranking once, by its net change.
+	for (int i = 0; i < batch.members_count; i++) {
+		if (batch.members[i].index != NO_INDEX) {
+			updateMemberRank(em, batch.members[i].index);
+		}
+	}
+	free(batch.entries);
+	free(batch.members);
+	free(batch.ids);
+	free(batch.linked);
+	free(batch.added_ids);
+	free(batch.removed_ids);
+	return res == EM_SUCCESS ? journal_res : res;
+}
+
+static EventManagerResult getMemberEvents(EventManager em, int member_id, int** event_ids, int* count)
+{
+	if (event_ids == NULL || count == NULL) {
+		return EM_NULL_ARGUMENT;
+	}
+	else if (member_id < 0) {
 		return EM_INVALID_MEMBER_ID;
 	}
-	else if (event_id < 0) {
-		return EM_INVALID_EVENT_ID;
+
+	int member = findMember(em, member_id), base_member = NO_INDEX;
+	int member_count = 0;
+	const int* member_events = NULL;
+	if (member != NO_INDEX) {
+		member_events = memberTableGetEvents(em->members, member, &member_count);
+	}
+	else {
+		base_member = findBaseMember(em, member_id);
+		if (base_member == NO_INDEX) {
+			return EM_MEMBER_ID_NOT_EXISTS;
+		}
+		member_count = snapshotGetMember(em->base, base_member).event_count;
+	}
+
+	*event_ids = NULL;
+	*count = 0;
+	if (member_count == 0) {
+		return EM_SUCCESS;
+	}
+	int* ids = malloc(sizeof(*ids) * member_count);
+	if (ids == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	if (member_events != NULL) {
+		memcpy(ids, member_events, sizeof(*ids) * member_count);
+	}
+	else { //A base member that wasn't copied is only read, the read lock doesn't allow copying it.
+		member_count = collectMemberEvents(em, member_id, ids);
+	}
+	*event_ids = ids;
+	*count = member_count;
+	return EM_SUCCESS;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+
+static int dateCompareEarliest(Date date1, Date date2)
+{
+	return (REVERSE_PRIORITY * dateCompare(date1, date2));
+}
+
+static int intCompare(int num1, int num2)
+{
+	if (num1 > num2) {
+		return FIRST_ELEMENT_BIGGER;
+	}
+	else if (num1 < num2) {
+		return SECOND_ELEMENT_BIGGER;
+	}
+	else {
+		return EQUAL_ELEMENTS;
+	}
+}
+
+static Date queueDateCreate(EventManager em, Date date)
+{
+	return em->allocator == NULL ? date : dateCopyWithAllocator(date, em->allocator);
+}
+
+static void queueDateDestroy(EventManager em, Date date)
+{
+	if (em->allocator != NULL) {
+		dateDestroy(date);
+	}
+}
+
+static EventManagerResult checkEventQueue(EventManager em, const char* event_name, Date event_date)
+{
+	EventsCursor cursor;
+	EVENTS_FOREACH(current_event, cursor, em) {
+		if (!strcmp(event_name, eventGetNameView(current_event)) && !dateCompare(event_date, eventGetDateView(current_event))) {
+			return EM_EVENT_ALREADY_EXISTS;
+		}
+	}
+
+	if (em->base != NULL) {
+		int date = dateToOrdinal(event_date);
+		for (int i = em->base_first_event; i < snapshotGetEventsCount(em->base); i++) {
+			SnapshotEvent base_event = snapshotGetEvent(em->base, i);
+			if (!em->base_events_removed[i] && base_event.date == date &&
+				!strcmp(event_name, snapshotGetString(em->base, base_event.name))) {
+				return EM_EVENT_ALREADY_EXISTS;
+			}
+		}
+	}
+	return EM_SUCCESS;
+}
+
+static Event findEvent(EventManager em, int event_id)
+{
+	EventsCursor cursor;
+	EVENTS_FOREACH(ptr, cursor, em) {
+		if (eventGetId(ptr) == event_id) {
+			return ptr;
+		}
+	}
+	int index = findBaseEvent(em, event_id);
+	return index == NO_INDEX ? NULL : em->base_overrides[index]; //Only copied base events are returned.
+}
+
+static int findMember(EventManager em, int member_id)
+{
+	int index = memberTableFind(em->members, member_id);
+	return index == MEMBER_TABLE_NO_INDEX ? NO_INDEX : index;
+}
+
+static void eventPrintStudentList(EventManager em, EventView* view, FILE* stream)
+{
+	if (view->event == NULL) {
+		SnapshotEvent base_event = snapshotGetEvent(em->base, view->base_index);
+		for (int i = 0; i < base_event.members_count; i++) {
+			printMemberName(em, snapshotGetMemberId(em->base, base_event.first_member + i), stream);
+		}
+		return;
+	}
+
+	int ids_count = 0;
+	const int* ids = eventGetStudentIds(view->event, &ids_count);
+	for (int i = 0; i < ids_count; i++) {
+		printMemberName(em, ids[i], stream);
+	}
+}
+
+static EventManagerResult printAllEventsParallel(EventManager em, const char* file_name)
+{
+	ReportChunk chunks[MAX_REPORT_THREADS];
+	int chunks_count = 0;
+	EventManagerResult res = formatAllEvents(em, chunks, &chunks_count);
+	FILE* fd = res == EM_SUCCESS ? fopen(file_name, "w") : NULL;
+	if (res == EM_SUCCESS && fd == NULL) {
+		res = EM_ERROR;
+	}
+	for (int i = 0; i < chunks_count && fd != NULL; i++) {
+		if (chunks[i].size > 0) { //The buffer of an empty range may be NULL.
+			fwrite(chunks[i].buffer, 1, chunks[i].size, fd);
+		}
+	}
+	if (fd != NULL) {
+		fclose(fd);
+	}
+	for (int i = 0; i < chunks_count; i++) {
+		free(chunks[i].buffer);
+	}
+	return res;
+}
+
+static EventManagerResult formatAllEvents(EventManager em, ReportChunk* chunks, int* chunks_count)
+{
+	*chunks_count = 0;
+	int events_count = getEventsAmount(em);
+	EventView* views = malloc(sizeof(*views) * (events_count + 1));
+	long long* costs = malloc(sizeof(*costs) * (events_count + 1)); //The members of the events before each event.
+	int names_count = 0;
+	MemberName* names = createMemberNames(em, &names_count);
+	if (views == NULL || costs == NULL || names == NULL) {
+		free(views);
+		free(costs);
+		free(names);
+		return EM_OUT_OF_MEMORY;
+	}
+
+	int count = 0;
+	ViewCursor cursor;
+	costs[0] = 0;
+	for (bool found = eventsFirstView(em, &cursor, &views[count]); found && count < events_count;
+		found = eventsNextView(em, &cursor, &views[count])) {
+		int ids_count = 0;
+		if (views[count].event == NULL) {
+			ids_count = snapshotGetEvent(em->base, views[count].base_index).members_count;
+		}
+		else {
+			eventGetStudentIds(views[count].event, &ids_count);
+		}
+		costs[count + 1] = costs[count] + 1 + ids_count; //Every line costs about one name per member.
+		count++;
+	}
+
+	//The ranges split the cost evenly, and the first one is formatted by this thread.
+	int threads_count = em->report_threads < count ? em->report_threads : (count > 0 ? count : 1);
+	pthread_t threads[MAX_REPORT_THREADS];
+	bool started[MAX_REPORT_THREADS];
+	for (int i = 0, first = 0; i < threads_count; i++) {
+		int last = first;
+		while (last < count && costs[last + 1] * threads_count <= costs[count] * (i + 1)) {
+			last++;
+		}
+		last = i == threads_count - 1 ? count : last;
+		ReportChunk chunk = { em, views, first, last, names, names_count, NULL, 0, 0, false };
+		chunks[i] = chunk;
+		started[i] = i > 0 && pthread_create(&threads[i], NULL, formatReportChunk, &chunks[i]) == 0;
+		first = last;
+	}
+	for (int i = 0; i < threads_count; i++) {
+		if (started[i]) {
+			pthread_join(threads[i], NULL);
+		}
+		else { //Also the ranges whose thread couldn't be started.
+			formatReportChunk(&chunks[i]);
+		}
+	}
+
+	EventManagerResult res = EM_SUCCESS;
+	for (int i = 0; i < threads_count; i++) {
+		if (chunks[i].failed) {
+			res = EM_OUT_OF_MEMORY;
+		}
+	}
+	*chunks_count = threads_count;
+	free(views);
+	free(costs);
+	free(names);
+	return res;
+}
+
+static EventManagerResult formatAllResponsibleMembers(EventManager em, ReportChunk* chunk)
+{
+	ReportChunk empty = { em, NULL, 0, 0, NULL, 0, NULL, 0, 0, false };
+	*chunk = empty;
+	MemberViewCursor cursor;
+	MemberView view;
+	for (bool found = membersFirstView(em, &cursor, &view); found; found = membersNextView(em, &cursor, &view)) {
+		if (view.event_count == 0) {
+			break;
+		}
+		char count[COUNT_TEXT_SIZE];
+		int count_length = snprintf(count, sizeof(count), ",%d\n", view.event_count);
+		if (!reportAppend(chunk, view.name, strlen(view.name)) || !reportAppend(chunk, count, count_length)) {
+			break;
+		}
+	}
+	return chunk->failed ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+}
+
+static EventManagerResult startReportWriter(const char* file_name, ReportChunk* chunks, int chunks_count,
+	EventManagerExport* report)
+{
+	size_t size = 0;
+	for (int i = 0; i < chunks_count; i++) {
+		size += chunks[i].size;
+	}
+	char* buffer = chunks_count == 1 ? chunks[0].buffer : malloc(size + 1);
+	if (buffer == NULL && size > 0) {
+		for (int i = 0; i < chunks_count; i++) {
+			free(chunks[i].buffer);
+		}
+		return EM_OUT_OF_MEMORY;
+	}
+	if (chunks_count > 1) { //The ranges are joined, so the writer gets a single buffer.
+		size_t offset = 0;
+		for (int i = 0; i < chunks_count; i++) {
+			if (chunks[i].size > 0) {
+				memcpy(buffer + offset, chunks[i].buffer, chunks[i].size);
+			}
+			offset += chunks[i].size;
+			free(chunks[i].buffer);
+		}
+	}
+	*report = reportWriterStart(file_name, buffer, size);
+	return *report == NULL ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+}
+
+static MemberName* createMemberNames(EventManager em, int* count)
+{
+	int members_count = memberTableGetSize(em->members);
+	int base_count = em->base == NULL ? 0 : snapshotGetMembersCount(em->base);
+	MemberName* names = malloc(sizeof(*names) * (members_count + base_count + 1));
+	if (names == NULL) {
+		return NULL;
+	}
+	*count = 0;
+	for (int i = 0; i < members_count; i++) {
+		names[*count].id = memberTableGetId(em->members, i);
+		names[(*count)++].name = memberTableGetName(em->members, i);
+	}
+	for (int i = 0; i < base_count; i++) {
+		if (!em->base_members_copied[i]) {
+			SnapshotMember member = snapshotGetMember(em->base, i);
+			names[*count].id = member.id;
+			names[(*count)++].name = snapshotGetString(em->base, member.name);
+		}
+	}
+	qsort(names, *count, sizeof(*names), memberNameCompare);
+	return names;
+}
+
+static int memberNameCompare(const void* name1, const void* name2)
+{
+	return intCompare(((const MemberName*)name1)->id, ((const MemberName*)name2)->id);
+}
+
+static void* formatReportChunk(void* chunk)
+{
+	ReportChunk* report = chunk;
+	EventManager em = report->em;
+	for (int i = report->first; i < report->last && !report->failed; i++) {
+		const EventView* view = &report->views[i];
+		int day = 0, month = 0, year = 0;
+		ordinalGet(view->date, &day, &month, &year);
+		char date[DATE_TEXT_SIZE];
+		int date_length = snprintf(date, sizeof(date), ",%d.%d.%d", day, month, year);
+		if (!reportAppend(report, view->name, strlen(view->name)) || !reportAppend(report, date, date_length)) {
+			break;
+		}
+
+		if (view->event == NULL) {
+			SnapshotEvent base_event = snapshotGetEvent(em->base, view->base_index);
+			for (int j = 0; j < base_event.members_count; j++) {
+				reportAppendMember(report, snapshotGetMemberId(em->base, base_event.first_member + j));
+			}
+		}
+		else {
+			int ids_count = 0;
+			const int* ids = eventGetStudentIds(view->event, &ids_count);
+			for (int j = 0; j < ids_count; j++) {
+				reportAppendMember(report, ids[j]);
+			}
+		}
+		reportAppend(report, "\n", 1);
+	}
+	return NULL;
+}
+
+static bool reportAppend(ReportChunk* chunk, const char* text, size_t length)
+{
+	if (chunk->failed) {
+		return false;
+	}
+	if (chunk->size + length > chunk->capacity) {
+		size_t capacity = chunk->capacity == 0 ? INITIAL_REPORT_BUFFER_SIZE : chunk->capacity;
+		while (capacity < chunk->size + length) {
+			capacity *= 2;
+		}
+		char* buffer = realloc(chunk->buffer, capacity);
+		if (buffer == NULL) {
+			chunk->failed = true;
+			return false;
+		}
+		chunk->buffer = buffer;
+		chunk->capacity = capacity;
+	}
+	memcpy(chunk->buffer + chunk->size, text, length);
+	chunk->size += length;
+	return true;
+}
+
+static bool reportAppendMember(ReportChunk* chunk, int member_id)
+{
+	MemberName key = { member_id, NULL };
+	MemberName* member = bsearch(&key, chunk->names, chunk->names_count, sizeof(*chunk->names), memberNameCompare);
+	assert(member != NULL);
+	if (member == NULL) {
+		return true;
 	}
+	return reportAppend(chunk, ",", 1) && reportAppend(chunk, member->name, strlen(member->name));
+}
 
-	Event event = findEvent(em->events, event_id);
+static int updateEventQueue(EventManager em)
+{
+	EventsCursor cursor;
+	Event event = eventsGetFirst(em, &cursor); //The events are sorted, so only the earliest can be outdated.
 	if (event == NULL) {
-		return EM_EVENT_ID_NOT_EXISTS;
+		return EVENT_QUEUE_UPDATED;
+	}
+	if (dateCompareEarliest(em->current_date, eventGetDateView(event)) != SECOND_ELEMENT_BIGGER) {
+		return EVENT_QUEUE_UPDATED;
+	}
+	int event_id = eventGetId(event);
+	if (unlinkEventMembers(em, event) != EM_SUCCESS || eventsRemoveFirst(em) != EM_SUCCESS) {
+		return EVENT_QUEUE_OUT_OF_MEMORY;
+	}
+	changeFeedAppend(em->changes, CHANGE_EVENT_REMOVED, event_id, 0, NULL);
+	return EVENT_REMOVED;
+}
+
+static EventManagerResult expireQueueEvents(EventManager em)
+{
+	//The events before the current date are outdated, so the range ends at the day before it.
+	Date last_day = dateFromOrdinal(dateToOrdinal(em->current_date) - 1);
+	if (last_day == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	ExpiredEvents expired = { em, 0, EM_SUCCESS };
+	pqForEachInPriorityRange(em->events, NULL, last_day, expireEvent, &expired);
+	dateDestroy(last_day);
+	for (int i = 0; i < expired.count; i++) { //The visited events are the first ones, so no dates are compared again.
+		pqRemove(em->events);
+	}
+	return expired.result;
+}
+
+static bool expireEvent(void* context, PQElement element, PQElementPriority priority)
+{
+	ExpiredEvents* expired = context;
+	if (unlinkEventMembers(expired->em, element) != EM_SUCCESS) {
+		expired->result = EM_OUT_OF_MEMORY;
+		return false;
+	}
+	expired->count++;
+	changeFeedAppend(expired->em->changes, CHANGE_EVENT_REMOVED, eventGetId(element), 0, NULL);
+	return true;
+}
+
+static EventManagerResult unlinkEventMembers(EventManager em, Event event)
+{
+	int ids_count = 0;
+	const int* ids = eventGetStudentIds(event, &ids_count);
+	for (int i = 0; i < ids_count; i++) {
+		if (unlinkMember(em, ids[i], eventGetId(event)) != EM_SUCCESS) {
+			return EM_OUT_OF_MEMORY;
+		}
+	}
+	return EM_SUCCESS;
+}
+
+static EventManagerResult eventsInsert(EventManager em, Event event, Date date)
+{
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) {
+		return twInsert(em->events_wheel, event, date) == TW_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+	Date priority = queueDateCreate(em, date);
+	int res = priority == NULL ? PQ_OUT_OF_MEMORY : pqInsert(em->events, event, priority);
+	queueDateDestroy(em, priority);
+	return res == PQ_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static EventManagerResult eventsRemove(EventManager em, Event event)
+{
+	int index = findBaseEvent(em, eventGetId(event));
+	if (index != NO_INDEX) {
+		removeBaseEvent(em, index);
+		return EM_SUCCESS;
+	}
+	if (em->backend == EM_BACKEND_PRIORITY_QUEUE) {
+		return pqRemoveElement(em->events, event) == PQ_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+	if (em->backend == EM_BACKEND_BTREE) { //The tree searches only the events of the same date.
+		return pqRemoveElementWithPriority(em->events, event, eventGetDateView(event)) == PQ_SUCCESS ?
+			EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+
+	return twRemoveElement(em->events_wheel, event, eventGetDateView(event)) == TW_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static EventManagerResult eventsRemoveFirst(EventManager em)
+{
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) {
+		return twRemoveFirst(em->events_wheel) == TW_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+	return pqRemove(em->events) == PQ_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static EventManagerResult eventsChangeDate(EventManager em, Event event, Date old_date, Date new_date)
+{
+	int index = findBaseEvent(em, eventGetId(event));
+	if (index != NO_INDEX) { //A moved base event is added to the events backend, like a new one.
+		if (eventsInsert(em, event, new_date) != EM_SUCCESS) {
+			return EM_OUT_OF_MEMORY;
+		}
+		removeBaseEvent(em, index);
+		return EM_SUCCESS;
+	}
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) { //The wheel moves the node itself, without copying.
+		return twChangeDate(em->events_wheel, event, old_date, new_date) == TW_SUCCESS ?
+			EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+
+	Event event_copy = eventCopy(event); //The queue iterator doesn't return a copy.
+	Date priority = event_copy == NULL ? NULL : queueDateCreate(em, new_date);
+	int res = priority == NULL ? PQ_OUT_OF_MEMORY : pqChangePriority(em->events, event_copy, old_date, priority);
+	queueDateDestroy(em, priority);
+	eventDestroy(event_copy);
+	return res == PQ_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static EventManagerResult eventsAppend(EventManager em, Event event, Date date)
+{
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) { //Buckets already keep insertion order.
+		return twInsert(em->events_wheel, event, date) == TW_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+	}
+	Date priority = queueDateCreate(em, date);
+	int res = priority == NULL ? PQ_OUT_OF_MEMORY : pqAppend(em->events, event, priority);
+	queueDateDestroy(em, priority);
+	return res == PQ_SUCCESS ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static Event eventsGetFirst(EventManager em, EventsCursor* cursor)
+{
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) {
+		return twCursorFirst(em->events_wheel, &cursor->wheel_cursor);
+	}
+	return pqCursorFirst(em->events, &cursor->queue_cursor);
+}
+
+static Event eventsGetNext(EventManager em, EventsCursor* cursor)
+{
+	if (em->backend == EM_BACKEND_TIMING_WHEEL) {
+		return twCursorNext(em->events_wheel, &cursor->wheel_cursor);
+	}
+	return pqCursorNext(em->events, &cursor->queue_cursor);
+}
+
+static EventManagerResult fillSnapshotContent(EventManager em, SnapshotContent* content)
+{
+	int index = 0;
+	MemberViewCursor members_cursor;
+	MemberView member_view;
+	for (bool found = membersFirstView(em, &members_cursor, &member_view); found;
+		found = membersNextView(em, &members_cursor, &member_view)) {
+		SnapshotMember* member = &content->members[index++];
+		member->id = member_view.id;
+		member->name = strTableAdd(content->names, member_view.name);
+		member->event_count = member_view.event_count;
+		if (member->name == STRING_TABLE_NO_INDEX) {
+			return EM_OUT_OF_MEMORY;
+		}
+	}
+
+	index = 0;
+	int member_index = 0;
+	ViewCursor cursor;
+	EventView view;
+	for (bool found = eventsFirstView(em, &cursor, &view); found; found = eventsNextView(em, &cursor, &view)) {
+		SnapshotEvent* record = &content->events[index++];
+		record->id = view.event != NULL ? eventGetId(view.event) : snapshotGetEvent(em->base, view.base_index).id;
+		record->name = strTableAdd(content->names, view.name);
+		record->date = view.date;
+		record->first_member = member_index;
+		if (record->name == STRING_TABLE_NO_INDEX) {
+			return EM_OUT_OF_MEMORY;
+		}
+		if (view.event == NULL) {
+			SnapshotEvent base_event = snapshotGetEvent(em->base, view.base_index);
+			for (int i = 0; i < base_event.members_count; i++) {
+				content->member_ids[member_index++] = snapshotGetMemberId(em->base, base_event.first_member + i);
+			}
+		}
+		int ids_count = 0;
+		const int* ids = eventGetStudentIds(view.event, &ids_count);
+		for (int i = 0; i < ids_count; i++) {
+			content->member_ids[member_index++] = ids[i];
+		}
+		record->members_count = member_index - record->first_member;
+	}
+	return index == content->events_count ? EM_SUCCESS : EM_OUT_OF_MEMORY;
+}
+
+static int dateToOrdinal(Date date)
+{
+	int day = 0, month = 0, year = 0;
+	dateGet(date, &day, &month, &year);
+	return (year * MONTHS_IN_YEAR + month - 1) * DAYS_IN_MONTH + day - 1;
+}
+
+static Date dateFromOrdinal(int ordinal)
+{
+	int day = 0, month = 0, year = 0;
+	ordinalGet(ordinal, &day, &month, &year);
+	return dateCreate(day, month, year);
+}
+
+static void ordinalGet(int ordinal, int* day, int* month, int* year)
+{
+	int days_in_year = DAYS_IN_MONTH * MONTHS_IN_YEAR;
+	int day_of_year = ordinal % days_in_year;
+	*year = ordinal / days_in_year;
+	if (day_of_year < 0) { //Rounds toward minus infinity for dates before year 0.
+		(*year)--;
+		day_of_year += days_in_year;
+	}
+	*day = day_of_year % DAYS_IN_MONTH + 1;
+	*month = day_of_year / DAYS_IN_MONTH + 1;
+}
+
+static EventManagerResult loadSnapshot(EventManager em, Snapshot snapshot)
+{
+	int members_count = snapshotGetMembersCount(snapshot);
+	LoadedMember* members = malloc(sizeof(*members) * (members_count > 0 ? members_count : 1));
+	if (members == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+
+	EventManagerResult res = EM_SUCCESS;
+	long long event_ids_count = 0, links_count = 0;
+	for (int i = 0; i < members_count && res == EM_SUCCESS; i++) {
+		SnapshotMember member = snapshotGetMember(snapshot, i);
+		if (member.id < 0 || member.event_count < 0) {
+			res = EM_ERROR;
+			break;
+		}
+		members[i].id = member.id;
+		members[i].event_count = member.event_count;
+		members[i].linked = 0;
+		event_ids_count += member.event_count;
+	}
+	for (int i = 0; i < snapshotGetEventsCount(snapshot); i++) {
+		links_count += snapshotGetEvent(snapshot, i).members_count;
+	}
+	if (res == EM_SUCCESS && (event_ids_count != links_count || event_ids_count > INT_MAX)) {
+		res = EM_ERROR; //The saved counts must add up to the members of the events.
+	}
+
+	//The events of all of the members are gathered in one array, each member owning a range of it.
+	int* event_ids = NULL;
+	if (res == EM_SUCCESS) {
+		event_ids = malloc(sizeof(*event_ids) * (event_ids_count > 0 ? (size_t)event_ids_count : 1));
+		res = event_ids == NULL ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+	}
+	if (res == EM_SUCCESS) {
+		for (int i = 0, offset = 0; i < members_count; i++) {
+			members[i].event_ids = event_ids + offset;
+			offset += members[i].event_count;
+		}
+		qsort(members, members_count, sizeof(*members), loadedMemberCompare);
+		for (int i = 1; i < members_count; i++) {
+			if (members[i - 1].id == members[i].id) {
+				res = EM_ERROR;
+			}
+		}
+	}
+	if (res == EM_SUCCESS) {
+		res = loadSnapshotEvents(em, snapshot, members, members_count);
+	}
+	for (int i = 0; i < members_count && res == EM_SUCCESS; i++) {
+		if (members[i].linked != members[i].event_count) { //The saved counts must match the events.
+			res = EM_ERROR;
+		}
+	}
+	for (int i = 0; i < members_count && res == EM_SUCCESS; i++) {
+		SnapshotMember member = snapshotGetMember(snapshot, i);
+		LoadedMember key = { member.id, 0, 0, NULL };
+		res = loadSnapshotMember(em, snapshotGetString(snapshot, member.name),
+			bsearch(&key, members, members_count, sizeof(*members), loadedMemberCompare));
+	}
+	free(event_ids);
+	free(members);
+	return res;
+}
+
+static EventManagerResult loadSnapshotMember(EventManager em, const char* name, LoadedMember* member)
+{
+	//The events were linked in date order, and their ids were checked to be unique.
+	qsort(member->event_ids, member->event_count, sizeof(*member->event_ids), idCompare);
+	//The snapshot's members are sorted by priority, so each one is ranked last without shifting others.
+	int index = memberTableAdd(em->members, member->id, name, member->event_ids, member->event_count);
+	return index == MEMBER_TABLE_NO_INDEX ? EM_OUT_OF_MEMORY : EM_SUCCESS;
+}
+
+static EventManagerResult loadSnapshotEvents(EventManager em, Snapshot snapshot,
+	LoadedMember* members, int members_count)
+{
+	int events_count = snapshotGetEventsCount(snapshot);
+	int* event_ids = malloc(sizeof(*event_ids) * (events_count > 0 ? events_count : 1));
+	int* member_ids = malloc(sizeof(*member_ids) * (members_count > 0 ? members_count : 1));
+	if (event_ids == NULL || member_ids == NULL) {
+		free(event_ids);
+		free(member_ids);
+		return EM_OUT_OF_MEMORY;
+	}
+
+	EventManagerResult res = EM_SUCCESS;
+	for (int i = 0; i < events_count && res == EM_SUCCESS; i++) {
+		SnapshotEvent record = snapshotGetEvent(snapshot, i);
+		if (record.id < 0 || record.members_count > members_count) {
+			res = EM_ERROR;
+			break;
+		}
+		event_ids[i] = record.id;
+		for (int j = 0; j < record.members_count && res == EM_SUCCESS; j++) {
+			LoadedMember key = { snapshotGetMemberId(snapshot, record.first_member + j), 0, 0, NULL };
+			LoadedMember* member = bsearch(&key, members, members_count, sizeof(*members), loadedMemberCompare);
+			if (member == NULL || member->linked == member->event_count) {
+				res = EM_ERROR;
+				break;
+			}
+			member->event_ids[member->linked++] = record.id;
+			member_ids[j] = key.id;
+		}
+		if (res != EM_SUCCESS) {
+			break;
+		}
+
+		Date date = dateFromOrdinal(record.date);
+		Event event = date == NULL ? NULL :
+			eventCreateInterned((char*)snapshotGetString(snapshot, record.name), record.id, date, em->allocator, em->names);
+		if (event == NULL) {
+			res = EM_OUT_OF_MEMORY;
+		}
+		else {
+			int event_res = eventSetStudentIds(event, member_ids, record.members_count);
+			if (event_res == EVENT_NULL_ARG) { //The ids of an event must be sorted and unique.
+				res = EM_ERROR;
+			}
+			else if (event_res != EVENT_SUCCESS) {
+				res = EM_OUT_OF_MEMORY;
+			}
+			else {
+				res = eventsAppend(em, event, date);
+			}
+		}
+		eventDestroy(event);
+		dateDestroy(date);
 	}
-	Student student = findStudent(em->students, member_id);
-	if (student == NULL) {
-		return EM_MEMBER_ID_NOT_EXISTS;
+	if (res == EM_SUCCESS) {
+		qsort(event_ids, events_count, sizeof(*event_ids), idCompare);
+		for (int i = 1; i < events_count; i++) {
+			if (event_ids[i - 1] == event_ids[i]) {
+				res = EM_ERROR;
+			}
+		}
 	}
+	free(event_ids);
+	free(member_ids);
+	return res;
+}
 
-	int res = eventAddStudentId(event, member_id);
-	if (res == EVENT_STUDENT_ALREDY_LINKED) {
-		return EM_EVENT_AND_MEMBER_ALREADY_LINKED;
-	}
-	else if (res == EVENT_MEMORY_FAIL) {
-		return EM_OUT_OF_MEMORY;
-	}
-	res = changeStudentEventCount(em->students, student, 1);
-	if (res == EM_OUT_OF_MEMORY) {
-		return EM_OUT_OF_MEMORY;
-	}
+static int loadedMemberCompare(const void* member1, const void* member2)
+{
+	return idCompare(&((const LoadedMember*)member1)->id, &((const LoadedMember*)member2)->id);
+}
 
-	return EM_SUCCESS;
+static int idCompare(const void* id1, const void* id2)
+{
+	return intCompare(*(const int*)id1, *(const int*)id2);
 }
 
-EventManagerResult emRemoveMemberFromEvent(EventManager em, int member_id, int event_id)
+static bool eventsFirstView(EventManager em, ViewCursor* cursor, EventView* view)
 {
-	if (em == NULL) {
-		return EM_NULL_ARGUMENT;
-	}
-	else if (event_id < 0) {
-		return EM_INVALID_EVENT_ID;
-	}
-	else if (member_id < 0) {
-		return EM_INVALID_MEMBER_ID;
-	}
+	cursor->next_event = eventsGetFirst(em, &cursor->events_cursor);
+	cursor->next_base = em->base_first_event;
+	return eventsNextView(em, cursor, view);
+}
 
-	Event event = findEvent(em->events, event_id);
-	if (event == NULL) {
-		return EM_EVENT_ID_NOT_EXISTS;
+static bool eventsNextView(EventManager em, ViewCursor* cursor, EventView* view)
+{
+	int base_count = em->base == NULL ? 0 : snapshotGetEventsCount(em->base);
+	while (cursor->next_base < base_count && em->base_events_removed[cursor->next_base]) {
+		cursor->next_base++;
+	}
+	int event_date = 0;
+	if (cursor->next_event != NULL) {
+		event_date = dateToOrdinal(eventGetDateView(cursor->next_event));
+	}
+
+	if (cursor->next_base < base_count) {
+		SnapshotEvent base_event = snapshotGetEvent(em->base, cursor->next_base);
+		if (cursor->next_event == NULL || base_event.date <= event_date) {
+			view->event = em->base_overrides[cursor->next_base];
+			view->base_index = cursor->next_base++;
+			view->date = base_event.date;
+			view->name = snapshotGetString(em->base, base_event.name);
+			return true;
+		}
 	}
-	Student student = findStudent(em->students, member_id);
-	if (student == NULL) {
-		return EM_MEMBER_ID_NOT_EXISTS;
+	if (cursor->next_event == NULL) {
+		return false;
 	}
+	view->event = cursor->next_event;
+	view->base_index = NO_INDEX;
+	view->date = event_date;
+	view->name = eventGetNameView(cursor->next_event);
+	cursor->next_event = eventsGetNext(em, &cursor->events_cursor);
+	return true;
+}
 
-	int res = eventRemoveStudentId(event, member_id);
-	if (res == EVENT_STUDENT_NOT_LINKED) {
-		return EM_EVENT_AND_MEMBER_NOT_LINKED;
-	}
-	else if (res == EVENT_MEMORY_FAIL) {
-		return EM_OUT_OF_MEMORY;
-	}
-	res = changeStudentEventCount(em->students, student, -1);
-	if (res == EM_OUT_OF_MEMORY) {
-		return EM_OUT_OF_MEMORY;
-	}
-	return EM_SUCCESS;
+static bool membersFirstView(EventManager em, MemberViewCursor* cursor, MemberView* view)
+{
+	cursor->next_rank = 0;
+	cursor->next_base = 0;
+	return membersNextView(em, cursor, view);
 }
 
-EventManagerResult emTick(EventManager em, int days)
+static bool membersNextView(EventManager em, MemberViewCursor* cursor, MemberView* view)
 {
-	if (em == NULL) {
-		return EM_NULL_ARGUMENT;
+	int base_count = em->base == NULL ? 0 : snapshotGetMembersCount(em->base);
+	while (cursor->next_base < base_count && em->base_members_copied[cursor->next_base]) {
+		cursor->next_base++;
+	}
+
+	int index = memberTableGetRanked(em->members, cursor->next_rank);
+	if (cursor->next_base < base_count) {
+		SnapshotMember member = snapshotGetMember(em->base, cursor->next_base);
+		if (index == MEMBER_TABLE_NO_INDEX ||
+			intCompare(member.event_count, memberTableGetEventCount(em->members, index)) == FIRST_ELEMENT_BIGGER ||
+			(member.event_count == memberTableGetEventCount(em->members, index) &&
+			member.id < memberTableGetId(em->members, index))) {
+			view->index = NO_INDEX;
+			view->id = member.id;
+			view->event_count = member.event_count;
+			view->name = snapshotGetString(em->base, member.name);
+			cursor->next_base++;
+			return true;
+		}
 	}
-	if (days <= 0) {
-		return EM_INVALID_DATE;
+	if (index == MEMBER_TABLE_NO_INDEX) {
+		return false;
 	}
+	view->index = index;
+	view->id = memberTableGetId(em->members, index);
+	view->event_count = memberTableGetEventCount(em->members, index);
+	view->name = memberTableGetName(em->members, index);
+	cursor->next_rank++;
+	return true;
+}
 
-	for (int i = 0; i < days; i++)
-	{
-		dateTick(em->current_date);
+static void printMemberName(EventManager em, int member_id, FILE* stream)
+{
+	int member = findMember(em, member_id);
+	if (member != NO_INDEX) {
+		fprintf(stream, ",%s", memberTableGetName(em->members, member));
+		return;
 	}
 
-	int res = updateEventQueue(em);
-	while (res == EVENT_REMOVED) {  //We must call the function again because emRemoveEvent changes the iterator.
-		res = updateEventQueue(em);
+	int index = findBaseMember(em, member_id);
+	assert(index != NO_INDEX);
+	if (index != NO_INDEX) {
+		fprintf(stream, ",%s", snapshotGetString(em->base, snapshotGetMember(em->base, index).name));
 	}
+}
 
-	if (res == EVENT_QUEUE_UPDATED) {
-		return EM_SUCCESS;
+static int findBaseEvent(EventManager em, int event_id)
+{
+	if (em->base == NULL) {
+		return NO_INDEX;
 	}
-	else {
-		return EM_OUT_OF_MEMORY;
+	for (int i = em->base_first_event; i < snapshotGetEventsCount(em->base); i++) {
+		if (!em->base_events_removed[i] && snapshotGetEvent(em->base, i).id == event_id) {
+			return i;
+		}
 	}
+	return NO_INDEX;
 }
 
-int emGetEventsAmount(EventManager em)
+static int findBaseMember(EventManager em, int member_id)
 {
-	if (em == NULL) {
-		return NO_SIZE;
+	if (em->base == NULL) {
+		return NO_INDEX;
+	}
+	for (int i = 0; i < snapshotGetMembersCount(em->base); i++) {
+		if (!em->base_members_copied[i] && snapshotGetMember(em->base, i).id == member_id) {
+			return i;
+		}
 	}
-	return pqGetSize(em->events);
+	return NO_INDEX;
 }
 
-char* emGetNextEvent(EventManager em)
+static bool eventHasMember(EventManager em, Event event, int base_index, int member_id)
 {
-	if (em == NULL) {
-		return NULL;
+	if (event != NULL) {
+		return eventHasStudentId(event, member_id);
+	}
+	SnapshotEvent base_event = snapshotGetEvent(em->base, base_index);
+	for (int i = 0; i < base_event.members_count; i++) {
+		if (snapshotGetMemberId(em->base, base_event.first_member + i) == member_id) {
+			return true;
+		}
 	}
-	Event event = pqGetFirst(em->events);
-	return eventGetNamePtr(event);
+	return false;
 }
 
-void emPrintAllEvents(EventManager em, const char* file_name)
+static EventManagerResult copyBaseEvent(EventManager em, int event_id)
 {
-	if (em == NULL || file_name == NULL) {
-		return;
+	int index = findBaseEvent(em, event_id);
+	if (index == NO_INDEX || em->base_overrides[index] != NULL) {
+		return EM_SUCCESS;
 	}
 
-	FILE* fd = fopen(file_name, "w");
-	if (fd == NULL) {
-		return;
+	SnapshotEvent base_event = snapshotGetEvent(em->base, index);
+	int* member_ids = malloc(sizeof(*member_ids) * (base_event.members_count + 1));
+	Date date = dateFromOrdinal(base_event.date);
+	Event event = date == NULL ? NULL :
+		eventCreateInterned((char*)snapshotGetString(em->base, base_event.name), base_event.id, date, em->allocator, em->names);
+	dateDestroy(date);
+	if (member_ids == NULL || event == NULL) {
+		free(member_ids);
+		eventDestroy(event);
+		return EM_OUT_OF_MEMORY;
 	}
-	PQ_FOREACH(Event, event, em->events) {
-		char* name = eventGetName(event);
-		assert(name != NULL);
-		Date date = eventGetDate(event);
-		assert(date != NULL);
 
-		int day = 0, month = 0, year = 0;
-		dateGet(date, &day, &month, &year);
+	for (int i = 0; i < base_event.members_count; i++) {
+		member_ids[i] = snapshotGetMemberId(em->base, base_event.first_member + i);
+	}
+	int res = eventSetStudentIds(event, member_ids, base_event.members_count);
+	free(member_ids);
+	if (res != EVENT_SUCCESS) {
+		eventDestroy(event);
+		return EM_OUT_OF_MEMORY;
+	}
+	em->base_overrides[index] = event;
+	return EM_SUCCESS;
+}
 
-		fprintf(fd, "%s,%d.%d.%d", name, day, month, year);
-		eventPrintStudentList(em->students, eventGetIdList(event), fd);
-		fprintf(fd, "\n");
+static EventManagerResult copyBaseMember(EventManager em, int member_id)
+{
+	int index = findBaseMember(em, member_id);
+	if (index == NO_INDEX) {
+		return EM_SUCCESS;
+	}
 
-		free(name);
-		dateDestroy(date);
+	SnapshotMember member = snapshotGetMember(em->base, index);
+	int* event_ids = malloc(sizeof(*event_ids) * (member.event_count > 0 ? member.event_count : 1));
+	if (event_ids == NULL) {
+		return EM_OUT_OF_MEMORY;
 	}
-	fclose(fd);
+	//checkBase matched the event count to the base events, and a changed event keeps its base members until unlinked.
+	int event_count = collectMemberEvents(em, member.id, event_ids);
+	assert(event_count == member.event_count);
+	int added = memberTableAdd(em->members, member.id, snapshotGetString(em->base, member.name), event_ids, event_count);
+	free(event_ids);
+	if (added == MEMBER_TABLE_NO_INDEX) {
+		return EM_OUT_OF_MEMORY;
+	}
+	em->base_members_copied[index] = true;
+	em->base_members_count--;
+	return EM_SUCCESS;
 }
 
-void emPrintAllResponsibleMembers(EventManager em, const char* file_name)
+static void removeBaseEvent(EventManager em, int index)
 {
-	if (em == NULL || file_name == NULL) {
-		return;
+	eventDestroy(em->base_overrides[index]);
+	em->base_overrides[index] = NULL;
+	em->base_events_removed[index] = true;
+	em->base_events_count--;
+	while (em->base_first_event < snapshotGetEventsCount(em->base) &&
+		em->base_events_removed[em->base_first_event]) {
+		em->base_first_event++;
 	}
+}
 
-	FILE* fd = fopen(file_name, "w");
-	if (fd == NULL) {
-		return;
+static EventManagerResult expireBaseEvents(EventManager em)
+{
+	if (em->base == NULL) {
+		return EM_SUCCESS;
 	}
-	PQ_FOREACH(Student, student, em->students) {
-		int event_count = stGetEventCount(student);
-		if (event_count == 0) {
+	int current_date = dateToOrdinal(em->current_date);
+	while (em->base_first_event < snapshotGetEventsCount(em->base)) { //The base events are sorted by date.
+		int index = em->base_first_event;
+		SnapshotEvent base_event = snapshotGetEvent(em->base, index);
+		if (base_event.date >= current_date) {
 			break;
 		}
-		char* name = stGetName(student);
-		assert(name != NULL);
 
-		fprintf(fd, "%s,%d\n", name, event_count);
-
-		free(name);
+		if (em->base_overrides[index] != NULL) {
+			if (unlinkEventMembers(em, em->base_overrides[index]) != EM_SUCCESS) {
+				return EM_OUT_OF_MEMORY;
+			}
+		}
+		else {
+			for (int i = 0; i < base_event.members_count; i++) {
+				if (unlinkMember(em, snapshotGetMemberId(em->base, base_event.first_member + i), base_event.id) != EM_SUCCESS) {
+					return EM_OUT_OF_MEMORY;
+				}
+			}
+		}
+		removeBaseEvent(em, index);
+		changeFeedAppend(em->changes, CHANGE_EVENT_REMOVED, base_event.id, 0, NULL);
 	}
-	fclose(fd);
+	return EM_SUCCESS;
 }
 
-/* =---------------------------------------------------------------------------=
-
-								Static Functions
-
-   =---------------------------------------------------------------------------=
-*/
-
-
-static int studentPriorityCompare(Pair pair1, Pair pair2)
+static EventManagerResult unlinkMember(EventManager em, int member_id, int event_id)
 {
-
-	assert(pair1 != NULL && pair2 != NULL);
-
-	int* count1 = pairGetFirst(pair1), * count2 = pairGetFirst(pair2);
-	assert(count1 != NULL && count2 != NULL);
-
-	int res = intCompare(*count1, *count2);
-	if (res != EQUAL_ELEMENTS) {
-		free(count1);
-		free(count2);
-		return res;
+	if (copyBaseMember(em, member_id) != EM_SUCCESS) {
+		return EM_OUT_OF_MEMORY;
 	}
-
-	int* id1 = pairGetSecond(pair1), * id2 = pairGetSecond(pair2);
-	assert(id1 != NULL && id2 != NULL);
-
-	res = intCompare(*id2, *id1);
-	//Need to free, because the function allocated memory in the heap.
-	free(count1);
-	free(count2);
-	free(id1);
-	free(id2);
-	return res;
-
+	int member = findMember(em, member_id);
+	assert(member != NO_INDEX);
+	memberTableUnlinkEvent(em->members, member, event_id);
+	changeFeedAppend(em->changes, CHANGE_MEMBER_UNLINKED, member_id, event_id, NULL);
+	updateMemberRank(em, member);
+	return EM_SUCCESS;
 }
 
-static int dateCompareEarliest(Date date1, Date date2)
+static void updateMemberRank(EventManager em, int member)
 {
-	return (REVERSE_PRIORITY * dateCompare(date1, date2));
+	int event_count = memberTableGetEventCount(em->members, member);
+	memberTableUpdateRank(em->members, member);
+	if (memberTableGetEventCount(em->members, member) != event_count) {
+		changeFeedAppend(em->changes, CHANGE_MEMBER_EVENT_COUNT, memberTableGetId(em->members, member),
+			memberTableGetEventCount(em->members, member), NULL);
+	}
 }
 
-static int intCompare(int num1, int num2)
+static int collectMemberEvents(EventManager em, int member_id, int* event_ids)
 {
-	if (num1 > num2) {
-		return FIRST_ELEMENT_BIGGER;
+	int count = 0;
+	ViewCursor cursor;
+	EventView view;
+	for (bool found = eventsFirstView(em, &cursor, &view); found; found = eventsNextView(em, &cursor, &view)) {
+		if (view.event != NULL) {
+			if (eventHasStudentId(view.event, member_id)) {
+				event_ids[count++] = eventGetId(view.event);
+			}
+			continue;
+		}
+		SnapshotEvent base_event = snapshotGetEvent(em->base, view.base_index);
+		for (int i = 0; i < base_event.members_count; i++) { //The member ids of an event are sorted.
+			int id = snapshotGetMemberId(em->base, base_event.first_member + i);
+			if (id >= member_id) {
+				if (id == member_id) {
+					event_ids[count++] = base_event.id;
+				}
+				break;
+			}
+		}
 	}
-	else if (num1 < num2) {
-		return SECOND_ELEMENT_BIGGER;
+	qsort(event_ids, count, sizeof(*event_ids), idCompare);
+	return count;
+}
+
+static bool checkBase(Snapshot snapshot)
+{
+	int members_count = snapshotGetMembersCount(snapshot);
+	LoadedMember* members = malloc(sizeof(*members) * (members_count + 1));
+	if (members == NULL) {
+		return false;
+	}
+	bool valid = true;
+	SnapshotMember previous_member = { 0, 0, 0 };
+	for (int i = 0; i < members_count && valid; i++) {
+		SnapshotMember member = snapshotGetMember(snapshot, i);
+		if (member.id < 0 || member.event_count < 0 || (i > 0 &&
+			(previous_member.event_count < member.event_count ||
+			(previous_member.event_count == member.event_count && previous_member.id >= member.id)))) {
+			valid = false;
+		}
+		members[i].id = member.id;
+		members[i].event_count = member.event_count;
+		members[i].linked = 0;
+		members[i].event_ids = NULL;
+		previous_member = member;
+	}
+	qsort(members, members_count, sizeof(*members), loadedMemberCompare);
+	for (int i = 1; i < members_count && valid; i++) {
+		valid = members[i - 1].id != members[i].id;
+	}
+
+	SnapshotEvent previous_event = { 0, 0, 0, 0, 0 };
+	for (int i = 0; i < snapshotGetEventsCount(snapshot) && valid; i++) {
+		SnapshotEvent base_event = snapshotGetEvent(snapshot, i);
+		if (base_event.id < 0 || (i > 0 && previous_event.date > base_event.date)) {
+			valid = false;
+		}
+		int previous_id = NO_INDEX; //Smaller than every member id.
+		for (int j = 0; j < base_event.members_count && valid; j++) {
+			LoadedMember key = { snapshotGetMemberId(snapshot, base_event.first_member + j), 0, 0, NULL };
+			LoadedMember* member = bsearch(&key, members, members_count, sizeof(*members), loadedMemberCompare);
+			valid = key.id > previous_id && member != NULL;
+			if (valid) {
+				member->linked++;
+			}
+			previous_id = key.id;
+		}
+		previous_event = base_event;
 	}
-	else {
-		return EQUAL_ELEMENTS;
+	for (int i = 0; i < members_count && valid; i++) {
+		valid = members[i].linked == members[i].event_count;
 	}
+	free(members);
+	return valid;
 }
 
-static void* intCopy(void* element)
+static void lockRead(EventManager em)
 {
-	if (element == NULL) {
-		return NULL;
+	if (em->thread_safe) {
+		pthread_rwlock_rdlock(&em->lock);
 	}
+}
 
-	int* new_int = malloc(sizeof(int));
-	if (new_int == NULL) {
-		return NULL;
+static void lockWrite(EventManager em)
+{
+	if (em->thread_safe) {
+		pthread_rwlock_wrlock(&em->lock);
 	}
-	*new_int = *(int*)element;
-	return new_int;
 }
 
-static void intFree(void* num)
+static void unlock(EventManager em)
 {
-	free(num);
+	if (em->thread_safe) {
+		pthread_rwlock_unlock(&em->lock);
+	}
 }
 
-static EventManagerResult checkEventQueue(PriorityQueue events, char* event_name, Date event_date)
+static long long latencyStart(EventManager em)
 {
-	PQ_FOREACH(Event, current_event, events) {
-		char* name = eventGetName(current_event);
-		if (name == NULL) {
-			return EM_OUT_OF_MEMORY;
-		}
-		Date date = eventGetDate(current_event);
-		if (date == NULL) {
-			free(name);
-			return EM_OUT_OF_MEMORY;
-		}
-
-		if (!strcmp(event_name, name) && !dateCompare(event_date, date)) {
-			free(name);
-			dateDestroy(date);
-			return EM_EVENT_ALREADY_EXISTS;
-		}
+	return em->latency == NULL ? 0 : latencyNow();
+}
 
-		free(name);
-		dateDestroy(date);
+static void latencyEnd(EventManager em, LatencyOperation operation, long long start_time)
+{
+	if (em->latency != NULL) {
+		latencyRecorderRecord(em->latency, operation, latencyElapsed(start_time));
 	}
-	return EM_SUCCESS;
 }
 
-static Event findEvent(PriorityQueue events, int event_id)
+static EventManagerResult dumpLatency(EventManager em, FILE* stream, bool csv)
 {
-	PQ_FOREACH(Event, ptr, events) {
-		if (eventGetId(ptr) == event_id) {
-			return ptr;
+	if (em->latency == NULL) {
+		return EM_ERROR;
+	}
+	LatencyHistogram histogram = latencyHistogramCreate();
+	if (histogram == NULL) {
+		return EM_OUT_OF_MEMORY;
+	}
+	if (csv) {
+		fprintf(stream, "operation,calls,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+	}
+	else {
+		fprintf(stream, "%-30s %10s %10s %10s %10s %10s %10s %10s (ns)\n",
+			"operation", "calls", "mean", "p50", "p90", "p99", "p999", "max");
+	}
+
+	for (int i = 0; i < LATENCY_OPERATIONS_COUNT; i++) {
+		latencyHistogramReset(histogram);
+		latencyRecorderMerge(em->latency, i, histogram);
+		long long calls = latencyHistogramGetCount(histogram);
+		if (csv) {
+			fprintf(stream, "%s,%lld,%.1f,%lld,%lld,%lld,%lld,%lld,%lld\n", latency_operation_names[i], calls,
+				latencyHistogramGetMean(histogram), latencyHistogramGetMin(histogram),
+				latencyHistogramGetPercentile(histogram, 50), latencyHistogramGetPercentile(histogram, 90),
+				latencyHistogramGetPercentile(histogram, 99), latencyHistogramGetPercentile(histogram, 99.9),
+				latencyHistogramGetMax(histogram));
+		}
+		else if (calls > 0) {
+			fprintf(stream, "%-30s %10lld %10.0f %10lld %10lld %10lld %10lld %10lld\n", latency_operation_names[i], calls,
+				latencyHistogramGetMean(histogram), latencyHistogramGetPercentile(histogram, 50),
+				latencyHistogramGetPercentile(histogram, 90), latencyHistogramGetPercentile(histogram, 99),
+				latencyHistogramGetPercentile(histogram, 99.9), latencyHistogramGetMax(histogram));
 		}
 	}
-	return NULL;
+	latencyHistogramDestroy(histogram);
+	return EM_SUCCESS;
 }
 
-static Student findStudent(PriorityQueue students, int student_id)
+static EventManagerResult journalOperation(EventManager em, JournalRecordType type,
+	const int* values, int values_count, const char* name)
 {
-	PQ_FOREACH(Student, ptr, students) {
-		if (stGetId(ptr) == student_id) {
-			return ptr;
-		}
+	if (em->journal == NULL) {
+		return EM_SUCCESS;
 	}
-	return NULL;
+	JournalResult res = journalAppend(em->journal, type, values, values_count, name);
+	if (res == JOURNAL_SUCCESS) {
+		return EM_SUCCESS;
+	}
+	journalRollback(em->journal);
+	return res == JOURNAL_OUT_OF_MEMORY ? EM_OUT_OF_MEMORY : EM_ERROR;
 }
 
-static EventManagerResult changeStudentEventCount(PriorityQueue students, Student student, int increment)
+static EventManagerResult journalOperationEnd(EventManager em, EventManagerResult res)
 {
-	stSetEventCount(student, increment);
-	if (changeStudentPriority(students, student) != EM_SUCCESS) {
-		return EM_OUT_OF_MEMORY;
+	if (em->journal == NULL) {
+		return res;
 	}
-	return EM_SUCCESS;
+	if (res != EM_SUCCESS) {
+		journalRollback(em->journal);
+		return res;
+	}
+	return journalCommit(em->journal) == JOURNAL_SUCCESS ? EM_SUCCESS : EM_ERROR;
 }
 
-static EventManagerResult changeStudentPriority(PriorityQueue students, Student student)
+static bool replayRecord(void* context, int type, const int* values, int values_count, const char* text)
 {
-	int event_count = stGetEventCount(student), student_id = stGetId(student);
-	Pair new_priority = pairCreate(&event_count, &student_id, intCopy, intCopy, intFree, intFree);
-	if (new_priority == NULL) {
-		return EM_OUT_OF_MEMORY;
+	EventManager em = context;
+	EventManagerResult res = EM_ERROR;
+	//The name arguments aren't changed, they are only copied into the events and members.
+	char* name = (char*)text;
+	if (type == JOURNAL_ADD_EVENT_BY_DATE && values_count == 2 && name != NULL) {
+		Date date = dateFromOrdinal(values[1]);
+		res = date == NULL ? EM_OUT_OF_MEMORY : addEventByDate(em, name, date, values[0]);
+		dateDestroy(date);
 	}
-	Student new_student = stCopy(student);
-	if (new_student == NULL) {
-		return EM_OUT_OF_MEMORY;
+	else if (type == JOURNAL_ADD_EVENT_BY_DIFF && values_count == 2 && name != NULL) {
+		res = addEventByDiff(em, name, values[1], values[0]);
 	}
-
-	int res = pqRemoveElement(students, student);
-	if (res != PQ_SUCCESS) {
-		stDestroy(new_student);
-		pairDestroy(new_priority);
-		return EM_OUT_OF_MEMORY;
+	else if (type == JOURNAL_REMOVE_EVENT && values_count == 1) {
+		res = removeEvent(em, values[0]);
 	}
-	res = pqInsert(students, new_student, new_priority);
-	if (res != PQ_SUCCESS) {
-		stDestroy(new_student);
-		pairDestroy(new_priority);
-		return EM_OUT_OF_MEMORY;
+	else if (type == JOURNAL_CHANGE_EVENT_DATE && values_count == 2) {
+		Date date = dateFromOrdinal(values[1]);
+		res = date == NULL ? EM_OUT_OF_MEMORY : changeEventDate(em, values[0], date);
+		dateDestroy(date);
 	}
-
-	stDestroy(new_student);
-	pairDestroy(new_priority);
-	return EM_SUCCESS;
+	else if (type == JOURNAL_ADD_MEMBER && values_count == 1 && name != NULL) {
+		res = addMember(em, name, values[0]);
+	}
+	else if (type == JOURNAL_ADD_MEMBER_TO_EVENT && values_count == 2) {
+		res = addMemberToEvent(em, values[0], values[1]);
+	}
+	else if (type == JOURNAL_REMOVE_MEMBER_FROM_EVENT && values_count == 2) {
+		res = removeMemberFromEvent(em, values[0], values[1]);
+	}
+	else if (type == JOURNAL_TICK && values_count == 1) {
+		res = tick(em, values[0]);
+	}
+	return res == EM_SUCCESS;
 }
 
-static void eventPrintStudentList(PriorityQueue students, Node id_list, FILE* stream)
+static EventManagerResult checkBatchOp(const EventManagerBatchOp* op)
 {
-	if (id_list == NULL || stream == NULL) {
-		return;
+	if (op->type == EM_BATCH_ADD_MEMBER_TO_EVENT) {
+		if (op->member_id < 0) {
+			return EM_INVALID_MEMBER_ID;
+		}
+		return op->event_id < 0 ? EM_INVALID_EVENT_ID : EM_SUCCESS;
 	}
-	assert(students != NULL);
-
-	NODE_FOREACH(Node, node, id_list) {
-		int* id = nodeGet(node);
-		assert(id != NULL);
-		Student student = findStudent(students, *id);
-		assert(student != NULL);
+	else if (op->type == EM_BATCH_REMOVE_MEMBER_FROM_EVENT) {
+		if (op->event_id < 0) {
+			return EM_INVALID_EVENT_ID;
+		}
+		return op->member_id < 0 ? EM_INVALID_MEMBER_ID : EM_SUCCESS;
+	}
+	return EM_ERROR;
+}
 
-		char* name = stGetName(student);
-		if (name == NULL) {
-			return;
+static EventManagerResult findBatchMembers(EventManager em, Batch* batch, int entries_count)
+{
+	for (int i = 0; i < entries_count; i++) {
+		batch->ids[i] = batch->entries[i].member_id;
+	}
+	qsort(batch->ids, entries_count, sizeof(*batch->ids), idCompare);
+	for (int i = 0; i < entries_count; i++) {
+		if (i > 0 && batch->ids[i - 1] == batch->ids[i]) {
+			continue;
+		}
+		BatchMember* member = &batch->members[batch->members_count++];
+		member->id = batch->ids[i];
+		member->index = NO_INDEX;
+		if (copyBaseMember(em, member->id) != EM_SUCCESS) {
+			return EM_OUT_OF_MEMORY;
 		}
+	}
 
-		fprintf(stream, ",%s", name);
-		free(name);
+	for (int i = 0; i < memberTableGetSize(em->members); i++) {
+		BatchMember* member = findBatchMember(batch, memberTableGetId(em->members, i));
+		if (member != NULL) {
+			member->index = i;
+		}
 	}
+	return EM_SUCCESS;
 }
 
-static int updateEventQueue(EventManager em)
+static BatchMember* findBatchMember(Batch* batch, int member_id)
+{
+	BatchMember key = { member_id, NO_INDEX };
+	return bsearch(&key, batch->members, batch->members_count, sizeof(*batch->members), batchMemberCompare);
+}
+
+static EventManagerResult applyBatchEvent(EventManager em, Event event, Batch* batch, int first, int last,
+	const EventManagerBatchOp* ops, EventManagerResult* results)
 {
-	PQ_FOREACH(Event, event, em->events) {
-		Date date = eventGetDate(event);
-		if (date == NULL) {
-			return EVENT_QUEUE_OUT_OF_MEMORY;
+	int ids_count = 0;
+	for (int i = first; i < last; i++) {
+		int member_id = batch->entries[i].member_id;
+		if (findBatchMember(batch, member_id)->index != NO_INDEX &&
+			(ids_count == 0 || batch->ids[ids_count - 1] != member_id)) {
+			batch->ids[ids_count++] = member_id;
 		}
+	}
+	eventFindStudentIds(event, batch->ids, ids_count, batch->linked);
 
-		if (dateCompareEarliest(em->current_date, date) == SECOND_ELEMENT_BIGGER) {
-			int res = emRemoveEvent(em, eventGetId(event));
-			if (res == EM_SUCCESS) {
-				dateDestroy(date);
-				return EVENT_REMOVED;
+	//Replays the operations of every member in order, on whether the member is linked.
+	int added_count = 0, removed_count = 0, id_index = 0;
+	for (int i = first; i < last;) {
+		int member_id = batch->entries[i].member_id, member_last = i;
+		while (member_last < last && batch->entries[member_last].member_id == member_id) {
+			member_last++;
+		}
+		if (findBatchMember(batch, member_id)->index == NO_INDEX) {
+			for (; i < member_last; i++) {
+				results[batch->entries[i].index] = EM_MEMBER_ID_NOT_EXISTS;
+			}
+			continue;
+		}
+		bool was_linked = batch->linked[id_index++], linked = was_linked;
+		for (; i < member_last; i++) {
+			int index = batch->entries[i].index;
+			if (ops[index].type == EM_BATCH_ADD_MEMBER_TO_EVENT) {
+				results[index] = linked ? EM_EVENT_AND_MEMBER_ALREADY_LINKED : EM_SUCCESS;
+				linked = true;
 			}
 			else {
-				return EVENT_QUEUE_OUT_OF_MEMORY;
+				results[index] = linked ? EM_SUCCESS : EM_EVENT_AND_MEMBER_NOT_LINKED;
+				linked = false;
 			}
 		}
-		dateDestroy(date);
+		if (linked && !was_linked) {
+			batch->added_ids[added_count++] = member_id;
+		}
+		else if (!linked && was_linked) {
+			batch->removed_ids[removed_count++] = member_id;
+		}
+	}
+
+	//The successful operations are logged before the event is changed, in batch order for every member.
+	int event_id = eventGetId(event), linked_count = 0;
+	EventManagerResult res = EM_SUCCESS;
+	for (int i = first; i < last && res == EM_SUCCESS; i++) {
+		int index = batch->entries[i].index;
+		if (results[index] == EM_SUCCESS) {
+			int values[] = { ops[index].member_id, event_id };
+			JournalRecordType type = ops[index].type == EM_BATCH_ADD_MEMBER_TO_EVENT ?
+				JOURNAL_ADD_MEMBER_TO_EVENT : JOURNAL_REMOVE_MEMBER_FROM_EVENT;
+			res = journalOperation(em, type, values, 2, NULL);
+		}
+	}
+
+	//Only linking can fail, so the added members are linked first and unlinked if the event can't be updated.
+	while (res == EM_SUCCESS && linked_count < added_count &&
+		memberTableLinkEvent(em->members, findBatchMember(batch, batch->added_ids[linked_count])->index, event_id)) {
+		linked_count++;
+	}
+	if (res == EM_SUCCESS && (linked_count < added_count ||
+		eventUpdateStudentIds(event, batch->added_ids, added_count, batch->removed_ids, removed_count) != EVENT_SUCCESS)) {
+		for (int i = 0; i < linked_count; i++) {
+			memberTableUnlinkEvent(em->members, findBatchMember(batch, batch->added_ids[i])->index, event_id);
+		}
+		res = EM_OUT_OF_MEMORY;
+	}
+	if (res != EM_SUCCESS) {
+		for (int i = first; i < last; i++) {
+			if (results[batch->entries[i].index] == EM_SUCCESS) {
+				results[batch->entries[i].index] = res;
+			}
+		}
+		return res;
+	}
+	for (int i = 0; i < removed_count; i++) {
+		memberTableUnlinkEvent(em->members, findBatchMember(batch, batch->removed_ids[i])->index, event_id);
+	}
+	for (int i = first; i < last; i++) { //The successful operations, in batch order for every member.
+		int index = batch->entries[i].index;
+		if (results[index] == EM_SUCCESS) {
+			ChangeType type = ops[index].type == EM_BATCH_ADD_MEMBER_TO_EVENT ? CHANGE_MEMBER_LINKED : CHANGE_MEMBER_UNLINKED;
+			changeFeedAppend(em->changes, type, ops[index].member_id, event_id, NULL);
+		}
+	}
+	return EM_SUCCESS;
+}
+
+static int batchEntryCompare(const void* entry1, const void* entry2)
+{
+	const BatchEntry* first = entry1, *second = entry2;
+	if (first->event_id != second->event_id) {
+		return intCompare(first->event_id, second->event_id);
+	}
+	if (first->member_id != second->member_id) {
+		return intCompare(first->member_id, second->member_id);
 	}
-	return EVENT_QUEUE_UPDATED;
-}
\ No newline at end of file
+	return intCompare(first->index, second->index);
+}
+
+static int batchMemberCompare(const void* member1, const void* member2)
+{
+	return intCompare(((const BatchMember*)member1)->id, ((const BatchMember*)member2)->id);
+}
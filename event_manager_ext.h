@@ -0,0 +1,464 @@
+#ifndef _EVENT_MANAGER_EXT_H
+#define _EVENT_MANAGER_EXT_H
+
+#include <stdio.h>
+#include "event_manager.h"
+#include "allocator.h"
+#include "stats.h"
+#include "report_writer.h"
+
+/*
+* Extensions to the event manager interface.
+* The functions declared in event_manager.h behave the same for every
+* event manager, regardless of how it was created.
+*/
+
+/** Type used for selecting the structure that stores the events of the event manager */
+typedef enum {
+	EM_BACKEND_PRIORITY_QUEUE,
+	EM_BACKEND_TIMING_WHEEL,
+	EM_BACKEND_BTREE
+} EventManagerBackend;
+
+/** Type used for selecting the change made by a batch operation */
+typedef enum {
+	EM_BATCH_ADD_MEMBER_TO_EVENT,
+	EM_BATCH_REMOVE_MEMBER_FROM_EVENT
+} EventManagerBatchOpType;
+
+/** Type for following a report that is written to its file in the background */
+typedef ReportWriter EventManagerExport;
+
+/** A change of an event's members, as given to emApplyBatch */
+typedef struct {
+	EventManagerBatchOpType type;
+	int member_id;
+	int event_id;
+} EventManagerBatchOp;
+
+
+/*
+createEventManagerWithBackend: Creates a new event manager that stores its events in the given backend.
+							   createEventManager(date) is the same as using EM_BACKEND_PRIORITY_QUEUE.
+
+@param date - The current date of the event manager.
+@param backend - EM_BACKEND_PRIORITY_QUEUE keeps the events in a sorted priority queue.
+				 EM_BACKEND_TIMING_WHEEL keeps the events in day buckets of a calendar timing wheel,
+				 so adding an event and expiring a day's events are O(1) amortized.
+				 EM_BACKEND_BTREE keeps the events in a priority queue of the B+-tree engine,
+				 so adding, moving and removing an event take O(log n) date comparisons.
+
+@return NULL if the date is NULL, the backend is unknown or if a memory allocation failed.
+		Else, returns a new event manager.
+*/
+EventManager createEventManagerWithBackend(Date date, EventManagerBackend backend);
+
+/*
+createEventManagerWithAllocator: Creates a new event manager like createEventManagerWithBackend, whose memory
+								 is allocated from the given allocator: the event manager itself, its current date,
+								 its queues and wheels, and every event, member, date and priority stored in them.
+								 Temporary buffers of single calls (such as reports and batches) still use malloc.
+
+@param date - The current date of the event manager.
+@param backend - The structure that stores the events.
+@param allocator - The allocator of the event manager, or NULL for the default allocator.
+				   It must stay valid until the event manager is destroyed.
+
+@return NULL if the date is NULL, the backend is unknown or if a memory allocation failed.
+		Else, returns a new event manager.
+*/
+EventManager createEventManagerWithAllocator(Date date, EventManagerBackend backend, const Allocator* allocator);
+
+/*
+createEventManagerWithArena: Creates a new event manager like createEventManagerWithBackend, whose memory
+							 is allocated from an arena that the event manager owns (see arena.h).
+							 Objects of the same size reuse each other's memory, and destroyEventManager
+							 releases the arena in one free per chunk instead of deallocating every
+							 event, member, date and node.
+
+@param date - The current date of the event manager.
+@param backend - The structure that stores the events.
+
+@return NULL if the date is NULL, the backend is unknown or if a memory allocation failed.
+		Else, returns a new event manager.
+*/
+EventManager createEventManagerWithArena(Date date, EventManagerBackend backend);
+
+/*
+emEnableThreadSafety: Makes the event manager safe to use from several threads.
+					  Functions that change the event manager take a write lock, while
+					  emGetEventsAmount, emGetNextEvent and the print functions take a read lock
+					  and don't change any shared state, so they can run in parallel.
+					  Waiting writers go before new readers, so a steady stream of reads can't starve changes.
+					  Must be called before the event manager is shared between threads.
+					  destroyEventManager must not run while other threads use the event manager,
+					  and the name returned by emGetNextEvent is only valid until the next change.
+
+@param em - The event manager to make thread safe.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_OUT_OF_MEMORY if the lock couldn't be initialized.
+		EM_SUCCESS if the event manager is thread safe (also when it already was).
+*/
+EventManagerResult emEnableThreadSafety(EventManager em);
+
+/*
+emSetReportThreads: Sets the number of threads emPrintAllEvents formats the events on.
+					With more than one thread, the events are split into ranges of about the same number
+					of events and members, every range is formatted into a buffer of its own by a thread,
+					with the member names found by their ids in a sorted copy of the names, and the buffers
+					are written in order. The file is the same as the one printed by a single thread,
+					which also prints it when the buffers can't be allocated.
+					Must be called before the event manager is shared between threads.
+
+@param em - The event manager to set.
+@param threads - The number of threads, including the calling thread, at most 64 are used (1 by default).
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_ERROR if threads is smaller than 1.
+		EM_SUCCESS if the number of threads has been set.
+*/
+EventManagerResult emSetReportThreads(EventManager em, int threads);
+
+/*
+emPrintAllEventsAsync: Prints the events like emPrintAllEvents, with the file written in the background.
+					   The report is formatted into memory under the read lock (on the threads set by
+					   emSetReportThreads), so it is consistent with the state at the call, and a writer
+					   thread opens, writes and closes the file. The event manager can be changed and
+					   even destroyed while the file is written.
+
+@param em - The event manager to print.
+@param file_name - The file to print into.
+@param report - Set to the handle of the export, which must be passed to emExportWait.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_OUT_OF_MEMORY if a memory allocation failed (The file isn't changed).
+		EM_SUCCESS if the export has started.
+*/
+EventManagerResult emPrintAllEventsAsync(EventManager em, const char* file_name, EventManagerExport* report);
+
+/*
+emPrintAllResponsibleMembersAsync: Prints the members like emPrintAllResponsibleMembers,
+								   with the file written in the background like emPrintAllEventsAsync.
+
+@param em - The event manager to print.
+@param file_name - The file to print into.
+@param report - Set to the handle of the export, which must be passed to emExportWait.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_OUT_OF_MEMORY if a memory allocation failed (The file isn't changed).
+		EM_SUCCESS if the export has started.
+*/
+EventManagerResult emPrintAllResponsibleMembersAsync(EventManager em, const char* file_name,
+	EventManagerExport* report);
+
+/*
+emExportIsDone: Returns whether the file of an export has been written, without waiting.
+
+@param report - The export to check.
+
+@return True if the export is NULL or its file has been written (or failed to be written).
+		Else, returns False.
+*/
+bool emExportIsDone(EventManagerExport report);
+
+/*
+emExportWait: Waits until the file of an export has been written, and deallocates the export.
+
+@param report - The export to wait for.
+
+@return EM_NULL_ARGUMENT if the export is NULL.
+		EM_ERROR if the file couldn't be opened or written.
+		EM_SUCCESS if the file has been written.
+*/
+EventManagerResult emExportWait(EventManagerExport report);
+
+/*
+emSaveSnapshot: Writes the state of the event manager to a versioned binary snapshot file.
+				The snapshot stores every name once in a string table, dates as day ordinals
+				and the sorted member ids of every event, in the order of the event manager's queues.
+				The file is replaced only when the new snapshot was written completely.
+
+@param em - The event manager to save.
+@param path - The path of the snapshot file.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_ERROR if the file couldn't be written.
+		EM_SUCCESS if the snapshot has been written.
+*/
+EventManagerResult emSaveSnapshot(EventManager em, const char* path);
+
+/*
+emLoadSnapshot: Creates a new event manager from a snapshot file written by emSaveSnapshot.
+				The queues are built by appending the records in their saved order,
+				so loading takes linear time instead of replaying every operation.
+				The new event manager uses the backend it was saved from, and isn't thread safe.
+
+@param path - The path of the snapshot file.
+
+@return NULL if the path is NULL, the file couldn't be read, isn't a valid snapshot
+		(unknown version, event or member ids that don't match) or if a memory allocation failed.
+		Else, returns the restored event manager.
+*/
+EventManager emLoadSnapshot(const char* path);
+
+/*
+emOpenSnapshot: Creates a new event manager that reads a snapshot file in place, through a read only memory mapping.
+				Nothing is deserialized when the snapshot is opened: emGetNextEvent, emGetEventsAmount and
+				the print functions read the mapped records directly, and processes that open the same
+				file share its pages.
+				Changes are kept in memory on top of the snapshot: new and moved events are stored in the
+				events backend, and a snapshot event or member is copied only when it is changed.
+				The file is never written, use emSaveSnapshot to save the changes.
+				All of the functions behave the same as for an event manager loaded by emLoadSnapshot.
+
+@param path - The path of the snapshot file, which must not be changed in place while it is open.
+
+@return NULL if the path is NULL, the file couldn't be mapped, isn't a valid snapshot
+		or its records aren't sorted, or if a memory allocation failed.
+		Else, returns the event manager, which keeps the file mapped until it is destroyed.
+*/
+EventManager emOpenSnapshot(const char* path);
+
+/*
+emEnableJournal: Starts logging every successful change of the event manager to an append-only journal file,
+				 so the changes can be recovered with emReplayJournal after a crash.
+				 The record of a change is appended before the change is made, and is dropped
+				 if the change fails. Records are written to the file and synced to the disk in groups:
+				 once group_size records are waiting, or once a change is made group_interval_ms
+				 after the last sync. A crash loses the changes made since the last sync.
+				 group_interval_ms is only checked when a change is made: there is no timer, so while
+				 no changes are made the waiting records aren't synced. A caller that needs them on
+				 the disk within a time limit must call emSyncJournal itself, after its last change
+				 or periodically. An existing journal file is appended to.
+
+@param em - The event manager to log.
+@param path - The path of the journal file.
+@param group_size - The number of changes that are synced together, 1 syncs every change.
+@param group_interval_ms - The time in milliseconds after the last sync from which the next change syncs
+						   its group, or 0 to sync only by group_size.
+
+@return EM_NULL_ARGUMENT if the event manager or the path is NULL.
+		EM_ERROR if the event manager already has a journal, group_size isn't positive,
+		group_interval_ms is negative or the file couldn't be opened.
+		EM_SUCCESS if the changes are logged from now on.
+		While a journal is enabled, a change whose record couldn't be appended isn't made,
+		and returns EM_OUT_OF_MEMORY (or EM_ERROR). A change that was made, but whose record
+		couldn't be written or synced, returns EM_ERROR: its record stays in the journal's memory
+		and is written again with the next group or by emSyncJournal.
+*/
+EventManagerResult emEnableJournal(EventManager em, const char* path, int group_size, int group_interval_ms);
+
+/*
+emSyncJournal: Syncs the changes that are waiting for their group to the disk.
+			   This is the only way to bound the time a change waits while no further changes are made.
+
+@param em - The event manager.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_ERROR if the journal couldn't be synced.
+		EM_SUCCESS if every logged change is on the disk (also when there is no journal).
+*/
+EventManagerResult emSyncJournal(EventManager em);
+
+/*
+emDisableJournal: Syncs and closes the journal of the event manager, later changes aren't logged.
+				  destroyEventManager does the same.
+
+@param em - The event manager.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_ERROR if the journal couldn't be synced.
+		EM_SUCCESS if the journal was closed (also when there was no journal).
+*/
+EventManagerResult emDisableJournal(EventManager em);
+
+/*
+emReplayJournal: Applies the changes logged in a journal file to the event manager, in order.
+				 The journal must be replayed over the state it was started from: recovery creates
+				 the event manager the same way as when the journal was enabled (usually with
+				 emLoadSnapshot or emOpenSnapshot), replays the journal and enables it again.
+				 To checkpoint, save a snapshot and enable a new journal file, then remove the old files.
+				 The replayed changes aren't logged again, even if the event manager has a journal.
+				 A record that was only partly written by a crash ends the replay.
+
+@param em - The event manager to apply the changes to.
+@param path - The path of the journal file.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_ERROR if the file couldn't be read, or a change failed because the journal
+		doesn't match the event manager (the changes before it remain applied).
+		EM_SUCCESS if all of the logged changes have been applied.
+*/
+EventManagerResult emReplayJournal(EventManager em, const char* path);
+
+/*
+emEnableChangeFeed: Starts recording the changes of the event manager in a feed of the latest changes,
+					so a reader can follow them with emExportChanges instead of reading the whole state.
+					Every change gets the next sequence number, starting at 1: an event added, removed
+					or moved to a new date (also by emTick), a member added, a member linked to or
+					unlinked from an event, and a member's number of events changed.
+					The feed keeps the last capacity changes, and older changes are dropped.
+
+@param em - The event manager to record.
+@param capacity - The number of changes the feed keeps.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_ERROR if the event manager already records its changes or the capacity isn't positive.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_SUCCESS if the changes are recorded from now on.
+*/
+EventManagerResult emEnableChangeFeed(EventManager em, int capacity);
+
+/*
+emGetChangeSequence: Returns the sequence number of the last recorded change.
+
+@param em - The event manager.
+
+@return 0 if the event manager is NULL, doesn't record its changes or hasn't changed since.
+		Else, returns the sequence number of the last change.
+*/
+long long emGetChangeSequence(EventManager em);
+
+/*
+emExportChanges: Prints the changes recorded after a sequence number to a file, one line each, in order:
+				 sequence,event_added,event_id,day.month.year,event_name
+				 sequence,event_removed,event_id
+				 sequence,event_date_changed,event_id,day.month.year
+				 sequence,member_added,member_id,member_name
+				 sequence,member_linked,member_id,event_id
+				 sequence,member_unlinked,member_id,event_id
+				 sequence,member_event_count,member_id,event_count
+
+@param em - The event manager to export the changes of.
+@param since - The sequence number of the last change the reader has, 0 for all of the changes.
+@param file_name - The path of the file.
+@param last - If not NULL, set to the sequence number of the last exported change, the next since.
+
+@return EM_NULL_ARGUMENT if the event manager or the file name is NULL.
+		EM_ERROR if the event manager doesn't record its changes, since is negative, a change after since
+		was already dropped (the reader must read the whole state again), or the file couldn't be written.
+		EM_SUCCESS if the changes have been printed.
+*/
+EventManagerResult emExportChanges(EventManager em, long long since, const char* file_name, long long* last);
+
+/*
+emApplyBatch: Applies a batch of member changes, as if emAddMemberToEvent and emRemoveMemberFromEvent
+			  were called for each of the operations in order.
+			  The operations are grouped by event and member: every event and member is searched for once,
+			  each event's member list is updated in a single merged pass, and each member's place
+			  in the members queue is updated once, by the net change of its event count.
+			  If the event manager has a journal, the successful operations of every event are logged before
+			  the event is changed, in batch order for every member, and the event isn't changed if they can't be.
+
+@param em - The event manager to change.
+@param ops - The operations to apply.
+@param ops_count - The number of operations.
+@param results - Set to the result of each operation, the same result the single call would have returned.
+				 May be NULL if the results aren't needed.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL, ops_count is negative, or ops is NULL while ops_count is positive.
+		EM_OUT_OF_MEMORY if a memory allocation failed, or the operations of an event couldn't be logged,
+		the operations that weren't applied have EM_OUT_OF_MEMORY as their result.
+		EM_ERROR if the journal couldn't be written or synced after an event was changed.
+		EM_SUCCESS if the batch has been applied (The operations may still have failed, see results).
+*/
+EventManagerResult emApplyBatch(EventManager em, const EventManagerBatchOp* ops, int ops_count,
+	EventManagerResult* results);
+
+/*
+emGetMemberEvents: Returns the events a member is linked to.
+				   Every member keeps the sorted ids of its events, updated together with the member lists
+				   of the events, so the events are copied without scanning the events.
+				   A member of a mapped snapshot that wasn't changed yet is found by scanning the events.
+
+@param em - The event manager that stores the member.
+@param member_id - The id of the member.
+@param event_ids - Set to a new array of the ids of the member's events sorted in ascending order,
+				   which the caller must free, or to NULL if the member isn't linked to any event.
+@param count - Set to the number of events.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_INVALID_MEMBER_ID if the member id is negative.
+		EM_MEMBER_ID_NOT_EXISTS if there is no member with the id.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_SUCCESS if the events have been returned.
+*/
+EventManagerResult emGetMemberEvents(EventManager em, int member_id, int** event_ids, int* count);
+
+/*
+emEnableLatencyTracking: Starts recording the latency of every call to the functions of the event manager
+						 that take its lock (including waiting for the lock), in a histogram per function.
+						 Every thread records into histograms of its own, without locks, and the histograms
+						 of all of the threads are merged by the report functions. A recorded call costs
+						 two clock reads (the time stamp counter on x86) and a histogram increment.
+						 Must be called before the event manager is shared between threads.
+
+@param em - The event manager to record the latency of.
+
+@return EM_NULL_ARGUMENT if the event manager is NULL.
+		EM_OUT_OF_MEMORY if the recorder couldn't be created.
+		EM_SUCCESS if the latency is recorded (also when it already was).
+*/
+EventManagerResult emEnableLatencyTracking(EventManager em);
+
+/*
+emDumpLatencyReport: Prints a table of the number of calls and the mean, p50, p90, p99, p999 and maximal latency
+					 in nanoseconds of every function that was called since latency tracking was enabled or reset.
+					 Percentiles are accurate to about 3%.
+
+@param em - The event manager to print the latency of.
+@param stream - The stream to print to.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_ERROR if latency tracking isn't enabled.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_SUCCESS if the report has been printed.
+*/
+EventManagerResult emDumpLatencyReport(EventManager em, FILE* stream);
+
+/*
+emDumpLatencyCsv: Prints the latency report as CSV, with a row for every function (also those that weren't called):
+				  operation,calls,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns
+
+@param em - The event manager to print the latency of.
+@param stream - The stream to print to.
+
+@return EM_NULL_ARGUMENT if one of the arguments is NULL.
+		EM_ERROR if latency tracking isn't enabled.
+		EM_OUT_OF_MEMORY if a memory allocation failed.
+		EM_SUCCESS if the report has been printed.
+*/
+EventManagerResult emDumpLatencyCsv(EventManager em, FILE* stream);
+
+/*
+emResetLatency: Empties the latency histograms, for measuring the next calls.
+
+@param em - The event manager to reset the latency of.
+*/
+void emResetLatency(EventManager em);
+
+/*
+emGetStats: Returns the work done by the public functions of the event manager since it was created
+			or since its stats were reset: the allocations and deallocations, the calls to compare
+			and equal functions of its queues and wheel, and the list nodes stepped over (see stats.h).
+			Reset the stats before a call to measure the cost of that single call.
+
+@param em - The event manager to read the stats of.
+@param stats - Set to the stats of the event manager, or to zeros if the counters are disabled.
+
+@return False if one of the arguments is NULL or if COLLECT_STATS wasn't defined.
+		Else, returns True.
+*/
+bool emGetStats(EventManager em, OperationStats* stats);
+
+/*
+emResetStats: Sets the stats of the event manager to zeros, for measuring the next calls.
+
+@param em - The event manager to reset the stats of.
+*/
+void emResetStats(EventManager em);
+
+#endif /* _EVENT_MANAGER_EXT_H */
@@ -0,0 +1,362 @@
+#define _POSIX_C_SOURCE 200809L //For fsync and clock_gettime under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "journal.h"
+
+#define WORD_SIZE 4
+#define MAX_TEXT_LENGTH 0xFFFFFF
+#define MILLISECONDS_IN_SECOND 1000
+#define NANOSECONDS_IN_MILLISECOND 1000000
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+#define WRITE_SIZE 4096 //Committed records are written to the file once they fill this many bytes.
+
+/*
+* Record layout, in 32 bit little endian words:
+*	length			- The number of bytes from type to the end of the text padding.
+*	type
+*	values_count
+*	values			- values_count words.
+*	text_length		- The length of the text, with its '\0' (0 if there is no text).
+*	text			- Padded with zeros to a multiple of WORD_SIZE.
+*	checksum		- FNV-1a of the bytes from type to the end of the text padding.
+*/
+#define RECORD_FIXED_WORDS 5
+
+struct journal_t {
+	FILE* file;
+	int group_size;
+	int group_interval_ms;
+	int pending; //Committed records that weren't synced yet.
+	int uncommitted; //Records that were appended since the last commit or rollback.
+	struct timespec last_sync;
+	unsigned char* buffer; //Holds the records that weren't written to the file yet.
+	size_t buffer_size;
+	size_t used; //The bytes of the buffer that hold records.
+	size_t committed; //The bytes at the start of the buffer that hold committed records.
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+putWord: Stores a 32 bit word in little endian order.
+
+@param buffer - The buffer to store the word in.
+@param value - The value to store.
+*/
+static void putWord(unsigned char* buffer, unsigned int value);
+
+/*
+getWord: Reads a 32 bit little endian word.
+
+@param buffer - The buffer to read from.
+
+@return The value of the word.
+*/
+static unsigned int getWord(const unsigned char* buffer);
+
+/*
+checksum: Returns the FNV-1a hash of a buffer.
+
+@param buffer - The buffer to hash.
+@param size - The number of bytes to hash.
+
+@return The hash of the buffer.
+*/
+static unsigned int checksum(const unsigned char* buffer, size_t size);
+
+/*
+millisecondsSince: Returns the number of milliseconds that passed since a time.
+
+@param time - A time of CLOCK_MONOTONIC.
+
+@return The number of milliseconds since the time.
+*/
+static long millisecondsSince(const struct timespec* time);
+
+/*
+reserveBuffer: Makes sure the record buffer of a journal has room for a given number of bytes,
+			   at least doubling it when it grows.
+
+@param journal - The journal to grow its buffer.
+@param size - The needed size in bytes.
+
+@return JOURNAL_OUT_OF_MEMORY if a memory allocation failed.
+		JOURNAL_SUCCESS otherwise.
+*/
+static JournalResult reserveBuffer(Journal journal, size_t size);
+
+/*
+writeCommitted: Writes the committed records of a journal to its file, and removes them from the buffer.
+
+@param journal - The journal to write.
+
+@return JOURNAL_FILE_ERROR if the records couldn't be written.
+		JOURNAL_SUCCESS otherwise.
+*/
+static JournalResult writeCommitted(Journal journal);
+
+/* =---------------------------------------------------------------------------=
+
+								Journal Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+Journal journalOpen(const char* path, int group_size, int group_interval_ms)
+{
+	if (path == NULL || group_size <= 0 || group_interval_ms < 0) {
+		return NULL;
+	}
+
+	Journal journal = malloc(sizeof(*journal));
+	if (journal == NULL) {
+		return NULL;
+	}
+	journal->file = fopen(path, "ab");
+	if (journal->file == NULL) {
+		free(journal);
+		return NULL;
+	}
+	setvbuf(journal->file, NULL, _IONBF, 0); //The records are buffered by the journal.
+	journal->group_size = group_size;
+	journal->group_interval_ms = group_interval_ms;
+	journal->pending = 0;
+	journal->uncommitted = 0;
+	journal->buffer = NULL;
+	journal->buffer_size = 0;
+	journal->used = 0;
+	journal->committed = 0;
+	clock_gettime(CLOCK_MONOTONIC, &journal->last_sync);
+	return journal;
+}
+
+void journalClose(Journal journal)
+{
+	if (journal == NULL) {
+		return;
+	}
+	journalSync(journal);
+	fclose(journal->file);
+	free(journal->buffer);
+	free(journal);
+}
+
+JournalResult journalAppend(Journal journal, int type, const int* values, int values_count, const char* text)
+{
+	if (journal == NULL || (values == NULL && values_count > 0)) {
+		return JOURNAL_NULL_ARGUMENT;
+	}
+	size_t text_length = text == NULL ? 0 : strlen(text) + 1;
+	if (values_count < 0 || values_count > JOURNAL_MAX_VALUES || text_length > MAX_TEXT_LENGTH) {
+		return JOURNAL_OUT_OF_MEMORY;
+	}
+
+	size_t padded_length = (text_length + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
+	size_t length = (RECORD_FIXED_WORDS - 2 + values_count) * WORD_SIZE + padded_length;
+	size_t size = length + 2 * WORD_SIZE;
+	if (reserveBuffer(journal, journal->used + size) != JOURNAL_SUCCESS) {
+		return JOURNAL_OUT_OF_MEMORY;
+	}
+
+	unsigned char* record = journal->buffer + journal->used;
+	unsigned char* position = record;
+	putWord(position, length);
+	position += WORD_SIZE;
+	putWord(position, type);
+	position += WORD_SIZE;
+	putWord(position, values_count);
+	position += WORD_SIZE;
+	for (int i = 0; i < values_count; i++) {
+		putWord(position, values[i]);
+		position += WORD_SIZE;
+	}
+	putWord(position, text_length);
+	position += WORD_SIZE;
+	memset(position, 0, padded_length);
+	if (text != NULL) {
+		memcpy(position, text, text_length);
+	}
+	position += padded_length;
+	putWord(position, checksum(record + WORD_SIZE, length));
+	journal->used += size;
+	journal->uncommitted++;
+	return JOURNAL_SUCCESS;
+}
+
+JournalResult journalCommit(Journal journal)
+{
+	if (journal == NULL) {
+		return JOURNAL_NULL_ARGUMENT;
+	}
+	journal->committed = journal->used;
+	journal->pending += journal->uncommitted;
+	journal->uncommitted = 0;
+	if (journal->pending >= journal->group_size || (journal->pending > 0 && journal->group_interval_ms > 0 &&
+		millisecondsSince(&journal->last_sync) >= journal->group_interval_ms)) {
+		return journalSync(journal);
+	}
+	return journal->committed >= WRITE_SIZE ? writeCommitted(journal) : JOURNAL_SUCCESS;
+}
+
+void journalRollback(Journal journal)
+{
+	if (journal == NULL) {
+		return;
+	}
+	journal->used = journal->committed;
+	journal->uncommitted = 0;
+}
+
+JournalResult journalSync(Journal journal)
+{
+	if (journal == NULL) {
+		return JOURNAL_NULL_ARGUMENT;
+	}
+	if (writeCommitted(journal) != JOURNAL_SUCCESS || fflush(journal->file) != 0 ||
+		fsync(fileno(journal->file)) != 0) {
+		return JOURNAL_FILE_ERROR;
+	}
+	journal->pending = 0;
+	clock_gettime(CLOCK_MONOTONIC, &journal->last_sync);
+	return JOURNAL_SUCCESS;
+}
+
+JournalResult journalReplay(const char* path, JournalRecordFunc replay, void* context, int* records)
+{
+	int ignored;
+	if (records == NULL) {
+		records = &ignored;
+	}
+	*records = 0;
+	if (path == NULL || replay == NULL) {
+		return JOURNAL_NULL_ARGUMENT;
+	}
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return JOURNAL_FILE_ERROR;
+	}
+
+	JournalResult res = JOURNAL_SUCCESS;
+	unsigned char* record = NULL;
+	unsigned char word[WORD_SIZE];
+	while (res == JOURNAL_SUCCESS && fread(word, 1, WORD_SIZE, file) == WORD_SIZE) {
+		size_t length = getWord(word);
+		if (length < (RECORD_FIXED_WORDS - 2) * WORD_SIZE || length % WORD_SIZE != 0 ||
+			length > (RECORD_FIXED_WORDS + JOURNAL_MAX_VALUES) * WORD_SIZE + MAX_TEXT_LENGTH + WORD_SIZE) {
+			break; //A torn length word, the rest of the file can't be trusted.
+		}
+		unsigned char* grown = realloc(record, length + WORD_SIZE);
+		if (grown == NULL) {
+			res = JOURNAL_OUT_OF_MEMORY;
+			break;
+		}
+		record = grown;
+		if (fread(record, 1, length + WORD_SIZE, file) != length + WORD_SIZE ||
+			getWord(record + length) != checksum(record, length)) {
+			break; //The last record was only partly written.
+		}
+
+		int type = getWord(record), values_count = getWord(record + WORD_SIZE);
+		size_t text_offset = (2 + (size_t)values_count + 1) * WORD_SIZE;
+		if (values_count < 0 || values_count > JOURNAL_MAX_VALUES || text_offset > length) {
+			break;
+		}
+		size_t text_length = getWord(record + text_offset - WORD_SIZE);
+		if (text_length > length - text_offset || (text_length > 0 && record[text_offset + text_length - 1] != '\0')) {
+			break;
+		}
+
+		int values[JOURNAL_MAX_VALUES];
+		for (int i = 0; i < values_count; i++) {
+			unsigned int value = getWord(record + (2 + i) * WORD_SIZE);
+			memcpy(&values[i], &value, sizeof(values[i])); //Reinterprets the two's complement bits.
+		}
+		if (!replay(context, type, values, values_count, text_length > 0 ? (char*)record + text_offset : NULL)) {
+			res = JOURNAL_RECORD_FAILED;
+			break;
+		}
+		(*records)++;
+	}
+	free(record);
+	fclose(file);
+	return res;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void putWord(unsigned char* buffer, unsigned int value)
+{
+	buffer[0] = value & 0xFF;
+	buffer[1] = (value >> 8) & 0xFF;
+	buffer[2] = (value >> 16) & 0xFF;
+	buffer[3] = (value >> 24) & 0xFF;
+}
+
+static unsigned int getWord(const unsigned char* buffer)
+{
+	return (unsigned int)buffer[0] | ((unsigned int)buffer[1] << 8) |
+		((unsigned int)buffer[2] << 16) | ((unsigned int)buffer[3] << 24);
+}
+
+static unsigned int checksum(const unsigned char* buffer, size_t size)
+{
+	unsigned int hash = FNV_OFFSET_BASIS;
+	for (size_t i = 0; i < size; i++) {
+		hash = (hash ^ buffer[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static long millisecondsSince(const struct timespec* time)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - time->tv_sec) * MILLISECONDS_IN_SECOND +
+		(now.tv_nsec - time->tv_nsec) / NANOSECONDS_IN_MILLISECOND;
+}
+
+static JournalResult reserveBuffer(Journal journal, size_t size)
+{
+	if (size <= journal->buffer_size) {
+		return JOURNAL_SUCCESS;
+	}
+	if (size < 2 * journal->buffer_size) {
+		size = 2 * journal->buffer_size;
+	}
+	unsigned char* buffer = realloc(journal->buffer, size);
+	if (buffer == NULL) {
+		return JOURNAL_OUT_OF_MEMORY;
+	}
+	journal->buffer = buffer;
+	journal->buffer_size = size;
+	return JOURNAL_SUCCESS;
+}
+
+static JournalResult writeCommitted(Journal journal)
+{
+	if (journal->committed == 0) {
+		return JOURNAL_SUCCESS;
+	}
+	if (fwrite(journal->buffer, 1, journal->committed, journal->file) != journal->committed) {
+		return JOURNAL_FILE_ERROR;
+	}
+	memmove(journal->buffer, journal->buffer + journal->committed, journal->used - journal->committed);
+	journal->used -= journal->committed;
+	journal->committed = 0;
+	return JOURNAL_SUCCESS;
+}
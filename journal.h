@@ -0,0 +1,121 @@
+#ifndef _JOURNAL_H
+#define _JOURNAL_H
+
+#include <stdbool.h>
+
+/*
+* An append-only binary journal of typed records, with group commit.
+* Every record holds a type, up to JOURNAL_MAX_VALUES integers and an optional string,
+* followed by a checksum, so a record that was only partly written is detected on replay.
+* Appended records are kept in memory until they are committed or rolled back, so the records
+* of a change can be appended before the change is made, and dropped if the change fails.
+* Committed records are written to the file in blocks, and are synced to the disk (fsync)
+* once per group: when group_size records are pending, or when a commit finds that
+* group_interval_ms passed since the last sync. Nothing syncs a group between commits,
+* only journalSync does.
+*/
+
+/** The maximal number of integers in a record */
+#define JOURNAL_MAX_VALUES 8
+
+/** Type for defining the journal */
+typedef struct journal_t* Journal;
+
+/** Type used for returning error codes from journal functions */
+typedef enum {
+	JOURNAL_SUCCESS,
+	JOURNAL_OUT_OF_MEMORY,
+	JOURNAL_NULL_ARGUMENT,
+	JOURNAL_FILE_ERROR,
+	JOURNAL_RECORD_FAILED
+} JournalResult;
+
+/** Type of the function that replays a record, returns false to stop the replay */
+typedef bool(*JournalRecordFunc)(void* context, int type, const int* values, int values_count, const char* text);
+
+
+/*
+journalOpen: Opens a journal file for appending, creating it if needed.
+
+@param path - The path of the journal file.
+@param group_size - The number of records that are synced together, 1 syncs every record.
+@param group_interval_ms - The longest time in milliseconds that a record waits for its group,
+						   checked when the next records are committed. 0 disables the time limit.
+
+@return NULL if the path is NULL, group_size isn't positive, group_interval_ms is negative,
+		the file couldn't be opened or if a memory allocation failed.
+		Else, returns the journal.
+*/
+Journal journalOpen(const char* path, int group_size, int group_interval_ms);
+
+/*
+journalClose: Syncs the committed records and closes the journal, records that weren't committed are dropped.
+
+@param journal - The journal to close.
+*/
+void journalClose(Journal journal);
+
+/*
+journalAppend: Appends a record to the journal, which is written only once it is committed with journalCommit.
+
+@param journal - The journal to append to.
+@param type - The type of the record.
+@param values - The integers of the record.
+@param values_count - The number of integers, between 0 and JOURNAL_MAX_VALUES.
+@param text - The string of the record, or NULL.
+
+@return JOURNAL_NULL_ARGUMENT if the journal is NULL, or values is NULL while values_count is positive.
+		JOURNAL_OUT_OF_MEMORY if values_count is out of range, the record is too long or a memory allocation failed.
+		JOURNAL_SUCCESS if the record has been appended.
+*/
+JournalResult journalAppend(Journal journal, int type, const int* values, int values_count, const char* text);
+
+/*
+journalCommit: Commits the records that were appended since the last commit or rollback,
+			   and writes and syncs the journal if the group is complete.
+
+@param journal - The journal to commit.
+
+@return JOURNAL_NULL_ARGUMENT if the journal is NULL.
+		JOURNAL_FILE_ERROR if the records couldn't be written or synced (They stay committed,
+		and are written again by the next commit or sync).
+		JOURNAL_SUCCESS if the records have been committed.
+*/
+JournalResult journalCommit(Journal journal);
+
+/*
+journalRollback: Drops the records that were appended since the last commit or rollback.
+
+@param journal - The journal to roll back.
+*/
+void journalRollback(Journal journal);
+
+/*
+journalSync: Writes and syncs all of the committed records to the disk.
+
+@param journal - The journal to sync.
+
+@return JOURNAL_NULL_ARGUMENT if the journal is NULL.
+		JOURNAL_FILE_ERROR if syncing failed.
+		JOURNAL_SUCCESS if all of the committed records are on the disk.
+*/
+JournalResult journalSync(Journal journal);
+
+/*
+journalReplay: Reads the records of a journal file in order, and passes each one to a function.
+			   A partly written record at the end of the file (a crash during an append) ends the replay.
+
+@param path - The path of the journal file.
+@param replay - The function that replays a record.
+@param context - Passed to every call of replay.
+@param records - If not NULL, set to the number of records that were replayed.
+
+@return JOURNAL_NULL_ARGUMENT if the path or the function is NULL.
+		JOURNAL_FILE_ERROR if the file couldn't be read.
+		JOURNAL_OUT_OF_MEMORY if a memory allocation failed.
+		JOURNAL_RECORD_FAILED if replay returned false.
+		JOURNAL_SUCCESS if all of the complete records have been replayed.
+*/
+JournalResult journalReplay(const char* path, JournalRecordFunc replay, void* context, int* records);
+
+#endif /* _JOURNAL_H */
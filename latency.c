@@ -0,0 +1,403 @@
+#define _POSIX_C_SOURCE 200809L //For clock_gettime and pthread_key_t under -std=c99.
+
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include "latency.h"
+
+#define SUB_BUCKET_BITS 5 //LATENCY_SUB_BUCKETS is 2 to this power.
+#define MAX_VALUE_BITS 36 //LATENCY_MAX_VALUE is the largest value of this many bits.
+#define BUCKETS_COUNT ((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+#define NANOSECONDS_IN_SECOND 1000000000LL
+#define CALIBRATION_NANOSECONDS 1000000 //How long the clock ticks are measured against CLOCK_MONOTONIC.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define READ_TICKS() ((long long)__builtin_ia32_rdtsc())
+#else
+#define READ_TICKS() monotonicNow()
+#endif
+
+struct latency_histogram_t {
+	long long count;
+	long long total; //The sum of the values, for the mean.
+	long long min; //LLONG_MAX while the histogram is empty.
+	long long max;
+	long long buckets[BUCKETS_COUNT];
+};
+
+/** The histograms of a single thread, linked to the other sets of the recorder */
+typedef struct histogram_set_t {
+	struct histogram_set_t* next;
+	struct latency_histogram_t histograms[];
+}*HistogramSet;
+
+struct latency_recorder_t {
+	int histograms_count;
+	pthread_key_t key; //The set of the calling thread.
+	pthread_mutex_t lock; //Protects the list of sets, which threads add to when they first record.
+	HistogramSet sets;
+};
+
+static pthread_once_t calibration_once = PTHREAD_ONCE_INIT;
+static double nanoseconds_per_tick = 1; //Set once by calibrate.
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+monotonicNow: Returns the time of CLOCK_MONOTONIC.
+
+@return The time in nanoseconds since an unspecified point.
+*/
+static long long monotonicNow(void);
+
+/*
+calibrate: Measures the length of a clock tick, by counting the ticks in about a millisecond of CLOCK_MONOTONIC.
+		   Called once, through calibration_once.
+*/
+static void calibrate(void);
+
+/*
+highestBit: Returns the index of the highest set bit of a value.
+
+@param value - A positive value that is at most LATENCY_MAX_VALUE.
+
+@return The index of the highest set bit, 0 for the lowest bit.
+*/
+static int highestBit(long long value);
+
+/*
+bucketIndex: Returns the bucket that a value is counted in.
+
+@param value - A value between 0 and LATENCY_MAX_VALUE.
+
+@return The index of the bucket.
+*/
+static int bucketIndex(long long value);
+
+/*
+bucketHighestValue: Returns the highest value that is counted in a bucket.
+
+@param index - The index of the bucket.
+
+@return The highest value of the bucket.
+*/
+static long long bucketHighestValue(int index);
+
+/*
+createSet: Allocates an empty histogram set for the calling thread and links it to the recorder.
+
+@param recorder - The recorder of the set.
+
+@return NULL if a memory allocation failed.
+		Else, returns the set.
+*/
+static HistogramSet createSet(LatencyRecorder recorder);
+
+/* =---------------------------------------------------------------------------=
+
+								Latency Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+long long latencyNow(void)
+{
+	return READ_TICKS();
+}
+
+long long latencyElapsed(long long start)
+{
+	long long end = READ_TICKS();
+	pthread_once(&calibration_once, calibrate);
+	return (long long)((end - start) * nanoseconds_per_tick);
+}
+
+LatencyHistogram latencyHistogramCreate(void)
+{
+	LatencyHistogram histogram = malloc(sizeof(*histogram));
+	if (histogram == NULL) {
+		return NULL;
+	}
+	latencyHistogramReset(histogram);
+	return histogram;
+}
+
+void latencyHistogramDestroy(LatencyHistogram histogram)
+{
+	free(histogram);
+}
+
+void latencyHistogramReset(LatencyHistogram histogram)
+{
+	if (histogram == NULL) {
+		return;
+	}
+	for (int i = 0; i < BUCKETS_COUNT; i++) {
+		histogram->buckets[i] = 0;
+	}
+	histogram->count = 0;
+	histogram->total = 0;
+	histogram->min = LLONG_MAX;
+	histogram->max = 0;
+}
+
+void latencyHistogramRecord(LatencyHistogram histogram, long long value)
+{
+	if (histogram == NULL) {
+		return;
+	}
+	if (value < 0) {
+		value = 0;
+	}
+	else if (value > LATENCY_MAX_VALUE) {
+		value = LATENCY_MAX_VALUE;
+	}
+	histogram->buckets[bucketIndex(value)]++;
+	histogram->count++;
+	histogram->total += value;
+	if (value < histogram->min) {
+		histogram->min = value;
+	}
+	if (value > histogram->max) {
+		histogram->max = value;
+	}
+}
+
+LatencyResult latencyHistogramMerge(LatencyHistogram destination, LatencyHistogram source)
+{
+	if (destination == NULL || source == NULL) {
+		return LATENCY_NULL_ARGUMENT;
+	}
+	for (int i = 0; i < BUCKETS_COUNT; i++) {
+		destination->buckets[i] += source->buckets[i];
+	}
+	destination->count += source->count;
+	destination->total += source->total;
+	if (source->min < destination->min) {
+		destination->min = source->min;
+	}
+	if (source->max > destination->max) {
+		destination->max = source->max;
+	}
+	return LATENCY_SUCCESS;
+}
+
+long long latencyHistogramGetCount(LatencyHistogram histogram)
+{
+	return histogram == NULL ? 0 : histogram->count;
+}
+
+long long latencyHistogramGetMin(LatencyHistogram histogram)
+{
+	return histogram == NULL || histogram->count == 0 ? 0 : histogram->min;
+}
+
+long long latencyHistogramGetMax(LatencyHistogram histogram)
+{
+	return histogram == NULL ? 0 : histogram->max;
+}
+
+double latencyHistogramGetMean(LatencyHistogram histogram)
+{
+	if (histogram == NULL || histogram->count == 0) {
+		return 0;
+	}
+	return (double)histogram->total / histogram->count;
+}
+
+long long latencyHistogramGetPercentile(LatencyHistogram histogram, double percentile)
+{
+	if (histogram == NULL || histogram->count == 0) {
+		return 0;
+	}
+	if (percentile > 100) {
+		percentile = 100;
+	}
+	long long rank = (long long)(percentile / 100 * histogram->count + 0.5); //Rounded to the nearest value.
+	if (rank < 1) {
+		rank = 1;
+	}
+
+	long long seen = 0;
+	for (int i = 0; i < BUCKETS_COUNT; i++) {
+		seen += histogram->buckets[i];
+		if (seen >= rank) {
+			long long value = bucketHighestValue(i);
+			return value < histogram->max ? value : histogram->max;
+		}
+	}
+	return histogram->max;
+}
+
+LatencyRecorder latencyRecorderCreate(int histograms_count)
+{
+	if (histograms_count <= 0) {
+		return NULL;
+	}
+	pthread_once(&calibration_once, calibrate); //So that the first recorded latency doesn't include the calibration.
+	LatencyRecorder recorder = malloc(sizeof(*recorder));
+	if (recorder == NULL) {
+		return NULL;
+	}
+	if (pthread_key_create(&recorder->key, NULL) != 0) {
+		free(recorder);
+		return NULL;
+	}
+	if (pthread_mutex_init(&recorder->lock, NULL) != 0) {
+		pthread_key_delete(recorder->key);
+		free(recorder);
+		return NULL;
+	}
+	recorder->histograms_count = histograms_count;
+	recorder->sets = NULL;
+	return recorder;
+}
+
+void latencyRecorderDestroy(LatencyRecorder recorder)
+{
+	if (recorder == NULL) {
+		return;
+	}
+	while (recorder->sets != NULL) {
+		HistogramSet next = recorder->sets->next;
+		free(recorder->sets);
+		recorder->sets = next;
+	}
+	pthread_key_delete(recorder->key);
+	pthread_mutex_destroy(&recorder->lock);
+	free(recorder);
+}
+
+void latencyRecorderRecord(LatencyRecorder recorder, int histogram, long long value)
+{
+	if (recorder == NULL || histogram < 0 || histogram >= recorder->histograms_count) {
+		return;
+	}
+	HistogramSet set = pthread_getspecific(recorder->key);
+	if (set == NULL) {
+		set = createSet(recorder);
+		if (set == NULL) {
+			return;
+		}
+	}
+	latencyHistogramRecord(&set->histograms[histogram], value);
+}
+
+LatencyResult latencyRecorderMerge(LatencyRecorder recorder, int histogram, LatencyHistogram merged)
+{
+	if (recorder == NULL || merged == NULL) {
+		return LATENCY_NULL_ARGUMENT;
+	}
+	if (histogram < 0 || histogram >= recorder->histograms_count) {
+		return LATENCY_INVALID_HISTOGRAM;
+	}
+	pthread_mutex_lock(&recorder->lock);
+	for (HistogramSet set = recorder->sets; set != NULL; set = set->next) {
+		latencyHistogramMerge(merged, &set->histograms[histogram]);
+	}
+	pthread_mutex_unlock(&recorder->lock);
+	return LATENCY_SUCCESS;
+}
+
+void latencyRecorderReset(LatencyRecorder recorder)
+{
+	if (recorder == NULL) {
+		return;
+	}
+	pthread_mutex_lock(&recorder->lock);
+	for (HistogramSet set = recorder->sets; set != NULL; set = set->next) {
+		for (int i = 0; i < recorder->histograms_count; i++) {
+			latencyHistogramReset(&set->histograms[i]);
+		}
+	}
+	pthread_mutex_unlock(&recorder->lock);
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static long long monotonicNow(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * NANOSECONDS_IN_SECOND + now.tv_nsec;
+}
+
+static void calibrate(void)
+{
+	long long start_time = monotonicNow();
+	long long start_ticks = READ_TICKS();
+	long long end_time = start_time;
+	while (end_time - start_time < CALIBRATION_NANOSECONDS) {
+		end_time = monotonicNow();
+	}
+	long long ticks = READ_TICKS() - start_ticks;
+	if (ticks > 0) {
+		nanoseconds_per_tick = (double)(end_time - start_time) / ticks;
+	}
+}
+
+static int highestBit(long long value)
+{
+#ifdef __GNUC__
+	return 63 - __builtin_clzll((unsigned long long)value);
+#else
+	int bit = 0;
+	for (int step = 32; step > 0; step /= 2) { //A binary search, 6 steps for any value.
+		if (value >= (1LL << step)) {
+			value >>= step;
+			bit += step;
+		}
+	}
+	return bit;
+#endif
+}
+
+static int bucketIndex(long long value)
+{
+	if (value < LATENCY_SUB_BUCKETS) {
+		return (int)value;
+	}
+	int shift = highestBit(value) - SUB_BUCKET_BITS;
+	return (shift + 1) * LATENCY_SUB_BUCKETS + (int)(value >> shift) - LATENCY_SUB_BUCKETS;
+}
+
+static long long bucketHighestValue(int index)
+{
+	if (index < LATENCY_SUB_BUCKETS) {
+		return index;
+	}
+	int shift = index / LATENCY_SUB_BUCKETS - 1;
+	long long sub_bucket = index % LATENCY_SUB_BUCKETS + LATENCY_SUB_BUCKETS;
+	return ((sub_bucket + 1) << shift) - 1;
+}
+
+static HistogramSet createSet(LatencyRecorder recorder)
+{
+	HistogramSet set = malloc(sizeof(*set) + sizeof(set->histograms[0]) * recorder->histograms_count);
+	if (set == NULL) {
+		return NULL;
+	}
+	for (int i = 0; i < recorder->histograms_count; i++) {
+		latencyHistogramReset(&set->histograms[i]);
+	}
+	if (pthread_setspecific(recorder->key, set) != 0) {
+		free(set);
+		return NULL;
+	}
+	pthread_mutex_lock(&recorder->lock);
+	set->next = recorder->sets;
+	recorder->sets = set;
+	pthread_mutex_unlock(&recorder->lock);
+	return set;
+}
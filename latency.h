@@ -0,0 +1,197 @@
+#ifndef _LATENCY_H
+#define _LATENCY_H
+
+/*
+* Latency histograms in the style of HdrHistogram.
+* Values are counted in log-linear buckets: values below LATENCY_SUB_BUCKETS have a bucket each,
+* and every power of 2 above them is split into LATENCY_SUB_BUCKETS equal buckets, so a value is
+* reported with a relative error of at most 1/LATENCY_SUB_BUCKETS. Recording is a few shifts and
+* an increment, and histograms with the same layout are merged by adding their buckets.
+* A recorder keeps a set of histograms for every thread that records into it, so threads record
+* without locks or atomics, and the sets are merged when the histograms are read.
+* Timestamps are taken from the time stamp counter on x86 with GCC or Clang, which is read in a
+* few nanoseconds and assumed to be invariant (constant rate and synchronized between cores, as on
+* every x86 processor of the last decade), and from CLOCK_MONOTONIC elsewhere.
+*/
+
+/** Type for defining a latency histogram */
+typedef struct latency_histogram_t* LatencyHistogram;
+
+/** Type for defining a recorder of per-thread histogram sets */
+typedef struct latency_recorder_t* LatencyRecorder;
+
+/** Type used for returning error codes from latency functions */
+typedef enum {
+	LATENCY_SUCCESS,
+	LATENCY_NULL_ARGUMENT,
+	LATENCY_INVALID_HISTOGRAM
+} LatencyResult;
+
+/** The number of buckets every power of 2 is split into */
+#define LATENCY_SUB_BUCKETS 32
+
+/** The largest value that is recorded exactly, larger values are recorded as it (about 68 seconds in nanoseconds) */
+#define LATENCY_MAX_VALUE ((1LL << 36) - 1)
+
+
+/*
+latencyNow: Returns a timestamp of the fastest monotonic clock available, for measuring latencies.
+
+@return The time in clock ticks since an unspecified point, only meaningful when passed to latencyElapsed.
+*/
+long long latencyNow(void);
+
+/*
+latencyElapsed: Returns the time that passed since a timestamp.
+				The first call calibrates the clock ticks against CLOCK_MONOTONIC, which takes about a millisecond.
+
+@param start - A timestamp returned by latencyNow.
+
+@return The time since start in nanoseconds.
+*/
+long long latencyElapsed(long long start);
+
+/*
+latencyHistogramCreate: Creates a new empty histogram.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty histogram.
+*/
+LatencyHistogram latencyHistogramCreate(void);
+
+/*
+latencyHistogramDestroy: Deallocates a histogram.
+
+@param histogram - The histogram to deallocate.
+*/
+void latencyHistogramDestroy(LatencyHistogram histogram);
+
+/*
+latencyHistogramReset: Empties a histogram.
+
+@param histogram - The histogram to empty.
+*/
+void latencyHistogramReset(LatencyHistogram histogram);
+
+/*
+latencyHistogramRecord: Counts a value in a histogram.
+
+@param histogram - The histogram to record in.
+@param value - The value to record, negative values are recorded as 0.
+*/
+void latencyHistogramRecord(LatencyHistogram histogram, long long value);
+
+/*
+latencyHistogramMerge: Adds the values of one histogram to another.
+
+@param destination - The histogram to add to.
+@param source - The histogram to add, it isn't changed.
+
+@return LATENCY_NULL_ARGUMENT if one of the arguments is NULL.
+		LATENCY_SUCCESS if the values have been added.
+*/
+LatencyResult latencyHistogramMerge(LatencyHistogram destination, LatencyHistogram source);
+
+/*
+latencyHistogramGetCount: Returns the number of values recorded in a histogram.
+
+@param histogram - The histogram to count.
+
+@return 0 if the histogram is NULL.
+		Else, returns the number of values.
+*/
+long long latencyHistogramGetCount(LatencyHistogram histogram);
+
+/*
+latencyHistogramGetMin: Returns the smallest value recorded in a histogram.
+
+@param histogram - The histogram to read.
+
+@return 0 if the histogram is NULL or empty.
+		Else, returns the smallest value.
+*/
+long long latencyHistogramGetMin(LatencyHistogram histogram);
+
+/*
+latencyHistogramGetMax: Returns the largest value recorded in a histogram.
+
+@param histogram - The histogram to read.
+
+@return 0 if the histogram is NULL or empty.
+		Else, returns the largest value.
+*/
+long long latencyHistogramGetMax(LatencyHistogram histogram);
+
+/*
+latencyHistogramGetMean: Returns the mean of the values recorded in a histogram.
+
+@param histogram - The histogram to read.
+
+@return 0 if the histogram is NULL or empty.
+		Else, returns the mean of the values.
+*/
+double latencyHistogramGetMean(LatencyHistogram histogram);
+
+/*
+latencyHistogramGetPercentile: Returns the value that the given percentage of the recorded values are at most.
+
+@param histogram - The histogram to read.
+@param percentile - The percentage, between 0 and 100 (For example 99.9 for p999).
+
+@return 0 if the histogram is NULL or empty.
+		Else, returns the highest value of the bucket that the percentile falls in,
+		but no more than the largest recorded value.
+*/
+long long latencyHistogramGetPercentile(LatencyHistogram histogram, double percentile);
+
+/*
+latencyRecorderCreate: Creates a new recorder of histogram sets.
+
+@param histograms_count - The number of histograms in every set.
+
+@return NULL if histograms_count isn't positive or if a memory allocation failed.
+		Else, returns a new recorder.
+*/
+LatencyRecorder latencyRecorderCreate(int histograms_count);
+
+/*
+latencyRecorderDestroy: Deallocates a recorder and the histogram sets of all of its threads.
+						No thread may record into the recorder while it is destroyed.
+
+@param recorder - The recorder to deallocate.
+*/
+void latencyRecorderDestroy(LatencyRecorder recorder);
+
+/*
+latencyRecorderRecord: Counts a value in a histogram of the calling thread's set.
+					   The first record of a thread allocates its set, and if that fails the value is dropped.
+
+@param recorder - The recorder to record in.
+@param histogram - The index of the histogram in the set.
+@param value - The value to record.
+*/
+void latencyRecorderRecord(LatencyRecorder recorder, int histogram, long long value);
+
+/*
+latencyRecorderMerge: Adds a histogram of every thread's set to a histogram.
+					  Threads must not record into the recorder while it is merged.
+
+@param recorder - The recorder to read.
+@param histogram - The index of the histogram in the sets.
+@param merged - The histogram to add to.
+
+@return LATENCY_NULL_ARGUMENT if the recorder or merged is NULL.
+		LATENCY_INVALID_HISTOGRAM if the index is out of range.
+		LATENCY_SUCCESS if the histograms have been added.
+*/
+LatencyResult latencyRecorderMerge(LatencyRecorder recorder, int histogram, LatencyHistogram merged);
+
+/*
+latencyRecorderReset: Empties the histograms of every thread's set.
+					  Threads must not record into the recorder while it is reset.
+
+@param recorder - The recorder to reset.
+*/
+void latencyRecorderReset(LatencyRecorder recorder);
+
+#endif /* _LATENCY_H */
@@ -0,0 +1,414 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "member_table.h"
+#include "sorted_ids.h"
+#include "stats.h"
+
+#define INITIAL_CAPACITY 16
+#define INITIAL_NAMES_CAPACITY 256
+#define INITIAL_EVENTS_CAPACITY 4
+
+struct member_table_t {
+	int* ids;
+	int* event_counts; //The number of events every member is ranked by.
+	int** events; //The sorted event ids of every member.
+	int* events_sizes;
+	int* events_capacities;
+	int* name_offsets; //The offset of every member's name in names.
+	int* ranking; //The member indexes by priority.
+	int* ranks; //The rank of every member, the inverse of ranking.
+	int size;
+	int capacity; //The length of the member arrays.
+	char* names; //The names of the members, each one followed by '\0'.
+	int names_size;
+	int names_capacity;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+resize: Moves an array into a new allocation of a different length.
+
+@param allocator - The allocator of the array.
+@param array - The array to move, deallocated if the allocation succeeded.
+@param used - The number of bytes of the array to copy.
+@param size - The number of bytes to allocate.
+
+@return NULL if the allocation failed (The array is left unchanged).
+		Else, returns the new array.
+*/
+static void* resize(const Allocator* allocator, void* array, size_t used, size_t size);
+
+/*
+growMembers: Doubles the length of the member arrays.
+
+@param table - The table to grow.
+
+@return False if a memory allocation failed (The arrays that were already moved keep the new length).
+		Else, returns True.
+*/
+static bool growMembers(MemberTable table);
+
+/*
+setEvents: Sets the events of a new member, in an allocation with room for more events.
+
+@param table - The table of the member.
+@param index - The index of the member.
+@param event_ids - The sorted ids of the events.
+@param event_count - The number of events.
+
+@return False if a memory allocation failed.
+		Else, returns True.
+*/
+static bool setEvents(MemberTable table, int index, const int* event_ids, int event_count);
+
+/*
+addName: Appends a name to the names blob, growing it if needed.
+
+@param table - The table to add to.
+@param name - The name to append.
+
+@return -1 if a memory allocation failed.
+		Else, returns the offset of the name in the blob.
+*/
+static int addName(MemberTable table, const char* name);
+
+/*
+rankedBefore: Returns whether a member has a higher priority than another member.
+
+@param table - The table of the members.
+@param index1 - The index of the first member.
+@param index2 - The index of the second member.
+
+@return True if the first member has more events, or has the same number of events and a smaller id.
+		Else, returns False.
+*/
+static bool rankedBefore(MemberTable table, int index1, int index2);
+
+/*
+findRank: Returns the first rank in a range of the ranking that a member isn't ranked after.
+
+@param table - The table of the member.
+@param index - The index of the member.
+@param low - The first rank of the range.
+@param high - The rank after the range.
+
+@return The first rank in [low, high) whose member isn't ranked before the member, or high if there is none.
+*/
+static int findRank(MemberTable table, int index, int low, int high);
+
+/*
+placeRanks: Sets the ranks of the members in a range of the ranking.
+
+@param table - The table of the members.
+@param low - The first rank to set.
+@param high - The rank after the last rank to set.
+*/
+static void placeRanks(MemberTable table, int low, int high);
+
+/* =---------------------------------------------------------------------------=
+
+								Member Table Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+MemberTable memberTableCreate(const Allocator* allocator)
+{
+	MemberTable table = allocatorAlloc(allocator, sizeof(*table));
+	if (table == NULL) {
+		return NULL;
+	}
+	table->ids = NULL;
+	table->event_counts = NULL;
+	table->events = NULL;
+	table->events_sizes = NULL;
+	table->events_capacities = NULL;
+	table->name_offsets = NULL;
+	table->ranking = NULL;
+	table->ranks = NULL;
+	table->size = 0;
+	table->capacity = 0;
+	table->names = NULL;
+	table->names_size = 0;
+	table->names_capacity = 0;
+	table->allocator = allocator;
+	return table;
+}
+
+void memberTableDestroy(MemberTable table)
+{
+	if (table == NULL) {
+		return;
+	}
+	for (int i = 0; i < table->size; i++) {
+		allocatorFree(table->allocator, table->events[i]);
+	}
+	allocatorFree(table->allocator, table->ids);
+	allocatorFree(table->allocator, table->event_counts);
+	allocatorFree(table->allocator, table->events);
+	allocatorFree(table->allocator, table->events_sizes);
+	allocatorFree(table->allocator, table->events_capacities);
+	allocatorFree(table->allocator, table->name_offsets);
+	allocatorFree(table->allocator, table->ranking);
+	allocatorFree(table->allocator, table->ranks);
+	allocatorFree(table->allocator, table->names);
+	allocatorFree(table->allocator, table);
+}
+
+int memberTableAdd(MemberTable table, int id, const char* name, const int* event_ids, int event_count)
+{
+	if (table == NULL || name == NULL || (event_ids == NULL && event_count > 0)) {
+		return MEMBER_TABLE_NO_INDEX;
+	}
+	if (table->size == table->capacity && !growMembers(table)) {
+		return MEMBER_TABLE_NO_INDEX;
+	}
+	int index = table->size;
+	if (!setEvents(table, index, event_ids, event_count)) {
+		return MEMBER_TABLE_NO_INDEX;
+	}
+	int offset = addName(table, name);
+	if (offset < 0) {
+		allocatorFree(table->allocator, table->events[index]);
+		return MEMBER_TABLE_NO_INDEX;
+	}
+
+	table->size++;
+	table->ids[index] = id;
+	table->event_counts[index] = event_count;
+	table->name_offsets[index] = offset;
+	int rank = findRank(table, index, 0, index);
+	memmove(&table->ranking[rank + 1], &table->ranking[rank], sizeof(*table->ranking) * (index - rank));
+	table->ranking[rank] = index;
+	placeRanks(table, rank, table->size);
+	return index;
+}
+
+int memberTableFind(MemberTable table, int id)
+{
+	if (table == NULL) {
+		return MEMBER_TABLE_NO_INDEX;
+	}
+	for (int i = 0; i < table->size; i++) {
+		if (table->ids[i] == id) {
+			return i;
+		}
+	}
+	return MEMBER_TABLE_NO_INDEX;
+}
+
+bool memberTableLinkEvent(MemberTable table, int index, int event_id)
+{
+	if (table == NULL || index < 0 || index >= table->size) {
+		return false;
+	}
+	int* events = table->events[index];
+	int size = table->events_sizes[index];
+	int position = sortedIdsLowerBound(events, size, event_id);
+	if (position < size && events[position] == event_id) {
+		return false;
+	}
+	if (size == table->events_capacities[index]) {
+		int capacity = size * 2;
+		events = resize(table->allocator, events, sizeof(*events) * size, sizeof(*events) * capacity);
+		if (events == NULL) {
+			return false;
+		}
+		table->events[index] = events;
+		table->events_capacities[index] = capacity;
+	}
+	memmove(&events[position + 1], &events[position], sizeof(*events) * (size - position));
+	events[position] = event_id;
+	table->events_sizes[index]++;
+	return true;
+}
+
+bool memberTableUnlinkEvent(MemberTable table, int index, int event_id)
+{
+	if (table == NULL || index < 0 || index >= table->size) {
+		return false;
+	}
+	int* events = table->events[index];
+	int size = table->events_sizes[index];
+	int position = sortedIdsLowerBound(events, size, event_id);
+	if (position == size || events[position] != event_id) {
+		return false;
+	}
+	memmove(&events[position], &events[position + 1], sizeof(*events) * (size - position - 1));
+	table->events_sizes[index]--;
+	return true;
+}
+
+void memberTableUpdateRank(MemberTable table, int index)
+{
+	if (table == NULL || index < 0 || index >= table->size) {
+		return;
+	}
+	int increment = table->events_sizes[index] - table->event_counts[index];
+	if (increment == 0) {
+		return;
+	}
+	table->event_counts[index] += increment;
+	int old_rank = table->ranks[index];
+	if (increment > 0) { //Moves toward the first rank, shifting the members it passes back.
+		int rank = findRank(table, index, 0, old_rank);
+		memmove(&table->ranking[rank + 1], &table->ranking[rank], sizeof(*table->ranking) * (old_rank - rank));
+		table->ranking[rank] = index;
+		placeRanks(table, rank, old_rank + 1);
+	}
+	else { //Moves toward the last rank, shifting the members it passes forward.
+		int rank = findRank(table, index, old_rank + 1, table->size) - 1;
+		memmove(&table->ranking[old_rank], &table->ranking[old_rank + 1], sizeof(*table->ranking) * (rank - old_rank));
+		table->ranking[rank] = index;
+		placeRanks(table, old_rank, rank + 1);
+	}
+}
+
+int memberTableGetSize(MemberTable table)
+{
+	return table == NULL ? MEMBER_TABLE_NO_SIZE : table->size;
+}
+
+int memberTableGetRanked(MemberTable table, int rank)
+{
+	if (table == NULL || rank < 0 || rank >= table->size) {
+		return MEMBER_TABLE_NO_INDEX;
+	}
+	return table->ranking[rank];
+}
+
+int memberTableGetId(MemberTable table, int index)
+{
+	return table->ids[index];
+}
+
+int memberTableGetEventCount(MemberTable table, int index)
+{
+	return table->event_counts[index];
+}
+
+const int* memberTableGetEvents(MemberTable table, int index, int* count)
+{
+	*count = table->events_sizes[index];
+	return table->events[index];
+}
+
+const char* memberTableGetName(MemberTable table, int index)
+{
+	return table->names + table->name_offsets[index];
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void* resize(const Allocator* allocator, void* array, size_t used, size_t size)
+{
+	void* resized = allocatorAlloc(allocator, size);
+	if (resized == NULL) {
+		return NULL;
+	}
+	if (used > 0) {
+		memcpy(resized, array, used);
+	}
+	allocatorFree(allocator, array);
+	return resized;
+}
+
+static bool growMembers(MemberTable table)
+{
+	int capacity = table->capacity == 0 ? INITIAL_CAPACITY : table->capacity * 2;
+	int** arrays[] = { &table->ids, &table->event_counts, &table->events_sizes, &table->events_capacities,
+		&table->name_offsets, &table->ranking, &table->ranks };
+	for (int i = 0; i < (int)(sizeof(arrays) / sizeof(arrays[0])); i++) {
+		int* resized = resize(table->allocator, *arrays[i], sizeof(int) * table->size, sizeof(int) * capacity);
+		if (resized == NULL) {
+			return false;
+		}
+		*arrays[i] = resized;
+	}
+	int** events = resize(table->allocator, table->events, sizeof(*events) * table->size, sizeof(*events) * capacity);
+	if (events == NULL) {
+		return false;
+	}
+	table->events = events;
+	table->capacity = capacity;
+	return true;
+}
+
+static bool setEvents(MemberTable table, int index, const int* event_ids, int event_count)
+{
+	int capacity = event_count > INITIAL_EVENTS_CAPACITY ? event_count : INITIAL_EVENTS_CAPACITY;
+	int* events = allocatorAlloc(table->allocator, sizeof(*events) * capacity);
+	if (events == NULL) {
+		return false;
+	}
+	if (event_count > 0) {
+		memcpy(events, event_ids, sizeof(*events) * event_count);
+	}
+	table->events[index] = events;
+	table->events_sizes[index] = event_count;
+	table->events_capacities[index] = capacity;
+	return true;
+}
+
+static int addName(MemberTable table, const char* name)
+{
+	int length = (int)strlen(name) + 1;
+	if (table->names_size + length > table->names_capacity) {
+		int capacity = table->names_capacity == 0 ? INITIAL_NAMES_CAPACITY : table->names_capacity;
+		while (capacity < table->names_size + length) {
+			capacity *= 2;
+		}
+		char* names = resize(table->allocator, table->names, table->names_size, capacity);
+		if (names == NULL) {
+			return -1;
+		}
+		table->names = names;
+		table->names_capacity = capacity;
+	}
+	int offset = table->names_size;
+	memcpy(table->names + offset, name, length);
+	table->names_size += length;
+	return offset;
+}
+
+static bool rankedBefore(MemberTable table, int index1, int index2)
+{
+	STATS_COUNT(comparisons);
+	int count1 = table->event_counts[index1], count2 = table->event_counts[index2];
+	return count1 > count2 || (count1 == count2 && table->ids[index1] < table->ids[index2]);
+}
+
+static int findRank(MemberTable table, int index, int low, int high)
+{
+	while (low < high) { //The members ranked before the member are a prefix of the range.
+		int middle = low + (high - low) / 2;
+		if (rankedBefore(table, table->ranking[middle], index)) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static void placeRanks(MemberTable table, int low, int high)
+{
+	for (int rank = low; rank < high; rank++) {
+		table->ranks[table->ranking[rank]] = rank;
+	}
+}
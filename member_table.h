@@ -0,0 +1,175 @@
+#ifndef _MEMBER_TABLE_H
+#define _MEMBER_TABLE_H
+
+#include <stdbool.h>
+#include "allocator.h"
+
+/*
+* A columnar table of members.
+* The members are stored in parallel arrays by their index (ids, event counts, and offsets
+* of the names in a single blob of names), so a scan over one field walks a single array.
+* The ranking keeps the member indexes ordered by priority: more events first, and the
+* smaller id first between members with the same number of events.
+* Every member also keeps the sorted ids of the events it is linked to, the reverse of the
+* events' member lists. Linking and unlinking events don't move the member in the ranking,
+* it is moved to the rank of its new number of events by memberTableUpdateRank, shifting
+* the members between its old and new ranks, without allocating. Until then the member is
+* ranked by its previous number of events, which keeps the ranking sorted when the events
+* of several members are changed together.
+* Indexes are given in the order the members are added and never change.
+*/
+
+/** Type for defining the member table */
+typedef struct member_table_t* MemberTable;
+
+/** Returned instead of an index when there is no such member */
+#define MEMBER_TABLE_NO_INDEX -1
+
+/** Returned as the size of a NULL table */
+#define MEMBER_TABLE_NO_SIZE -1
+
+
+/*
+memberTableCreate: Creates a new empty member table.
+
+@param allocator - The allocator of the table, or NULL for the default allocator.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty table.
+*/
+MemberTable memberTableCreate(const Allocator* allocator);
+
+/*
+memberTableDestroy: Deallocates the table and the names and events of its members.
+
+@param table - The table to deallocate.
+*/
+void memberTableDestroy(MemberTable table);
+
+/*
+memberTableAdd: Adds a member to the table and ranks it by its number of events.
+				The id isn't checked against the ids in the table.
+
+@param table - The table to add to.
+@param id - The id of the member.
+@param name - The name of the member, copied into the table.
+@param event_ids - The ids of the member's events, sorted and unique, copied into the table.
+				   May be NULL if the member has no events.
+@param event_count - The number of events of the member.
+
+@return MEMBER_TABLE_NO_INDEX if the table or name is NULL, the event ids are NULL while event_count is positive,
+		or if a memory allocation failed.
+		Else, returns the index of the new member.
+*/
+int memberTableAdd(MemberTable table, int id, const char* name, const int* event_ids, int event_count);
+
+/*
+memberTableFind: Searches for a member by its id, scanning the ids in order.
+
+@param table - The table to search.
+@param id - The id to search for.
+
+@return MEMBER_TABLE_NO_INDEX if the table is NULL or there is no member with the id.
+		Else, returns the index of the member.
+*/
+int memberTableFind(MemberTable table, int id);
+
+/*
+memberTableLinkEvent: Adds an event to the sorted events of a member.
+					  The member keeps its rank until memberTableUpdateRank is called.
+
+@param table - The table of the member.
+@param index - The index of the member.
+@param event_id - The id of the event.
+
+@return False if the table is NULL, the index is out of range, the member is already linked to the event,
+		or if a memory allocation failed.
+		Else, returns True.
+*/
+bool memberTableLinkEvent(MemberTable table, int index, int event_id);
+
+/*
+memberTableUnlinkEvent: Removes an event from the sorted events of a member, without allocating.
+						The member keeps its rank until memberTableUpdateRank is called.
+
+@param table - The table of the member.
+@param index - The index of the member.
+@param event_id - The id of the event.
+
+@return False if the table is NULL, the index is out of range or the member isn't linked to the event.
+		Else, returns True.
+*/
+bool memberTableUnlinkEvent(MemberTable table, int index, int event_id);
+
+/*
+memberTableUpdateRank: Moves a member to the rank of its number of events.
+
+@param table - The table of the member.
+@param index - The index of the member, nothing is done if it is out of range.
+*/
+void memberTableUpdateRank(MemberTable table, int index);
+
+/*
+memberTableGetSize: Returns the number of members in the table.
+
+@param table - The table to count.
+
+@return MEMBER_TABLE_NO_SIZE if the table is NULL.
+		Else, returns the number of members.
+*/
+int memberTableGetSize(MemberTable table);
+
+/*
+memberTableGetRanked: Returns the member at a rank of the ranking.
+
+@param table - The table to read.
+@param rank - The rank, 0 for the member with the highest priority.
+
+@return MEMBER_TABLE_NO_INDEX if the table is NULL or the rank is out of range.
+		Else, returns the index of the member.
+*/
+int memberTableGetRanked(MemberTable table, int rank);
+
+/*
+memberTableGetId: Returns the id of a member.
+
+@param table - The table of the member.
+@param index - The index of the member, which must be in range.
+
+@return The id of the member.
+*/
+int memberTableGetId(MemberTable table, int index);
+
+/*
+memberTableGetEventCount: Returns the number of events a member is ranked by.
+
+@param table - The table of the member.
+@param index - The index of the member, which must be in range.
+
+@return The event count of the member, as of its last rank update.
+*/
+int memberTableGetEventCount(MemberTable table, int index);
+
+/*
+memberTableGetEvents: Returns the events of a member.
+
+@param table - The table of the member.
+@param index - The index of the member, which must be in range.
+@param count - Set to the number of events.
+
+@return The ids of the events sorted in ascending order (NOT A COPY), valid until the member's events change.
+		May be NULL if the member has no events.
+*/
+const int* memberTableGetEvents(MemberTable table, int index, int* count);
+
+/*
+memberTableGetName: Returns the name of a member.
+
+@param table - The table of the member.
+@param index - The index of the member, which must be in range.
+
+@return The name of the member (NOT A COPY), valid until the next member is added.
+*/
+const char* memberTableGetName(MemberTable table, int index);
+
+#endif /* _MEMBER_TABLE_H */
@@ -0,0 +1,272 @@
+#define _POSIX_C_SOURCE 200809L //For pthread under -std=c99.
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "multi_queue.h"
+#include "priority_queue_ext.h"
+
+#define NO_SIZE -1
+#define INSERT_TRY_LOCK_ATTEMPTS 4
+#define RANDOM_MULTIPLIER 2654435761u
+
+/** A single PriorityQueue with its own lock */
+typedef struct {
+	PriorityQueue queue;
+	pthread_mutex_t lock;
+} Shard;
+
+struct MultiQueue_t {
+	Shard* shards;
+	int shards_count;
+	int size;
+	CopyPQElement copyElement;
+	ComparePQElementPriorities comparePriorities;
+};
+
+/** Each thread has its own random state, so picking a shard doesn't touch shared memory */
+static __thread unsigned int random_state = 0;
+static unsigned int random_seeds = 0;
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+nextRandom: Returns the next number of the calling thread's xorshift generator.
+			The generator is seeded on the first call of every thread.
+
+@return A pseudo random number.
+*/
+static unsigned int nextRandom(void);
+
+/*
+removeBest: Removes the higher priority head of two random shards.
+			If both shards are empty, the other shards are searched in order.
+
+@param queue - The multi queue to remove the element from.
+@param element - If not NULL, set to a copy of the removed element.
+
+@return False if the multi queue is empty or if copying the element failed.
+		Else, returns True.
+*/
+static bool removeBest(MultiQueue queue, PQElement* element);
+
+/*
+removeFromShard: Removes the head of a locked shard.
+
+@param queue - The multi queue that stores the shard.
+@param shard - The locked shard to remove the head from.
+@param element - If not NULL, set to a copy of the removed element.
+
+@return False if the shard is empty or if copying the element failed.
+		Else, returns True.
+*/
+static bool removeFromShard(MultiQueue queue, Shard* shard, PQElement* element);
+
+/*
+removeFromAnyShard: Removes the head of the first non empty shard.
+
+@param queue - The multi queue to remove the element from.
+@param element - If not NULL, set to a copy of the removed element.
+
+@return False if all of the shards are empty or if copying the element failed.
+		Else, returns True.
+*/
+static bool removeFromAnyShard(MultiQueue queue, PQElement* element);
+
+/* =---------------------------------------------------------------------------=
+
+								Multi Queue Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+MultiQueue mqCreate(int shards, CopyPQElement copy_element, FreePQElement free_element,
+	EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+	FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities)
+{
+	if (shards <= 0 || copy_element == NULL || free_element == NULL || equal_elements == NULL ||
+		copy_priority == NULL || free_priority == NULL || compare_priorities == NULL) {
+		return NULL;
+	}
+
+	MultiQueue queue = malloc(sizeof(*queue));
+	if (queue == NULL) {
+		return NULL;
+	}
+	queue->shards = malloc(sizeof(*queue->shards) * shards);
+	if (queue->shards == NULL) {
+		free(queue);
+		return NULL;
+	}
+	for (int i = 0; i < shards; i++) {
+		queue->shards[i].queue = pqCreate(copy_element, free_element, equal_elements,
+			copy_priority, free_priority, compare_priorities);
+		if (queue->shards[i].queue == NULL || pthread_mutex_init(&queue->shards[i].lock, NULL) != 0) {
+			pqDestroy(queue->shards[i].queue);
+			queue->shards_count = i;
+			mqDestroy(queue);
+			return NULL;
+		}
+	}
+	queue->shards_count = shards;
+	queue->size = 0;
+	queue->copyElement = copy_element;
+	queue->comparePriorities = compare_priorities;
+	return queue;
+}
+
+void mqDestroy(MultiQueue queue)
+{
+	if (queue == NULL) {
+		return;
+	}
+	for (int i = 0; i < queue->shards_count; i++) {
+		pqDestroy(queue->shards[i].queue);
+		pthread_mutex_destroy(&queue->shards[i].lock);
+	}
+	free(queue->shards);
+	free(queue);
+}
+
+int mqGetSize(MultiQueue queue)
+{
+	if (queue == NULL) {
+		return NO_SIZE;
+	}
+	return __atomic_load_n(&queue->size, __ATOMIC_RELAXED);
+}
+
+PriorityQueueResult mqInsert(MultiQueue queue, PQElement element, PQElementPriority priority)
+{
+	if (queue == NULL || element == NULL || priority == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+
+	Shard* shard = NULL;
+	for (int attempt = 1; shard == NULL; attempt++) { //Any shard will do, so a busy one is skipped.
+		Shard* candidate = &queue->shards[nextRandom() % queue->shards_count];
+		if (pthread_mutex_trylock(&candidate->lock) == 0) {
+			shard = candidate;
+		}
+		else if (attempt == INSERT_TRY_LOCK_ATTEMPTS) {
+			pthread_mutex_lock(&candidate->lock);
+			shard = candidate;
+		}
+	}
+
+	PriorityQueueResult res = pqInsert(shard->queue, element, priority);
+	pthread_mutex_unlock(&shard->lock);
+	if (res == PQ_SUCCESS) {
+		__atomic_fetch_add(&queue->size, 1, __ATOMIC_RELAXED);
+	}
+	return res;
+}
+
+PQElement mqPop(MultiQueue queue)
+{
+	if (queue == NULL) {
+		return NULL;
+	}
+
+	PQElement element = NULL;
+	removeBest(queue, &element);
+	return element;
+}
+
+PriorityQueueResult mqRemove(MultiQueue queue)
+{
+	if (queue == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+
+	removeBest(queue, NULL);
+	return PQ_SUCCESS;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static unsigned int nextRandom(void)
+{
+	if (random_state == 0) {
+		random_state = (__atomic_add_fetch(&random_seeds, 1, __ATOMIC_RELAXED) * RANDOM_MULTIPLIER) | 1;
+	}
+	random_state ^= random_state << 13;
+	random_state ^= random_state >> 17;
+	random_state ^= random_state << 5;
+	return random_state;
+}
+
+static bool removeBest(MultiQueue queue, PQElement* element)
+{
+	if (mqGetSize(queue) == 0) {
+		return false;
+	}
+	if (queue->shards_count == 1) {
+		return removeFromAnyShard(queue, element);
+	}
+
+	int first = nextRandom() % queue->shards_count;
+	int second = (first + 1 + nextRandom() % (queue->shards_count - 1)) % queue->shards_count;
+	Shard* low = &queue->shards[first < second ? first : second]; //Locked in index order to avoid deadlocks.
+	Shard* high = &queue->shards[first < second ? second : first];
+	pthread_mutex_lock(&low->lock);
+	pthread_mutex_lock(&high->lock);
+
+	PQElementPriority low_priority = pqGetFirstPriority(low->queue);
+	PQElementPriority high_priority = pqGetFirstPriority(high->queue);
+	bool removed = false;
+	if (low_priority != NULL &&
+		(high_priority == NULL || queue->comparePriorities(low_priority, high_priority) >= 0)) {
+		removed = removeFromShard(queue, low, element);
+	}
+	else if (high_priority != NULL) {
+		removed = removeFromShard(queue, high, element);
+	}
+	pthread_mutex_unlock(&high->lock);
+	pthread_mutex_unlock(&low->lock);
+
+	if (low_priority == NULL && high_priority == NULL) {
+		return removeFromAnyShard(queue, element);
+	}
+	return removed;
+}
+
+static bool removeFromShard(MultiQueue queue, Shard* shard, PQElement* element)
+{
+	PQElement head = pqGetFirst(shard->queue);
+	if (head == NULL) {
+		return false;
+	}
+	if (element != NULL) {
+		*element = queue->copyElement(head);
+		if (*element == NULL) {
+			return false;
+		}
+	}
+	pqRemove(shard->queue);
+	__atomic_fetch_sub(&queue->size, 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+static bool removeFromAnyShard(MultiQueue queue, PQElement* element)
+{
+	for (int i = 0; i < queue->shards_count; i++) {
+		Shard* shard = &queue->shards[i];
+		pthread_mutex_lock(&shard->lock);
+		bool removed = removeFromShard(queue, shard, element);
+		pthread_mutex_unlock(&shard->lock);
+		if (removed) {
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,88 @@
+#ifndef _MULTI_QUEUE_H
+#define _MULTI_QUEUE_H
+
+#include <stdbool.h>
+#include "priority_queue.h"
+
+/*
+* A relaxed priority scheduler built from several PriorityQueue shards,
+* each one guarded by its own lock.
+* An insertion goes to a random shard, and a removal samples two random shards
+* and removes the head with the higher priority of the two.
+* Removals return one of the highest priority elements, but not necessarily
+* the highest one, in exchange for almost no contention between threads.
+* All of the functions may be called from several threads at the same time,
+* except mqDestroy.
+*/
+
+/** Type for defining the multi queue */
+typedef struct MultiQueue_t* MultiQueue;
+
+
+/*
+mqCreate: Creates a new empty multi queue.
+		  The functions have the same meaning as in pqCreate, and are used by every shard.
+
+@param shards - The number of PriorityQueue shards, usually twice the number of threads.
+
+@return NULL if one of the arguments is NULL, shards isn't positive or if a memory allocation failed.
+		Else, returns a new empty multi queue.
+*/
+MultiQueue mqCreate(int shards, CopyPQElement copy_element, FreePQElement free_element,
+	EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+	FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities);
+
+/*
+mqDestroy: Deallocates the multi queue and all of its elements.
+		   Must not be called while other threads use the multi queue.
+
+@param queue - The multi queue to deallocate.
+*/
+void mqDestroy(MultiQueue queue);
+
+/*
+mqGetSize: Returns the number of elements in all of the shards.
+		   While other threads change the multi queue the result is a snapshot.
+
+@param queue - The multi queue to count.
+
+@return -1 if the multi queue is NULL.
+		Else, returns the number of elements.
+*/
+int mqGetSize(MultiQueue queue);
+
+/*
+mqInsert: Adds a copy of an element with a copy of its priority to a random shard.
+
+@param queue - The multi queue to add the element to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_NULL_ARGUMENT if one of the arguments is NULL.
+		PQ_OUT_OF_MEMORY if a memory allocation failed.
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult mqInsert(MultiQueue queue, PQElement element, PQElementPriority priority);
+
+/*
+mqPop: Removes the higher priority head of two random shards and returns a copy of it.
+	   If both shards are empty, the other shards are searched in order.
+
+@param queue - The multi queue to remove the element from.
+
+@return NULL if the multi queue is NULL or empty, or if copying the element failed.
+		Else, returns a copy of the removed element, which the caller must deallocate.
+*/
+PQElement mqPop(MultiQueue queue);
+
+/*
+mqRemove: Removes the higher priority head of two random shards.
+
+@param queue - The multi queue to remove the element from.
+
+@return PQ_NULL_ARGUMENT if the multi queue is NULL.
+		PQ_SUCCESS otherwise (also when the multi queue is empty).
+*/
+PriorityQueueResult mqRemove(MultiQueue queue);
+
+#endif /* _MULTI_QUEUE_H */
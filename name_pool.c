@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "name_pool.h"
+
+#define INITIAL_SLOTS_COUNT 32
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+/** A stored name with its reference count, the name is returned as a pointer to str */
+typedef struct {
+	int references;
+	unsigned int hash;
+	char str[];
+} NameEntry;
+
+struct name_pool_t {
+	NameEntry** slots; //Open addressing with linear probing, NULL marks an empty slot.
+	int slots_count; //Always a power of 2, at least twice the size.
+	int size;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+hashString: Returns the FNV-1a hash of a string.
+
+@param str - The string to hash.
+
+@return The hash of the string.
+*/
+static unsigned int hashString(const char* str);
+
+/*
+getEntry: Returns the entry of an interned name.
+
+@param name - The interned name.
+
+@return The entry that holds the name.
+*/
+static NameEntry* getEntry(const char* name);
+
+/*
+findSlot: Returns the slot that holds a string, or the empty slot it should be added to.
+
+@param pool - The pool to search in.
+@param str - The string to search for.
+@param hash - The hash of the string.
+
+@return The index of the slot.
+*/
+static int findSlot(NamePool pool, const char* str, unsigned int hash);
+
+/*
+grow: Doubles the number of slots of the pool and rehashes its names.
+
+@param pool - The pool to grow.
+
+@return False if a memory allocation failed (The pool is left unchanged).
+		Else, returns True.
+*/
+static bool grow(NamePool pool);
+
+/*
+removeSlot: Empties a slot and moves the entries after it back, so no probe sequence is broken.
+
+@param pool - The pool to remove the slot from.
+@param slot - The index of the slot to empty.
+*/
+static void removeSlot(NamePool pool, int slot);
+
+/* =---------------------------------------------------------------------------=
+
+								Name Pool Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+NamePool namePoolCreate(const Allocator* allocator)
+{
+	NamePool pool = allocatorAlloc(allocator, sizeof(*pool));
+	if (pool == NULL) {
+		return NULL;
+	}
+	pool->slots = allocatorAlloc(allocator, sizeof(*pool->slots) * INITIAL_SLOTS_COUNT);
+	if (pool->slots == NULL) {
+		allocatorFree(allocator, pool);
+		return NULL;
+	}
+	for (int i = 0; i < INITIAL_SLOTS_COUNT; i++) {
+		pool->slots[i] = NULL;
+	}
+	pool->slots_count = INITIAL_SLOTS_COUNT;
+	pool->size = 0;
+	pool->allocator = allocator;
+	return pool;
+}
+
+void namePoolDestroy(NamePool pool)
+{
+	if (pool == NULL) {
+		return;
+	}
+	for (int i = 0; i < pool->slots_count; i++) {
+		allocatorFree(pool->allocator, pool->slots[i]);
+	}
+	allocatorFree(pool->allocator, pool->slots);
+	allocatorFree(pool->allocator, pool);
+}
+
+const char* namePoolAcquire(NamePool pool, const char* str)
+{
+	if (pool == NULL || str == NULL) {
+		return NULL;
+	}
+
+	unsigned int hash = hashString(str);
+	int slot = findSlot(pool, str, hash);
+	if (pool->slots[slot] != NULL) {
+		pool->slots[slot]->references++;
+		return pool->slots[slot]->str;
+	}
+	if ((pool->size + 1) * 2 > pool->slots_count) {
+		if (!grow(pool)) {
+			return NULL;
+		}
+		slot = findSlot(pool, str, hash);
+	}
+
+	size_t length = strlen(str) + 1;
+	NameEntry* entry = allocatorAlloc(pool->allocator, offsetof(NameEntry, str) + length);
+	if (entry == NULL) {
+		return NULL;
+	}
+	entry->references = 1;
+	entry->hash = hash;
+	memcpy(entry->str, str, length);
+	pool->slots[slot] = entry;
+	pool->size++;
+	return entry->str;
+}
+
+void namePoolRelease(NamePool pool, const char* name)
+{
+	if (pool == NULL || name == NULL) {
+		return;
+	}
+	NameEntry* entry = getEntry(name);
+	if (--entry->references > 0) {
+		return;
+	}
+	removeSlot(pool, findSlot(pool, name, entry->hash));
+	allocatorFree(pool->allocator, entry);
+}
+
+int namePoolGetSize(NamePool pool)
+{
+	if (pool == NULL) {
+		return NAME_POOL_NO_SIZE;
+	}
+	return pool->size;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static unsigned int hashString(const char* str)
+{
+	unsigned int hash = FNV_OFFSET_BASIS;
+	for (; *str != '\0'; str++) {
+		hash = (hash ^ (unsigned char)*str) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static NameEntry* getEntry(const char* name)
+{
+	return (NameEntry*)(name - offsetof(NameEntry, str));
+}
+
+static int findSlot(NamePool pool, const char* str, unsigned int hash)
+{
+	int mask = pool->slots_count - 1;
+	int slot = hash & mask;
+	while (pool->slots[slot] != NULL &&
+		pool->slots[slot]->str != str &&
+		(pool->slots[slot]->hash != hash || strcmp(pool->slots[slot]->str, str) != 0)) {
+		slot = (slot + 1) & mask; //Linear probing, the pool is never more than half full.
+	}
+	return slot;
+}
+
+static bool grow(NamePool pool)
+{
+	int slots_count = pool->slots_count * 2;
+	NameEntry** slots = allocatorAlloc(pool->allocator, sizeof(*slots) * slots_count);
+	if (slots == NULL) {
+		return false;
+	}
+	for (int i = 0; i < slots_count; i++) {
+		slots[i] = NULL;
+	}
+
+	NameEntry** old_slots = pool->slots;
+	int old_slots_count = pool->slots_count;
+	pool->slots = slots;
+	pool->slots_count = slots_count;
+	for (int i = 0; i < old_slots_count; i++) {
+		if (old_slots[i] != NULL) {
+			pool->slots[findSlot(pool, old_slots[i]->str, old_slots[i]->hash)] = old_slots[i];
+		}
+	}
+	allocatorFree(pool->allocator, old_slots);
+	return true;
+}
+
+static void removeSlot(NamePool pool, int slot)
+{
+	int mask = pool->slots_count - 1;
+	pool->slots[slot] = NULL;
+	pool->size--;
+	for (int next = (slot + 1) & mask; pool->slots[next] != NULL; next = (next + 1) & mask) {
+		int home = pool->slots[next]->hash & mask;
+		//The entry may move back to the empty slot only if its home isn't between the two slots.
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			pool->slots[slot] = pool->slots[next];
+			pool->slots[next] = NULL;
+			slot = next;
+		}
+	}
+}
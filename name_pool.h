@@ -0,0 +1,68 @@
+#ifndef _NAME_POOL_H
+#define _NAME_POOL_H
+
+#include "allocator.h"
+
+/*
+* A pool of interned, reference counted strings.
+* Every distinct string is stored once, so two names acquired from the same pool
+* are equal if and only if they are the same pointer. A name stays in the pool
+* while it has references, and is deallocated when the last one is released.
+*/
+
+/** Type for defining the name pool */
+typedef struct name_pool_t* NamePool;
+
+/** Returned as the size of a NULL pool */
+#define NAME_POOL_NO_SIZE -1
+
+
+/*
+namePoolCreate: Creates a new empty name pool.
+
+@param allocator - The allocator of the pool and its names, or NULL for the default allocator.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty pool.
+*/
+NamePool namePoolCreate(const Allocator* allocator);
+
+/*
+namePoolDestroy: Deallocates the pool and all of the names that are still in it.
+
+@param pool - The pool to deallocate.
+*/
+void namePoolDestroy(NamePool pool);
+
+/*
+namePoolAcquire: Returns the interned copy of a string and adds a reference to it,
+				 adding a copy of the string to the pool if it isn't stored yet.
+				 Acquiring a name that is already interned finds it without comparing the strings.
+
+@param pool - The pool to intern the string in.
+@param str - The string to intern.
+
+@return NULL if one of the arguments is NULL or if a memory allocation failed.
+		Else, returns the interned name, valid until its last reference is released.
+*/
+const char* namePoolAcquire(NamePool pool, const char* str);
+
+/*
+namePoolRelease: Removes a reference from an interned name, and deallocates it if it was the last one.
+
+@param pool - The pool the name was acquired from.
+@param name - The interned name, nothing is done if it is NULL.
+*/
+void namePoolRelease(NamePool pool, const char* name);
+
+/*
+namePoolGetSize: Returns the number of distinct names in the pool.
+
+@param pool - The pool to count.
+
+@return NAME_POOL_NO_SIZE if the pool is NULL.
+		Else, returns the number of names.
+*/
+int namePoolGetSize(NamePool pool);
+
+#endif /* _NAME_POOL_H */
@@ -1,11 +1,13 @@
 #include <stdlib.h>
 #include <assert.h>
 #include "node.h"
+#include "stats.h"
 
 struct node_t {
 	Element data;
 	ElemCopyFunc copyFunc;
 	ElemFreeFunc freeFunc;
+	const Allocator* allocator;
 	Node next;
 };
 
@@ -17,24 +19,44 @@ struct node_t {
 */
 
 Node nodeCreate(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func)
+{
+	return nodeCreateWithAllocator(data, copy_func, free_func, NULL);
+}
+
+Node nodeCreateWithAllocator(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func,
+	const Allocator* allocator)
 {
 	if (data == NULL || copy_func == NULL || free_func == NULL) {
 		return NULL;
 	}
 
-	Node node = malloc(sizeof(*node));
+	Element copy = copy_func(data);
+	if (copy == NULL) {
+		return NULL;
+	}
+	Node node = nodeCreateOwning(copy, copy_func, free_func, allocator);
 	if (node == NULL) {
+		free_func(copy);
 		return NULL;
 	}
+	return node;
+}
 
-	node->data = copy_func(data);
-	if (node->data == NULL) {
-		free(node);
+Node nodeCreateOwning(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func, const Allocator* allocator)
+{
+	if (data == NULL || copy_func == NULL || free_func == NULL) {
+		return NULL;
+	}
+
+	Node node = allocatorAlloc(allocator, sizeof(*node));
+	if (node == NULL) {
 		return NULL;
 	}
 
+	node->data = data;
 	node->copyFunc = copy_func;
 	node->freeFunc = free_func;
+	node->allocator = allocator;
 	node->next = NULL;
 	return node;
 }
@@ -48,7 +70,7 @@ void nodeRemove(Node node)
 		return;
 	}
 	node->freeFunc(node->data);
-	free(node);
+	allocatorFree(node->allocator, node);
 }
 
 
@@ -67,7 +89,7 @@ Node nodeCopy(Node list)
 	if (list == NULL){
 		return NULL;
 	}
-	Node copy = nodeCreate(list->data, list->copyFunc, list->freeFunc);
+	Node copy = nodeCreateWithAllocator(list->data, list->copyFunc, list->freeFunc, list->allocator);
 	assert(copy != NULL);
 	return copy;
 }
@@ -103,6 +125,7 @@ Node nodeGetNext(Node node)
 		return NULL;
 	}
 
+	STATS_COUNT(nodes_visited);
 	return node->next;
 }
 
@@ -28,6 +28,35 @@ nodeCreate: Creates a new single node.
 */
 Node nodeCreate(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func);
 
+/*
+nodeCreateWithAllocator: Creates a new single node, allocated from the given allocator.
+                         Copies of the node, and nodes added after it with nodeAdd, use the same allocator.
+
+@param data - The element to store in the node.
+@param copy_func - Function for copying elements.
+@param free_func - Function for deallocating elements.
+@param allocator - The allocator of the node, or NULL for the default allocator.
+
+@return NULL if one of the supplied arguments is NULL or if a memory allocation failed.
+        Else, it will return a node which stores a copy of data, and the next node points to NULL.
+*/
+Node nodeCreateWithAllocator(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func,
+    const Allocator* allocator);
+
+/*
+nodeCreateOwning: Creates a new single node that takes ownership of data instead of copying it.
+                  The node deallocates data when it is removed, so the caller must not use it afterwards.
+
+@param data - The element to store in the node.
+@param copy_func - Function for copying elements (Used when the node is copied).
+@param free_func - Function for deallocating elements.
+@param allocator - The allocator of the node, or NULL for the default allocator.
+
+@return NULL if one of the supplied arguments is NULL or if a memory allocation failed (data isn't deallocated).
+        Else, it will return a node which stores data, and the next node points to NULL.
+*/
+Node nodeCreateOwning(Element data, ElemCopyFunc copy_func, ElemFreeFunc free_func, const Allocator* allocator);
+
 /*
 nodeAdd: Adds a new node at the end of a node list.
 
@@ -10,6 +10,7 @@ struct pair_t
 	ElemCopyFunc secondCopyFunc;
 	ElemFreeFunc firstFreeFunc;
 	ElemFreeFunc secondFreeFunc;
+	const Allocator* allocator;
 };
 
 /* =---------------------------------------------------------------------------=
@@ -22,6 +23,14 @@ struct pair_t
 Pair pairCreate(Element first_element, Element second_element,
 	ElemCopyFunc first_copy_func, ElemCopyFunc second_copy_func,
 	ElemFreeFunc first_free_func, ElemFreeFunc second_free_func)
+{
+	return pairCreateWithAllocator(first_element, second_element, first_copy_func, second_copy_func,
+		first_free_func, second_free_func, NULL);
+}
+
+Pair pairCreateWithAllocator(Element first_element, Element second_element,
+	ElemCopyFunc first_copy_func, ElemCopyFunc second_copy_func,
+	ElemFreeFunc first_free_func, ElemFreeFunc second_free_func, const Allocator* allocator)
 {
 	if (first_element == NULL || second_element == NULL ||
 		first_copy_func == NULL || second_copy_func == NULL ||
@@ -29,19 +38,19 @@ Pair pairCreate(Element first_element, Element second_element,
 		return NULL;
 	}
 
-	Pair pair = malloc(sizeof(*pair));
+	Pair pair = allocatorAlloc(allocator, sizeof(*pair));
 	if (pair == NULL) {
 		return NULL;
 	}
 	pair->first = first_copy_func(first_element);
 	if (pair->first == NULL) {
-		free(pair);
+		allocatorFree(allocator, pair);
 		return NULL;
 	}
 	pair->second = second_copy_func(second_element);
 	if (pair->second == NULL) {
 		first_free_func(pair->first);
-		free(pair);
+		allocatorFree(allocator, pair);
 		return NULL;
 	}
 
@@ -49,6 +58,7 @@ Pair pairCreate(Element first_element, Element second_element,
 	pair->secondCopyFunc = second_copy_func;
 	pair->firstFreeFunc = first_free_func;
 	pair->secondFreeFunc = second_free_func;
+	pair->allocator = allocator;
 
 	return pair;
 }
@@ -61,7 +71,7 @@ void pairDestroy(Pair pair) //Generic function passed to node_t.
 	}
 	pair->firstFreeFunc(pair->first);
 	pair->secondFreeFunc(pair->second);
-	free(pair);
+	allocatorFree(pair->allocator, pair);
 }
 
 
@@ -92,8 +102,8 @@ Pair pairCopy(Pair pair)
 	}
 
 
-	Pair pair_copy = pairCreate(pair->first, pair->second, pair->firstCopyFunc,
-		pair->secondCopyFunc, pair->firstFreeFunc, pair->secondFreeFunc);
+	Pair pair_copy = pairCreateWithAllocator(pair->first, pair->second, pair->firstCopyFunc,
+		pair->secondCopyFunc, pair->firstFreeFunc, pair->secondFreeFunc, pair->allocator);
 
 	if (pair_copy == NULL) {
 		return NULL;
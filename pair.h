@@ -1,6 +1,8 @@
 #ifndef _PAIR_H
 #define _PAIR_H
 
+#include "allocator.h"
+
 /* Type use for defining a pair	*/
 
 typedef struct pair_t* Pair;
@@ -35,6 +37,25 @@ Pair pairCreate(Element first_element, Element second_element,
 	ElemCopyFunc first_copy_func, ElemCopyFunc second_copy_func,
 	ElemFreeFunc first_free_func, ElemFreeFunc second_free_func);
 
+/*
+pairCreateWithAllocator: Creates a new pair of elements, allocated from the given allocator.
+						 Copies of the pair use the same allocator.
+
+@param first_element - The first element in the pair.
+@param second_element - The second element in the pair.
+@param first_copy_func - The first element's copying function.
+@param second_copy_func - The second element's copying function.
+@param first_free_func - The first element's deallocating function.
+@param second_free_func - The second element's deallocating function.
+@param allocator - The allocator of the pair, or NULL for the default allocator.
+
+@return NULL if one of the arguments is NULL, or if the memory allocation failed.
+		Else, it will return a pair that stores a copy of 2 elements.
+*/
+Pair pairCreateWithAllocator(Element first_element, Element second_element,
+	ElemCopyFunc first_copy_func, ElemCopyFunc second_copy_func,
+	ElemFreeFunc first_free_func, ElemFreeFunc second_free_func, const Allocator* allocator);
+
 /*
 pairDestroy: Deallocates the pair and its elements.
 
@@ -0,0 +1,630 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "pairing_heap.h"
+#include "stats.h"
+
+typedef struct ph_node_t* PhNode;
+
+struct ph_node_t {
+	PQElement element;
+	PQElementPriority priority;
+	long long sequence;
+	PhNode child; //The first child, which comes after the node like all of its subtree.
+	PhNode sibling; //The next child of the parent.
+	PhNode previous; //The previous child of the parent, or the parent of a first child, NULL for the root.
+};
+
+struct pairing_heap_t {
+	PhNode root;
+	int size;
+	long long sequence; //The sequence of the next inserted entry.
+	PhNode* order; //The nodes in queue order, followed by the space that sorting them uses.
+	int order_capacity; //The number of nodes that the order array can sort.
+	bool ordered; //True while the order array has the nodes of the heap.
+	CopyPQElement copyElement;
+	FreePQElement freeElement;
+	EqualPQElements equalElements;
+	CopyPQElementPriority copyPriority;
+	FreePQElementPriority freePriority;
+	ComparePQElementPriorities comparePriorities;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+
+/*
+createNode: Creates a node that stores copies of an element and its priority, and isn't linked to the heap.
+
+@param heap - The heap that the node is created for.
+@param element - The element to copy.
+@param priority - The priority to copy.
+@param sequence - The sequence of the node.
+
+@return NULL if a memory allocation failed.
+		Else, returns the new node.
+*/
+static PhNode createNode(PairingHeap heap, PQElement element, PQElementPriority priority, long long sequence);
+
+/*
+destroyNode: Deallocates a node with its element and priority.
+
+@param heap - The heap of the node.
+@param node - The node to deallocate.
+*/
+static void destroyNode(PairingHeap heap, PhNode node);
+
+/*
+destroyNodes: Deallocates a subtree, without recursion since a pairing heap can be as deep as it is large.
+			  The subtree is rotated so that every node is deallocated when it has no child left.
+
+@param heap - The heap of the subtree.
+@param node - The root of the subtree, its siblings are deallocated too.
+*/
+static void destroyNodes(PairingHeap heap, PhNode node);
+
+/*
+compareNodes: Compares two nodes by their priorities, and then by their sequences when the priorities are equal.
+
+@param heap - The heap that compares the priorities.
+@param node1 - The first node to compare.
+@param node2 - The second node to compare.
+
+@return A positive number if node1 comes first, a negative number if node2 comes first, else 0.
+*/
+static int compareNodes(PairingHeap heap, PhNode node1, PhNode node2);
+
+/*
+link: Links two roots, the one that comes after becomes the first child of the other one.
+
+@param heap - The heap of the roots.
+@param node1 - The first root, which is kept on top when the nodes compare equal.
+@param node2 - The second root.
+
+@return The root that stays on top.
+*/
+static PhNode link(PairingHeap heap, PhNode node1, PhNode node2);
+
+/*
+mergePairs: Links a list of siblings into one root, in two passes: pairs from left to right,
+			and then the results from right to left.
+
+@param heap - The heap of the siblings.
+@param first - The first sibling of the list, or NULL.
+
+@return The root of the linked siblings, or NULL if the list was empty.
+*/
+static PhNode mergePairs(PairingHeap heap, PhNode first);
+
+/*
+removeNode: Removes a node from the heap, links its children in its place and deallocates it.
+
+@param heap - The heap of the node.
+@param node - The node to remove.
+*/
+static void removeNode(PairingHeap heap, PhNode node);
+
+/*
+nextNode: Returns the next node of the heap in a preorder walk, which visits every node once.
+
+@param node - The current node.
+@param skip_children - True to skip the subtree of the node.
+
+@return NULL if the walk ended.
+		Else, returns the next node.
+*/
+static PhNode nextNode(PhNode node, bool skip_children);
+
+/*
+buildOrder: Sorts the nodes of the heap into the order array, unless it is already sorted.
+
+@param heap - The heap to sort.
+
+@return False if a memory allocation failed.
+		Else, returns True.
+*/
+static bool buildOrder(PairingHeap heap);
+
+/*
+findRangeStart: Returns the index in the order array of the first node that doesn't come before the start of a range.
+
+@param heap - The sorted heap.
+@param from - The highest priority of the range, or NULL for the first node.
+
+@return The index of the first node of the range, or the size of the heap if there is none.
+*/
+static int findRangeStart(PairingHeap heap, PQElementPriority from);
+
+/*
+isBeforeRangeEnd: Checks that a priority doesn't come after the end of a range.
+
+@param heap - The heap that compares the priorities.
+@param priority - The priority to check.
+@param to - The lowest priority of the range, or NULL for no end.
+
+@return True if the priority isn't lower than to.
+		Else, returns False.
+*/
+static bool isBeforeRangeEnd(PairingHeap heap, PQElementPriority priority, PQElementPriority to);
+
+/*
+comparePriorities: Compares two priorities with the compare function of the heap, counting the call.
+
+@param heap - The heap that compares the priorities.
+@param priority1 - The first priority to compare.
+@param priority2 - The second priority to compare.
+
+@return The result of the compare function of the heap.
+*/
+static int comparePriorities(PairingHeap heap, PQElementPriority priority1, PQElementPriority priority2);
+
+/*
+equalElements: Compares two elements with the equal function of the heap, counting the call.
+
+@param heap - The heap that compares the elements.
+@param element1 - The first element to compare.
+@param element2 - The second element to compare.
+
+@return The result of the equal function of the heap.
+*/
+static bool equalElements(PairingHeap heap, PQElement element1, PQElement element2);
+
+/* =---------------------------------------------------------------------------=
+
+								Pairing Heap Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+PairingHeap phCreate(CopyPQElement copy_element, FreePQElement free_element,
+					 EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+					 FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+					 const Allocator* allocator)
+{
+	PairingHeap heap = allocatorAlloc(allocator, sizeof(*heap));
+	if (heap == NULL) {
+		return NULL;
+	}
+	heap->root = NULL;
+	heap->size = 0;
+	heap->sequence = 0;
+	heap->order = NULL;
+	heap->order_capacity = 0;
+	heap->ordered = false;
+	heap->copyElement = copy_element;
+	heap->freeElement = free_element;
+	heap->equalElements = equal_elements;
+	heap->copyPriority = copy_priority;
+	heap->freePriority = free_priority;
+	heap->comparePriorities = compare_priorities;
+	heap->allocator = allocator;
+	return heap;
+}
+
+void phDestroy(PairingHeap heap)
+{
+	if (heap == NULL) {
+		return;
+	}
+	destroyNodes(heap, heap->root);
+	allocatorFree(heap->allocator, heap->order);
+	allocatorFree(heap->allocator, heap);
+}
+
+PairingHeap phCopy(PairingHeap heap)
+{
+	if (heap == NULL) {
+		return NULL;
+	}
+	PairingHeap copy = phCreate(heap->copyElement, heap->freeElement, heap->equalElements, heap->copyPriority,
+		heap->freePriority, heap->comparePriorities, heap->allocator);
+	//Every copied node is linked to the root with one comparison.
+	for (PhNode node = heap->root; node != NULL && copy != NULL; node = nextNode(node, false)) {
+		PhNode node_copy = createNode(copy, node->element, node->priority, node->sequence);
+		if (node_copy == NULL) {
+			phDestroy(copy);
+			copy = NULL;
+		}
+		else {
+			copy->root = copy->root == NULL ? node_copy : link(copy, copy->root, node_copy);
+			copy->size++;
+		}
+	}
+	if (copy != NULL) {
+		copy->sequence = heap->sequence;
+	}
+	return copy;
+}
+
+int phGetSize(PairingHeap heap)
+{
+	return heap->size;
+}
+
+bool phContains(PairingHeap heap, PQElement element)
+{
+	for (PhNode node = heap->root; node != NULL; node = nextNode(node, false)) {
+		STATS_COUNT(nodes_visited);
+		if (equalElements(heap, node->element, element)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+PriorityQueueResult phInsert(PairingHeap heap, PQElement element, PQElementPriority priority)
+{
+	PhNode node = createNode(heap, element, priority, heap->sequence);
+	if (node == NULL) {
+		return PQ_OUT_OF_MEMORY;
+	}
+	heap->sequence++;
+	heap->root = heap->root == NULL ? node : link(heap, heap->root, node);
+	heap->size++;
+	heap->ordered = false;
+	return PQ_SUCCESS;
+}
+
+void phRemoveFirst(PairingHeap heap)
+{
+	if (heap->root != NULL) {
+		removeNode(heap, heap->root);
+	}
+}
+
+PriorityQueueResult phRemoveElement(PairingHeap heap, PQElement element)
+{
+	//The walk isn't in queue order, so the first of the equal elements is the one that compares first.
+	PhNode found = NULL;
+	for (PhNode node = heap->root; node != NULL; node = nextNode(node, false)) {
+		STATS_COUNT(nodes_visited);
+		if (equalElements(heap, node->element, element) && (found == NULL || compareNodes(heap, node, found) > 0)) {
+			found = node;
+		}
+	}
+	if (found == NULL) {
+		return PQ_ELEMENT_DOES_NOT_EXISTS;
+	}
+	removeNode(heap, found);
+	return PQ_SUCCESS;
+}
+
+PriorityQueueResult phRemoveElementWithPriority(PairingHeap heap, PQElement element, PQElementPriority priority)
+{
+	PhNode found = NULL;
+	PhNode node = heap->root;
+	while (node != NULL) {
+		STATS_COUNT(nodes_visited);
+		int res = comparePriorities(heap, node->priority, priority);
+		bool match = res == 0 && equalElements(heap, node->element, element);
+		if (match && (found == NULL || node->sequence < found->sequence)) {
+			found = node;
+		}
+		//The subtree of a node comes after it, so it can't have an earlier match.
+		node = nextNode(node, res < 0 || match);
+	}
+	if (found == NULL) {
+		return PQ_ELEMENT_DOES_NOT_EXISTS;
+	}
+	removeNode(heap, found);
+	return PQ_SUCCESS;
+}
+
+void phClear(PairingHeap heap)
+{
+	destroyNodes(heap, heap->root);
+	heap->root = NULL;
+	heap->size = 0;
+	heap->ordered = false;
+}
+
+PQElement phCursorFirst(PairingHeap heap, PQCursor* cursor)
+{
+	cursor->position = heap->root;
+	cursor->index = 0;
+	return heap->root == NULL ? NULL : heap->root->element;
+}
+
+PQElement phCursorNext(PairingHeap heap, PQCursor* cursor)
+{
+	if (cursor->position == NULL || !buildOrder(heap)) {
+		cursor->position = NULL;
+		return NULL;
+	}
+	cursor->index++;
+	if (cursor->index >= heap->size) {
+		cursor->position = NULL;
+		return NULL;
+	}
+	cursor->position = heap->order[cursor->index];
+	return heap->order[cursor->index]->element;
+}
+
+PQElementPriority phGetFirstPriority(PairingHeap heap)
+{
+	return heap->root == NULL ? NULL : heap->root->priority;
+}
+
+bool phForEachInPriorityRange(PairingHeap heap, PQElementPriority from, PQElementPriority to,
+							  PQRangeFunc visit, void* context)
+{
+	if (!buildOrder(heap)) {
+		return false;
+	}
+	bool visiting = true;
+	for (int i = findRangeStart(heap, from); i < heap->size && visiting; i++) {
+		visiting = isBeforeRangeEnd(heap, heap->order[i]->priority, to) &&
+			visit(context, heap->order[i]->element, heap->order[i]->priority);
+	}
+	return true;
+}
+
+bool phRemoveRange(PairingHeap heap, PQElementPriority from, PQElementPriority to)
+{
+	if (from == NULL && to == NULL) {
+		phClear(heap);
+		return true;
+	}
+	if (!buildOrder(heap)) {
+		return false;
+	}
+	int start = findRangeStart(heap, from), end = start;
+	while (end < heap->size && isBeforeRangeEnd(heap, heap->order[end]->priority, to)) {
+		end++;
+	}
+	//The order array isn't sorted again while the nodes of the range are removed, it only loses them.
+	PhNode* order = heap->order;
+	for (int i = start; i < end; i++) {
+		removeNode(heap, order[i]);
+	}
+	return true;
+}
+
+void phMerge(PairingHeap heap, PairingHeap other)
+{
+	//The sequences of the other heap are offset past the ones of the heap, so its nodes come after on ties.
+	for (PhNode node = other->root; node != NULL; node = nextNode(node, false)) {
+		STATS_COUNT(nodes_visited);
+		node->sequence += heap->sequence;
+	}
+	if (other->root != NULL) {
+		heap->root = heap->root == NULL ? other->root : link(heap, heap->root, other->root);
+	}
+	heap->size += other->size;
+	heap->sequence += other->sequence;
+	heap->ordered = false;
+	other->root = NULL;
+	other->size = 0;
+	other->sequence = 0;
+	other->ordered = false;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static PhNode createNode(PairingHeap heap, PQElement element, PQElementPriority priority, long long sequence)
+{
+	PhNode node = allocatorAlloc(heap->allocator, sizeof(*node));
+	if (node == NULL) {
+		return NULL;
+	}
+	node->element = heap->copyElement(element);
+	node->priority = node->element == NULL ? NULL : heap->copyPriority(priority);
+	if (node->priority == NULL) {
+		if (node->element != NULL) {
+			heap->freeElement(node->element);
+		}
+		allocatorFree(heap->allocator, node);
+		return NULL;
+	}
+	node->sequence = sequence;
+	node->child = NULL;
+	node->sibling = NULL;
+	node->previous = NULL;
+	return node;
+}
+
+static void destroyNode(PairingHeap heap, PhNode node)
+{
+	heap->freeElement(node->element);
+	heap->freePriority(node->priority);
+	allocatorFree(heap->allocator, node);
+}
+
+static void destroyNodes(PairingHeap heap, PhNode node)
+{
+	while (node != NULL) {
+		if (node->child == NULL) {
+			PhNode next = node->sibling;
+			destroyNode(heap, node);
+			node = next;
+		}
+		else { //The first child takes the place of the node, and the node becomes its next sibling.
+			PhNode child = node->child;
+			node->child = child->sibling;
+			child->sibling = node;
+			node = child;
+		}
+	}
+}
+
+static int compareNodes(PairingHeap heap, PhNode node1, PhNode node2)
+{
+	int res = comparePriorities(heap, node1->priority, node2->priority);
+	if (res != 0) {
+		return res;
+	}
+	return (node1->sequence < node2->sequence) - (node1->sequence > node2->sequence); //Earlier sequences come first.
+}
+
+static PhNode link(PairingHeap heap, PhNode node1, PhNode node2)
+{
+	PhNode top = node1, bottom = node2;
+	if (compareNodes(heap, node1, node2) < 0) {
+		top = node2;
+		bottom = node1;
+	}
+	bottom->sibling = top->child;
+	if (top->child != NULL) {
+		top->child->previous = bottom;
+	}
+	bottom->previous = top;
+	top->child = bottom;
+	top->previous = NULL;
+	top->sibling = NULL;
+	return top;
+}
+
+static PhNode mergePairs(PairingHeap heap, PhNode first)
+{
+	//The first pass chains the linked pairs in reverse order through their sibling fields.
+	PhNode pairs = NULL;
+	while (first != NULL) {
+		PhNode node1 = first, node2 = first->sibling;
+		first = node2 == NULL ? NULL : node2->sibling;
+		PhNode pair = node2 == NULL ? node1 : link(heap, node1, node2);
+		pair->previous = NULL;
+		pair->sibling = pairs;
+		pairs = pair;
+	}
+
+	PhNode root = NULL;
+	while (pairs != NULL) {
+		PhNode next = pairs->sibling;
+		pairs->sibling = NULL;
+		root = root == NULL ? pairs : link(heap, pairs, root);
+		pairs = next;
+	}
+	return root;
+}
+
+static void removeNode(PairingHeap heap, PhNode node)
+{
+	PhNode children = mergePairs(heap, node->child);
+	if (node == heap->root) {
+		heap->root = children;
+	}
+	else {
+		if (node->previous->child == node) {
+			node->previous->child = node->sibling;
+		}
+		else {
+			node->previous->sibling = node->sibling;
+		}
+		if (node->sibling != NULL) {
+			node->sibling->previous = node->previous;
+		}
+		if (children != NULL) {
+			heap->root = link(heap, heap->root, children);
+		}
+	}
+	destroyNode(heap, node);
+	heap->size--;
+	heap->ordered = false;
+}
+
+static PhNode nextNode(PhNode node, bool skip_children)
+{
+	if (!skip_children && node->child != NULL) {
+		return node->child;
+	}
+	//Climbs to the nearest ancestor that has a next sibling, through the previous siblings of every level.
+	while (node != NULL && node->sibling == NULL) {
+		while (node->previous != NULL && node->previous->child != node) {
+			node = node->previous;
+		}
+		node = node->previous;
+	}
+	return node == NULL ? NULL : node->sibling;
+}
+
+static bool buildOrder(PairingHeap heap)
+{
+	if (heap->ordered) {
+		return true;
+	}
+	if (heap->order_capacity < heap->size) {
+		PhNode* order = allocatorAlloc(heap->allocator, sizeof(*order) * 2 * heap->size);
+		if (order == NULL) {
+			return false;
+		}
+		allocatorFree(heap->allocator, heap->order);
+		heap->order = order;
+		heap->order_capacity = heap->size;
+	}
+
+	int count = 0;
+	for (PhNode node = heap->root; node != NULL; node = nextNode(node, false)) {
+		STATS_COUNT(nodes_visited);
+		heap->order[count++] = node;
+	}
+	assert(count == heap->size);
+
+	//A bottom up merge sort between the two halves of the array, which ends in the first half.
+	PhNode* source = heap->order;
+	PhNode* target = heap->order + heap->order_capacity;
+	for (int width = 1; width < count; width *= 2) {
+		for (int low = 0; low < count; low += 2 * width) {
+			int middle = low + width < count ? low + width : count;
+			int high = low + 2 * width < count ? low + 2 * width : count;
+			int left = low, right = middle;
+			for (int i = low; i < high; i++) {
+				bool take_left = left < middle && (right == high || compareNodes(heap, source[left], source[right]) >= 0);
+				target[i] = take_left ? source[left++] : source[right++];
+			}
+		}
+		PhNode* sorted = target;
+		target = source;
+		source = sorted;
+	}
+	if (source != heap->order) {
+		memcpy(heap->order, source, sizeof(*source) * count);
+	}
+	heap->ordered = true;
+	return true;
+}
+
+static int findRangeStart(PairingHeap heap, PQElementPriority from)
+{
+	if (from == NULL) {
+		return 0;
+	}
+	int low = 0, high = heap->size;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (comparePriorities(heap, heap->order[middle]->priority, from) > 0) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static bool isBeforeRangeEnd(PairingHeap heap, PQElementPriority priority, PQElementPriority to)
+{
+	return to == NULL || comparePriorities(heap, priority, to) >= 0;
+}
+
+static int comparePriorities(PairingHeap heap, PQElementPriority priority1, PQElementPriority priority2)
+{
+	STATS_COUNT(comparisons);
+	return heap->comparePriorities(priority1, priority2);
+}
+
+static bool equalElements(PairingHeap heap, PQElement element1, PQElement element2)
+{
+	STATS_COUNT(equality_checks);
+	return heap->equalElements(element1, element2);
+}
@@ -0,0 +1,199 @@
+#ifndef _PAIRING_HEAP_H
+#define _PAIRING_HEAP_H
+
+#include <stdbool.h>
+#include "priority_queue.h"
+#include "priority_queue_ext.h"
+#include "allocator.h"
+
+/*
+* The pairing heap engine of the priority queue (see pqCreateWithEngine).
+* Every node keeps its children in a list, and the first node of the queue is the root, so
+* inserting and melding two heaps link two roots with one comparison, and removing a node
+* pairs up its children in two passes, which is O(log n) amortized.
+* Like the B+-tree engine, entries are ordered by their priority and then by a 64-bit sequence
+* that the heap gives them when they are inserted. A melded heap keeps the sequences of both heaps,
+* so equal priorities that came from different heaps are ordered by those sequences, and when the
+* sequences are equal too, by the order the heap linked them in, which the same calls always repeat.
+* The heap isn't ordered beyond its root, so iterating past the first element, and the priority
+* range functions, sort the nodes into an order array that is kept until the heap changes.
+* The functions behave like the pq functions of the same names, whose arguments the priority
+* queue already checked.
+*/
+
+/** Type for defining the pairing heap of a priority queue */
+typedef struct pairing_heap_t* PairingHeap;
+
+
+/*
+phCreate: Creates a new empty heap, the functions are the ones of the queue.
+
+@param allocator - The allocator of the nodes, or NULL for the default allocator.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty heap.
+*/
+PairingHeap phCreate(CopyPQElement copy_element, FreePQElement free_element,
+					 EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+					 FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+					 const Allocator* allocator);
+
+/*
+phDestroy: Deallocates the heap and all of its elements and priorities.
+
+@param heap - The heap to deallocate.
+*/
+void phDestroy(PairingHeap heap);
+
+/*
+phCopy: Returns a copy of the heap, whose entries keep their sequences.
+
+@param heap - The heap to copy.
+
+@return NULL if the heap is NULL or if a memory allocation failed.
+		Else, returns a copy of the heap.
+*/
+PairingHeap phCopy(PairingHeap heap);
+
+/*
+phGetSize: Returns the number of elements in the heap.
+
+@param heap - The heap to count.
+
+@return The number of elements, kept by the heap.
+*/
+int phGetSize(PairingHeap heap);
+
+/*
+phContains: Checks whether an element is in the heap.
+
+@param heap - The heap to search.
+@param element - The element to search for.
+
+@return True if an element of the heap is equal to it.
+		Else, returns False.
+*/
+bool phContains(PairingHeap heap, PQElement element);
+
+/*
+phInsert: Adds copies of an element and its priority after the elements of equal or higher priority.
+
+@param heap - The heap to add to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_OUT_OF_MEMORY if a memory allocation failed (The heap isn't changed).
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult phInsert(PairingHeap heap, PQElement element, PQElementPriority priority);
+
+/*
+phRemoveFirst: Removes the element with the highest priority, if there is one.
+
+@param heap - The heap to remove from.
+*/
+void phRemoveFirst(PairingHeap heap);
+
+/*
+phRemoveElement: Removes the first element that is equal to an element, searching all of the heap.
+
+@param heap - The heap to remove from.
+@param element - The element to remove.
+
+@return PQ_ELEMENT_DOES_NOT_EXISTS if no element is equal to it.
+		PQ_SUCCESS if the element has been removed.
+*/
+PriorityQueueResult phRemoveElement(PairingHeap heap, PQElement element);
+
+/*
+phRemoveElementWithPriority: Removes the first element that is equal to an element and has an equal priority,
+							 skipping the subtrees whose roots come after that priority.
+
+@param heap - The heap to remove from.
+@param element - The element to remove.
+@param priority - The priority of the element.
+
+@return PQ_ELEMENT_DOES_NOT_EXISTS if no element of that priority is equal to it.
+		PQ_SUCCESS if the element has been removed.
+*/
+PriorityQueueResult phRemoveElementWithPriority(PairingHeap heap, PQElement element, PQElementPriority priority);
+
+/*
+phClear: Removes all of the elements of the heap.
+
+@param heap - The heap to empty.
+*/
+void phClear(PairingHeap heap);
+
+/*
+phCursorFirst: Sets a cursor to the first element and returns it, without sorting the heap.
+
+@param heap - The heap to iterate over.
+@param cursor - The cursor to set.
+
+@return NULL if the heap is empty.
+		Else, returns the first element (Not a copy).
+*/
+PQElement phCursorFirst(PairingHeap heap, PQCursor* cursor);
+
+/*
+phCursorNext: Advances a cursor and returns the element it points to.
+			  The first advance after a change of the heap sorts it into its order array.
+
+@param heap - The heap to iterate over.
+@param cursor - The cursor to advance.
+
+@return NULL if the end of the heap was reached, the cursor was reset or if a memory allocation failed.
+		Else, returns the next element (Not a copy).
+*/
+PQElement phCursorNext(PairingHeap heap, PQCursor* cursor);
+
+/*
+phGetFirstPriority: Returns the priority of the first element.
+
+@param heap - The heap to read.
+
+@return NULL if the heap is empty.
+		Else, returns the priority of the first element (Not a copy).
+*/
+PQElementPriority phGetFirstPriority(PairingHeap heap);
+
+/*
+phForEachInPriorityRange: Passes the elements whose priorities are in a range to a function, in order.
+
+@param heap - The heap to visit.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+@param visit - The function that visits an element and its priority.
+@param context - Passed to every call of visit.
+
+@return False if a memory allocation failed (No element was visited).
+		Else, returns True.
+*/
+bool phForEachInPriorityRange(PairingHeap heap, PQElementPriority from, PQElementPriority to,
+							  PQRangeFunc visit, void* context);
+
+/*
+phRemoveRange: Removes all of the elements whose priorities are in a range.
+
+@param heap - The heap to remove from.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+
+@return False if a memory allocation failed (The heap isn't changed).
+		Else, returns True.
+*/
+bool phRemoveRange(PairingHeap heap, PQElementPriority from, PQElementPriority to);
+
+/*
+phMerge: Moves all of the nodes of another heap into the heap by linking the two roots, with one comparison.
+		 The sequences of the other heap's nodes are offset past the heap's in O(m), so on equal
+		 priorities the nodes of the heap come first, and each heap keeps its own order.
+		 Both heaps must have the same functions and allocator.
+
+@param heap - The heap to merge into.
+@param other - The heap to empty.
+*/
+void phMerge(PairingHeap heap, PairingHeap other);
+
+#endif /* _PAIRING_HEAP_H */
@@ -1,19 +1,28 @@
 #include <stdlib.h>
 #include "priority_queue.h"
+#include "priority_queue_ext.h"
 #include "node.h"
 #include "pair.h"
+#include "btree_queue.h"
+#include "pairing_heap.h"
+#include "stats.h"
 
 #define NO_SIZE -1
 
 struct PriorityQueue_t {
+	BTreeQueue tree; //The elements of the B+-tree engine, else NULL.
+	PairingHeap heap; //The elements of the pairing heap engine, else NULL.
 	Node elements;
-	Node iterator;
+	Node last; //A hint for pqAppend, NULL when the last node isn't known.
+	PQCursor iterator;
 	CopyPQElement copyElement;
 	FreePQElement freeElement;
 	EqualPQElements equalElements;
 	CopyPQElementPriority copyPriorityElement;
 	FreePQElementPriority freePriorityElement;
 	ComparePQElementPriorities comparePriorities;
+	const Allocator* allocator;
+	OperationStats stats; //Only counted when COLLECT_STATS is defined.
 };
 
 /* =---------------------------------------------------------------------------=
@@ -36,6 +45,18 @@ getQueueSpot: Returns the last node that has a higher priority than the current
 */
 static Node getQueueSpot(PriorityQueue queue, Node node);
 
+/*
+createNode: Creates a queue node that stores copies of an element and its priority.
+
+@param queue - The queue that the node is created for.
+@param element - The element to copy into the node.
+@param priority - The priority to copy into the node.
+
+@return NULL if a memory allocation failed.
+		Else, returns the new node.
+*/
+static Node createNode(PriorityQueue queue, PQElement element, PQElementPriority priority);
+
 /*
 removeElement: Removes a specific element with a specific priority from the queue.
 
@@ -48,6 +69,90 @@ removeElement: Removes a specific element with a specific priority from the queu
 */
 static PriorityQueueResult removeElement(PriorityQueue queue, PQElement element, PQElementPriority priority);
 
+/*
+findRangeStart: Returns the first node whose priority isn't higher than the start of a range.
+
+@param queue - The queue to search.
+@param from - The highest priority of the range, or NULL for the first node.
+@param previous - Set to the node before the returned node, or to NULL if it is the first node.
+
+@return NULL if no node is in the range or after it.
+		Else, returns the first node of the range, or the node after the range if it is empty.
+*/
+static Node findRangeStart(PriorityQueue queue, PQElementPriority from, Node* previous);
+
+/*
+isBeforeRangeEnd: Checks that the priority of a node isn't lower than the end of a range.
+
+@param queue - The queue of the node.
+@param node - The node to check.
+@param to - The lowest priority of the range, or NULL for no end.
+
+@return True if the node isn't NULL and its priority isn't lower than to.
+		Else, returns False.
+*/
+static bool isBeforeRangeEnd(PriorityQueue queue, Node node, PQElementPriority to);
+
+/*
+comparePriorities: Compares two priorities with the compare function of the queue, counting the call in its stats.
+
+@param queue - The queue that compares the priorities.
+@param priority1 - The first priority to compare.
+@param priority2 - The second priority to compare.
+
+@return The result of the compare function of the queue.
+*/
+static int comparePriorities(PriorityQueue queue, PQElementPriority priority1, PQElementPriority priority2);
+
+/*
+equalElements: Compares two elements with the equal function of the queue, counting the call in its stats.
+
+@param queue - The queue that compares the elements.
+@param element1 - The first element to compare.
+@param element2 - The second element to compare.
+
+@return The result of the equal function of the queue.
+*/
+static bool equalElements(PriorityQueue queue, PQElement element1, PQElement element2);
+
+/*
+nextNode: Returns the node after a node of the queue, counting the step in its stats.
+
+@param queue - The queue of the node.
+@param node - The node to step from.
+
+@return NULL if the node is NULL or the last node.
+		Else, returns the next node.
+*/
+static Node nextNode(PriorityQueue queue, Node node);
+
+/*
+removeNode: Deallocates a node of the queue, counting the deallocations in its stats.
+
+@param queue - The queue of the node.
+@param node - The node to deallocate, already unlinked from the queue.
+*/
+static void removeNode(PriorityQueue queue, Node node);
+
+/*
+mergeLists: Merges the nodes of a queue's list into the list of another queue, keeping both in order.
+
+@param queue - The queue to merge into, its nodes come first among equal priorities.
+@param source - The queue whose nodes move, its list is left empty.
+*/
+static void mergeLists(PriorityQueue queue, PriorityQueue source);
+
+/*
+sameFunctions: Checks whether two queues copy, free and compare their elements and priorities with the same functions.
+
+@param queue1 - The first queue.
+@param queue2 - The second queue.
+
+@return True if all of the functions of the queues are the same.
+		Else, returns False.
+*/
+static bool sameFunctions(PriorityQueue queue1, PriorityQueue queue2);
+
 /* =---------------------------------------------------------------------------=
 
 							Priority Queue Functions
@@ -59,25 +164,72 @@ static PriorityQueueResult removeElement(PriorityQueue queue, PQElement element,
 PriorityQueue pqCreate(CopyPQElement copy_element, FreePQElement free_element,
 						EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
 						FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities)
+{
+	return pqCreateWithAllocator(copy_element, free_element, equal_elements, copy_priority,
+								free_priority, compare_priorities, NULL);
+}
+
+
+PriorityQueue pqCreateWithEngine(CopyPQElement copy_element, FreePQElement free_element,
+								 EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+								 FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+								 PQEngine engine, const Allocator* allocator)
+{
+	if (engine != PQ_ENGINE_LIST && engine != PQ_ENGINE_BTREE && engine != PQ_ENGINE_PAIRING_HEAP) {
+		return NULL;
+	}
+	PriorityQueue queue = pqCreateWithAllocator(copy_element, free_element, equal_elements, copy_priority,
+												free_priority, compare_priorities, allocator);
+	if (queue == NULL || engine == PQ_ENGINE_LIST) {
+		return queue;
+	}
+
+	STATS_BEGIN(start);
+	if (engine == PQ_ENGINE_BTREE) {
+		queue->tree = bqCreate(copy_element, free_element, equal_elements, copy_priority, free_priority,
+							   compare_priorities, allocator);
+	}
+	else {
+		queue->heap = phCreate(copy_element, free_element, equal_elements, copy_priority, free_priority,
+							   compare_priorities, allocator);
+	}
+	STATS_END(&queue->stats, start);
+	if (queue->tree == NULL && queue->heap == NULL) {
+		allocatorFree(allocator, queue);
+		return NULL;
+	}
+	return queue;
+}
+
+
+PriorityQueue pqCreateWithAllocator(CopyPQElement copy_element, FreePQElement free_element,
+									EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+									FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+									const Allocator* allocator)
 {
 	if (copy_element == NULL || free_element == NULL || equal_elements == NULL ||
 		copy_priority == NULL || free_priority == NULL || compare_priorities == NULL) {
 		return NULL;
 	}
 
-	PriorityQueue queue = malloc(sizeof(*queue));
+	PriorityQueue queue = allocatorAlloc(allocator, sizeof(*queue));
 	if (queue == NULL) {
 		return NULL;
 	}
 
+	queue->tree = NULL;
+	queue->heap = NULL;
 	queue->elements = NULL;
-	queue->iterator = NULL;
+	queue->last = NULL;
+	queue->iterator.position = NULL;
 	queue->copyElement = copy_element;
 	queue->freeElement = free_element;
 	queue->equalElements = equal_elements;
 	queue->copyPriorityElement = copy_priority;
 	queue->freePriorityElement = free_priority;
 	queue->comparePriorities = compare_priorities;
+	queue->allocator = allocator;
+	statsReset(&queue->stats);
 
 	return queue;
 }
@@ -88,8 +240,10 @@ void pqDestroy(PriorityQueue queue)
 	if (queue == NULL) {
 		return;
 	}
+	bqDestroy(queue->tree);
+	phDestroy(queue->heap);
 	nodeDestroy(queue->elements);
-	free(queue);
+	allocatorFree(queue->allocator, queue);
 }
 
 
@@ -98,20 +252,31 @@ PriorityQueue pqCopy(PriorityQueue queue)
 	if (queue == NULL) {
 		return NULL;
 	}
-	PriorityQueue queue_copy = pqCreate(queue->copyElement, queue->freeElement,
-										queue->equalElements, queue->copyPriorityElement,
-										queue->freePriorityElement, queue->comparePriorities);
+	PriorityQueue queue_copy = pqCreateWithAllocator(queue->copyElement, queue->freeElement,
+													queue->equalElements, queue->copyPriorityElement,
+													queue->freePriorityElement, queue->comparePriorities,
+													queue->allocator);
 	if (queue_copy == NULL) {
 		return NULL;
 	}
 
-	queue_copy->elements = nodeListCopy(queue->elements);
-	if (queue_copy->elements == NULL) {
-		free(queue_copy);
+	STATS_BEGIN(start);
+	if (queue->tree != NULL) {
+		queue_copy->tree = bqCopy(queue->tree);
+	}
+	else if (queue->heap != NULL) {
+		queue_copy->heap = phCopy(queue->heap);
+	}
+	else {
+		queue_copy->elements = nodeListCopy(queue->elements);
+	}
+	STATS_END(&queue->stats, start);
+	if (queue_copy->tree == NULL && queue_copy->heap == NULL && queue_copy->elements == NULL) {
+		allocatorFree(queue_copy->allocator, queue_copy);
 		return NULL;
 	}
-	queue->iterator = NULL;
-	queue_copy->iterator = NULL;
+	queue->iterator.position = NULL;
+	queue_copy->iterator.position = NULL;
 
 	return queue_copy;
 }
@@ -122,12 +287,18 @@ int pqGetSize(PriorityQueue queue)
 	if (queue == NULL) {
 		return NO_SIZE;
 	}
+	if (queue->tree != NULL) {
+		return bqGetSize(queue->tree);
+	}
+	if (queue->heap != NULL) {
+		return phGetSize(queue->heap);
+	}
 
 	int count = 0;
 	Node ptr = queue->elements;
 	while (ptr != NULL) {
 		count++;
-		ptr = nodeGetNext(ptr);
+		ptr = nextNode(queue, ptr);
 	}
 	return count;
 }
@@ -138,10 +309,22 @@ bool pqContains(PriorityQueue queue, PQElement element)
 	if (queue == NULL || element == NULL) {
 		return false;
 	}
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		bool found = bqContains(queue->tree, element);
+		STATS_END(&queue->stats, start);
+		return found;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		bool found = phContains(queue->heap, element);
+		STATS_END(&queue->stats, start);
+		return found;
+	}
 
-	NODE_FOREACH(Node, ptr, queue->elements) {
+	for (Node ptr = queue->elements; ptr != NULL; ptr = nextNode(queue, ptr)) {
 		Pair data = nodeGet(ptr);
-		if (queue->equalElements(pairFirst(data), element)) {
+		if (equalElements(queue, pairFirst(data), element)) {
 			return true;
 		}
 	}
@@ -155,18 +338,25 @@ PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPr
 	if (queue == NULL || element == NULL || priority == NULL) {
 		return PQ_NULL_ARGUMENT;
 	}
-
-	Pair pair = pairCreate(element, priority, queue->copyElement, queue->copyPriorityElement,
-							queue->freeElement, queue->freePriorityElement);
-	if (pair == NULL) {
-		return PQ_OUT_OF_MEMORY;
+	if (queue->tree != NULL) {
+		queue->iterator.position = NULL;
+		STATS_BEGIN(start);
+		PriorityQueueResult res = bqInsert(queue->tree, element, priority);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
+	if (queue->heap != NULL) {
+		queue->iterator.position = NULL;
+		STATS_BEGIN(start);
+		PriorityQueueResult res = phInsert(queue->heap, element, priority);
+		STATS_END(&queue->stats, start);
+		return res;
 	}
-	Node node = nodeCreate(pair, (ElemCopyFunc)pairCopy, (ElemFreeFunc)pairDestroy);
+
+	Node node = createNode(queue, element, priority);
 	if (node == NULL) {
-		pairDestroy(pair);
 		return PQ_OUT_OF_MEMORY;
 	}
-	pairDestroy(pair); //nodeCreate makes a copy of the pair.
 
 	if (queue->elements == NULL) { //Check if this the first time an element is added.
 		queue->elements = node;
@@ -174,11 +364,11 @@ PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPr
 	}
 	Node ptr = getQueueSpot(queue, node);
 	if (ptr != node) {
-	nodeSetNext(node, nodeGetNext(ptr));
+	nodeSetNext(node, nextNode(queue, ptr));
 	nodeSetNext(ptr, node);
 	}
 
-	queue->iterator = NULL;
+	queue->iterator.position = NULL;
 	return PQ_SUCCESS;
 }
 
@@ -189,13 +379,9 @@ PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
 	if (queue == NULL || element == NULL || old_priority == NULL || new_priority == NULL) {
 		return PQ_NULL_ARGUMENT;
 	}
-	Node ptr = queue->elements;
-	if (ptr == NULL) {
-		return PQ_ELEMENT_DOES_NOT_EXISTS;
-	}
 
-	queue->iterator = NULL;
-	int res = removeElement(queue, element, old_priority);
+	queue->iterator.position = NULL;
+	int res = pqRemoveElementWithPriority(queue, element, old_priority);
 	if (res != PQ_SUCCESS) {
 		return res;
 	}
@@ -209,14 +395,27 @@ PriorityQueueResult pqRemove(PriorityQueue queue)
 		return PQ_NULL_ARGUMENT;
 	}
 
-	queue->iterator = NULL;
+	queue->iterator.position = NULL;
+	queue->last = NULL;
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		bqRemoveFirst(queue->tree);
+		STATS_END(&queue->stats, start);
+		return PQ_SUCCESS;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		phRemoveFirst(queue->heap);
+		STATS_END(&queue->stats, start);
+		return PQ_SUCCESS;
+	}
 	Node ptr = queue->elements;
 	if (ptr == NULL) {
 		return PQ_SUCCESS;
 	}
-	
-	queue->elements = nodeGetNext(ptr);
-	nodeRemove(ptr);
+
+	queue->elements = nextNode(queue, ptr);
+	removeNode(queue, ptr);
 	return PQ_SUCCESS;
 }
 
@@ -227,15 +426,27 @@ PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element)
 		return PQ_NULL_ARGUMENT;
 	}
 
-	queue->iterator = NULL;
+	queue->iterator.position = NULL;
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		PriorityQueueResult res = bqRemoveElement(queue->tree, element);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		PriorityQueueResult res = phRemoveElement(queue->heap, element);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
 	Node ptr = queue->elements;
 	if (ptr == NULL) {
 		return PQ_ELEMENT_DOES_NOT_EXISTS;
 	}
 
-	NODE_FOREACH(Node, ptr, queue->elements) {
+	for (Node ptr = queue->elements; ptr != NULL; ptr = nextNode(queue, ptr)) {
 		Pair data = nodeGet(ptr);
-		if (queue->equalElements(pairFirst(data), element)) {
+		if (equalElements(queue, pairFirst(data), element)) {
 			return removeElement(queue, element, pairSecond(data));
 		}
 	}
@@ -243,13 +454,78 @@ PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element)
 }
 
 
+PriorityQueueResult pqRemoveElementWithPriority(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+	if (queue == NULL || element == NULL || priority == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+
+	queue->iterator.position = NULL;
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		PriorityQueueResult res = bqRemoveElementWithPriority(queue->tree, element, priority);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		PriorityQueueResult res = phRemoveElementWithPriority(queue->heap, element, priority);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
+	if (queue->elements == NULL) {
+		return PQ_ELEMENT_DOES_NOT_EXISTS;
+	}
+	return removeElement(queue, element, priority);
+}
+
+
+PriorityQueueResult pqAppend(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+	if (queue == NULL || element == NULL || priority == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+	if (queue->tree != NULL) {
+		queue->iterator.position = NULL;
+		STATS_BEGIN(start);
+		PriorityQueueResult res = bqAppend(queue->tree, element, priority);
+		STATS_END(&queue->stats, start);
+		return res;
+	}
+	if (queue->heap != NULL) { //A heap has no end to append to, and inserting is O(1) anyway.
+		return pqInsert(queue, element, priority);
+	}
+	if (queue->elements == NULL) {
+		return pqInsert(queue, element, priority);
+	}
+
+	Node last = queue->last != NULL ? queue->last : queue->elements;
+	//Only walks when the queue changed since the last append.
+	for (Node next = nextNode(queue, last); next != NULL; next = nextNode(queue, next)) {
+		last = next;
+	}
+	if (comparePriorities(queue, pairSecond(nodeGet(last)), priority) < 0) {
+		queue->last = last;
+		return pqInsert(queue, element, priority); //Out of order, takes the regular path.
+	}
+
+	Node node = createNode(queue, element, priority);
+	if (node == NULL) {
+		return PQ_OUT_OF_MEMORY;
+	}
+	nodeSetNext(last, node);
+	queue->last = node;
+	queue->iterator.position = NULL;
+	return PQ_SUCCESS;
+}
+
+
 PQElement pqGetFirst(PriorityQueue queue)
 {
 	if (queue == NULL) {
 		return NULL;
 	}
-	queue->iterator = queue->elements;
-	return pairFirst(nodeGet(queue->iterator));
+	return pqCursorFirst(queue, &queue->iterator);
 }
 
 PQElement pqGetNext(PriorityQueue queue)
@@ -257,8 +533,182 @@ PQElement pqGetNext(PriorityQueue queue)
 	if (queue == NULL) {
 		return NULL;
 	}
-	queue->iterator = nodeGetNext(queue->iterator);
-	return pairFirst(nodeGet(queue->iterator));
+	return pqCursorNext(queue, &queue->iterator);
+}
+
+
+PQElement pqCursorFirst(PriorityQueue queue, PQCursor* cursor)
+{
+	if (queue == NULL || cursor == NULL) {
+		return NULL;
+	}
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		PQElement element = bqCursorFirst(queue->tree, cursor);
+		STATS_END(&queue->stats, start);
+		return element;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		PQElement element = phCursorFirst(queue->heap, cursor);
+		STATS_END(&queue->stats, start);
+		return element;
+	}
+	cursor->position = queue->elements;
+	return pairFirst(nodeGet(cursor->position));
+}
+
+PQElement pqCursorNext(PriorityQueue queue, PQCursor* cursor)
+{
+	if (queue == NULL || cursor == NULL) {
+		return NULL;
+	}
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		PQElement element = bqCursorNext(queue->tree, cursor);
+		STATS_END(&queue->stats, start);
+		return element;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		PQElement element = phCursorNext(queue->heap, cursor);
+		STATS_END(&queue->stats, start);
+		return element;
+	}
+	cursor->position = nextNode(queue, cursor->position);
+	return pairFirst(nodeGet(cursor->position));
+}
+
+
+PQElementPriority pqGetFirstPriority(PriorityQueue queue)
+{
+	if (queue == NULL) {
+		return NULL;
+	}
+	if (queue->tree != NULL) {
+		return bqGetFirstPriority(queue->tree);
+	}
+	if (queue->heap != NULL) {
+		return phGetFirstPriority(queue->heap);
+	}
+	return pairSecond(nodeGet(queue->elements));
+}
+
+
+PriorityQueueResult pqForEachInPriorityRange(PriorityQueue queue, PQElementPriority from, PQElementPriority to,
+											 PQRangeFunc visit, void* context)
+{
+	if (queue == NULL || visit == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		bqForEachInPriorityRange(queue->tree, from, to, visit, context);
+		STATS_END(&queue->stats, start);
+		return PQ_SUCCESS;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		bool sorted = phForEachInPriorityRange(queue->heap, from, to, visit, context);
+		STATS_END(&queue->stats, start);
+		return sorted ? PQ_SUCCESS : PQ_OUT_OF_MEMORY;
+	}
+
+	Node previous = NULL;
+	for (Node ptr = findRangeStart(queue, from, &previous); isBeforeRangeEnd(queue, ptr, to); ptr = nextNode(queue, ptr)) {
+		Pair data = nodeGet(ptr);
+		if (!visit(context, pairFirst(data), pairSecond(data))) {
+			break;
+		}
+	}
+	return PQ_SUCCESS;
+}
+
+
+PriorityQueueResult pqRemoveRange(PriorityQueue queue, PQElementPriority from, PQElementPriority to)
+{
+	if (queue == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+
+	queue->iterator.position = NULL;
+	queue->last = NULL;
+	if (queue->tree != NULL) {
+		STATS_BEGIN(start);
+		bqRemoveRange(queue->tree, from, to);
+		STATS_END(&queue->stats, start);
+		return PQ_SUCCESS;
+	}
+	if (queue->heap != NULL) {
+		STATS_BEGIN(start);
+		bool sorted = phRemoveRange(queue->heap, from, to);
+		STATS_END(&queue->stats, start);
+		return sorted ? PQ_SUCCESS : PQ_OUT_OF_MEMORY;
+	}
+	Node previous = NULL;
+	Node ptr = findRangeStart(queue, from, &previous);
+	while (isBeforeRangeEnd(queue, ptr, to)) {
+		Node next = nextNode(queue, ptr);
+		removeNode(queue, ptr);
+		ptr = next;
+	}
+	if (previous == NULL) {
+		queue->elements = ptr;
+	}
+	else {
+		nodeSetNext(previous, ptr);
+	}
+	return PQ_SUCCESS;
+}
+
+
+PriorityQueueResult pqMerge(PriorityQueue queue, PriorityQueue source)
+{
+	if (queue == NULL || source == NULL) {
+		return PQ_NULL_ARGUMENT;
+	}
+	if ((queue->tree == NULL) != (source->tree == NULL) || (queue->heap == NULL) != (source->heap == NULL) ||
+		queue->allocator != source->allocator || !sameFunctions(queue, source)) {
+		return PQ_ERROR;
+	}
+	if (queue == source) {
+		return PQ_SUCCESS;
+	}
+
+	queue->iterator.position = NULL;
+	source->iterator.position = NULL;
+	PriorityQueueResult res = PQ_SUCCESS;
+	STATS_BEGIN(start);
+	if (queue->tree != NULL) {
+		res = bqMerge(queue->tree, source->tree);
+	}
+	else if (queue->heap != NULL) {
+		phMerge(queue->heap, source->heap);
+	}
+	else {
+		mergeLists(queue, source);
+	}
+	STATS_END(&queue->stats, start);
+	return res;
+}
+
+
+bool pqGetStats(PriorityQueue queue, OperationStats* stats)
+{
+	if (queue == NULL || stats == NULL) {
+		return false;
+	}
+	*stats = queue->stats;
+	return statsEnabled();
+}
+
+
+void pqResetStats(PriorityQueue queue)
+{
+	if (queue == NULL) {
+		return;
+	}
+	statsReset(&queue->stats);
 }
 
 
@@ -267,9 +717,18 @@ PriorityQueueResult pqClear(PriorityQueue queue)
 	if (queue == NULL) {
 		return PQ_NULL_ARGUMENT;
 	}
+	STATS_BEGIN(start);
+	if (queue->tree != NULL) {
+		bqClear(queue->tree);
+	}
+	if (queue->heap != NULL) {
+		phClear(queue->heap);
+	}
 	nodeDestroy(queue->elements);
+	STATS_END(&queue->stats, start);
 	queue->elements = NULL;
-	queue->iterator = NULL;
+	queue->last = NULL;
+	queue->iterator.position = NULL;
 	return PQ_SUCCESS;
 }
 
@@ -286,50 +745,172 @@ static Node getQueueSpot(PriorityQueue queue, Node node)
 	Node ptr = queue->elements;
 	PQElementPriority priority = pairSecond(nodeGet(ptr));
 
-	if (queue->comparePriorities(priority, pairSecond(nodeGet(node))) < 0) {
+	if (comparePriorities(queue, priority, pairSecond(nodeGet(node))) < 0) {
 		nodeSetNext(node, ptr);
 		queue->elements = node;
 		return node;
 	}
 
 	Node prev = ptr;
-	ptr = nodeGetNext(ptr);
+	ptr = nextNode(queue, ptr);
 	while (ptr != NULL) {
 		PQElementPriority priority = pairSecond(nodeGet(ptr));
-		if (queue->comparePriorities(priority, pairSecond(nodeGet(node))) < 0) {
+		if (comparePriorities(queue, priority, pairSecond(nodeGet(node))) < 0) {
 			return prev;
 		}
 		prev = ptr;
-		ptr = nodeGetNext(ptr);
+		ptr = nextNode(queue, ptr);
 	}
 	return prev; //Returns the last element in the list.
 }
 
 
+static Node createNode(PriorityQueue queue, PQElement element, PQElementPriority priority)
+{
+	STATS_BEGIN(start);
+	Pair pair = pairCreateWithAllocator(element, priority, queue->copyElement, queue->copyPriorityElement,
+										queue->freeElement, queue->freePriorityElement, queue->allocator);
+	Node node = pair == NULL ? NULL :
+		nodeCreateOwning(pair, (ElemCopyFunc)pairCopy, (ElemFreeFunc)pairDestroy, queue->allocator);
+	if (pair != NULL && node == NULL) { //The node owns the pair, so it is copied only once.
+		pairDestroy(pair);
+	}
+	STATS_END(&queue->stats, start);
+	return node;
+}
+
+
 static PriorityQueueResult removeElement(PriorityQueue queue, PQElement element, PQElementPriority priority)
 {
+	queue->last = NULL;
 	Node ptr = queue->elements;
 	PQElement curr_element = pairFirst(nodeGet(ptr));
 	PQElementPriority curr_priority = pairSecond(nodeGet(ptr));
 
-	if (queue->equalElements(curr_element, element) && !queue->comparePriorities(curr_priority, priority)) {
-		queue->elements = nodeGetNext(ptr);
-		nodeRemove(ptr);
+	if (equalElements(queue, curr_element, element) && !comparePriorities(queue, curr_priority, priority)) {
+		queue->elements = nextNode(queue, ptr);
+		removeNode(queue, ptr);
 		return PQ_SUCCESS;
 	}
 
-	Node ptr_next = nodeGetNext(ptr);
+	Node ptr_next = nextNode(queue, ptr);
 	while (ptr_next != NULL) {
 		PQElement curr_element = pairFirst(nodeGet(ptr_next));
 		PQElementPriority curr_priority = pairSecond(nodeGet(ptr_next));
 
-		if (queue->equalElements(curr_element, element) && !queue->comparePriorities(curr_priority, priority)) {
-			nodeSetNext(ptr, nodeGetNext(ptr_next));
-			nodeRemove(ptr_next);
+		if (equalElements(queue, curr_element, element) && !comparePriorities(queue, curr_priority, priority)) {
+			nodeSetNext(ptr, nextNode(queue, ptr_next));
+			removeNode(queue, ptr_next);
 			return PQ_SUCCESS;
 		}
 		ptr = ptr_next;
-		ptr_next = nodeGetNext(ptr_next);
+		ptr_next = nextNode(queue, ptr_next);
 	}
 	return PQ_ELEMENT_DOES_NOT_EXISTS;
+}
+
+
+static Node findRangeStart(PriorityQueue queue, PQElementPriority from, Node* previous)
+{
+	*previous = NULL;
+	Node ptr = queue->elements;
+	if (from == NULL) {
+		return ptr;
+	}
+	//The queue is sorted, so the range starts at the first node that isn't higher than from.
+	while (ptr != NULL && comparePriorities(queue, pairSecond(nodeGet(ptr)), from) > 0) {
+		*previous = ptr;
+		ptr = nextNode(queue, ptr);
+	}
+	return ptr;
+}
+
+
+static bool isBeforeRangeEnd(PriorityQueue queue, Node node, PQElementPriority to)
+{
+	if (node == NULL) {
+		return false;
+	}
+	return to == NULL || comparePriorities(queue, pairSecond(nodeGet(node)), to) >= 0;
+}
+
+
+static int comparePriorities(PriorityQueue queue, PQElementPriority priority1, PQElementPriority priority2)
+{
+	STATS_BEGIN(start);
+	STATS_COUNT(comparisons);
+	int res = queue->comparePriorities(priority1, priority2);
+	STATS_END(&queue->stats, start);
+	return res;
+}
+
+
+static bool equalElements(PriorityQueue queue, PQElement element1, PQElement element2)
+{
+	STATS_BEGIN(start);
+	STATS_COUNT(equality_checks);
+	bool res = queue->equalElements(element1, element2);
+	STATS_END(&queue->stats, start);
+	return res;
+}
+
+
+static Node nextNode(PriorityQueue queue, Node node)
+{
+	STATS_BEGIN(start);
+	Node next = nodeGetNext(node);
+	STATS_END(&queue->stats, start);
+	return next;
+}
+
+
+static void removeNode(PriorityQueue queue, Node node)
+{
+	STATS_BEGIN(start);
+	nodeRemove(node);
+	STATS_END(&queue->stats, start);
+}
+
+
+static void mergeLists(PriorityQueue queue, PriorityQueue source)
+{
+	Node first = queue->elements, second = source->elements;
+	Node head = NULL, tail = NULL;
+	while (first != NULL || second != NULL) {
+		Node next = NULL;
+		if (second == NULL || (first != NULL &&
+			comparePriorities(queue, pairSecond(nodeGet(first)), pairSecond(nodeGet(second))) >= 0)) {
+			next = first;
+			first = nextNode(queue, first);
+		}
+		else {
+			next = second;
+			second = nextNode(queue, second);
+		}
+		if (tail == NULL) {
+			head = next;
+		}
+		else {
+			nodeSetNext(tail, next);
+		}
+		tail = next;
+		if (first == NULL || second == NULL) { //The rest of the other list is already linked in order.
+			nodeSetNext(tail, first != NULL ? first : second);
+			first = NULL;
+			second = NULL;
+		}
+	}
+	queue->elements = head;
+	queue->last = NULL;
+	source->elements = NULL;
+	source->last = NULL;
+}
+
+
+static bool sameFunctions(PriorityQueue queue1, PriorityQueue queue2)
+{
+	return queue1->copyElement == queue2->copyElement && queue1->freeElement == queue2->freeElement &&
+		   queue1->equalElements == queue2->equalElements && queue1->copyPriorityElement == queue2->copyPriorityElement &&
+		   queue1->freePriorityElement == queue2->freePriorityElement &&
+		   queue1->comparePriorities == queue2->comparePriorities;
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+#ifndef _PRIORITY_QUEUE_EXT_H
+#define _PRIORITY_QUEUE_EXT_H
+
+#include "priority_queue.h"
+#include "allocator.h"
+#include "stats.h"
+
+/*
+* Extensions to the priority queue interface.
+* The functions declared in priority_queue.h behave the same for every queue.
+*/
+
+/** Type for iterating over a queue without changing it, the position is private to the engine of the queue */
+typedef struct {
+	void* position;
+	int index;
+} PQCursor;
+
+/** Type used for selecting the structure that stores the elements of a queue */
+typedef enum {
+	PQ_ENGINE_LIST,
+	PQ_ENGINE_BTREE,
+	PQ_ENGINE_PAIRING_HEAP
+} PQEngine;
+
+/** Type of the function that visits an element of a priority range, returns false to stop the visit */
+typedef bool(*PQRangeFunc)(void* context, PQElement element, PQElementPriority priority);
+
+
+/*
+pqCreateWithAllocator: Creates a new empty queue like pqCreate, whose nodes are allocated from the given allocator.
+					   Elements and priorities are copied by the given copy functions, so they are allocated
+					   like the originals: an element created with the same allocator is copied into it.
+					   Copies of the queue use the same allocator.
+
+@param copy_element - Function for copying elements.
+@param free_element - Function for deallocating elements.
+@param equal_elements - Function for comparing elements.
+@param copy_priority - Function for copying priorities.
+@param free_priority - Function for deallocating priorities.
+@param compare_priorities - Function for comparing priorities.
+@param allocator - The allocator of the queue, or NULL for the default allocator.
+
+@return NULL if one of the functions is NULL or if a memory allocation failed.
+		Else, returns a new empty queue.
+*/
+PriorityQueue pqCreateWithAllocator(CopyPQElement copy_element, FreePQElement free_element,
+									EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+									FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+									const Allocator* allocator);
+
+/*
+pqCreateWithEngine: Creates a new empty queue like pqCreateWithAllocator, whose elements are stored in the given engine.
+					All of the engines keep the same order, and copies of the queue use the same engine.
+					Equal priorities are kept in insertion order: the list by the position of every insertion,
+					and the other engines by a 64-bit sequence that they give every element when it is inserted,
+					which is compared only when the compare function returns 0.
+
+@param copy_element - Function for copying elements.
+@param free_element - Function for deallocating elements.
+@param equal_elements - Function for comparing elements.
+@param copy_priority - Function for copying priorities.
+@param free_priority - Function for deallocating priorities.
+@param compare_priorities - Function for comparing priorities.
+@param engine - PQ_ENGINE_LIST keeps the elements in a sorted linked list, so inserting walks the list.
+				PQ_ENGINE_BTREE keeps the elements in a B+-tree with wide linked leaves, so inserting,
+				removing the first element, changing a priority and pqRemoveElementWithPriority take
+				O(log n) comparisons, the size is kept, and iterating reads the leaves in order.
+				PQ_ENGINE_PAIRING_HEAP keeps the elements in a pairing heap, so inserting takes O(1),
+				pqMerge makes one comparison, removing the first element and pqRemoveElementWithPriority
+				take O(log n) amortized, and iterating past the first element or visiting a range sorts
+				the queue once after every change (pqAppend is the same as pqInsert).
+@param allocator - The allocator of the queue, or NULL for the default allocator.
+
+@return NULL if one of the functions is NULL, the engine is unknown or if a memory allocation failed.
+		Else, returns a new empty queue.
+*/
+PriorityQueue pqCreateWithEngine(CopyPQElement copy_element, FreePQElement free_element,
+								 EqualPQElements equal_elements, CopyPQElementPriority copy_priority,
+								 FreePQElementPriority free_priority, ComparePQElementPriorities compare_priorities,
+								 PQEngine engine, const Allocator* allocator);
+
+/*
+pqCursorFirst: Sets an external cursor to the highest priority element and returns it.
+			   Unlike pqGetFirst, the queue itself isn't changed, so several cursors
+			   (or several threads) can iterate over the same queue at the same time.
+			   Any change to the queue invalidates its cursors.
+
+@param queue - The queue to iterate over.
+@param cursor - The cursor to set.
+
+@return NULL if one of the arguments is NULL or if the queue is empty.
+		Else, returns the highest priority element (Not a copy).
+*/
+PQElement pqCursorFirst(PriorityQueue queue, PQCursor* cursor);
+
+/*
+pqCursorNext: Advances an external cursor and returns the element it points to.
+
+@param queue - The queue to iterate over.
+@param cursor - The cursor to advance.
+
+@return NULL if one of the arguments is NULL or if the end of the queue was reached.
+		Else, returns the next element (Not a copy).
+*/
+PQElement pqCursorNext(PriorityQueue queue, PQCursor* cursor);
+
+/*
+pqGetFirstPriority: Returns the priority of the highest priority element.
+					The returned priority is not copied, and therefore it is the user's
+					responsibility not to modify it in any way.
+
+@param queue - The queue to read from.
+
+@return NULL if the queue is NULL or empty.
+		Else, returns the priority of the first element (Not a copy).
+*/
+PQElementPriority pqGetFirstPriority(PriorityQueue queue);
+
+/*
+pqAppend: Adds a copy of an element with a copy of its priority after the last element of the queue.
+		  Meant for building a queue from elements that are already in queue order:
+		  consecutive appends don't walk the queue, so building it takes linear time.
+		  An element with a higher priority than the last one is inserted like in pqInsert.
+
+@param queue - The queue to add the element to.
+@param element - The element to add.
+@param priority - The priority of the element.
+
+@return PQ_NULL_ARGUMENT if one of the arguments is NULL.
+		PQ_OUT_OF_MEMORY if a memory allocation failed.
+		PQ_SUCCESS if the element has been added.
+*/
+PriorityQueueResult pqAppend(PriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/*
+pqRemoveElementWithPriority: Removes an element whose priority is known, like pqRemoveElement,
+							 but searches only the elements of that priority.
+
+@param queue - The queue to remove the element from.
+@param element - The element to remove.
+@param priority - The priority of the element in the queue.
+
+@return PQ_NULL_ARGUMENT if one of the arguments is NULL.
+		PQ_ELEMENT_DOES_NOT_EXISTS if no element of that priority is equal to it.
+		PQ_SUCCESS if the first element of that priority that is equal to it has been removed.
+*/
+PriorityQueueResult pqRemoveElementWithPriority(PriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/*
+pqForEachInPriorityRange: Passes the elements whose priorities are in a range to a function, in queue order.
+						  The range is given in queue order, from its highest priority to its lowest,
+						  and includes both bounds. For a queue of dates where the earliest date comes
+						  first, from is the earliest date of the range and to is the latest.
+						  The function must not change the queue.
+
+@param queue - The queue to visit.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+@param visit - The function that visits an element (Not a copy) and its priority (Not a copy).
+@param context - Passed to every call of visit.
+
+@return PQ_NULL_ARGUMENT if the queue or the function is NULL.
+		PQ_OUT_OF_MEMORY if the pairing heap engine failed to sort the queue (No element was visited).
+		PQ_SUCCESS if the elements of the range have been visited, or visit returned false.
+*/
+PriorityQueueResult pqForEachInPriorityRange(PriorityQueue queue, PQElementPriority from, PQElementPriority to,
+											 PQRangeFunc visit, void* context);
+
+/*
+pqRemoveRange: Removes all of the elements whose priorities are in a range, see pqForEachInPriorityRange.
+			   The bounds are compared after elements are removed, so they must not be priorities
+			   of the queue itself (Like the one returned by pqGetFirstPriority).
+
+@param queue - The queue to remove the elements from.
+@param from - The highest priority of the range, or NULL to start at the first element.
+@param to - The lowest priority of the range, or NULL to end at the last element.
+
+@return PQ_NULL_ARGUMENT if the queue is NULL.
+		PQ_OUT_OF_MEMORY if the pairing heap engine failed to sort the queue (The queue isn't changed).
+		PQ_SUCCESS if the elements of the range have been removed (Also if the range is empty).
+*/
+PriorityQueueResult pqRemoveRange(PriorityQueue queue, PQElementPriority from, PQElementPriority to);
+
+/*
+pqMerge: Moves all of the elements of a queue into another queue, without copying them, and empties it.
+		 Equal priorities keep their order within each queue, and the elements of queue come before
+		 the ones of source with the same priority, in every engine.
+		 The list engine merges the two lists in O(n + m), the B+-tree engine builds a full tree
+		 from the two leaf lists in O(n + m), and the pairing heap engine offsets the insertion
+		 sequences of source past the ones of queue in O(m) and links the two roots with one comparison.
+
+@param queue - The queue to merge into.
+@param source - The queue to empty.
+
+@return PQ_NULL_ARGUMENT if one of the queues is NULL.
+		PQ_ERROR if the queues use different engines, different allocators or different functions.
+		PQ_OUT_OF_MEMORY if a memory allocation failed (The queues aren't changed).
+		PQ_SUCCESS if the elements have been moved (Also if both are the same queue, which isn't changed).
+*/
+PriorityQueueResult pqMerge(PriorityQueue queue, PriorityQueue source);
+
+/*
+pqGetStats: Returns the work done by the queue since it was created or since its stats were reset:
+			the allocations and deallocations of its nodes and elements, the calls to its
+			compare and equal functions, and the nodes its operations stepped over (see stats.h).
+
+@param queue - The queue to read the stats of.
+@param stats - Set to the stats of the queue, or to zeros if the counters are disabled.
+
+@return False if one of the arguments is NULL or if COLLECT_STATS wasn't defined.
+		Else, returns True.
+*/
+bool pqGetStats(PriorityQueue queue, OperationStats* stats);
+
+/*
+pqResetStats: Sets the stats of the queue to zeros, for measuring the next operations.
+
+@param queue - The queue to reset the stats of.
+*/
+void pqResetStats(PriorityQueue queue);
+
+/*
+* Macro for iterating over a queue with an external cursor.
+* The cursor must be declared by the caller.
+*/
+#define PQ_CURSOR_FOREACH(type, iterator, cursor, queue) \
+	for(type iterator = (type) pqCursorFirst(queue, &(cursor)) ; \
+		iterator != NULL ;\
+		iterator = (type) pqCursorNext(queue, &(cursor)))
+
+#endif /* _PRIORITY_QUEUE_EXT_H */
@@ -0,0 +1,123 @@
+#define _POSIX_C_SOURCE 200809L //For pthread under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "report_writer.h"
+
+struct report_writer_t {
+	char* path;
+	char* buffer;
+	size_t size;
+	bool started; //True if the thread was started, else the file was already written.
+	pthread_t thread;
+	pthread_mutex_t lock; //Guards done.
+	bool done;
+	ReportWriterResult result; //Set before done, read after the thread was joined.
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+writeReport: Writes the buffer of a writer to its file and frees the buffer, the entry function of the writer thread.
+
+@param writer - The ReportWriter to write.
+
+@return NULL.
+*/
+static void* writeReport(void* writer);
+
+/* =---------------------------------------------------------------------------=
+
+								Report Writer Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+ReportWriter reportWriterStart(const char* path, char* buffer, size_t size)
+{
+	ReportWriter writer = path == NULL ? NULL : malloc(sizeof(*writer));
+	char* path_copy = writer == NULL ? NULL : malloc(strlen(path) + 1);
+	if (path_copy == NULL) {
+		free(writer);
+		free(buffer);
+		return NULL;
+	}
+	strcpy(path_copy, path);
+	if (pthread_mutex_init(&writer->lock, NULL) != 0) {
+		free(path_copy);
+		free(writer);
+		free(buffer);
+		return NULL;
+	}
+	writer->path = path_copy;
+	writer->buffer = buffer;
+	writer->size = size;
+	writer->done = false;
+	writer->result = REPORT_WRITER_SUCCESS;
+	writer->started = pthread_create(&writer->thread, NULL, writeReport, writer) == 0;
+	if (!writer->started) {
+		writeReport(writer);
+	}
+	return writer;
+}
+
+bool reportWriterIsDone(ReportWriter writer)
+{
+	if (writer == NULL) {
+		return true;
+	}
+	pthread_mutex_lock(&writer->lock);
+	bool done = writer->done;
+	pthread_mutex_unlock(&writer->lock);
+	return done;
+}
+
+ReportWriterResult reportWriterWait(ReportWriter writer)
+{
+	if (writer == NULL) {
+		return REPORT_WRITER_NULL_ARGUMENT;
+	}
+	if (writer->started) {
+		pthread_join(writer->thread, NULL);
+	}
+	ReportWriterResult result = writer->result;
+	pthread_mutex_destroy(&writer->lock);
+	free(writer->path);
+	free(writer);
+	return result;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void* writeReport(void* writer)
+{
+	ReportWriter report = writer;
+	ReportWriterResult result = REPORT_WRITER_FILE_ERROR;
+	FILE* fd = fopen(report->path, "w");
+	if (fd != NULL) {
+		bool written = report->size == 0 || fwrite(report->buffer, 1, report->size, fd) == report->size;
+		if (fclose(fd) == 0 && written) {
+			result = REPORT_WRITER_SUCCESS;
+		}
+	}
+	free(report->buffer);
+	report->buffer = NULL;
+
+	pthread_mutex_lock(&report->lock);
+	report->result = result;
+	report->done = true;
+	pthread_mutex_unlock(&report->lock);
+	return NULL;
+}
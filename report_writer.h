@@ -0,0 +1,60 @@
+#ifndef _REPORT_WRITER_H
+#define _REPORT_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+* A background writer of a report that was already formatted into memory.
+* The writer takes the buffer and writes it to a file on a thread of its own,
+* so the file is opened, written and closed without blocking the thread that
+* formatted the report. The caller polls the writer or waits for it, and
+* waiting also releases the writer.
+*/
+
+/** Type for defining the report writer */
+typedef struct report_writer_t* ReportWriter;
+
+/** Type used for returning error codes from report writer functions */
+typedef enum {
+	REPORT_WRITER_SUCCESS,
+	REPORT_WRITER_NULL_ARGUMENT,
+	REPORT_WRITER_FILE_ERROR
+} ReportWriterResult;
+
+
+/*
+reportWriterStart: Starts writing a buffer to a file in the background, replacing the file.
+				   If the thread can't be started, the file is written before returning.
+
+@param path - The path of the file, copied.
+@param buffer - The report, allocated by malloc. The writer frees it, also when it can't be created.
+@param size - The number of bytes to write.
+
+@return NULL if the path is NULL or if a memory allocation failed.
+		Else, returns the writer, which must be passed to reportWriterWait.
+*/
+ReportWriter reportWriterStart(const char* path, char* buffer, size_t size);
+
+/*
+reportWriterIsDone: Returns whether the file has been written, without waiting.
+
+@param writer - The writer to check.
+
+@return True if the writer is NULL or the file has been written (or failed).
+		Else, returns False.
+*/
+bool reportWriterIsDone(ReportWriter writer);
+
+/*
+reportWriterWait: Waits until the file has been written, and deallocates the writer.
+
+@param writer - The writer to wait for.
+
+@return REPORT_WRITER_NULL_ARGUMENT if the writer is NULL.
+		REPORT_WRITER_FILE_ERROR if the file couldn't be opened or written.
+		REPORT_WRITER_SUCCESS if the file has been written.
+*/
+ReportWriterResult reportWriterWait(ReportWriter writer);
+
+#endif /* _REPORT_WRITER_H */
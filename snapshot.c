@@ -0,0 +1,513 @@
+#define _POSIX_C_SOURCE 200809L //For mmap under -std=c99.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+
+#define WORD_SIZE 4
+#define MEMBER_WORDS 3
+#define EVENT_WORDS 5
+#define TEMP_SUFFIX ".tmp"
+#define MAX_IMAGE_SIZE 0xFFFFFFFFu
+
+/** The word offsets of the header fields */
+enum {
+	HEADER_MAGIC,
+	HEADER_VERSION,
+	HEADER_BACKEND,
+	HEADER_CURRENT_DATE,
+	HEADER_STRINGS_COUNT,
+	HEADER_STRING_OFFSETS,
+	HEADER_STRING_DATA,
+	HEADER_STRING_DATA_SIZE,
+	HEADER_MEMBERS_COUNT,
+	HEADER_MEMBERS,
+	HEADER_EVENTS_COUNT,
+	HEADER_EVENTS,
+	HEADER_MEMBER_IDS_COUNT,
+	HEADER_MEMBER_IDS,
+	HEADER_FILE_SIZE,
+	HEADER_RESERVED,
+	SNAPSHOT_HEADER_WORDS
+};
+
+/** "EMSN" read as a little endian word */
+#define SNAPSHOT_MAGIC 0x4E534D45u
+
+struct snapshot_t {
+	unsigned char* data;
+	size_t size;
+	bool mapped; //True if data is a read only mapping of the file, else it was read into memory.
+	const unsigned char* string_offsets;
+	const char* string_data;
+	const unsigned char* members;
+	const unsigned char* events;
+	const unsigned char* member_ids;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+putWord: Stores a 32 bit word in little endian order.
+
+@param buffer - The buffer to store the word in.
+@param index - The word index in the buffer.
+@param value - The value to store.
+*/
+static void putWord(unsigned char* buffer, size_t index, unsigned int value);
+
+/*
+getWord: Reads a 32 bit little endian word.
+
+@param buffer - The buffer to read from.
+@param index - The word index in the buffer.
+
+@return The value of the word.
+*/
+static unsigned int getWord(const unsigned char* buffer, size_t index);
+
+/*
+getSignedWord: Reads a 32 bit little endian word that holds a signed value.
+
+@param buffer - The buffer to read from.
+@param index - The word index in the buffer.
+
+@return The signed value of the word.
+*/
+static int getSignedWord(const unsigned char* buffer, size_t index);
+
+/*
+alignToWord: Rounds a size up to a multiple of WORD_SIZE.
+
+@param size - The size to round.
+
+@return The rounded size.
+*/
+static size_t alignToWord(size_t size);
+
+/*
+readFile: Reads a whole file into memory.
+
+@param path - The path of the file.
+@param size - Set to the size of the file.
+
+@return NULL if the file couldn't be read or a memory allocation failed.
+		Else, returns the content of the file, which the caller must deallocate.
+*/
+static unsigned char* readFile(const char* path, size_t* size);
+
+/*
+mapFile: Maps a whole file into memory for reading.
+
+@param path - The path of the file.
+@param size - Set to the size of the file.
+
+@return NULL if the file couldn't be mapped or is empty.
+		Else, returns the read only mapping of the file, which the caller must unmap.
+*/
+static unsigned char* mapFile(const char* path, size_t* size);
+
+/*
+checkSection: Checks that a section of the image is inside the file.
+
+@param snapshot - The image.
+@param offset - The offset of the section.
+@param count - The number of records in the section.
+@param words - The number of words in a record.
+
+@return True if the section is word aligned and ends inside the file.
+		Else, returns False.
+*/
+static bool checkSection(Snapshot snapshot, unsigned int offset, unsigned int count, int words);
+
+/*
+checkImage: Checks that an image is well formed and sets its section pointers.
+
+@param snapshot - The image to check, with data and size set.
+
+@return True if the image is valid.
+		Else, returns False.
+*/
+static bool checkImage(Snapshot snapshot);
+
+/* =---------------------------------------------------------------------------=
+
+								Snapshot Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+SnapshotResult snapshotSave(const char* path, const SnapshotContent* content)
+{
+	if (path == NULL || content == NULL || content->names == NULL ||
+		(content->members == NULL && content->members_count > 0) ||
+		(content->events == NULL && content->events_count > 0) ||
+		(content->member_ids == NULL && content->member_ids_count > 0)) {
+		return SNAPSHOT_NULL_ARGUMENT;
+	}
+
+	int strings_count = strTableGetSize(content->names);
+	size_t string_data_size = 0;
+	for (int i = 0; i < strings_count; i++) {
+		string_data_size += strlen(strTableGet(content->names, i)) + 1;
+	}
+	size_t string_offsets = SNAPSHOT_HEADER_WORDS * WORD_SIZE;
+	size_t string_data = string_offsets + (size_t)(strings_count + 1) * WORD_SIZE;
+	size_t members = string_data + alignToWord(string_data_size);
+	size_t events = members + (size_t)content->members_count * MEMBER_WORDS * WORD_SIZE;
+	size_t member_ids = events + (size_t)content->events_count * EVENT_WORDS * WORD_SIZE;
+	size_t size = member_ids + (size_t)content->member_ids_count * WORD_SIZE;
+	if (size > MAX_IMAGE_SIZE) { //The offsets are 32 bit words.
+		return SNAPSHOT_FILE_ERROR;
+	}
+
+	unsigned char* image = calloc(size, 1);
+	if (image == NULL) {
+		return SNAPSHOT_OUT_OF_MEMORY;
+	}
+	unsigned int header[SNAPSHOT_HEADER_WORDS] = {
+		SNAPSHOT_MAGIC, SNAPSHOT_VERSION, content->backend, content->current_date,
+		strings_count, string_offsets, string_data, string_data_size,
+		content->members_count, members, content->events_count, events,
+		content->member_ids_count, member_ids, size, 0
+	};
+	for (int i = 0; i < SNAPSHOT_HEADER_WORDS; i++) {
+		putWord(image, i, header[i]);
+	}
+
+	size_t position = 0;
+	for (int i = 0; i < strings_count; i++) {
+		const char* name = strTableGet(content->names, i);
+		size_t length = strlen(name) + 1;
+		putWord(image + string_offsets, i, position);
+		memcpy(image + string_data + position, name, length);
+		position += length;
+	}
+	putWord(image + string_offsets, strings_count, position);
+
+	for (int i = 0; i < content->members_count; i++) {
+		const SnapshotMember* member = &content->members[i];
+		putWord(image + members, (size_t)i * MEMBER_WORDS, member->id);
+		putWord(image + members, (size_t)i * MEMBER_WORDS + 1, member->name);
+		putWord(image + members, (size_t)i * MEMBER_WORDS + 2, member->event_count);
+	}
+	for (int i = 0; i < content->events_count; i++) {
+		const SnapshotEvent* event = &content->events[i];
+		putWord(image + events, (size_t)i * EVENT_WORDS, event->id);
+		putWord(image + events, (size_t)i * EVENT_WORDS + 1, event->name);
+		putWord(image + events, (size_t)i * EVENT_WORDS + 2, event->date);
+		putWord(image + events, (size_t)i * EVENT_WORDS + 3, event->first_member);
+		putWord(image + events, (size_t)i * EVENT_WORDS + 4, event->members_count);
+	}
+	for (int i = 0; i < content->member_ids_count; i++) {
+		putWord(image + member_ids, i, content->member_ids[i]);
+	}
+
+	char* temp_path = malloc(strlen(path) + sizeof(TEMP_SUFFIX));
+	if (temp_path == NULL) {
+		free(image);
+		return SNAPSHOT_OUT_OF_MEMORY;
+	}
+	strcpy(temp_path, path);
+	strcat(temp_path, TEMP_SUFFIX);
+
+	FILE* fd = fopen(temp_path, "wb");
+	bool written = fd != NULL && fwrite(image, 1, size, fd) == size;
+	if (fd != NULL && fclose(fd) != 0) {
+		written = false;
+	}
+	free(image);
+	if (!written || rename(temp_path, path) != 0) {
+		remove(temp_path);
+		free(temp_path);
+		return SNAPSHOT_FILE_ERROR;
+	}
+	free(temp_path);
+	return SNAPSHOT_SUCCESS;
+}
+
+Snapshot snapshotOpen(const char* path, SnapshotResult* result)
+{
+	SnapshotResult ignored;
+	if (result == NULL) {
+		result = &ignored;
+	}
+	if (path == NULL) {
+		*result = SNAPSHOT_NULL_ARGUMENT;
+		return NULL;
+	}
+
+	Snapshot snapshot = malloc(sizeof(*snapshot));
+	if (snapshot == NULL) {
+		*result = SNAPSHOT_OUT_OF_MEMORY;
+		return NULL;
+	}
+	snapshot->data = readFile(path, &snapshot->size);
+	snapshot->mapped = false;
+	if (snapshot->data == NULL) {
+		free(snapshot);
+		*result = SNAPSHOT_FILE_ERROR;
+		return NULL;
+	}
+	if (!checkImage(snapshot)) {
+		snapshotClose(snapshot);
+		*result = SNAPSHOT_BAD_FORMAT;
+		return NULL;
+	}
+	*result = SNAPSHOT_SUCCESS;
+	return snapshot;
+}
+
+Snapshot snapshotMap(const char* path, SnapshotResult* result)
+{
+	SnapshotResult ignored;
+	if (result == NULL) {
+		result = &ignored;
+	}
+	if (path == NULL) {
+		*result = SNAPSHOT_NULL_ARGUMENT;
+		return NULL;
+	}
+
+	Snapshot snapshot = malloc(sizeof(*snapshot));
+	if (snapshot == NULL) {
+		*result = SNAPSHOT_OUT_OF_MEMORY;
+		return NULL;
+	}
+	snapshot->data = mapFile(path, &snapshot->size);
+	snapshot->mapped = true;
+	if (snapshot->data == NULL) {
+		free(snapshot);
+		*result = SNAPSHOT_FILE_ERROR;
+		return NULL;
+	}
+	if (!checkImage(snapshot)) {
+		snapshotClose(snapshot);
+		*result = SNAPSHOT_BAD_FORMAT;
+		return NULL;
+	}
+	*result = SNAPSHOT_SUCCESS;
+	return snapshot;
+}
+
+void snapshotClose(Snapshot snapshot)
+{
+	if (snapshot == NULL) {
+		return;
+	}
+	if (snapshot->mapped) {
+		munmap(snapshot->data, snapshot->size);
+	}
+	else {
+		free(snapshot->data);
+	}
+	free(snapshot);
+}
+
+int snapshotGetBackend(Snapshot snapshot)
+{
+	return getSignedWord(snapshot->data, HEADER_BACKEND);
+}
+
+int snapshotGetCurrentDate(Snapshot snapshot)
+{
+	return getSignedWord(snapshot->data, HEADER_CURRENT_DATE);
+}
+
+int snapshotGetMembersCount(Snapshot snapshot)
+{
+	return getSignedWord(snapshot->data, HEADER_MEMBERS_COUNT);
+}
+
+SnapshotMember snapshotGetMember(Snapshot snapshot, int index)
+{
+	size_t base = (size_t)index * MEMBER_WORDS;
+	SnapshotMember member = {
+		getSignedWord(snapshot->members, base),
+		getSignedWord(snapshot->members, base + 1),
+		getSignedWord(snapshot->members, base + 2)
+	};
+	return member;
+}
+
+int snapshotGetEventsCount(Snapshot snapshot)
+{
+	return getSignedWord(snapshot->data, HEADER_EVENTS_COUNT);
+}
+
+SnapshotEvent snapshotGetEvent(Snapshot snapshot, int index)
+{
+	size_t base = (size_t)index * EVENT_WORDS;
+	SnapshotEvent event = {
+		getSignedWord(snapshot->events, base),
+		getSignedWord(snapshot->events, base + 1),
+		getSignedWord(snapshot->events, base + 2),
+		getSignedWord(snapshot->events, base + 3),
+		getSignedWord(snapshot->events, base + 4)
+	};
+	return event;
+}
+
+int snapshotGetMemberId(Snapshot snapshot, int index)
+{
+	return getSignedWord(snapshot->member_ids, index);
+}
+
+const char* snapshotGetString(Snapshot snapshot, int index)
+{
+	return snapshot->string_data + getWord(snapshot->string_offsets, index);
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void putWord(unsigned char* buffer, size_t index, unsigned int value)
+{
+	unsigned char* word = buffer + index * WORD_SIZE;
+	word[0] = value & 0xFF;
+	word[1] = (value >> 8) & 0xFF;
+	word[2] = (value >> 16) & 0xFF;
+	word[3] = (value >> 24) & 0xFF;
+}
+
+static unsigned int getWord(const unsigned char* buffer, size_t index)
+{
+	const unsigned char* word = buffer + index * WORD_SIZE;
+	return (unsigned int)word[0] | ((unsigned int)word[1] << 8) |
+		((unsigned int)word[2] << 16) | ((unsigned int)word[3] << 24);
+}
+
+static int getSignedWord(const unsigned char* buffer, size_t index)
+{
+	unsigned int value = getWord(buffer, index);
+	int result;
+	memcpy(&result, &value, sizeof(result)); //Reinterprets the two's complement bits.
+	return result;
+}
+
+static size_t alignToWord(size_t size)
+{
+	return (size + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
+}
+
+static unsigned char* readFile(const char* path, size_t* size)
+{
+	FILE* fd = fopen(path, "rb");
+	if (fd == NULL) {
+		return NULL;
+	}
+	long length = -1;
+	if (fseek(fd, 0, SEEK_END) == 0) {
+		length = ftell(fd);
+	}
+	if (length < 0 || fseek(fd, 0, SEEK_SET) != 0) {
+		fclose(fd);
+		return NULL;
+	}
+
+	unsigned char* data = malloc(length > 0 ? length : 1);
+	if (data == NULL || fread(data, 1, length, fd) != (size_t)length) {
+		free(data);
+		fclose(fd);
+		return NULL;
+	}
+	fclose(fd);
+	*size = length;
+	return data;
+}
+
+static unsigned char* mapFile(const char* path, size_t* size)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+	struct stat info;
+	void* data = MAP_FAILED;
+	if (fstat(fd, &info) == 0 && info.st_size > 0) {
+		data = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	close(fd); //The mapping stays valid after the file is closed.
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+	*size = info.st_size;
+	return data;
+}
+
+static bool checkSection(Snapshot snapshot, unsigned int offset, unsigned int count, int words)
+{
+	return offset % WORD_SIZE == 0 && offset <= snapshot->size &&
+		count <= (snapshot->size - offset) / ((size_t)words * WORD_SIZE);
+}
+
+static bool checkImage(Snapshot snapshot)
+{
+	const unsigned char* data = snapshot->data;
+	if (snapshot->size < SNAPSHOT_HEADER_WORDS * WORD_SIZE ||
+		getWord(data, HEADER_MAGIC) != SNAPSHOT_MAGIC ||
+		getWord(data, HEADER_VERSION) != SNAPSHOT_VERSION ||
+		getWord(data, HEADER_FILE_SIZE) != snapshot->size) {
+		return false;
+	}
+
+	unsigned int strings_count = getWord(data, HEADER_STRINGS_COUNT);
+	unsigned int string_data = getWord(data, HEADER_STRING_DATA);
+	unsigned int string_data_size = getWord(data, HEADER_STRING_DATA_SIZE);
+	unsigned int members_count = getWord(data, HEADER_MEMBERS_COUNT);
+	unsigned int events_count = getWord(data, HEADER_EVENTS_COUNT);
+	unsigned int member_ids_count = getWord(data, HEADER_MEMBER_IDS_COUNT);
+	if (strings_count >= (unsigned int)-1 || members_count > (unsigned int)-1 / 2 ||
+		events_count > (unsigned int)-1 / 2 || member_ids_count > (unsigned int)-1 / 2 ||
+		!checkSection(snapshot, getWord(data, HEADER_STRING_OFFSETS), strings_count + 1, 1) ||
+		!checkSection(snapshot, getWord(data, HEADER_MEMBERS), members_count, MEMBER_WORDS) ||
+		!checkSection(snapshot, getWord(data, HEADER_EVENTS), events_count, EVENT_WORDS) ||
+		!checkSection(snapshot, getWord(data, HEADER_MEMBER_IDS), member_ids_count, 1) ||
+		string_data > snapshot->size || string_data_size > snapshot->size - string_data) {
+		return false;
+	}
+	snapshot->string_offsets = snapshot->data + getWord(data, HEADER_STRING_OFFSETS);
+	snapshot->string_data = (char*)snapshot->data + string_data;
+	snapshot->members = snapshot->data + getWord(data, HEADER_MEMBERS);
+	snapshot->events = snapshot->data + getWord(data, HEADER_EVENTS);
+	snapshot->member_ids = snapshot->data + getWord(data, HEADER_MEMBER_IDS);
+
+	unsigned int previous = 0;
+	for (unsigned int i = 0; i <= strings_count; i++) { //Every name must end with '\0' inside the string data.
+		unsigned int offset = getWord(snapshot->string_offsets, i);
+		if (offset < previous || offset > string_data_size ||
+			(i > 0 && (offset == previous || snapshot->string_data[offset - 1] != '\0'))) {
+			return false;
+		}
+		previous = offset;
+	}
+	for (unsigned int i = 0; i < members_count; i++) {
+		if (getWord(snapshot->members, (size_t)i * MEMBER_WORDS + 1) >= strings_count) {
+			return false;
+		}
+	}
+	for (unsigned int i = 0; i < events_count; i++) {
+		unsigned int name = getWord(snapshot->events, (size_t)i * EVENT_WORDS + 1);
+		unsigned int first = getWord(snapshot->events, (size_t)i * EVENT_WORDS + 3);
+		unsigned int count = getWord(snapshot->events, (size_t)i * EVENT_WORDS + 4);
+		if (name >= strings_count || first > member_ids_count || count > member_ids_count - first) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,193 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include "string_table.h"
+
+/*
+* A versioned binary image of an event manager's state.
+* The image has no pointers: a fixed header holds the offsets of its sections,
+* and records refer to names and member ids by their index in the image.
+* All of the values are stored as 32 bit little endian words.
+*
+* Sections, in file order:
+*	Header			- SNAPSHOT_HEADER_WORDS words, see snapshot.c.
+*	String offsets	- strings_count + 1 offsets into the string data.
+*	String data		- The names, each one terminated by '\0'.
+*	Members			- {id, name index, event count} in the members queue order.
+*	Events			- {id, name index, date ordinal, first member id, members count} in date order.
+*	Member ids		- The sorted member ids of every event, one event after the other.
+*/
+
+/** The version written by snapshotSave, images of other versions are rejected */
+#define SNAPSHOT_VERSION 1
+
+/** Type for defining a snapshot image that was read from a file */
+typedef struct snapshot_t* Snapshot;
+
+/** Type used for returning error codes from snapshot functions */
+typedef enum {
+	SNAPSHOT_SUCCESS,
+	SNAPSHOT_OUT_OF_MEMORY,
+	SNAPSHOT_NULL_ARGUMENT,
+	SNAPSHOT_FILE_ERROR,
+	SNAPSHOT_BAD_FORMAT
+} SnapshotResult;
+
+/** A member record of the image */
+typedef struct {
+	int id;
+	int name;
+	int event_count;
+} SnapshotMember;
+
+/** An event record of the image, its member ids are member_ids[first_member .. first_member + members_count) */
+typedef struct {
+	int id;
+	int name;
+	int date;
+	int first_member;
+	int members_count;
+} SnapshotEvent;
+
+/** The content of an image, as given to snapshotSave */
+typedef struct {
+	int backend;
+	int current_date;
+	StringTable names;
+	SnapshotMember* members;
+	int members_count;
+	SnapshotEvent* events;
+	int events_count;
+	int* member_ids;
+	int member_ids_count;
+} SnapshotContent;
+
+
+/*
+snapshotSave: Writes an image of the given content to a file.
+			  The image is written to a temporary file that replaces the file only when complete,
+			  so a failed save leaves the previous image intact.
+
+@param path - The path of the file to write.
+@param content - The content of the image. Name and member id indexes must be in range.
+
+@return SNAPSHOT_NULL_ARGUMENT if one of the arguments is NULL.
+		SNAPSHOT_OUT_OF_MEMORY if a memory allocation failed.
+		SNAPSHOT_FILE_ERROR if the file couldn't be written.
+		SNAPSHOT_SUCCESS if the image has been written.
+*/
+SnapshotResult snapshotSave(const char* path, const SnapshotContent* content);
+
+/*
+snapshotOpen: Reads an image from a file and checks that it is well formed:
+			  the version is known, the sections are inside the file, and every
+			  name and member id index is in range.
+
+@param path - The path of the file to read.
+@param result - If not NULL, set to the result of the function.
+
+@return NULL if one of the arguments is NULL, the file couldn't be read or isn't a valid image.
+		Else, returns the image, which must be closed with snapshotClose.
+*/
+Snapshot snapshotOpen(const char* path, SnapshotResult* result);
+
+/*
+snapshotMap: Maps an image file into memory for reading, instead of reading it.
+			 The image is checked like in snapshotOpen, and its pages are shared
+			 with every other process that maps the same file.
+			 snapshotSave replaces a file instead of writing over it, so saving
+			 to the same path doesn't change an image that is already mapped.
+
+@param path - The path of the file to map.
+@param result - If not NULL, set to the result of the function.
+
+@return NULL if one of the arguments is NULL, the file couldn't be mapped or isn't a valid image.
+		Else, returns the image, which must be closed with snapshotClose.
+*/
+Snapshot snapshotMap(const char* path, SnapshotResult* result);
+
+/*
+snapshotClose: Deallocates an image, or unmaps it if it was mapped.
+
+@param snapshot - The image to deallocate.
+*/
+void snapshotClose(Snapshot snapshot);
+
+/*
+snapshotGetBackend: Returns the events backend the image was saved from.
+
+@param snapshot - The image to read.
+
+@return The backend stored in the image.
+*/
+int snapshotGetBackend(Snapshot snapshot);
+
+/*
+snapshotGetCurrentDate: Returns the date ordinal of the current date stored in the image.
+
+@param snapshot - The image to read.
+
+@return The current date ordinal.
+*/
+int snapshotGetCurrentDate(Snapshot snapshot);
+
+/*
+snapshotGetMembersCount: Returns the number of member records in the image.
+
+@param snapshot - The image to read.
+
+@return The number of members.
+*/
+int snapshotGetMembersCount(Snapshot snapshot);
+
+/*
+snapshotGetMember: Reads a member record.
+
+@param snapshot - The image to read.
+@param index - The index of the member, between 0 and snapshotGetMembersCount - 1.
+
+@return The member record.
+*/
+SnapshotMember snapshotGetMember(Snapshot snapshot, int index);
+
+/*
+snapshotGetEventsCount: Returns the number of event records in the image.
+
+@param snapshot - The image to read.
+
+@return The number of events.
+*/
+int snapshotGetEventsCount(Snapshot snapshot);
+
+/*
+snapshotGetEvent: Reads an event record.
+
+@param snapshot - The image to read.
+@param index - The index of the event, between 0 and snapshotGetEventsCount - 1.
+
+@return The event record.
+*/
+SnapshotEvent snapshotGetEvent(Snapshot snapshot, int index);
+
+/*
+snapshotGetMemberId: Reads a member id of an event.
+
+@param snapshot - The image to read.
+@param index - The index of the member id, usually SnapshotEvent.first_member + i.
+
+@return The member id.
+*/
+int snapshotGetMemberId(Snapshot snapshot, int index);
+
+/*
+snapshotGetString: Returns a name stored in the image.
+				   The returned string is not copied, and stays valid until the image is closed.
+
+@param snapshot - The image to read.
+@param index - The index of the name.
+
+@return The name (Not a copy).
+*/
+const char* snapshotGetString(Snapshot snapshot, int index);
+
+#endif /* _SNAPSHOT_H */
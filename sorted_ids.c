@@ -0,0 +1,329 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "sorted_ids.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SORTED_IDS_X86
+#include <immintrin.h>
+#endif
+
+#define SCALAR_SEARCH_LENGTH 1 //The scalar kernel searches by halves to the end.
+#define VECTOR_SEARCH_LENGTH 32 //The vector kernels count the ids of the last ranges of this length.
+
+static pthread_once_t detection_once = PTHREAD_ONCE_INIT;
+static SortedIdsKernel kernel = SORTED_IDS_SCALAR; //Set once by detectKernel, or by sortedIdsSetKernel.
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+detectKernel: Selects the fastest implementation that the processor supports.
+			  Called once, through detection_once.
+*/
+static void detectKernel(void);
+
+/*
+isSupported: Returns whether the processor supports an implementation.
+
+@param selected - The implementation to check.
+
+@return True if the implementation can run.
+		Else, returns False.
+*/
+static bool isSupported(SortedIdsKernel selected);
+
+/*
+countLessScalar: Counts the ids in a short range that are smaller than an id, one id at a time.
+
+@param ids - The sorted ids of the range.
+@param count - The number of ids in the range.
+@param id - The id to compare to.
+
+@return The number of ids smaller than id.
+*/
+static int countLessScalar(const int* ids, int count, int id);
+
+/*
+intersectScalar: Writes the common ids of two arrays by merging them one id at a time.
+				 The parameters and the return value are as in sortedIdsIntersect.
+*/
+static int intersectScalar(const int* ids1, int count1, const int* ids2, int count2, int* result);
+
+#ifdef SORTED_IDS_X86
+/*
+countLessSse2: Counts the ids in a short range that are smaller than an id, 4 ids at a time.
+			   The parameters and the return value are as in countLessScalar.
+*/
+static int countLessSse2(const int* ids, int count, int id);
+
+/*
+countLessAvx2: Counts the ids in a short range that are smaller than an id, 8 ids at a time.
+			   The parameters and the return value are as in countLessScalar.
+*/
+static int countLessAvx2(const int* ids, int count, int id);
+
+/*
+intersectSse2: Writes the common ids of two arrays, comparing blocks of 4 ids of each array with each other.
+			   The parameters and the return value are as in sortedIdsIntersect.
+*/
+static int intersectSse2(const int* ids1, int count1, const int* ids2, int count2, int* result);
+
+/*
+intersectAvx2: Writes the common ids of two arrays, comparing blocks of 8 ids of each array with each other.
+			   The parameters and the return value are as in sortedIdsIntersect.
+*/
+static int intersectAvx2(const int* ids1, int count1, const int* ids2, int count2, int* result);
+
+/*
+emitMatches: Writes the ids of a block of the first array that matched ids of the second array.
+			 While result has room for the whole block, every id is written and only the matched ids
+			 are kept, so the writes don't depend on the matches.
+
+@param block - The block of the first array.
+@param width - The number of ids in the block.
+@param mask - Bit i is set if block[i] matched.
+@param result - The array to write to.
+@param found - The number of ids already in result.
+@param room - The length of result.
+
+@return The number of ids in result after the matches.
+*/
+static inline int emitMatches(const int* block, int width, int mask, int* result, int found, int room);
+#endif
+
+/* =---------------------------------------------------------------------------=
+
+								Sorted Ids Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+int sortedIdsLowerBound(const int* ids, int count, int id)
+{
+	SortedIdsKernel selected = sortedIdsGetKernel();
+	int search_length = selected == SORTED_IDS_SCALAR ? SCALAR_SEARCH_LENGTH : VECTOR_SEARCH_LENGTH;
+	int low = 0, high = count;
+	while (high - low > search_length) { //The ids smaller than id are a prefix of the range.
+		int middle = low + (high - low) / 2;
+		if (ids[middle] < id) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+#ifdef SORTED_IDS_X86
+	if (selected == SORTED_IDS_AVX2) {
+		return low + countLessAvx2(ids + low, high - low, id);
+	}
+	if (selected == SORTED_IDS_SSE2) {
+		return low + countLessSse2(ids + low, high - low, id);
+	}
+#endif
+	return low + countLessScalar(ids + low, high - low, id);
+}
+
+bool sortedIdsContains(const int* ids, int count, int id)
+{
+	int index = sortedIdsLowerBound(ids, count, id);
+	return index < count && ids[index] == id;
+}
+
+int sortedIdsIntersect(const int* ids1, int count1, const int* ids2, int count2, int* result)
+{
+#ifdef SORTED_IDS_X86
+	SortedIdsKernel selected = sortedIdsGetKernel();
+	if (selected == SORTED_IDS_AVX2) {
+		return intersectAvx2(ids1, count1, ids2, count2, result);
+	}
+	if (selected == SORTED_IDS_SSE2) {
+		return intersectSse2(ids1, count1, ids2, count2, result);
+	}
+#endif
+	return intersectScalar(ids1, count1, ids2, count2, result);
+}
+
+SortedIdsKernel sortedIdsGetKernel(void)
+{
+	pthread_once(&detection_once, detectKernel);
+	return kernel;
+}
+
+bool sortedIdsSetKernel(SortedIdsKernel selected)
+{
+	pthread_once(&detection_once, detectKernel);
+	if (!isSupported(selected)) {
+		return false;
+	}
+	kernel = selected;
+	return true;
+}
+
+const char* sortedIdsKernelName(SortedIdsKernel selected)
+{
+	const char* names[] = { "scalar", "sse2", "avx2" };
+	if (selected < SORTED_IDS_SCALAR || selected > SORTED_IDS_AVX2) {
+		return "unknown";
+	}
+	return names[selected];
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static void detectKernel(void)
+{
+	if (isSupported(SORTED_IDS_AVX2)) {
+		kernel = SORTED_IDS_AVX2;
+	}
+	else if (isSupported(SORTED_IDS_SSE2)) {
+		kernel = SORTED_IDS_SSE2;
+	}
+	else {
+		kernel = SORTED_IDS_SCALAR;
+	}
+}
+
+static bool isSupported(SortedIdsKernel selected)
+{
+	if (selected == SORTED_IDS_SCALAR) {
+		return true;
+	}
+#ifdef SORTED_IDS_X86
+	__builtin_cpu_init();
+	if (selected == SORTED_IDS_SSE2) {
+		return __builtin_cpu_supports("sse2");
+	}
+	if (selected == SORTED_IDS_AVX2) {
+		return __builtin_cpu_supports("avx2");
+	}
+#endif
+	return false;
+}
+
+static int countLessScalar(const int* ids, int count, int id)
+{
+	int less = 0;
+	for (int i = 0; i < count; i++) {
+		less += ids[i] < id;
+	}
+	return less;
+}
+
+static int intersectScalar(const int* ids1, int count1, const int* ids2, int count2, int* result)
+{
+	int i = 0, j = 0, found = 0;
+	while (i < count1 && j < count2) {
+		if (ids1[i] < ids2[j]) {
+			i++;
+		}
+		else if (ids1[i] > ids2[j]) {
+			j++;
+		}
+		else {
+			result[found++] = ids1[i];
+			i++;
+			j++;
+		}
+	}
+	return found;
+}
+
+#ifdef SORTED_IDS_X86
+__attribute__((target("sse2")))
+static int countLessSse2(const int* ids, int count, int id)
+{
+	__m128i key = _mm_set1_epi32(id), less = _mm_setzero_si128();
+	int i = 0;
+	for (; i + 4 <= count; i += 4) { //Every smaller id sets its lane of the comparison to -1.
+		__m128i block = _mm_loadu_si128((const __m128i*)(ids + i));
+		less = _mm_sub_epi32(less, _mm_cmplt_epi32(block, key));
+	}
+	less = _mm_add_epi32(less, _mm_shuffle_epi32(less, _MM_SHUFFLE(1, 0, 3, 2)));
+	less = _mm_add_epi32(less, _mm_shuffle_epi32(less, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(less) + countLessScalar(ids + i, count - i, id);
+}
+
+__attribute__((target("avx2")))
+static int countLessAvx2(const int* ids, int count, int id)
+{
+	__m256i key = _mm256_set1_epi32(id), less = _mm256_setzero_si256();
+	int i = 0;
+	for (; i + 8 <= count; i += 8) { //Every smaller id sets its lane of the comparison to -1.
+		__m256i block = _mm256_loadu_si256((const __m256i*)(ids + i));
+		less = _mm256_sub_epi32(less, _mm256_cmpgt_epi32(key, block));
+	}
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(less), _mm256_extracti128_si256(less, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(half) + countLessScalar(ids + i, count - i, id);
+}
+
+__attribute__((target("sse2")))
+static int intersectSse2(const int* ids1, int count1, const int* ids2, int count2, int* result)
+{
+	int i = 0, j = 0, found = 0, room = count1 < count2 ? count1 : count2;
+	while (i + 4 <= count1 && j + 4 <= count2) {
+		__m128i block1 = _mm_loadu_si128((const __m128i*)(ids1 + i));
+		__m128i block2 = _mm_loadu_si128((const __m128i*)(ids2 + j));
+		__m128i matches = _mm_or_si128( //Compares every id of block1 with every id of block2.
+			_mm_or_si128(_mm_cmpeq_epi32(block1, block2),
+				_mm_cmpeq_epi32(block1, _mm_shuffle_epi32(block2, _MM_SHUFFLE(0, 3, 2, 1)))),
+			_mm_or_si128(_mm_cmpeq_epi32(block1, _mm_shuffle_epi32(block2, _MM_SHUFFLE(1, 0, 3, 2))),
+				_mm_cmpeq_epi32(block1, _mm_shuffle_epi32(block2, _MM_SHUFFLE(2, 1, 0, 3)))));
+		found = emitMatches(ids1 + i, 4, _mm_movemask_ps(_mm_castsi128_ps(matches)), result, found, room);
+		int last1 = ids1[i + 3], last2 = ids2[j + 3];
+		int difference = last2 - last1; //Can't overflow, the ids are non-negative.
+		i += 4 & ~(difference >> 31); //A block whose last id is the smaller can't match later blocks.
+		j += 4 & ~(-difference >> 31); //Computed without branches, the order of the blocks is unpredictable.
+	}
+	return found + intersectScalar(ids1 + i, count1 - i, ids2 + j, count2 - j, result + found);
+}
+
+__attribute__((target("avx2")))
+static int intersectAvx2(const int* ids1, int count1, const int* ids2, int count2, int* result)
+{
+	__m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+	int i = 0, j = 0, found = 0, room = count1 < count2 ? count1 : count2;
+	while (i + 8 <= count1 && j + 8 <= count2) {
+		__m256i block1 = _mm256_loadu_si256((const __m256i*)(ids1 + i));
+		__m256i block2 = _mm256_loadu_si256((const __m256i*)(ids2 + j));
+		__m256i matches = _mm256_cmpeq_epi32(block1, block2);
+		for (int rotation = 1; rotation < 8; rotation++) { //Compares every id of block1 with every id of block2.
+			block2 = _mm256_permutevar8x32_epi32(block2, rotate);
+			matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(block1, block2));
+		}
+		found = emitMatches(ids1 + i, 8, _mm256_movemask_ps(_mm256_castsi256_ps(matches)), result, found, room);
+		int last1 = ids1[i + 7], last2 = ids2[j + 7];
+		int difference = last2 - last1; //Can't overflow, the ids are non-negative.
+		i += 8 & ~(difference >> 31); //A block whose last id is the smaller can't match later blocks.
+		j += 8 & ~(-difference >> 31); //Computed without branches, the order of the blocks is unpredictable.
+	}
+	return found + intersectScalar(ids1 + i, count1 - i, ids2 + j, count2 - j, result + found);
+}
+
+static inline int emitMatches(const int* block, int width, int mask, int* result, int found, int room)
+{
+	if (found + width <= room) {
+		for (int k = 0; k < width; k++) { //Each id is overwritten by the next one unless it matched.
+			result[found] = block[k];
+			found += (mask >> k) & 1;
+		}
+		return found;
+	}
+	while (mask != 0) { //The lowest bits first, so the ids stay in order.
+		result[found++] = block[__builtin_ctz(mask)];
+		mask &= mask - 1;
+	}
+	return found;
+}
+#endif
@@ -0,0 +1,86 @@
+#ifndef _SORTED_IDS_H
+#define _SORTED_IDS_H
+
+#include <stdbool.h>
+
+/*
+* Kernels over arrays of non-negative ids that are sorted in increasing order and without duplicates,
+* which is how the student ids of an event are stored.
+* On x86 with GCC or Clang the kernels compare 8 ids at a time with AVX2, or 4 at a time with SSE2,
+* as supported by the processor (detected on the first call). Elsewhere they use scalar loops.
+* Every kernel gives the same results, the selection only changes their speed.
+*/
+
+/** The implementations of the kernels */
+typedef enum {
+	SORTED_IDS_SCALAR,
+	SORTED_IDS_SSE2,
+	SORTED_IDS_AVX2
+} SortedIdsKernel;
+
+
+/*
+sortedIdsLowerBound: Returns the number of ids in an array that are smaller than an id,
+					 which is the index the id is found at or should be inserted at.
+
+@param ids - The sorted ids.
+@param count - The number of ids.
+@param id - The id to search for.
+
+@return The number of ids smaller than id.
+*/
+int sortedIdsLowerBound(const int* ids, int count, int id);
+
+/*
+sortedIdsContains: Returns whether an id is in an array of sorted ids.
+
+@param ids - The sorted ids.
+@param count - The number of ids.
+@param id - The id to search for.
+
+@return True if the id is in the array.
+		Else, returns False.
+*/
+bool sortedIdsContains(const int* ids, int count, int id);
+
+/*
+sortedIdsIntersect: Writes the ids that are in both of two arrays of sorted ids.
+
+@param ids1 - The first sorted ids.
+@param count1 - The number of ids in ids1.
+@param ids2 - The second sorted ids.
+@param count2 - The number of ids in ids2.
+@param result - Set to the common ids in increasing order, must have room for the smaller of the counts.
+
+@return The number of common ids.
+*/
+int sortedIdsIntersect(const int* ids1, int count1, const int* ids2, int count2, int* result);
+
+/*
+sortedIdsGetKernel: Returns the implementation that the kernels use.
+
+@return The selected SortedIdsKernel.
+*/
+SortedIdsKernel sortedIdsGetKernel(void);
+
+/*
+sortedIdsSetKernel: Selects the implementation of the kernels, for benchmarks and tests.
+					Must not be called while other threads use the kernels.
+
+@param kernel - The implementation to select.
+
+@return False if the processor (or the compiler) doesn't support the implementation, and the selection isn't changed.
+		Else, returns True.
+*/
+bool sortedIdsSetKernel(SortedIdsKernel kernel);
+
+/*
+sortedIdsKernelName: Returns the name of an implementation.
+
+@param kernel - The implementation.
+
+@return "scalar", "sse2", "avx2", or "unknown".
+*/
+const char* sortedIdsKernelName(SortedIdsKernel kernel);
+
+#endif /* _SORTED_IDS_H */
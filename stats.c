@@ -0,0 +1,41 @@
+#include "stats.h"
+
+#ifdef COLLECT_STATS
+OperationStats stats_counters = { 0, 0, 0, 0, 0 };
+#endif
+
+/* =---------------------------------------------------------------------------=
+
+								Stats Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+bool statsEnabled(void)
+{
+#ifdef COLLECT_STATS
+	return true;
+#else
+	return false;
+#endif
+}
+
+void statsReset(OperationStats* stats)
+{
+	stats->allocations = 0;
+	stats->deallocations = 0;
+	stats->comparisons = 0;
+	stats->equality_checks = 0;
+	stats->nodes_visited = 0;
+}
+
+void statsAccumulate(OperationStats* stats, const OperationStats* start)
+{
+#ifdef COLLECT_STATS
+	stats->allocations += stats_counters.allocations - start->allocations;
+	stats->deallocations += stats_counters.deallocations - start->deallocations;
+	stats->comparisons += stats_counters.comparisons - start->comparisons;
+	stats->equality_checks += stats_counters.equality_checks - start->equality_checks;
+	stats->nodes_visited += stats_counters.nodes_visited - start->nodes_visited;
+#endif
+}
@@ -0,0 +1,72 @@
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <stdbool.h>
+
+/*
+* Instrumentation counters of the work done by queue and event manager operations.
+* Counting is compiled in only when COLLECT_STATS is defined (make STATS_FLAG=-DCOLLECT_STATS),
+* otherwise the STATS_* macros expand to nothing and the get stats functions report that
+* the counters are disabled.
+* The process-wide counters are bumped where the work happens (allocatorAlloc, allocatorFree,
+* nodeGetNext and the queues' comparator calls), and every object adds the difference of the
+* counters over its own operations to its stats. The counters aren't atomic, so stats builds
+* are meant for profiling from a single thread.
+*/
+
+/** The counters of the work done by operations */
+typedef struct {
+	long allocations; //Successful allocations through an allocator.
+	long deallocations; //Deallocations through an allocator.
+	long comparisons; //Calls to priority comparison functions.
+	long equality_checks; //Calls to element equality functions.
+	long nodes_visited; //Steps from a node to the next one.
+} OperationStats;
+
+#ifdef COLLECT_STATS
+
+/** The process-wide counters, only changed through the STATS_* macros */
+extern OperationStats stats_counters;
+
+/** Counts one unit of work of the given counter */
+#define STATS_COUNT(counter) (stats_counters.counter++)
+
+/** Starts measuring an operation, declaring the variable that holds the counters at its start */
+#define STATS_BEGIN(start) OperationStats start = stats_counters
+
+/** Adds the work done since STATS_BEGIN to the stats of an object */
+#define STATS_END(stats, start) statsAccumulate(stats, &start)
+
+#else
+
+#define STATS_COUNT(counter) ((void)0)
+#define STATS_BEGIN(start) ((void)0)
+#define STATS_END(stats, start) ((void)0)
+
+#endif /* COLLECT_STATS */
+
+
+/*
+statsEnabled: Returns whether the counters were compiled in.
+
+@return True if COLLECT_STATS was defined when stats.c was compiled.
+		Else, returns False.
+*/
+bool statsEnabled(void);
+
+/*
+statsReset: Sets all of the counters of stats to 0.
+
+@param stats - The stats to reset.
+*/
+void statsReset(OperationStats* stats);
+
+/*
+statsAccumulate: Adds the work done since start was taken from the process-wide counters to stats.
+
+@param stats - The stats to add to.
+@param start - The process-wide counters at the start of the operation.
+*/
+void statsAccumulate(OperationStats* stats, const OperationStats* start);
+
+#endif /* _STATS_H */
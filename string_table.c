@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "string_table.h"
+
+#define NO_SIZE -1
+#define INITIAL_CAPACITY 16
+#define EMPTY_SLOT 0
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+struct string_table_t {
+	char** strings; //The strings by their index.
+	int size;
+	int capacity;
+	int* slots; //Open addressing hash index, each slot holds index + 1 or EMPTY_SLOT.
+	int slots_count; //Always a power of 2, at least twice the capacity.
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+hashString: Returns the FNV-1a hash of a string.
+
+@param str - The string to hash.
+
+@return The hash of the string.
+*/
+static unsigned int hashString(const char* str);
+
+/*
+findSlot: Returns the slot that holds a string, or the empty slot it should be added to.
+
+@param table - The table to search in.
+@param str - The string to search for.
+
+@return The index of the slot.
+*/
+static int findSlot(StringTable table, const char* str);
+
+/*
+grow: Doubles the capacity of the table and rebuilds its hash index.
+
+@param table - The table to grow.
+
+@return False if a memory allocation failed (The table is left unchanged).
+		Else, returns True.
+*/
+static bool grow(StringTable table);
+
+/* =---------------------------------------------------------------------------=
+
+								String Table Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+StringTable strTableCreate(void)
+{
+	StringTable table = malloc(sizeof(*table));
+	if (table == NULL) {
+		return NULL;
+	}
+	table->strings = malloc(sizeof(*table->strings) * INITIAL_CAPACITY);
+	table->slots = calloc(INITIAL_CAPACITY * 2, sizeof(*table->slots));
+	if (table->strings == NULL || table->slots == NULL) {
+		free(table->strings);
+		free(table->slots);
+		free(table);
+		return NULL;
+	}
+	table->size = 0;
+	table->capacity = INITIAL_CAPACITY;
+	table->slots_count = INITIAL_CAPACITY * 2;
+	return table;
+}
+
+void strTableDestroy(StringTable table)
+{
+	if (table == NULL) {
+		return;
+	}
+	for (int i = 0; i < table->size; i++) {
+		free(table->strings[i]);
+	}
+	free(table->strings);
+	free(table->slots);
+	free(table);
+}
+
+int strTableAdd(StringTable table, const char* str)
+{
+	if (table == NULL || str == NULL) {
+		return STRING_TABLE_NO_INDEX;
+	}
+
+	int slot = findSlot(table, str);
+	if (table->slots[slot] != EMPTY_SLOT) {
+		return table->slots[slot] - 1;
+	}
+	if (table->size == table->capacity) {
+		if (!grow(table)) {
+			return STRING_TABLE_NO_INDEX;
+		}
+		slot = findSlot(table, str);
+	}
+
+	char* copy = malloc(strlen(str) + 1);
+	if (copy == NULL) {
+		return STRING_TABLE_NO_INDEX;
+	}
+	strcpy(copy, str);
+	table->strings[table->size] = copy;
+	table->slots[slot] = table->size + 1;
+	return table->size++;
+}
+
+int strTableFind(StringTable table, const char* str)
+{
+	if (table == NULL || str == NULL) {
+		return STRING_TABLE_NO_INDEX;
+	}
+	return table->slots[findSlot(table, str)] - 1; //An empty slot gives STRING_TABLE_NO_INDEX.
+}
+
+const char* strTableGet(StringTable table, int index)
+{
+	if (table == NULL || index < 0 || index >= table->size) {
+		return NULL;
+	}
+	return table->strings[index];
+}
+
+int strTableGetSize(StringTable table)
+{
+	if (table == NULL) {
+		return NO_SIZE;
+	}
+	return table->size;
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static unsigned int hashString(const char* str)
+{
+	unsigned int hash = FNV_OFFSET_BASIS;
+	for (; *str != '\0'; str++) {
+		hash = (hash ^ (unsigned char)*str) * FNV_PRIME;
+	}
+	return hash;
+}
+
+static int findSlot(StringTable table, const char* str)
+{
+	int mask = table->slots_count - 1;
+	int slot = hashString(str) & mask;
+	while (table->slots[slot] != EMPTY_SLOT &&
+		strcmp(table->strings[table->slots[slot] - 1], str) != 0) {
+		slot = (slot + 1) & mask; //Linear probing, the index is never more than half full.
+	}
+	return slot;
+}
+
+static bool grow(StringTable table)
+{
+	int capacity = table->capacity * 2, slots_count = table->slots_count * 2;
+	char** strings = realloc(table->strings, sizeof(*strings) * capacity);
+	if (strings == NULL) {
+		return false;
+	}
+	table->strings = strings;
+	int* slots = calloc(slots_count, sizeof(*slots));
+	if (slots == NULL) {
+		return false;
+	}
+
+	free(table->slots);
+	table->slots = slots;
+	table->slots_count = slots_count;
+	table->capacity = capacity;
+	for (int i = 0; i < table->size; i++) {
+		table->slots[findSlot(table, table->strings[i])] = i + 1;
+	}
+	return true;
+}
@@ -0,0 +1,71 @@
+#ifndef _STRING_TABLE_H
+#define _STRING_TABLE_H
+
+/** Type for defining a table of unique strings, each one identified by a dense index */
+typedef struct string_table_t* StringTable;
+
+/** Returned when a string isn't stored in the table or when adding it failed */
+#define STRING_TABLE_NO_INDEX -1
+
+
+/*
+strTableCreate: Creates a new empty string table.
+
+@return NULL if a memory allocation failed.
+		Else, returns a new empty table.
+*/
+StringTable strTableCreate(void);
+
+/*
+strTableDestroy: Deallocates the table and all of its strings.
+
+@param table - The table to deallocate.
+*/
+void strTableDestroy(StringTable table);
+
+/*
+strTableAdd: Adds a copy of a string to the table, unless an equal string is already stored.
+			 Indexes are given in the order the strings were first added, starting from 0.
+
+@param table - The table to add the string to.
+@param str - The string to add.
+
+@return STRING_TABLE_NO_INDEX if one of the arguments is NULL or if a memory allocation failed.
+		Else, returns the index of the string in the table.
+*/
+int strTableAdd(StringTable table, const char* str);
+
+/*
+strTableFind: Returns the index of a string stored in the table.
+
+@param table - The table to search in.
+@param str - The string to search for.
+
+@return STRING_TABLE_NO_INDEX if one of the arguments is NULL or if the string isn't stored.
+		Else, returns the index of the string in the table.
+*/
+int strTableFind(StringTable table, const char* str);
+
+/*
+strTableGet: Returns the string stored at an index.
+			 The returned string is not copied, and stays valid until the table is destroyed.
+
+@param table - The table to read from.
+@param index - The index of the string.
+
+@return NULL if the table is NULL or if the index is out of range.
+		Else, returns the stored string (Not a copy).
+*/
+const char* strTableGet(StringTable table, int index);
+
+/*
+strTableGetSize: Returns the number of strings in the table.
+
+@param table - The table to count.
+
+@return -1 if the table is NULL.
+		Else, returns the number of strings stored in the table.
+*/
+int strTableGetSize(StringTable table);
+
+#endif /* _STRING_TABLE_H */
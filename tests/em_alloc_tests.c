@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "event_manager.h"
+#include "event_manager_ext.h"
+#include "date.h"
+#include "allocator.h"
+#include "test_checks.h"
+
+/*
+* Regression test of the allocations made by every public call of the event manager.
+* The event manager is created with a counting allocator, and every call is measured on a manager
+* of SMALL_SIZE and of LARGE_SIZE events and members: the counts must be the same for both sizes,
+* since no call may copy the names or dates of all of the stored events or members,
+* and must not exceed the counts in limits. Reads, prints and ticks must not allocate at all.
+* Temporary buffers of single calls use malloc (see createEventManagerWithAllocator),
+* so only the memory that the event manager keeps is counted.
+*/
+
+#define SMALL_SIZE 100
+#define LARGE_SIZE 1000
+#define DAYS_RANGE 300
+#define EXPIRED_EVENT_DAYS 1 //Only the first event is on this day, so a tick expires one event in both sizes.
+#define DAYS_OFFSET 3 //The other events are on the days from this one on.
+#define NAME_LENGTH 32
+#define FIRST_YEAR 2025
+#define NEW_ID_OFFSET 1 //The ids of the measured event and member are the size plus it.
+#define NEW_EVENT_DAYS 50 //A day that has events in both sizes, so the timing wheel doesn't add a bucket.
+
+typedef enum {
+	CALL_ADD_EVENT_BY_DIFF,
+	CALL_ADD_EVENT_BY_DATE,
+	CALL_CHANGE_EVENT_DATE,
+	CALL_ADD_MEMBER,
+	CALL_ADD_MEMBER_TO_EVENT,
+	CALL_REMOVE_MEMBER_FROM_EVENT,
+	CALL_REMOVE_EVENT,
+	CALL_GET_EVENTS_AMOUNT,
+	CALL_GET_NEXT_EVENT,
+	CALL_PRINT_ALL_EVENTS,
+	CALL_PRINT_ALL_RESPONSIBLE_MEMBERS,
+	CALL_TICK,
+	CALLS_COUNT
+} Call;
+
+static const char* call_names[CALLS_COUNT] = {
+	"emAddEventByDiff", "emAddEventByDate", "emChangeEventDate", "emAddMember", "emAddMemberToEvent",
+	"emRemoveMemberFromEvent", "emRemoveEvent", "emGetEventsAmount", "emGetNextEvent", "emPrintAllEvents",
+	"emPrintAllResponsibleMembers", "emTick"
+};
+
+static const EventManagerBackend backends[] = { EM_BACKEND_PRIORITY_QUEUE, EM_BACKEND_TIMING_WHEEL, EM_BACKEND_BTREE };
+#define BACKENDS_COUNT ((int)(sizeof(backends) / sizeof(backends[0])))
+
+/*
+* The most allocations of every call, by backend. Adding an event allocates the event, its name
+* and date, and the node and copies stored by the backend. Linking a member may grow the sorted ids.
+*/
+static const int limits[CALLS_COUNT][BACKENDS_COUNT] = {
+	{ 10, 7, 9 }, //CALL_ADD_EVENT_BY_DIFF
+	{ 10, 7, 9 }, //CALL_ADD_EVENT_BY_DATE
+	{ 10, 2, 9 }, //CALL_CHANGE_EVENT_DATE
+	{ 1, 1, 1 }, //CALL_ADD_MEMBER
+	{ 1, 1, 1 }, //CALL_ADD_MEMBER_TO_EVENT
+	{ 0, 0, 0 }, //CALL_REMOVE_MEMBER_FROM_EVENT
+	{ 0, 0, 0 }, //CALL_REMOVE_EVENT
+	{ 0, 0, 0 }, //CALL_GET_EVENTS_AMOUNT
+	{ 0, 0, 0 }, //CALL_GET_NEXT_EVENT
+	{ 0, 0, 0 }, //CALL_PRINT_ALL_EVENTS
+	{ 0, 0, 0 }, //CALL_PRINT_ALL_RESPONSIBLE_MEMBERS
+	{ 0, 0, 0 } //CALL_TICK
+};
+
+static long allocations = 0;
+static long live_blocks = 0;
+
+static void* countingAlloc(void* context, size_t size)
+{
+	(void)context;
+	void* ptr = malloc(size);
+	if (ptr != NULL) {
+		allocations++;
+		live_blocks++;
+	}
+	return ptr;
+}
+
+static void countingFree(void* context, void* ptr)
+{
+	(void)context;
+	if (ptr != NULL) {
+		live_blocks--;
+	}
+	free(ptr);
+}
+
+static const Allocator counting_allocator = { countingAlloc, countingFree, NULL };
+
+/* Creates an event manager with size members and size events, every event with two members. */
+static EventManager createFilled(EventManagerBackend backend, int size)
+{
+	Date date = dateCreate(1, 1, FIRST_YEAR);
+	EventManager em = createEventManagerWithAllocator(date, backend, &counting_allocator);
+	dateDestroy(date);
+	if (em == NULL) {
+		return NULL;
+	}
+	char name[NAME_LENGTH];
+	bool filled = true;
+	for (int i = 0; i < size && filled; i++) {
+		sprintf(name, "member %d", i);
+		filled = emAddMember(em, name, i) == EM_SUCCESS;
+		sprintf(name, "event %d", i);
+		int days = i == 0 ? EXPIRED_EVENT_DAYS : DAYS_OFFSET + i % DAYS_RANGE;
+		filled = filled && emAddEventByDiff(em, name, days, i) == EM_SUCCESS;
+	}
+	for (int i = 0; i < size && filled; i++) {
+		filled = emAddMemberToEvent(em, i, i) == EM_SUCCESS && emAddMemberToEvent(em, (i + 1) % size, i) == EM_SUCCESS;
+	}
+	if (!filled) {
+		destroyEventManager(em);
+		return NULL;
+	}
+	return em;
+}
+
+/* Makes a call on an event manager made by createFilled, in the order of Call. Returns false if it failed. */
+static bool makeCall(EventManager em, Call call, int size)
+{
+	int new_id = size + NEW_ID_OFFSET;
+	char event_name[] = "new event";
+	char dated_event_name[] = "new dated event";
+	char member_name[] = "new member";
+	if (call == CALL_ADD_EVENT_BY_DIFF) {
+		return emAddEventByDiff(em, event_name, NEW_EVENT_DAYS, new_id) == EM_SUCCESS;
+	}
+	if (call == CALL_ADD_EVENT_BY_DATE || call == CALL_CHANGE_EVENT_DATE) {
+		Date date = dateCreate(20, 3, FIRST_YEAR);
+		EventManagerResult res = call == CALL_ADD_EVENT_BY_DATE ? emAddEventByDate(em, dated_event_name, date, new_id + 1) :
+								 emChangeEventDate(em, new_id, date);
+		dateDestroy(date);
+		return res == EM_SUCCESS;
+	}
+	if (call == CALL_ADD_MEMBER) {
+		return emAddMember(em, member_name, new_id) == EM_SUCCESS;
+	}
+	if (call == CALL_ADD_MEMBER_TO_EVENT) {
+		return emAddMemberToEvent(em, new_id, new_id) == EM_SUCCESS;
+	}
+	if (call == CALL_REMOVE_MEMBER_FROM_EVENT) {
+		return emRemoveMemberFromEvent(em, new_id, new_id) == EM_SUCCESS;
+	}
+	if (call == CALL_REMOVE_EVENT) {
+		return emRemoveEvent(em, new_id) == EM_SUCCESS;
+	}
+	if (call == CALL_GET_EVENTS_AMOUNT) {
+		return emGetEventsAmount(em) == size + 1;
+	}
+	if (call == CALL_GET_NEXT_EVENT) {
+		return emGetNextEvent(em) != NULL;
+	}
+	if (call == CALL_PRINT_ALL_EVENTS) {
+		emPrintAllEvents(em, "/dev/null");
+		return true;
+	}
+	if (call == CALL_PRINT_ALL_RESPONSIBLE_MEMBERS) {
+		emPrintAllResponsibleMembers(em, "/dev/null");
+		return true;
+	}
+	return emTick(em, 2) == EM_SUCCESS && emGetEventsAmount(em) == size; //Expires the first event.
+}
+
+/* Sets counts to the allocations of every call on an event manager of a backend and a size. */
+static bool countCalls(EventManagerBackend backend, int size, long* counts)
+{
+	EventManager em = createFilled(backend, size);
+	CHECK(em != NULL);
+	bool success = true;
+	for (int call = 0; call < CALLS_COUNT && success; call++) {
+		long start = allocations;
+		success = makeCall(em, call, size);
+		counts[call] = allocations - start;
+		if (!success) {
+			printf("\n%s failed ", call_names[call]);
+		}
+	}
+	destroyEventManager(em);
+	CHECK(success);
+	CHECK(live_blocks == 0);
+	return true;
+}
+
+static bool testAllocationsPerCall(void)
+{
+	for (int i = 0; i < BACKENDS_COUNT; i++) {
+		long small_counts[CALLS_COUNT], large_counts[CALLS_COUNT];
+		CHECK(countCalls(backends[i], SMALL_SIZE, small_counts));
+		CHECK(countCalls(backends[i], LARGE_SIZE, large_counts));
+		for (int call = 0; call < CALLS_COUNT; call++) {
+			if (large_counts[call] != small_counts[call] || large_counts[call] > limits[call][i]) {
+				printf("\n%s on backend %d: %ld allocations with %d events, %ld with %d, at most %d ",
+					   call_names[call], i, small_counts[call], SMALL_SIZE, large_counts[call], LARGE_SIZE,
+					   limits[call][i]);
+			}
+			CHECK(large_counts[call] == small_counts[call]);
+			CHECK(large_counts[call] <= limits[call][i]);
+		}
+	}
+	return true;
+}
+
+int main(void)
+{
+	int failures = 0;
+	RUN_TEST(testAllocationsPerCall, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,509 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "event_manager.h"
+#include "event_manager_ext.h"
+#include "date.h"
+#include "test_checks.h"
+
+/*
+* Round trip tests of the persistence of the event manager.
+* An event manager is changed by a seeded sequence of random calls, persisted and restored, and
+* the restored one must print the same, and keep returning the same results for the same calls.
+*/
+
+#define EVENT_IDS 150
+#define MEMBER_IDS 80
+#define DAYS_RANGE 200
+#define NAME_LENGTH 32
+#define DAYS_IN_MONTH 30
+#define MONTHS_IN_YEAR 12
+#define FIRST_YEAR 2025
+#define OPS 3000
+#define TRUNCATE_STEP 7 //Snapshots are loaded after truncating them to every TRUNCATE_STEP-th length.
+#define BYTE_FLIPS 300
+#define SNAPSHOT_FILE "em_persist_tests.snapshot"
+#define CORRUPT_FILE "em_persist_tests_corrupt.snapshot"
+#define JOURNAL_FILE "em_persist_tests.journal"
+#define JOURNAL_GROUP_SIZE 8
+#define TORN_MEMBER_ID (MEMBER_IDS + 1) //Added by the record that is torn, no random call uses it.
+#define LONG_NAME_LENGTH 0x1000000 //Too long for a journal record, so the record of a change with it can't be appended.
+#define PRINT_FILE1 "em_persist_tests_1.txt"
+#define PRINT_FILE2 "em_persist_tests_2.txt"
+
+static const EventManagerBackend backends[] = { EM_BACKEND_PRIORITY_QUEUE, EM_BACKEND_TIMING_WHEEL, EM_BACKEND_BTREE };
+#define BACKENDS_COUNT ((int)(sizeof(backends) / sizeof(backends[0])))
+
+static int nextRandom(unsigned int* seed, int range)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (int)((*seed >> 16) % (unsigned int)range);
+}
+
+/* Returns the date that is days after 1.1.FIRST_YEAR, the first day of the event managers. */
+static Date dateAfter(int days)
+{
+	return dateCreate(1 + days % DAYS_IN_MONTH, 1 + days / DAYS_IN_MONTH % MONTHS_IN_YEAR,
+					  FIRST_YEAR + days / (DAYS_IN_MONTH * MONTHS_IN_YEAR));
+}
+
+static EventManager createTestEventManager(EventManagerBackend backend)
+{
+	Date date = dateAfter(0);
+	EventManager em = createEventManagerWithBackend(date, backend);
+	dateDestroy(date);
+	return em;
+}
+
+/* Makes a random call that changes the event manager, and returns its result. */
+static EventManagerResult applyRandomOp(EventManager em, unsigned int* seed)
+{
+	int op = nextRandom(seed, 10);
+	int event_id = nextRandom(seed, EVENT_IDS);
+	int member_id = nextRandom(seed, MEMBER_IDS);
+	int days = nextRandom(seed, DAYS_RANGE);
+	char name[NAME_LENGTH];
+	if (op == 0 || op == 1) {
+		sprintf(name, "event %d", event_id % (EVENT_IDS / 2)); //Names repeat, on other dates.
+		return emAddEventByDiff(em, name, days, event_id);
+	}
+	if (op == 2) {
+		sprintf(name, "member %d", member_id);
+		return emAddMember(em, name, member_id);
+	}
+	if (op == 3 || op == 4) {
+		return emAddMemberToEvent(em, member_id, event_id);
+	}
+	if (op == 5) {
+		return emRemoveMemberFromEvent(em, member_id, event_id);
+	}
+	if (op == 6) {
+		return emRemoveEvent(em, event_id);
+	}
+	if (op == 7) {
+		return emTick(em, 1 + days % 3);
+	}
+	Date date = dateAfter(days);
+	EventManagerResult res = emChangeEventDate(em, event_id, date);
+	dateDestroy(date);
+	return res;
+}
+
+/* Applies count random calls to the event manager. */
+static void applyRandomOps(EventManager em, unsigned int* seed, int count)
+{
+	for (int i = 0; i < count; i++) {
+		applyRandomOp(em, seed);
+	}
+}
+
+/* Checks that both event managers return the same results for the same count random calls. */
+static bool applySameOps(EventManager em1, EventManager em2, unsigned int seed, int count)
+{
+	unsigned int seed2 = seed;
+	for (int i = 0; i < count; i++) {
+		if (applyRandomOp(em1, &seed) != applyRandomOp(em2, &seed2)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Checks that both event managers have the same events, the same first event and print the same. */
+static bool sameState(EventManager em1, EventManager em2)
+{
+	if (emGetEventsAmount(em1) != emGetEventsAmount(em2)) {
+		return false;
+	}
+	char* next1 = emGetNextEvent(em1);
+	char* next2 = emGetNextEvent(em2);
+	if ((next1 == NULL) != (next2 == NULL) || (next1 != NULL && strcmp(next1, next2) != 0)) {
+		return false;
+	}
+	emPrintAllEvents(em1, PRINT_FILE1);
+	emPrintAllEvents(em2, PRINT_FILE2);
+	bool same = testFilesEqual(PRINT_FILE1, PRINT_FILE2);
+	emPrintAllResponsibleMembers(em1, PRINT_FILE1);
+	emPrintAllResponsibleMembers(em2, PRINT_FILE2);
+	same = same && testFilesEqual(PRINT_FILE1, PRINT_FILE2);
+	remove(PRINT_FILE1);
+	remove(PRINT_FILE2);
+	return same;
+}
+
+/* Reads a whole file into a new buffer, and sets size to its length. Returns NULL if it couldn't be read. */
+static unsigned char* readFile(const char* path, long* size)
+{
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return NULL;
+	}
+	fseek(file, 0, SEEK_END);
+	*size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	unsigned char* data = malloc(*size > 0 ? *size : 1);
+	if (data != NULL && fread(data, 1, *size, file) != (size_t)*size) {
+		free(data);
+		data = NULL;
+	}
+	fclose(file);
+	return data;
+}
+
+static bool writeFile(const char* path, const unsigned char* data, long size)
+{
+	FILE* file = fopen(path, "wb");
+	if (file == NULL) {
+		return false;
+	}
+	bool written = fwrite(data, 1, size, file) == (size_t)size;
+	return fclose(file) == 0 && written;
+}
+
+static bool testSnapshotRoundTrip(void)
+{
+	for (int i = 0; i < BACKENDS_COUNT; i++) {
+		EventManager em = createTestEventManager(backends[i]);
+		CHECK(em != NULL);
+		unsigned int seed = (unsigned int)i + 1;
+		applyRandomOps(em, &seed, OPS);
+		CHECK(emGetEventsAmount(em) > 0);
+		CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+		EventManager loaded = emLoadSnapshot(SNAPSHOT_FILE);
+		CHECK(loaded != NULL);
+		CHECK(sameState(em, loaded));
+		CHECK(applySameOps(em, loaded, seed, OPS));
+		CHECK(sameState(em, loaded));
+
+		CHECK(emSaveSnapshot(loaded, SNAPSHOT_FILE) == EM_SUCCESS);
+		EventManager reloaded = emLoadSnapshot(SNAPSHOT_FILE);
+		CHECK(reloaded != NULL);
+		CHECK(sameState(em, reloaded));
+		destroyEventManager(em);
+		destroyEventManager(loaded);
+		destroyEventManager(reloaded);
+	}
+	remove(SNAPSHOT_FILE);
+	return true;
+}
+
+static bool testSnapshotEmpty(void)
+{
+	EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(em != NULL);
+	CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+	EventManager loaded = emLoadSnapshot(SNAPSHOT_FILE);
+	CHECK(loaded != NULL);
+	CHECK(emGetEventsAmount(loaded) == 0 && emGetNextEvent(loaded) == NULL);
+	CHECK(sameState(em, loaded));
+	destroyEventManager(em);
+	destroyEventManager(loaded);
+	remove(SNAPSHOT_FILE);
+	CHECK(emLoadSnapshot(SNAPSHOT_FILE) == NULL);
+	CHECK(emSaveSnapshot(NULL, SNAPSHOT_FILE) == EM_NULL_ARGUMENT);
+	CHECK(emLoadSnapshot(NULL) == NULL);
+	return true;
+}
+
+static bool testOpenSnapshotRoundTrip(void)
+{
+	for (int i = 0; i < BACKENDS_COUNT; i++) {
+		EventManager em = createTestEventManager(backends[i]);
+		CHECK(em != NULL);
+		unsigned int seed = (unsigned int)i + 11;
+		applyRandomOps(em, &seed, OPS);
+		CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+		EventManager opened = emOpenSnapshot(SNAPSHOT_FILE);
+		CHECK(opened != NULL);
+		CHECK(sameState(em, opened));
+		CHECK(applySameOps(em, opened, seed, OPS));
+		CHECK(sameState(em, opened));
+
+		CHECK(emSaveSnapshot(opened, CORRUPT_FILE) == EM_SUCCESS);
+		EventManager reloaded = emLoadSnapshot(CORRUPT_FILE);
+		CHECK(reloaded != NULL);
+		CHECK(sameState(em, reloaded));
+		destroyEventManager(em);
+		destroyEventManager(opened);
+		destroyEventManager(reloaded);
+	}
+	remove(SNAPSHOT_FILE);
+	remove(CORRUPT_FILE);
+	CHECK(emOpenSnapshot(SNAPSHOT_FILE) == NULL);
+	CHECK(emOpenSnapshot(NULL) == NULL);
+	return true;
+}
+
+/*
+* Prints an opened snapshot on several report threads, so the events of the snapshot are counted from it.
+* Event managers with fewer events than report threads leave some ranges empty.
+*/
+static bool testOpenSnapshotParallelReports(void)
+{
+	int sizes[] = { 0, 2, OPS };
+	for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+		EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+		CHECK(em != NULL);
+		unsigned int seed = (unsigned int)i + 21;
+		applyRandomOps(em, &seed, sizes[i]);
+		CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+		EventManager opened = emOpenSnapshot(SNAPSHOT_FILE);
+		CHECK(opened != NULL);
+		CHECK(emSetReportThreads(opened, 4) == EM_SUCCESS);
+		CHECK(sameState(em, opened));
+		CHECK(emSetReportThreads(em, 4) == EM_SUCCESS);
+		CHECK(applySameOps(em, opened, seed, sizes[i]));
+		CHECK(sameState(em, opened));
+		destroyEventManager(em);
+		destroyEventManager(opened);
+	}
+	remove(SNAPSHOT_FILE);
+	return true;
+}
+
+/* Calls that fail on the events and members of an opened snapshot must return the same results as on the original. */
+static bool testOpenSnapshotFailedCalls(void)
+{
+	EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(em != NULL);
+	CHECK(emAddEventByDiff(em, "event", 5, 1) == EM_SUCCESS);
+	CHECK(emAddEventByDiff(em, "event", 6, 2) == EM_SUCCESS);
+	CHECK(emAddMember(em, "member 1", 1) == EM_SUCCESS);
+	CHECK(emAddMember(em, "member 2", 2) == EM_SUCCESS);
+	CHECK(emAddMemberToEvent(em, 1, 1) == EM_SUCCESS);
+	CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+	EventManager opened = emOpenSnapshot(SNAPSHOT_FILE);
+	CHECK(opened != NULL);
+
+	EventManager ems[] = { em, opened };
+	Date taken = dateAfter(5);
+	for (int i = 0; i < 2; i++) {
+		CHECK(emRemoveEvent(ems[i], EVENT_IDS) == EM_EVENT_NOT_EXISTS);
+		CHECK(emChangeEventDate(ems[i], EVENT_IDS, taken) == EM_EVENT_ID_NOT_EXISTS);
+		CHECK(emChangeEventDate(ems[i], 2, taken) == EM_EVENT_ALREADY_EXISTS);
+		CHECK(emAddMemberToEvent(ems[i], MEMBER_IDS, 1) == EM_MEMBER_ID_NOT_EXISTS);
+		CHECK(emAddMemberToEvent(ems[i], 1, EVENT_IDS) == EM_EVENT_ID_NOT_EXISTS);
+		CHECK(emAddMemberToEvent(ems[i], 1, 1) == EM_EVENT_AND_MEMBER_ALREADY_LINKED);
+		CHECK(emRemoveMemberFromEvent(ems[i], MEMBER_IDS, 1) == EM_MEMBER_ID_NOT_EXISTS);
+		CHECK(emRemoveMemberFromEvent(ems[i], 2, 1) == EM_EVENT_AND_MEMBER_NOT_LINKED);
+		CHECK(emRemoveMemberFromEvent(ems[i], 1, 2) == EM_EVENT_AND_MEMBER_NOT_LINKED);
+	}
+	dateDestroy(taken);
+	CHECK(sameState(em, opened));
+
+	for (int i = 0; i < 2; i++) {
+		CHECK(emAddMemberToEvent(ems[i], 2, 1) == EM_SUCCESS);
+		CHECK(emRemoveMemberFromEvent(ems[i], 1, 1) == EM_SUCCESS);
+		CHECK(emRemoveEvent(ems[i], 2) == EM_SUCCESS);
+	}
+	CHECK(sameState(em, opened));
+	destroyEventManager(em);
+	destroyEventManager(opened);
+	remove(SNAPSHOT_FILE);
+	return true;
+}
+
+/* Truncated snapshots must be rejected, and snapshots with a flipped byte must be rejected or load safely. */
+static bool testSnapshotCorrupt(void)
+{
+	EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(em != NULL);
+	unsigned int seed = 7;
+	applyRandomOps(em, &seed, OPS);
+	CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+	destroyEventManager(em);
+	long size = 0;
+	unsigned char* data = readFile(SNAPSHOT_FILE, &size);
+	CHECK(data != NULL && size > 0);
+
+	for (long length = 0; length < size; length += TRUNCATE_STEP) {
+		CHECK(writeFile(CORRUPT_FILE, data, length));
+		CHECK(emLoadSnapshot(CORRUPT_FILE) == NULL);
+		CHECK(emOpenSnapshot(CORRUPT_FILE) == NULL);
+	}
+	for (int i = 0; i < BYTE_FLIPS; i++) {
+		long position = nextRandom(&seed, (int)size);
+		unsigned char flip = (unsigned char)(1 + nextRandom(&seed, 255));
+		data[position] ^= flip;
+		CHECK(writeFile(CORRUPT_FILE, data, size));
+		EventManager loaded = emLoadSnapshot(CORRUPT_FILE);
+		if (loaded != NULL) {
+			emPrintAllEvents(loaded, "/dev/null");
+			emPrintAllResponsibleMembers(loaded, "/dev/null");
+			applyRandomOps(loaded, &seed, OPS / 10);
+			destroyEventManager(loaded);
+		}
+		EventManager opened = emOpenSnapshot(CORRUPT_FILE);
+		if (opened != NULL) {
+			emPrintAllEvents(opened, "/dev/null");
+			emPrintAllResponsibleMembers(opened, "/dev/null");
+			applyRandomOps(opened, &seed, OPS / 10);
+			destroyEventManager(opened);
+		}
+		data[position] ^= flip;
+	}
+	free(data);
+	remove(SNAPSHOT_FILE);
+	remove(CORRUPT_FILE);
+	return true;
+}
+
+/* Replaying the journal of an event manager over a new one must rebuild it. */
+static bool testJournalReplay(void)
+{
+	for (int i = 0; i < BACKENDS_COUNT; i++) {
+		remove(JOURNAL_FILE);
+		EventManager em = createTestEventManager(backends[i]);
+		CHECK(em != NULL);
+		CHECK(emEnableJournal(em, JOURNAL_FILE, JOURNAL_GROUP_SIZE, 0) == EM_SUCCESS);
+		unsigned int seed = (unsigned int)i + 21;
+		applyRandomOps(em, &seed, OPS);
+		CHECK(emDisableJournal(em) == EM_SUCCESS);
+		applyRandomOps(em, &seed, OPS / 10); //Not logged, so not replayed.
+
+		EventManager replayed = createTestEventManager(backends[i]);
+		EventManager expected = createTestEventManager(backends[i]);
+		CHECK(replayed != NULL && expected != NULL);
+		CHECK(emReplayJournal(replayed, JOURNAL_FILE) == EM_SUCCESS);
+		seed = (unsigned int)i + 21;
+		applyRandomOps(expected, &seed, OPS);
+		CHECK(sameState(replayed, expected));
+		CHECK(applySameOps(replayed, expected, seed, OPS));
+		CHECK(sameState(replayed, expected));
+		destroyEventManager(em);
+		destroyEventManager(replayed);
+		destroyEventManager(expected);
+	}
+	remove(JOURNAL_FILE);
+	return true;
+}
+
+/* Recovery from a checkpoint: the snapshot that a new journal was started from, then that journal. */
+static bool testJournalCheckpoint(void)
+{
+	remove(JOURNAL_FILE);
+	EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	EventManager expected = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(em != NULL && expected != NULL);
+	unsigned int seed = 31;
+	CHECK(applySameOps(em, expected, seed, OPS));
+	CHECK(emSaveSnapshot(em, SNAPSHOT_FILE) == EM_SUCCESS);
+	CHECK(emEnableJournal(em, JOURNAL_FILE, JOURNAL_GROUP_SIZE, 0) == EM_SUCCESS);
+	CHECK(applySameOps(em, expected, seed + 1, OPS));
+	destroyEventManager(em); //Syncs the journal, like the last group before a crash.
+
+	EventManager recovered = emOpenSnapshot(SNAPSHOT_FILE);
+	CHECK(recovered != NULL);
+	CHECK(emReplayJournal(recovered, JOURNAL_FILE) == EM_SUCCESS);
+	CHECK(sameState(recovered, expected));
+	CHECK(applySameOps(recovered, expected, seed + 2, OPS));
+	CHECK(sameState(recovered, expected));
+	destroyEventManager(recovered);
+	destroyEventManager(expected);
+	remove(SNAPSHOT_FILE);
+	remove(JOURNAL_FILE);
+	return true;
+}
+
+/*
+* Changes are logged before they are made: a change whose record can't be appended isn't made,
+* and the records of failed calls and batch operations are dropped, so the journal replays the same state.
+*/
+static bool testJournalWriteAhead(void)
+{
+	remove(JOURNAL_FILE);
+	EventManager em = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(em != NULL);
+	CHECK(emEnableJournal(em, JOURNAL_FILE, 1, 0) == EM_SUCCESS);
+	CHECK(emAddEventByDiff(em, "event", 1, 1) == EM_SUCCESS);
+	CHECK(emAddMember(em, "member 1", 1) == EM_SUCCESS);
+	long logged_size = 0, size = 0;
+	free(readFile(JOURNAL_FILE, &logged_size));
+
+	char* long_name = malloc(LONG_NAME_LENGTH + 1);
+	CHECK(long_name != NULL);
+	memset(long_name, 'a', LONG_NAME_LENGTH);
+	long_name[LONG_NAME_LENGTH] = '\0';
+	EventManagerResult res = emAddMember(em, long_name, 2);
+	free(long_name);
+	CHECK(res == EM_OUT_OF_MEMORY);
+	CHECK(emAddMemberToEvent(em, 2, 1) == EM_MEMBER_ID_NOT_EXISTS);
+	CHECK(emRemoveEvent(em, 2) == EM_EVENT_NOT_EXISTS);
+	CHECK(emRemoveMemberFromEvent(em, 1, 1) == EM_EVENT_AND_MEMBER_NOT_LINKED);
+	CHECK(emSyncJournal(em) == EM_SUCCESS);
+	free(readFile(JOURNAL_FILE, &size));
+	CHECK(size == logged_size);
+
+	EventManagerBatchOp ops[] = {
+		{ EM_BATCH_ADD_MEMBER_TO_EVENT, 1, 1 },
+		{ EM_BATCH_ADD_MEMBER_TO_EVENT, 1, 1 },
+		{ EM_BATCH_REMOVE_MEMBER_FROM_EVENT, 2, 1 },
+		{ EM_BATCH_ADD_MEMBER_TO_EVENT, 1, 2 }
+	};
+	EventManagerResult results[sizeof(ops) / sizeof(ops[0])];
+	CHECK(emApplyBatch(em, ops, (int)(sizeof(ops) / sizeof(ops[0])), results) == EM_SUCCESS);
+	CHECK(results[0] == EM_SUCCESS && results[1] == EM_EVENT_AND_MEMBER_ALREADY_LINKED);
+	CHECK(results[2] == EM_MEMBER_ID_NOT_EXISTS && results[3] == EM_EVENT_ID_NOT_EXISTS);
+	CHECK(emAddMember(em, "member 2", 2) == EM_SUCCESS);
+
+	EventManager replayed = createTestEventManager(EM_BACKEND_PRIORITY_QUEUE);
+	CHECK(replayed != NULL);
+	CHECK(emReplayJournal(replayed, JOURNAL_FILE) == EM_SUCCESS);
+	CHECK(sameState(em, replayed));
+	destroyEventManager(em);
+	destroyEventManager(replayed);
+	remove(JOURNAL_FILE);
+	return true;
+}
+
+/* A journal whose last record was only partly written replays the records before it. */
+static bool testJournalTornRecord(void)
+{
+	remove(JOURNAL_FILE);
+	EventManager em = createTestEventManager(EM_BACKEND_TIMING_WHEEL);
+	EventManager expected = createTestEventManager(EM_BACKEND_TIMING_WHEEL);
+	CHECK(em != NULL && expected != NULL);
+	CHECK(emEnableJournal(em, JOURNAL_FILE, 1, 0) == EM_SUCCESS);
+	unsigned int seed = 41;
+	CHECK(applySameOps(em, expected, seed, OPS));
+	long size = 0;
+	unsigned char* data = readFile(JOURNAL_FILE, &size);
+	CHECK(data != NULL);
+	free(data);
+	long last_record_start = size;
+	char name[] = "torn member";
+	CHECK(emAddMember(em, name, TORN_MEMBER_ID) == EM_SUCCESS);
+	destroyEventManager(em);
+	data = readFile(JOURNAL_FILE, &size);
+	CHECK(data != NULL && size > last_record_start + 1);
+	CHECK(writeFile(JOURNAL_FILE, data, last_record_start + (size - last_record_start) / 2));
+	free(data);
+
+	EventManager replayed = createTestEventManager(EM_BACKEND_TIMING_WHEEL);
+	CHECK(replayed != NULL);
+	CHECK(emReplayJournal(replayed, JOURNAL_FILE) == EM_SUCCESS);
+	CHECK(sameState(replayed, expected));
+	CHECK(emAddMember(replayed, name, TORN_MEMBER_ID) == EM_SUCCESS); //The torn record wasn't applied.
+	CHECK(emReplayJournal(replayed, NULL) == EM_NULL_ARGUMENT);
+	destroyEventManager(replayed);
+	destroyEventManager(expected);
+	remove(JOURNAL_FILE);
+	return true;
+}
+
+int main(void)
+{
+	int failures = 0;
+	RUN_TEST(testSnapshotRoundTrip, failures);
+	RUN_TEST(testSnapshotEmpty, failures);
+	RUN_TEST(testOpenSnapshotRoundTrip, failures);
+	RUN_TEST(testOpenSnapshotParallelReports, failures);
+	RUN_TEST(testOpenSnapshotFailedCalls, failures);
+	RUN_TEST(testSnapshotCorrupt, failures);
+	RUN_TEST(testJournalReplay, failures);
+	RUN_TEST(testJournalCheckpoint, failures);
+	RUN_TEST(testJournalWriteAhead, failures);
+	RUN_TEST(testJournalTornRecord, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "event_manager.h"
+#include "event_manager_ext.h"
+#include "date.h"
+#include "test_checks.h"
+
+/*
+* Stress test of the thread safe mode of the event manager (see emEnableThreadSafety).
+* Writer threads change the event manager while reader threads print it and read its first event.
+* Every writer uses its own event and member ids, and its own days (even days for the first writer
+* and odd days for the second), so its calls return the same results in any interleaving, and the
+* event manager ends up like one that ran the writers one after the other without threads.
+* Run it under -fsanitize=thread to check for data races as well.
+*/
+
+#define WRITERS 2
+#define READERS 2
+#define WRITER_OPS 4000
+#define READER_OPS 150
+#define WRITER_IDS 100000 //The ids of writer i start at i * WRITER_IDS.
+#define EVENTS_PER_WRITER 120
+#define MEMBERS_PER_WRITER 60
+#define DAYS_RANGE 90
+#define NAME_LENGTH 32
+#define DAYS_IN_MONTH 30
+#define MONTHS_IN_YEAR 12
+#define FIRST_YEAR 2025
+#define THREADED_FILE "em_thread_tests_threaded.txt"
+#define SERIAL_FILE "em_thread_tests_serial.txt"
+
+typedef struct {
+	EventManager em;
+	int writer;
+	EventManagerResult results[WRITER_OPS];
+} Writer;
+
+typedef struct {
+	EventManager em;
+	bool valid;
+} Reader;
+
+static int nextRandom(unsigned int* seed, int range)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (int)((*seed >> 16) % (unsigned int)range);
+}
+
+/* Returns the date that is days after 1.1.FIRST_YEAR, the first day of the event managers. */
+static Date dateAfter(int days)
+{
+	return dateCreate(1 + days % DAYS_IN_MONTH, 1 + days / DAYS_IN_MONTH % MONTHS_IN_YEAR,
+					  FIRST_YEAR + days / (DAYS_IN_MONTH * MONTHS_IN_YEAR));
+}
+
+/* Makes a random change with the ids and days of a writer, and returns its result. */
+static EventManagerResult applyWriterOp(EventManager em, int writer, unsigned int* seed)
+{
+	int op = nextRandom(seed, 7);
+	int event_id = writer * WRITER_IDS + nextRandom(seed, EVENTS_PER_WRITER);
+	int member_id = writer * WRITER_IDS + nextRandom(seed, MEMBERS_PER_WRITER);
+	int days = 2 * nextRandom(seed, DAYS_RANGE) + writer;
+	char name[NAME_LENGTH];
+	if (op == 0) {
+		sprintf(name, "w%d-e%d", writer, event_id);
+		return emAddEventByDiff(em, name, days, event_id);
+	}
+	if (op == 1) {
+		sprintf(name, "w%d-m%d", writer, member_id);
+		return emAddMember(em, name, member_id);
+	}
+	if (op == 2 || op == 3) {
+		return emAddMemberToEvent(em, member_id, event_id);
+	}
+	if (op == 4) {
+		return emRemoveMemberFromEvent(em, member_id, event_id);
+	}
+	if (op == 5) {
+		return emRemoveEvent(em, event_id);
+	}
+	Date date = dateAfter(days);
+	EventManagerResult res = emChangeEventDate(em, event_id, date);
+	dateDestroy(date);
+	return res;
+}
+
+static void* runWriter(void* context)
+{
+	Writer* writer = context;
+	unsigned int seed = (unsigned int)writer->writer + 1;
+	for (int i = 0; i < WRITER_OPS; i++) {
+		writer->results[i] = applyWriterOp(writer->em, writer->writer, &seed);
+	}
+	return NULL;
+}
+
+static void* runReader(void* context)
+{
+	Reader* reader = context;
+	reader->valid = true;
+	for (int i = 0; i < READER_OPS; i++) {
+		int amount = emGetEventsAmount(reader->em);
+		reader->valid = reader->valid && amount >= 0 && amount <= WRITERS * EVENTS_PER_WRITER;
+		emGetNextEvent(reader->em); //The name may change once the lock is released, so it isn't read.
+		if (i % 2 == 0) {
+			emPrintAllEvents(reader->em, "/dev/null");
+		}
+		else {
+			emPrintAllResponsibleMembers(reader->em, "/dev/null");
+		}
+	}
+	return NULL;
+}
+
+/* Checks that both event managers print the same events and the same responsible members. */
+static bool printSame(EventManager em1, EventManager em2)
+{
+	emPrintAllEvents(em1, THREADED_FILE);
+	emPrintAllEvents(em2, SERIAL_FILE);
+	bool same = testFilesEqual(THREADED_FILE, SERIAL_FILE);
+	emPrintAllResponsibleMembers(em1, THREADED_FILE);
+	emPrintAllResponsibleMembers(em2, SERIAL_FILE);
+	same = same && testFilesEqual(THREADED_FILE, SERIAL_FILE);
+	remove(THREADED_FILE);
+	remove(SERIAL_FILE);
+	return same;
+}
+
+/*
+* Runs the writers and the readers on a thread safe event manager, then checks it against an event manager
+* that ran the same writers one after the other.
+*/
+static bool runStress(EventManagerBackend backend, bool arena, int report_threads)
+{
+	Date date = dateAfter(0);
+	EventManager em = arena ? createEventManagerWithArena(date, backend) : createEventManagerWithBackend(date, backend);
+	EventManager serial = createEventManagerWithBackend(date, backend);
+	dateDestroy(date);
+	CHECK(em != NULL && serial != NULL);
+	CHECK(emEnableThreadSafety(em) == EM_SUCCESS);
+	CHECK(emEnableThreadSafety(em) == EM_SUCCESS);
+	CHECK(emSetReportThreads(em, report_threads) == EM_SUCCESS);
+
+	static Writer writers[WRITERS];
+	Reader readers[READERS];
+	pthread_t threads[WRITERS + READERS];
+	for (int i = 0; i < WRITERS; i++) {
+		writers[i].em = em;
+		writers[i].writer = i;
+		CHECK(pthread_create(&threads[i], NULL, runWriter, &writers[i]) == 0);
+	}
+	for (int i = 0; i < READERS; i++) {
+		readers[i].em = em;
+		CHECK(pthread_create(&threads[WRITERS + i], NULL, runReader, &readers[i]) == 0);
+	}
+	for (int i = 0; i < WRITERS + READERS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	for (int i = 0; i < READERS; i++) {
+		CHECK(readers[i].valid);
+	}
+
+	for (int i = 0; i < WRITERS; i++) {
+		unsigned int seed = (unsigned int)i + 1;
+		for (int j = 0; j < WRITER_OPS; j++) {
+			CHECK(applyWriterOp(serial, i, &seed) == writers[i].results[j]);
+		}
+	}
+	CHECK(emGetEventsAmount(em) == emGetEventsAmount(serial));
+	CHECK(emGetEventsAmount(em) > 0);
+	CHECK(printSame(em, serial));
+	destroyEventManager(em);
+	destroyEventManager(serial);
+	return true;
+}
+
+static bool testStressPriorityQueue(void)
+{
+	return runStress(EM_BACKEND_PRIORITY_QUEUE, false, 1);
+}
+
+static bool testStressTimingWheel(void)
+{
+	return runStress(EM_BACKEND_TIMING_WHEEL, false, 1);
+}
+
+static bool testStressBTree(void)
+{
+	return runStress(EM_BACKEND_BTREE, false, 1);
+}
+
+static bool testStressArenaParallelReports(void)
+{
+	return runStress(EM_BACKEND_PRIORITY_QUEUE, true, 4);
+}
+
+int main(void)
+{
+	int failures = 0;
+	RUN_TEST(testStressPriorityQueue, failures);
+	RUN_TEST(testStressTimingWheel, failures);
+	RUN_TEST(testStressBTree, failures);
+	RUN_TEST(testStressArenaParallelReports, failures);
+	return failures == 0 ? 0 : 1;
+}
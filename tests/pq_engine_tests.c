@@ -0,0 +1,499 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "priority_queue.h"
+#include "priority_queue_ext.h"
+#include "test_checks.h"
+
+/*
+* Differential test of the priority queue engines.
+* The same seeded sequence of random calls is made on a queue of every engine: the B+-tree and the pairing
+* heap must return the same results and keep the same order as the list, also after merges.
+*/
+
+#define MAX_SIZE 3000
+#define MAX_ENTRIES 200000 //The most elements that a queue can hold after the merges of a test.
+#define OPS 20000
+#define SEEDS 2
+#define PHASE_OPS 5000 //The range of the priorities is chosen again every PHASE_OPS calls.
+#define GROW_OPS 10000 //The calls alternate between growing the queues and not every GROW_OPS calls.
+#define CHECK_STEP 211 //The queues are compared after every CHECK_STEP-th call.
+#define ELEMENTS_RANGE (2 * MAX_SIZE)
+#define FEW_PRIORITIES 3
+#define SOME_PRIORITIES 100
+#define MANY_PRIORITIES 30000
+#define MERGE_SIZE 100
+#define LARGE_MERGE_SIZE 2000
+#define RANGE_VISIT_STOP 50 //Some visits stop after a random number of elements up to it.
+#define CALL_WEIGHTS_SUM 1000
+
+typedef enum {
+	LANE_LIST,
+	LANE_BTREE,
+	LANE_HEAP,
+	LANES_COUNT
+} Lane;
+
+static const PQEngine lane_engines[LANES_COUNT] = {
+	PQ_ENGINE_LIST, PQ_ENGINE_BTREE, PQ_ENGINE_PAIRING_HEAP
+};
+
+typedef enum {
+	CALL_INSERT,
+	CALL_APPEND,
+	CALL_REMOVE,
+	CALL_REMOVE_ELEMENT,
+	CALL_CHANGE_PRIORITY,
+	CALL_REMOVE_ELEMENT_WITH_PRIORITY,
+	CALL_CONTAINS,
+	CALL_FOR_EACH_IN_PRIORITY_RANGE,
+	CALL_REMOVE_RANGE,
+	CALL_GET_FIRST_PRIORITY,
+	CALL_COPY,
+	CALL_CLEAR,
+	CALL_MERGE,
+	CALL_GET_FIRST,
+	CALLS_COUNT
+} Call;
+
+/* Out of CALL_WEIGHTS_SUM random calls, in the order of Call. */
+static const int call_weights[CALLS_COUNT] = { 300, 100, 150, 70, 100, 40, 60, 40, 30, 20, 10, 1, 40, 39 };
+
+typedef struct {
+	int element;
+	int priority;
+} Entry;
+
+/** The elements of a queue in queue order, as visited by pqForEachInPriorityRange */
+typedef struct {
+	Entry entries[MAX_ENTRIES];
+	int count;
+	int stop; //The visit stops after stop entries, or at the end if it's negative.
+} Dump;
+
+typedef struct {
+	PriorityQueue queues[LANES_COUNT];
+	bool merges; //Whether pqMerge is called.
+	unsigned int seed;
+	int priorities_range;
+} Lanes;
+
+static Dump dump1, dump2, merged;
+
+static int nextRandom(unsigned int* seed, int range)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (int)((*seed >> 16) % (unsigned int)range);
+}
+
+static PQElement copyInt(PQElement element)
+{
+	int* copy = malloc(sizeof(*copy));
+	if (copy != NULL) {
+		*copy = *(int*)element;
+	}
+	return copy;
+}
+
+static void freeInt(PQElement element)
+{
+	free(element);
+}
+
+static bool equalInts(PQElement element1, PQElement element2)
+{
+	return *(int*)element1 == *(int*)element2;
+}
+
+/* A higher int is a higher priority. */
+static int compareInts(PQElementPriority priority1, PQElementPriority priority2)
+{
+	return *(int*)priority1 - *(int*)priority2;
+}
+
+/* Copies like copyInt, as a function of its own. */
+static PQElementPriority copyPriority(PQElementPriority priority)
+{
+	return copyInt(priority);
+}
+
+/* A lower int is a higher priority. */
+static int compareIntsReversed(PQElementPriority priority1, PQElementPriority priority2)
+{
+	return compareInts(priority2, priority1);
+}
+
+static PriorityQueue createQueue(PQEngine engine)
+{
+	return pqCreateWithEngine(copyInt, freeInt, equalInts, copyInt, freeInt, compareInts, engine, NULL);
+}
+
+static bool visitEntry(void* context, PQElement element, PQElementPriority priority)
+{
+	Dump* dump = context;
+	if (dump->count == MAX_ENTRIES) {
+		return false;
+	}
+	dump->entries[dump->count].element = *(int*)element;
+	dump->entries[dump->count].priority = *(int*)priority;
+	dump->count++;
+	return dump->count != dump->stop;
+}
+
+/* Sets dump to all of the elements of a queue. */
+static bool dumpQueue(PriorityQueue queue, Dump* dump)
+{
+	dump->count = 0;
+	dump->stop = -1;
+	CHECK(pqForEachInPriorityRange(queue, NULL, NULL, visitEntry, dump) == PQ_SUCCESS);
+	CHECK(dump->count == pqGetSize(queue));
+	return true;
+}
+
+static bool sameEntries(const Entry* entries1, const Entry* entries2, int count)
+{
+	for (int i = 0; i < count; i++) {
+		if (entries1[i].element != entries2[i].element || entries1[i].priority != entries2[i].priority) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Checks that the cursors of a queue pass over its elements in the order of its dump. */
+static bool cursorFollowsDump(PriorityQueue queue, const Dump* dump)
+{
+	PQCursor cursor;
+	int count = 0;
+	PQ_CURSOR_FOREACH(int*, element, cursor, queue) {
+		CHECK(count < dump->count && *element == dump->entries[count].element);
+		count++;
+	}
+	CHECK(count == dump->count);
+	return true;
+}
+
+/* Checks that two queues hold the same elements with the same priorities in the same order. */
+static bool sameQueues(PriorityQueue queue1, PriorityQueue queue2)
+{
+	CHECK(pqGetSize(queue1) == pqGetSize(queue2));
+	CHECK(dumpQueue(queue1, &dump1) && dumpQueue(queue2, &dump2));
+	CHECK(cursorFollowsDump(queue1, &dump1) && cursorFollowsDump(queue2, &dump2));
+	CHECK(sameEntries(dump1.entries, dump2.entries, dump1.count));
+	return true;
+}
+
+/* Checks every queue against the list. */
+static bool checkLanes(Lanes* lanes)
+{
+	for (int i = LANE_LIST + 1; i < LANES_COUNT; i++) {
+		CHECK(sameQueues(lanes->queues[LANE_LIST], lanes->queues[i]));
+	}
+	return true;
+}
+
+/* Picks the next call, growing the queues in every other GROW_OPS calls and keeping them under MAX_SIZE. */
+static Call pickCall(Lanes* lanes, int op)
+{
+	int weight = nextRandom(&lanes->seed, CALL_WEIGHTS_SUM);
+	Call call = CALL_INSERT;
+	while (weight >= call_weights[call]) {
+		weight -= call_weights[call];
+		call++;
+	}
+	bool removes = call == CALL_REMOVE || call == CALL_REMOVE_ELEMENT || call == CALL_REMOVE_ELEMENT_WITH_PRIORITY ||
+				   call == CALL_REMOVE_RANGE || call == CALL_MERGE;
+	bool grows = pqGetSize(lanes->queues[LANE_LIST]) < MAX_SIZE;
+	if ((op / GROW_OPS) % 2 == 0 && grows && removes && nextRandom(&lanes->seed, 10) != 0) {
+		return nextRandom(&lanes->seed, 4) == 0 ? CALL_APPEND : CALL_INSERT;
+	}
+	if (call == CALL_MERGE && !lanes->merges) {
+		return CALL_GET_FIRST;
+	}
+	if ((call == CALL_INSERT || call == CALL_APPEND) && !grows) {
+		return CALL_REMOVE;
+	}
+	return call;
+}
+
+/* Changes the priority of a random element of the queues, or of a random element that may not be in them. */
+static void changePriority(Lanes* lanes, int element, int priority, int new_priority, int* results)
+{
+	int size = pqGetSize(lanes->queues[LANE_LIST]);
+	if (size > 0 && dumpQueue(lanes->queues[LANE_LIST], &dump1)) {
+		Entry entry = dump1.entries[nextRandom(&lanes->seed, size)];
+		element = entry.element;
+		priority = entry.priority;
+	}
+	for (int i = 0; i < LANES_COUNT; i++) {
+		results[i] = pqChangePriority(lanes->queues[i], &element, &priority, &new_priority);
+	}
+}
+
+/*
+* Visits a priority range of every queue, checks that they visit the elements of the list in its order, and
+* sets results to the number of elements visited.
+*/
+static bool visitRange(Lanes* lanes, int priority1, int priority2, int* results)
+{
+	int high = priority1 > priority2 ? priority1 : priority2, low = priority1 > priority2 ? priority2 : priority1;
+	int* from = nextRandom(&lanes->seed, 5) != 0 ? &high : NULL;
+	int* to = nextRandom(&lanes->seed, 5) != 0 ? &low : NULL;
+	int stop = nextRandom(&lanes->seed, 3) != 0 ? -1 : 1 + nextRandom(&lanes->seed, RANGE_VISIT_STOP);
+	for (int i = 0; i < LANES_COUNT; i++) {
+		Dump* dump = i == LANE_LIST ? &dump1 : &dump2;
+		dump->count = 0;
+		dump->stop = stop;
+		CHECK(pqForEachInPriorityRange(lanes->queues[i], from, to, visitEntry, dump) == PQ_SUCCESS);
+		results[i] = dump->count;
+		CHECK(sameEntries(dump1.entries, dump->entries, dump1.count < dump->count ? dump1.count : dump->count));
+	}
+	return true;
+}
+
+/* Removes a small priority range of every queue. */
+static void removeRange(Lanes* lanes, int priority, int* results)
+{
+	int low = priority, high = low + nextRandom(&lanes->seed, lanes->priorities_range / 20 + 1);
+	int* from = &high;
+	int* to = &low;
+	if (nextRandom(&lanes->seed, 4) == 0) {
+		from = nextRandom(&lanes->seed, 5) != 0 ? &high : NULL;
+		to = nextRandom(&lanes->seed, 5) != 0 ? &low : NULL;
+	}
+	for (int i = 0; i < LANES_COUNT; i++) {
+		results[i] = pqRemoveRange(lanes->queues[i], from, to);
+	}
+}
+
+/* Replaces every queue by a copy of it. The list engine can't copy an empty queue, so it's kept. */
+static bool copyQueues(Lanes* lanes)
+{
+	for (int i = 0; i < LANES_COUNT; i++) {
+		PriorityQueue copy = pqCopy(lanes->queues[i]);
+		CHECK(copy != NULL || (lane_engines[i] == PQ_ENGINE_LIST && pqGetSize(lanes->queues[i]) == 0));
+		if (copy != NULL) {
+			pqDestroy(lanes->queues[i]);
+			lanes->queues[i] = copy;
+		}
+	}
+	return true;
+}
+
+/* Sets merged to the stable merge of the dumps of two lists, the elements of the first before equal ones. */
+static void mergeDumps(const Dump* queue, const Dump* source)
+{
+	int i = 0, j = 0;
+	merged.count = 0;
+	while (i < queue->count || j < source->count) {
+		bool from_queue = j == source->count ||
+						  (i < queue->count && queue->entries[i].priority >= source->entries[j].priority);
+		merged.entries[merged.count++] = from_queue ? queue->entries[i++] : source->entries[j++];
+	}
+}
+
+/*
+* Merges a random queue of the same engine into every queue, and checks that the list keeps the order of
+* a stable merge, that the sources are empty and still usable, and that queues of other engines are rejected.
+*/
+static bool mergeQueues(Lanes* lanes, int* results)
+{
+	PriorityQueue sources[LANES_COUNT];
+	for (int i = 0; i < LANES_COUNT; i++) {
+		sources[i] = createQueue(lane_engines[i]);
+		CHECK(sources[i] != NULL);
+	}
+	int size = nextRandom(&lanes->seed, 4) == 0 ? 0 :
+			   nextRandom(&lanes->seed, nextRandom(&lanes->seed, 5) == 0 ? LARGE_MERGE_SIZE : MERGE_SIZE);
+	for (int j = 0; j < size; j++) {
+		int element = nextRandom(&lanes->seed, ELEMENTS_RANGE), priority = nextRandom(&lanes->seed,
+																					 lanes->priorities_range);
+		bool remove = nextRandom(&lanes->seed, 8) == 0;
+		for (int i = 0; i < LANES_COUNT; i++) {
+			CHECK(pqInsert(sources[i], &element, &priority) == PQ_SUCCESS);
+			CHECK(!remove || pqRemove(sources[i]) == PQ_SUCCESS);
+		}
+	}
+
+	int size_before = pqGetSize(lanes->queues[LANE_LIST]);
+	CHECK(pqMerge(lanes->queues[LANE_LIST], sources[LANE_BTREE]) == PQ_ERROR);
+	CHECK(pqMerge(lanes->queues[LANE_HEAP], sources[LANE_LIST]) == PQ_ERROR);
+	CHECK(pqMerge(lanes->queues[LANE_LIST], lanes->queues[LANE_LIST]) == PQ_SUCCESS);
+	CHECK(pqGetSize(lanes->queues[LANE_LIST]) == size_before);
+
+	CHECK(dumpQueue(lanes->queues[LANE_LIST], &dump1) && dumpQueue(sources[LANE_LIST], &dump2));
+	mergeDumps(&dump1, &dump2);
+	for (int i = 0; i < LANES_COUNT; i++) {
+		results[i] = pqMerge(lanes->queues[i], sources[i]);
+	}
+	CHECK(dumpQueue(lanes->queues[LANE_LIST], &dump1));
+	CHECK(dump1.count == merged.count && sameEntries(dump1.entries, merged.entries, merged.count));
+
+	int element = 5;
+	for (int i = 0; i < LANES_COUNT; i++) {
+		CHECK(pqGetSize(sources[i]) == 0 && pqGetFirst(sources[i]) == NULL);
+		CHECK(pqInsert(sources[i], &element, &element) == PQ_SUCCESS && pqGetSize(sources[i]) == 1);
+		pqDestroy(sources[i]);
+	}
+	return true;
+}
+
+/* Reads the first element or the first priority of every queue. */
+static void getFirst(Lanes* lanes, bool priority, int* results)
+{
+	for (int i = 0; i < LANES_COUNT; i++) {
+		int* first = priority ? pqGetFirstPriority(lanes->queues[i]) : pqGetFirst(lanes->queues[i]);
+		results[i] = first == NULL ? -1 : *first;
+	}
+}
+
+/* Makes a random call on every queue, and checks that every queue returned the same result as the list. */
+static bool applyRandomCall(Lanes* lanes, int op)
+{
+	int results[LANES_COUNT] = { 0 };
+	int element = nextRandom(&lanes->seed, ELEMENTS_RANGE);
+	int priority = nextRandom(&lanes->seed, lanes->priorities_range);
+	int other_priority = nextRandom(&lanes->seed, lanes->priorities_range);
+	Call call = pickCall(lanes, op);
+	for (int i = 0; i < LANES_COUNT; i++) {
+		if (call == CALL_INSERT) {
+			results[i] = pqInsert(lanes->queues[i], &element, &priority);
+		}
+		else if (call == CALL_APPEND) {
+			results[i] = pqAppend(lanes->queues[i], &element, &priority);
+		}
+		else if (call == CALL_REMOVE) {
+			results[i] = pqRemove(lanes->queues[i]);
+		}
+		else if (call == CALL_REMOVE_ELEMENT) {
+			results[i] = pqRemoveElement(lanes->queues[i], &element);
+		}
+		else if (call == CALL_REMOVE_ELEMENT_WITH_PRIORITY) {
+			results[i] = pqRemoveElementWithPriority(lanes->queues[i], &element, &priority);
+		}
+		else if (call == CALL_CONTAINS) {
+			results[i] = pqContains(lanes->queues[i], &element);
+		}
+		else if (call == CALL_CLEAR) {
+			results[i] = pqClear(lanes->queues[i]);
+		}
+	}
+	if (call == CALL_CHANGE_PRIORITY) {
+		changePriority(lanes, element, priority, other_priority, results);
+	}
+	else if (call == CALL_FOR_EACH_IN_PRIORITY_RANGE) {
+		CHECK(visitRange(lanes, priority, other_priority, results));
+	}
+	else if (call == CALL_REMOVE_RANGE) {
+		removeRange(lanes, priority, results);
+	}
+	else if (call == CALL_COPY) {
+		CHECK(copyQueues(lanes));
+	}
+	else if (call == CALL_MERGE) {
+		CHECK(mergeQueues(lanes, results));
+	}
+	else if (call == CALL_GET_FIRST || call == CALL_GET_FIRST_PRIORITY) {
+		getFirst(lanes, call == CALL_GET_FIRST_PRIORITY, results);
+	}
+	for (int i = LANE_LIST + 1; i < LANES_COUNT; i++) {
+		CHECK(results[i] == results[LANE_LIST]);
+	}
+	return true;
+}
+
+/* Empties the queues from their first elements, checking that they come out in the same order. */
+static bool drainLanes(Lanes* lanes)
+{
+	while (pqGetSize(lanes->queues[LANE_LIST]) > 0) {
+		for (int i = LANE_LIST + 1; i < LANES_COUNT; i++) {
+			CHECK(equalInts(pqGetFirst(lanes->queues[LANE_LIST]), pqGetFirst(lanes->queues[i])));
+		}
+		for (int i = 0; i < LANES_COUNT; i++) {
+			CHECK(pqRemove(lanes->queues[i]) == PQ_SUCCESS);
+		}
+	}
+	for (int i = 0; i < LANES_COUNT; i++) {
+		CHECK(pqGetSize(lanes->queues[i]) == 0);
+	}
+	return true;
+}
+
+static bool runEngines(unsigned int seed, bool merges)
+{
+	static const int priorities_ranges[] = { FEW_PRIORITIES, SOME_PRIORITIES, SOME_PRIORITIES, MANY_PRIORITIES };
+	Lanes lanes = { .merges = merges, .seed = seed };
+	for (int i = 0; i < LANES_COUNT; i++) {
+		lanes.queues[i] = createQueue(lane_engines[i]);
+		CHECK(lanes.queues[i] != NULL);
+	}
+	bool passed = true;
+	for (int op = 0; op < OPS && passed; op++) {
+		if (op % PHASE_OPS == 0) {
+			lanes.priorities_range = priorities_ranges[nextRandom(&lanes.seed, 4)];
+		}
+		passed = applyRandomCall(&lanes, op) && (op % CHECK_STEP != 0 || checkLanes(&lanes));
+	}
+	passed = passed && checkLanes(&lanes) && drainLanes(&lanes);
+	for (int i = 0; i < LANES_COUNT; i++) {
+		pqDestroy(lanes.queues[i]);
+	}
+	return passed;
+}
+
+static bool testEnginesWithoutMerge(void)
+{
+	for (unsigned int seed = 1; seed <= SEEDS; seed++) {
+		CHECK(runEngines(seed, false));
+	}
+	return true;
+}
+
+static bool testEnginesWithMerge(void)
+{
+	for (unsigned int seed = 1; seed <= SEEDS; seed++) {
+		CHECK(runEngines(seed, true));
+	}
+	return true;
+}
+
+/* Queues whose elements are copied, freed or compared by other functions can't be merged. */
+static bool testMergeArguments(void)
+{
+	for (int i = 0; i < LANES_COUNT; i++) {
+		PriorityQueue queue = createQueue(lane_engines[i]);
+		PriorityQueue reversed = pqCreateWithEngine(copyInt, freeInt, equalInts, copyInt, freeInt,
+													compareIntsReversed, lane_engines[i], NULL);
+		PriorityQueue other_copy = pqCreateWithEngine(copyInt, freeInt, equalInts, copyPriority, freeInt, compareInts,
+													  lane_engines[i], NULL);
+		CHECK(queue != NULL && reversed != NULL && other_copy != NULL);
+		CHECK(pqMerge(queue, NULL) == PQ_NULL_ARGUMENT);
+		CHECK(pqMerge(NULL, queue) == PQ_NULL_ARGUMENT);
+		CHECK(pqMerge(queue, queue) == PQ_SUCCESS);
+
+		for (int element = 0; element < 3; element++) {
+			CHECK(pqInsert(queue, &element, &element) == PQ_SUCCESS);
+			CHECK(pqInsert(reversed, &element, &element) == PQ_SUCCESS);
+		}
+		CHECK(pqMerge(queue, reversed) == PQ_ERROR);
+		CHECK(pqMerge(reversed, queue) == PQ_ERROR);
+		CHECK(pqGetSize(queue) == 3 && pqGetSize(reversed) == 3);
+		CHECK(*(int*)pqGetFirst(queue) == 2 && *(int*)pqGetFirst(reversed) == 0);
+		CHECK(pqMerge(other_copy, queue) == PQ_ERROR && pqGetSize(queue) == 3);
+		CHECK(pqMerge(queue, other_copy) == PQ_ERROR);
+		pqDestroy(queue);
+		pqDestroy(reversed);
+		pqDestroy(other_copy);
+	}
+	return true;
+}
+
+int main(void)
+{
+	int failures = 0;
+	RUN_TEST(testEnginesWithoutMerge, failures);
+	RUN_TEST(testEnginesWithMerge, failures);
+	RUN_TEST(testMergeArguments, failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "test_checks.h"
+
+bool testFilesEqual(const char* path1, const char* path2)
+{
+	FILE* file1 = fopen(path1, "r");
+	FILE* file2 = fopen(path2, "r");
+	bool equal = file1 != NULL && file2 != NULL;
+	while (equal) {
+		int c1 = fgetc(file1), c2 = fgetc(file2);
+		equal = c1 == c2;
+		if (c1 == EOF) {
+			break;
+		}
+	}
+	if (file1 != NULL) {
+		fclose(file1);
+	}
+	if (file2 != NULL) {
+		fclose(file2);
+	}
+	return equal;
+}
+
+int testCountLines(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return -1;
+	}
+	int lines = 0;
+	for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+		lines += c == '\n';
+	}
+	fclose(file);
+	return lines;
+}
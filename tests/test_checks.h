@@ -0,0 +1,53 @@
+#ifndef _TEST_CHECKS_H
+#define _TEST_CHECKS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/*
+* Helpers for the test programs of the check target.
+* A test is a function that takes no arguments and returns true if it passed.
+* CHECK returns false from the test when a condition doesn't hold, after printing it.
+*/
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("\n%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			return false; \
+		} \
+	} while (0)
+
+/** Runs a test, prints its result and counts it in failures if it failed */
+#define RUN_TEST(test, failures) \
+	do { \
+		printf("%s: ", #test); \
+		fflush(stdout); \
+		bool passed = test(); \
+		printf("%s\n", passed ? "OK" : "FAILED"); \
+		(failures) += passed ? 0 : 1; \
+	} while (0)
+
+
+/*
+testFilesEqual: Checks whether two files have the same contents.
+
+@param path1 - The first file.
+@param path2 - The second file.
+
+@return False if a file couldn't be read or if their contents differ.
+		Else, returns True.
+*/
+bool testFilesEqual(const char* path1, const char* path2);
+
+/*
+testCountLines: Counts the lines of a file.
+
+@param path - The file to count.
+
+@return -1 if the file couldn't be read.
+		Else, returns the number of newlines in it.
+*/
+int testCountLines(const char* path);
+
+#endif /* _TEST_CHECKS_H */
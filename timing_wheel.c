@@ -0,0 +1,505 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "timing_wheel.h"
+#include "node.h"
+#include "stats.h"
+
+#define DAYS_IN_MONTH 30
+#define MONTHS_IN_YEAR 12
+#define INITIAL_YEARS_CAPACITY 4
+#define NO_SIZE -1
+#define NOT_FOUND -1
+
+/** A single day slot, elements are appended at the tail to keep insertion order */
+typedef struct {
+	Node head;
+	Node tail;
+} DayBucket;
+
+/** 30 day slots of a single month, allocated only while the month has elements */
+typedef struct month_wheel_t {
+	DayBucket days[DAYS_IN_MONTH];
+	int size;
+}*MonthWheel;
+
+/** 12 month slots of a single year, allocated only while the year has elements */
+typedef struct year_wheel_t {
+	int year;
+	MonthWheel months[MONTHS_IN_YEAR];
+	int size;
+}*YearWheel;
+
+struct timing_wheel_t {
+	YearWheel* years; //Sorted by year, empty years are released immediately.
+	int years_count;
+	int years_capacity;
+	int size;
+	TwCursor iterator;
+	ElemCopyFunc copyFunc;
+	ElemFreeFunc freeFunc;
+	ElemEqualFunc equalFunc;
+	const Allocator* allocator;
+};
+
+/* =---------------------------------------------------------------------------=
+
+							Static Functions Declarations
+
+   =---------------------------------------------------------------------------=
+*/
+
+/*
+findYear: Searches for the index of a year wheel with a binary search.
+
+@param wheel - The wheel to search in.
+@param year - The year to search for.
+@param insert_index - If not NULL, set to the index the year should be inserted at.
+
+@return NOT_FOUND if the year has no wheel.
+		Else, returns the index of the year wheel.
+*/
+static int findYear(TimingWheel wheel, int year, int* insert_index);
+
+/*
+getBucket: Returns the day bucket of a given date.
+
+@param wheel - The wheel to search in.
+@param date - The date of the bucket.
+@param create - If true, missing year and month wheels are allocated.
+
+@return NULL if the bucket doesn't exist (and create is false) or if a memory allocation failed.
+		Else, returns the day bucket of the date.
+*/
+static DayBucket* getBucket(TimingWheel wheel, Date date, bool create);
+
+/*
+appendNode: Adds a node to the end of the bucket of a given date.
+
+@param wheel - The wheel to add the node to.
+@param node - The node to add.
+@param date - The date of the bucket.
+
+@return TW_OUT_OF_MEMORY if the bucket allocation failed.
+		TW_SUCCESS if the node has been added.
+*/
+static TimingWheelResult appendNode(TimingWheel wheel, Node node, Date date);
+
+/*
+unlinkNode: Detaches the node storing the element from the bucket of a given date.
+			The month and year wheels are kept even if they became empty.
+
+@param wheel - The wheel to detach the node from.
+@param element - The element to search for.
+@param date - The date of the bucket.
+
+@return NULL if the element isn't stored in the bucket.
+		Else, returns the detached node.
+*/
+static Node unlinkNode(TimingWheel wheel, Element element, Date date);
+
+/*
+releaseEmpty: Deallocates the month and the year wheels of a position if they are empty.
+
+@param wheel - The wheel that stores the position.
+@param year_index - The index of the year wheel.
+@param month - The month slot (0 based).
+*/
+static void releaseEmpty(TimingWheel wheel, int year_index, int month);
+
+/*
+releaseEmptyDate: Deallocates the month and the year wheels of a date if they are empty.
+
+@param wheel - The wheel that stores the date.
+@param date - The date to check.
+*/
+static void releaseEmptyDate(TimingWheel wheel, Date date);
+
+/*
+seekBucket: Finds the first non empty day bucket starting from a given position (inclusive).
+
+@param wheel - The wheel to search in.
+@param year_index - The year index to start from, updated to the found position.
+@param month - The month slot to start from, updated to the found position.
+@param day - The day slot to start from, updated to the found position.
+
+@return NULL if there are no elements from the given position on.
+		Else, returns the first node of the found bucket.
+*/
+static Node seekBucket(TimingWheel wheel, int* year_index, int* month, int* day);
+
+/* =---------------------------------------------------------------------------=
+
+								Timing Wheel Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+TimingWheel twCreate(ElemCopyFunc copy_func, ElemFreeFunc free_func, ElemEqualFunc equal_func)
+{
+	return twCreateWithAllocator(copy_func, free_func, equal_func, NULL);
+}
+
+TimingWheel twCreateWithAllocator(ElemCopyFunc copy_func, ElemFreeFunc free_func, ElemEqualFunc equal_func,
+								  const Allocator* allocator)
+{
+	if (copy_func == NULL || free_func == NULL || equal_func == NULL) {
+		return NULL;
+	}
+
+	TimingWheel wheel = allocatorAlloc(allocator, sizeof(*wheel));
+	if (wheel == NULL) {
+		return NULL;
+	}
+	wheel->years = allocatorAlloc(allocator, sizeof(*wheel->years) * INITIAL_YEARS_CAPACITY);
+	if (wheel->years == NULL) {
+		allocatorFree(allocator, wheel);
+		return NULL;
+	}
+	wheel->years_count = 0;
+	wheel->years_capacity = INITIAL_YEARS_CAPACITY;
+	wheel->size = 0;
+	wheel->iterator.node = NULL;
+	wheel->copyFunc = copy_func;
+	wheel->freeFunc = free_func;
+	wheel->equalFunc = equal_func;
+	wheel->allocator = allocator;
+	return wheel;
+}
+
+void twDestroy(TimingWheel wheel)
+{
+	if (wheel == NULL) {
+		return;
+	}
+	for (int i = 0; i < wheel->years_count; i++) {
+		for (int month = 0; month < MONTHS_IN_YEAR; month++) {
+			MonthWheel month_wheel = wheel->years[i]->months[month];
+			if (month_wheel == NULL) {
+				continue;
+			}
+			for (int day = 0; day < DAYS_IN_MONTH; day++) {
+				nodeDestroy(month_wheel->days[day].head);
+			}
+			allocatorFree(wheel->allocator, month_wheel);
+		}
+		allocatorFree(wheel->allocator, wheel->years[i]);
+	}
+	allocatorFree(wheel->allocator, wheel->years);
+	allocatorFree(wheel->allocator, wheel);
+}
+
+int twGetSize(TimingWheel wheel)
+{
+	if (wheel == NULL) {
+		return NO_SIZE;
+	}
+	return wheel->size;
+}
+
+TimingWheelResult twInsert(TimingWheel wheel, Element element, Date date)
+{
+	if (wheel == NULL || element == NULL || date == NULL) {
+		return TW_NULL_ARGUMENT;
+	}
+
+	Node node = nodeCreateWithAllocator(element, wheel->copyFunc, wheel->freeFunc, wheel->allocator);
+	if (node == NULL) {
+		return TW_OUT_OF_MEMORY;
+	}
+	if (appendNode(wheel, node, date) != TW_SUCCESS) {
+		nodeRemove(node);
+		return TW_OUT_OF_MEMORY;
+	}
+	wheel->size++;
+	return TW_SUCCESS;
+}
+
+TimingWheelResult twRemoveElement(TimingWheel wheel, Element element, Date date)
+{
+	if (wheel == NULL || element == NULL || date == NULL) {
+		return TW_NULL_ARGUMENT;
+	}
+
+	Node node = unlinkNode(wheel, element, date);
+	if (node == NULL) {
+		return TW_ELEMENT_DOES_NOT_EXIST;
+	}
+	releaseEmptyDate(wheel, date);
+	nodeRemove(node);
+	wheel->size--;
+	return TW_SUCCESS;
+}
+
+TimingWheelResult twChangeDate(TimingWheel wheel, Element element, Date old_date, Date new_date)
+{
+	if (wheel == NULL || element == NULL || old_date == NULL || new_date == NULL) {
+		return TW_NULL_ARGUMENT;
+	}
+	if (getBucket(wheel, new_date, true) == NULL) { //Allocate first, so a failure leaves the element in place.
+		return TW_OUT_OF_MEMORY;
+	}
+
+	Node node = unlinkNode(wheel, element, old_date);
+	if (node == NULL) {
+		releaseEmptyDate(wheel, new_date);
+		return TW_ELEMENT_DOES_NOT_EXIST;
+	}
+	TimingWheelResult res = appendNode(wheel, node, new_date);
+	assert(res == TW_SUCCESS); //The bucket was allocated above.
+	releaseEmptyDate(wheel, old_date);
+	return res;
+}
+
+TimingWheelResult twRemoveFirst(TimingWheel wheel)
+{
+	if (wheel == NULL) {
+		return TW_NULL_ARGUMENT;
+	}
+
+	wheel->iterator.node = NULL;
+	int year_index = 0, month = 0, day = 0;
+	Node first = seekBucket(wheel, &year_index, &month, &day);
+	if (first == NULL) {
+		return TW_SUCCESS;
+	}
+
+	YearWheel year_wheel = wheel->years[year_index];
+	DayBucket* bucket = &year_wheel->months[month]->days[day];
+	bucket->head = nodeGetNext(first);
+	if (bucket->head == NULL) {
+		bucket->tail = NULL;
+	}
+	nodeRemove(first);
+	year_wheel->months[month]->size--;
+	year_wheel->size--;
+	wheel->size--;
+	releaseEmpty(wheel, year_index, month);
+	return TW_SUCCESS;
+}
+
+Element twGetFirst(TimingWheel wheel)
+{
+	if (wheel == NULL) {
+		return NULL;
+	}
+	return twCursorFirst(wheel, &wheel->iterator);
+}
+
+Element twGetNext(TimingWheel wheel)
+{
+	if (wheel == NULL) {
+		return NULL;
+	}
+	return twCursorNext(wheel, &wheel->iterator);
+}
+
+Element twCursorFirst(TimingWheel wheel, TwCursor* cursor)
+{
+	if (wheel == NULL || cursor == NULL) {
+		return NULL;
+	}
+
+	cursor->year_index = 0;
+	cursor->month = 0;
+	cursor->day = 0;
+	cursor->node = seekBucket(wheel, &cursor->year_index, &cursor->month, &cursor->day);
+	return nodeGet(cursor->node);
+}
+
+Element twCursorNext(TimingWheel wheel, TwCursor* cursor)
+{
+	if (wheel == NULL || cursor == NULL || cursor->node == NULL) {
+		return NULL;
+	}
+
+	cursor->node = nodeGetNext(cursor->node);
+	if (cursor->node == NULL) {
+		cursor->day++;
+		cursor->node = seekBucket(wheel, &cursor->year_index, &cursor->month, &cursor->day);
+	}
+	return nodeGet(cursor->node);
+}
+
+/* =---------------------------------------------------------------------------=
+
+								Static Functions
+
+   =---------------------------------------------------------------------------=
+*/
+
+static int findYear(TimingWheel wheel, int year, int* insert_index)
+{
+	int low = 0, high = wheel->years_count - 1;
+	while (low <= high) {
+		int middle = low + (high - low) / 2;
+		if (wheel->years[middle]->year == year) {
+			return middle;
+		}
+		else if (wheel->years[middle]->year < year) {
+			low = middle + 1;
+		}
+		else {
+			high = middle - 1;
+		}
+	}
+	if (insert_index != NULL) {
+		*insert_index = low;
+	}
+	return NOT_FOUND;
+}
+
+static DayBucket* getBucket(TimingWheel wheel, Date date, bool create)
+{
+	int day = 0, month = 0, year = 0;
+	dateGet(date, &day, &month, &year);
+
+	int insert_index = 0;
+	int year_index = findYear(wheel, year, &insert_index);
+	if (year_index == NOT_FOUND) {
+		if (!create) {
+			return NULL;
+		}
+		if (wheel->years_count == wheel->years_capacity) {
+			YearWheel* years = allocatorAlloc(wheel->allocator, sizeof(*years) * wheel->years_capacity * 2);
+			if (years == NULL) {
+				return NULL;
+			}
+			memcpy(years, wheel->years, sizeof(*years) * wheel->years_count);
+			allocatorFree(wheel->allocator, wheel->years);
+			wheel->years = years;
+			wheel->years_capacity *= 2;
+		}
+		YearWheel year_wheel = allocatorAlloc(wheel->allocator, sizeof(*year_wheel));
+		if (year_wheel == NULL) {
+			return NULL;
+		}
+		memset(year_wheel, 0, sizeof(*year_wheel));
+		year_wheel->year = year;
+		memmove(wheel->years + insert_index + 1, wheel->years + insert_index,
+			sizeof(*wheel->years) * (wheel->years_count - insert_index));
+		wheel->years[insert_index] = year_wheel;
+		wheel->years_count++;
+		year_index = insert_index;
+	}
+
+	YearWheel year_wheel = wheel->years[year_index];
+	if (year_wheel->months[month - 1] == NULL) {
+		if (!create) {
+			return NULL;
+		}
+		year_wheel->months[month - 1] = allocatorAlloc(wheel->allocator, sizeof(*year_wheel->months[month - 1]));
+		if (year_wheel->months[month - 1] == NULL) {
+			releaseEmpty(wheel, year_index, month - 1);
+			return NULL;
+		}
+		memset(year_wheel->months[month - 1], 0, sizeof(*year_wheel->months[month - 1]));
+	}
+	return &year_wheel->months[month - 1]->days[day - 1];
+}
+
+static TimingWheelResult appendNode(TimingWheel wheel, Node node, Date date)
+{
+	DayBucket* bucket = getBucket(wheel, date, true);
+	if (bucket == NULL) {
+		return TW_OUT_OF_MEMORY;
+	}
+
+	nodeSetNext(node, NULL);
+	if (bucket->tail == NULL) {
+		bucket->head = node;
+	}
+	else {
+		nodeSetNext(bucket->tail, node);
+	}
+	bucket->tail = node;
+
+	int day = 0, month = 0, year = 0;
+	dateGet(date, &day, &month, &year);
+	YearWheel year_wheel = wheel->years[findYear(wheel, year, NULL)];
+	year_wheel->months[month - 1]->size++;
+	year_wheel->size++;
+	wheel->iterator.node = NULL;
+	return TW_SUCCESS;
+}
+
+static Node unlinkNode(TimingWheel wheel, Element element, Date date)
+{
+	DayBucket* bucket = getBucket(wheel, date, false);
+	if (bucket == NULL) {
+		return NULL;
+	}
+
+	Node prev = NULL;
+	NODE_FOREACH(Node, ptr, bucket->head) {
+		STATS_COUNT(equality_checks);
+		if (!wheel->equalFunc(nodeGet(ptr), element)) {
+			prev = ptr;
+			continue;
+		}
+		if (prev == NULL) {
+			bucket->head = nodeGetNext(ptr);
+		}
+		else {
+			nodeSetNext(prev, nodeGetNext(ptr));
+		}
+		if (bucket->tail == ptr) {
+			bucket->tail = prev;
+		}
+		nodeSetNext(ptr, NULL);
+
+		int day = 0, month = 0, year = 0;
+		dateGet(date, &day, &month, &year);
+		int year_index = findYear(wheel, year, NULL);
+		wheel->years[year_index]->months[month - 1]->size--;
+		wheel->years[year_index]->size--;
+		wheel->iterator.node = NULL;
+		return ptr;
+	}
+	return NULL;
+}
+
+static void releaseEmpty(TimingWheel wheel, int year_index, int month)
+{
+	if (year_index == NOT_FOUND) {
+		return;
+	}
+	YearWheel year_wheel = wheel->years[year_index];
+	if (year_wheel->months[month] != NULL && year_wheel->months[month]->size == 0) {
+		allocatorFree(wheel->allocator, year_wheel->months[month]);
+		year_wheel->months[month] = NULL;
+	}
+	if (year_wheel->size > 0) {
+		return;
+	}
+	allocatorFree(wheel->allocator, year_wheel);
+	memmove(wheel->years + year_index, wheel->years + year_index + 1,
+		sizeof(*wheel->years) * (wheel->years_count - year_index - 1));
+	wheel->years_count--;
+}
+
+static void releaseEmptyDate(TimingWheel wheel, Date date)
+{
+	int day = 0, month = 0, year = 0;
+	dateGet(date, &day, &month, &year);
+	releaseEmpty(wheel, findYear(wheel, year, NULL), month - 1);
+}
+
+static Node seekBucket(TimingWheel wheel, int* year_index, int* month, int* day)
+{
+	for (; *year_index < wheel->years_count; (*year_index)++, *month = 0, *day = 0) {
+		YearWheel year_wheel = wheel->years[*year_index];
+		for (; *month < MONTHS_IN_YEAR; (*month)++, *day = 0) {
+			MonthWheel month_wheel = year_wheel->months[*month];
+			if (month_wheel == NULL) {
+				continue;
+			}
+			for (; *day < DAYS_IN_MONTH; (*day)++) {
+				if (month_wheel->days[*day].head != NULL) {
+					return month_wheel->days[*day].head;
+				}
+			}
+		}
+	}
+	return NULL;
+}
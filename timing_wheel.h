@@ -0,0 +1,183 @@
+#ifndef _TIMING_WHEEL_H
+#define _TIMING_WHEEL_H
+
+#include <stdbool.h>
+#include "date.h"
+#include "pair.h"
+
+/** Type for defining a hierarchical timing wheel (years -> months -> days) */
+typedef struct timing_wheel_t* TimingWheel;
+
+/** Type for iterating over the wheel without changing it, positions are private to timing_wheel.c */
+typedef struct {
+	void* node;
+	int year_index;
+	int month;
+	int day;
+} TwCursor;
+
+/** Type used for comparing two elements stored in the wheel */
+typedef bool(*ElemEqualFunc)(Element, Element);
+
+/** Type used for returning error codes from timing wheel functions */
+typedef enum {
+	TW_SUCCESS,
+	TW_OUT_OF_MEMORY,
+	TW_NULL_ARGUMENT,
+	TW_ELEMENT_DOES_NOT_EXIST
+} TimingWheelResult;
+
+
+/*
+twCreate: Creates a new empty timing wheel.
+		  Elements are kept in day buckets, grouped into month wheels of 30 days,
+		  which are grouped into year wheels of 12 months (same calendar as date.c).
+
+@param copy_func - Function for copying elements.
+@param free_func - Function for deallocating elements.
+@param equal_func - Function for comparing elements.
+
+@return NULL if one of the arguments is NULL or if a memory allocation failed.
+		Else, returns a new empty timing wheel.
+*/
+TimingWheel twCreate(ElemCopyFunc copy_func, ElemFreeFunc free_func, ElemEqualFunc equal_func);
+
+/*
+twCreateWithAllocator: Creates a new empty timing wheel like twCreate, whose wheels and nodes
+					   are allocated from the given allocator.
+
+@param copy_func - Function for copying elements.
+@param free_func - Function for deallocating elements.
+@param equal_func - Function for comparing elements.
+@param allocator - The allocator of the wheel, or NULL for the default allocator.
+
+@return NULL if one of the functions is NULL or if a memory allocation failed.
+		Else, returns a new empty timing wheel.
+*/
+TimingWheel twCreateWithAllocator(ElemCopyFunc copy_func, ElemFreeFunc free_func, ElemEqualFunc equal_func,
+								  const Allocator* allocator);
+
+/*
+twDestroy: Deallocates the wheel and all of its elements.
+
+@param wheel - The wheel to deallocate.
+*/
+void twDestroy(TimingWheel wheel);
+
+/*
+twGetSize: Returns the number of elements in the wheel.
+
+@param wheel - The wheel to count.
+
+@return -1 if the wheel is NULL.
+		Else, returns the number of elements stored in the wheel.
+*/
+int twGetSize(TimingWheel wheel);
+
+/*
+twInsert: Adds a copy of an element to the bucket of the given date.
+		  Elements with the same date are kept in insertion order.
+
+@param wheel - The wheel to add the element to.
+@param element - The element to add.
+@param date - The date bucket of the element.
+
+@return TW_NULL_ARGUMENT if one of the arguments is NULL.
+		TW_OUT_OF_MEMORY if a memory allocation failed.
+		TW_SUCCESS if the element has been added successfully.
+*/
+TimingWheelResult twInsert(TimingWheel wheel, Element element, Date date);
+
+/*
+twRemoveElement: Removes an element from the bucket of the given date.
+
+@param wheel - The wheel to remove the element from.
+@param element - The element to remove.
+@param date - The date bucket the element is stored in.
+
+@return TW_NULL_ARGUMENT if one of the arguments is NULL.
+		TW_ELEMENT_DOES_NOT_EXIST if the element isn't stored in the date's bucket.
+		TW_SUCCESS if the element has been removed successfully.
+*/
+TimingWheelResult twRemoveElement(TimingWheel wheel, Element element, Date date);
+
+/*
+twChangeDate: Moves an element from one date bucket to the end of another,
+			  without copying the element.
+
+@param wheel - The wheel that stores the element.
+@param element - The element to move.
+@param old_date - The date bucket the element is stored in.
+@param new_date - The date bucket to move the element to.
+
+@return TW_NULL_ARGUMENT if one of the arguments is NULL.
+		TW_OUT_OF_MEMORY if a memory allocation failed.
+		TW_ELEMENT_DOES_NOT_EXIST if the element isn't stored in the old date's bucket.
+		TW_SUCCESS if the element has been moved successfully.
+*/
+TimingWheelResult twChangeDate(TimingWheel wheel, Element element, Date old_date, Date new_date);
+
+/*
+twRemoveFirst: Removes the earliest element from the wheel.
+
+@param wheel - The wheel to remove the element from.
+
+@return TW_NULL_ARGUMENT if the wheel is NULL.
+		TW_SUCCESS otherwise (also when the wheel is empty).
+*/
+TimingWheelResult twRemoveFirst(TimingWheel wheel);
+
+/*
+twGetFirst: Sets the internal iterator to the earliest element and returns it.
+
+@param wheel - The wheel to iterate over.
+
+@return NULL if the wheel is NULL or empty.
+		Else, returns the earliest element (Not a copy).
+*/
+Element twGetFirst(TimingWheel wheel);
+
+/*
+twGetNext: Advances the internal iterator and returns the element it points to.
+
+@param wheel - The wheel to iterate over.
+
+@return NULL if the wheel is NULL, the iterator is undefined or the end was reached.
+		Else, returns the next element in date order (Not a copy).
+*/
+Element twGetNext(TimingWheel wheel);
+
+/*
+twCursorFirst: Sets an external cursor to the earliest element and returns it.
+			   The wheel itself isn't changed, so several cursors can iterate at the same time.
+			   Any change to the wheel invalidates its cursors.
+
+@param wheel - The wheel to iterate over.
+@param cursor - The cursor to set.
+
+@return NULL if one of the arguments is NULL or if the wheel is empty.
+		Else, returns the earliest element (Not a copy).
+*/
+Element twCursorFirst(TimingWheel wheel, TwCursor* cursor);
+
+/*
+twCursorNext: Advances an external cursor and returns the element it points to.
+
+@param wheel - The wheel to iterate over.
+@param cursor - The cursor to advance.
+
+@return NULL if one of the arguments is NULL or if the end was reached.
+		Else, returns the next element in date order (Not a copy).
+*/
+Element twCursorNext(TimingWheel wheel, TwCursor* cursor);
+
+/*
+* Macro for iterating over the wheel in date order.
+* Declares a new iterator for the loop.
+*/
+#define TW_FOREACH(type, iterator, wheel) \
+	for(type iterator = (type) twGetFirst(wheel) ; \
+		iterator != NULL ;\
+		iterator = twGetNext(wheel))
+
+#endif /* _TIMING_WHEEL_H */